@@ -5,18 +5,24 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../tachyon/algorithm/compression/compression_manager.cpp \
+../tachyon/algorithm/compression/compression_policy.cpp \
 ../tachyon/algorithm/compression/genotype_encoder.cpp \
-../tachyon/algorithm/compression/libzpaq.cpp 
+../tachyon/algorithm/compression/libzpaq.cpp \
+../tachyon/algorithm/compression/zstd_dictionary.cpp 
 
 OBJS += \
 ./tachyon/algorithm/compression/compression_manager.o \
+./tachyon/algorithm/compression/compression_policy.o \
 ./tachyon/algorithm/compression/genotype_encoder.o \
-./tachyon/algorithm/compression/libzpaq.o 
+./tachyon/algorithm/compression/libzpaq.o \
+./tachyon/algorithm/compression/zstd_dictionary.o 
 
 CPP_DEPS += \
 ./tachyon/algorithm/compression/compression_manager.d \
+./tachyon/algorithm/compression/compression_policy.d \
 ./tachyon/algorithm/compression/genotype_encoder.d \
-./tachyon/algorithm/compression/libzpaq.d 
+./tachyon/algorithm/compression/libzpaq.d \
+./tachyon/algorithm/compression/zstd_dictionary.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
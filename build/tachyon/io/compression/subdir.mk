@@ -5,16 +5,19 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../tachyon/io/compression/BGZFController.cpp \
+../tachyon/io/compression/BGZFControllerParallel.cpp \
 ../tachyon/io/compression/TGZFController.cpp \
 ../tachyon/io/compression/TGZFControllerStream.cpp 
 
 OBJS += \
 ./tachyon/io/compression/BGZFController.o \
+./tachyon/io/compression/BGZFControllerParallel.o \
 ./tachyon/io/compression/TGZFController.o \
 ./tachyon/io/compression/TGZFControllerStream.o 
 
 CPP_DEPS += \
 ./tachyon/io/compression/BGZFController.d \
+./tachyon/io/compression/BGZFControllerParallel.d \
 ./tachyon/io/compression/TGZFController.d \
 ./tachyon/io/compression/TGZFControllerStream.d 
 
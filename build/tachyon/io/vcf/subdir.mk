@@ -4,13 +4,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
-../tachyon/io/vcf/VCFHeader.cpp 
+../tachyon/io/vcf/VCFHeader.cpp \
+../tachyon/io/vcf/VCFReader.cpp \
+../tachyon/io/vcf/VCFRecordConverter.cpp 
 
 OBJS += \
-./tachyon/io/vcf/VCFHeader.o 
+./tachyon/io/vcf/VCFHeader.o \
+./tachyon/io/vcf/VCFReader.o \
+./tachyon/io/vcf/VCFRecordConverter.o 
 
 CPP_DEPS += \
-./tachyon/io/vcf/VCFHeader.d 
+./tachyon/io/vcf/VCFHeader.d \
+./tachyon/io/vcf/VCFReader.d \
+./tachyon/io/vcf/VCFRecordConverter.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
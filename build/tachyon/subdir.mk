@@ -5,15 +5,18 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../tachyon/main.cpp \
-../tachyon/variant_reader.cpp 
+../tachyon/variant_reader.cpp \
+../tachyon/variant_reader_prefetcher.cpp 
 
 OBJS += \
 ./tachyon/main.o \
-./tachyon/variant_reader.o 
+./tachyon/variant_reader.o \
+./tachyon/variant_reader_prefetcher.o 
 
 CPP_DEPS += \
 ./tachyon/main.d \
-./tachyon/variant_reader.d 
+./tachyon/variant_reader.d \
+./tachyon/variant_reader_prefetcher.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,230 @@
+#ifndef ALGORITHM_BLOCK_CHECKSUM_H_
+#define ALGORITHM_BLOCK_CHECKSUM_H_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <streambuf>
+#include <algorithm>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "../support/type_definitions.h"
+#include "../support/helpers.h"
+#include "../third_party/xxhash/xxhash.h"
+
+namespace tachyon{
+namespace algorithm{
+
+// Integrity checks of a file. SHA-512 digests cover all data
+// of the file. The other algorithms checksum each block
+// separately and are only meant to detect corruption
+typedef enum {YON_CHECKSUM_SHA512, YON_CHECKSUM_CRC32C, YON_CHECKSUM_XXHASH64} TACHYON_CHECKSUM_TYPE;
+
+#define YON_CHECKSUM_XXHASH_SEED 2147483647
+
+/**<
+ * Streaming CRC32C or xxHash64 checksum of a run of bytes.
+ * CRC32C uses the SSE4.2 instruction if available.
+ */
+struct BlockChecksum{
+private:
+	typedef BlockChecksum self_type;
+
+public:
+	BlockChecksum(const TACHYON_CHECKSUM_TYPE type) :
+		type(type),
+		crc(0xFFFFFFFF),
+		state(nullptr)
+	{
+		if(this->type == YON_CHECKSUM_XXHASH64){
+			this->state = XXH64_createState();
+			XXH64_reset(this->state, YON_CHECKSUM_XXHASH_SEED);
+		}
+	}
+
+	~BlockChecksum(){
+		if(this->state != nullptr) XXH64_freeState(this->state);
+	}
+
+	void update(const char* data, U64 length){
+		if(this->type == YON_CHECKSUM_XXHASH64){
+			XXH64_update(this->state, data, length);
+			return;
+		}
+
+#if defined(__SSE4_2__)
+		U64 crc64 = this->crc;
+		for(; length >= sizeof(U64); length -= sizeof(U64), data += sizeof(U64)){
+			U64 word;
+			memcpy(&word, data, sizeof(U64));
+			crc64 = _mm_crc32_u64(crc64, word);
+		}
+		this->crc = crc64;
+		for(; length; --length, ++data)
+			this->crc = _mm_crc32_u8(this->crc, *data);
+#else
+		for(; length; --length, ++data){
+			this->crc ^= (BYTE)*data;
+			for(U32 i = 0; i < 8; ++i)
+				this->crc = (this->crc >> 1) ^ (0x82F63B78 & (0 - (this->crc & 1)));
+		}
+#endif
+	}
+
+	inline U64 digest(void) const{
+		if(this->type == YON_CHECKSUM_XXHASH64) return(XXH64_digest(this->state));
+		return(this->crc ^ 0xFFFFFFFF);
+	}
+
+	static U64 compute(const TACHYON_CHECKSUM_TYPE type, const char* data, const U64 length){
+		self_type checksum(type);
+		checksum.update(data, length);
+		return(checksum.digest());
+	}
+
+	static bool parseType(const std::string& name, TACHYON_CHECKSUM_TYPE& type){
+		if(name == "sha512")   { type = YON_CHECKSUM_SHA512;   return true; }
+		if(name == "crc32c")   { type = YON_CHECKSUM_CRC32C;   return true; }
+		if(name == "xxhash64") { type = YON_CHECKSUM_XXHASH64; return true; }
+		return false;
+	}
+
+	static std::string typeString(const TACHYON_CHECKSUM_TYPE type){
+		switch(type){
+		case(YON_CHECKSUM_CRC32C):   return("crc32c");
+		case(YON_CHECKSUM_XXHASH64): return("xxhash64");
+		default:                     return("sha512");
+		}
+	}
+
+private:
+	BlockChecksum(const self_type& other);
+	self_type& operator=(const self_type& other);
+
+public:
+	TACHYON_CHECKSUM_TYPE type;
+	U32            crc;
+	XXH64_state_t* state;
+};
+
+/**<
+ * Output stream buffer computing the checksum of all bytes
+ * written through it before passing them on to the target
+ * buffer. Positions are those of the target buffer.
+ */
+class BlockChecksumStreamBuffer : public std::streambuf{
+private:
+	typedef BlockChecksumStreamBuffer self_type;
+
+public:
+	BlockChecksumStreamBuffer(std::streambuf* target, const TACHYON_CHECKSUM_TYPE type) : target_(target), checksum_(type){}
+	~BlockChecksumStreamBuffer(){}
+
+	inline U64 digest(void) const{ return(this->checksum_.digest()); }
+
+protected:
+	int_type overflow(int_type c){
+		if(traits_type::eq_int_type(c, traits_type::eof())) return(traits_type::not_eof(c));
+		const char byte = traits_type::to_char_type(c);
+		this->checksum_.update(&byte, 1);
+		return(this->target_->sputc(byte));
+	}
+
+	std::streamsize xsputn(const char* data, std::streamsize length){
+		this->checksum_.update(data, length);
+		return(this->target_->sputn(data, length));
+	}
+
+	pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode){
+		return(this->target_->pubseekoff(offset, direction, mode));
+	}
+
+	int sync(void){ return(this->target_->pubsync()); }
+
+private:
+	std::streambuf* target_;
+	BlockChecksum   checksum_;
+};
+
+/**<
+ * Checksums of the blocks of a file keyed by the offset of each
+ * block. Blocks are stored back-to-back such that a block ends
+ * where the next block, or the data, ends.
+ */
+class BlockChecksumManager{
+private:
+	typedef BlockChecksumManager self_type;
+	typedef std::size_t          size_type;
+
+	struct Entry{
+		Entry() : byte_offset(0), checksum(0){}
+		Entry(const U64 byte_offset, const U64 checksum) : byte_offset(byte_offset), checksum(checksum){}
+
+		U64 byte_offset;
+		U64 checksum;
+	};
+
+public:
+	BlockChecksumManager() : type(YON_CHECKSUM_SHA512){}
+	~BlockChecksumManager(){}
+
+	inline const size_type size(void) const{ return(this->entries_.size()); }
+	inline const bool empty(void) const{ return(this->entries_.size() == 0); }
+	inline void clear(void){ this->entries_.clear(); }
+
+	inline void add(const U64 byte_offset, const U64 checksum){ this->entries_.push_back(Entry(byte_offset, checksum)); }
+
+	/**<
+	 * Find the byte range and checksum of the block starting at
+	 * `byte_offset`
+	 * @param byte_offset     Offset of the block
+	 * @param offset_end_data Offset of the end of the data
+	 * @param length          Length of the block
+	 * @param checksum        Checksum of the block
+	 * @return                Returns TRUE if the block is known or FALSE otherwise
+	 */
+	bool find(const U64 byte_offset, const U64 offset_end_data, U64& length, U64& checksum) const{
+		std::vector<Entry>::const_iterator it = std::lower_bound(this->entries_.begin(), this->entries_.end(), byte_offset,
+		                                        [](const Entry& entry, const U64 offset){ return(entry.byte_offset < offset); });
+		if(it == this->entries_.end() || it->byte_offset != byte_offset) return false;
+
+		checksum = it->checksum;
+		length   = ((it + 1) == this->entries_.end() ? offset_end_data : (it + 1)->byte_offset) - byte_offset;
+		return true;
+	}
+
+private:
+	friend std::ostream& operator<<(std::ostream& stream, const self_type& manager){
+		const size_type n_entries = manager.size();
+		stream.write(reinterpret_cast<const char*>(&n_entries), sizeof(size_type));
+		for(size_type i = 0; i < n_entries; ++i){
+			stream.write(reinterpret_cast<const char*>(&manager.entries_[i].byte_offset), sizeof(U64));
+			stream.write(reinterpret_cast<const char*>(&manager.entries_[i].checksum),    sizeof(U64));
+		}
+		return(stream);
+	}
+
+	friend std::ifstream& operator>>(std::ifstream& stream, self_type& manager){
+		size_type n_entries = 0;
+		stream.read(reinterpret_cast<char*>(&n_entries), sizeof(size_type));
+		manager.entries_.resize(n_entries);
+		for(size_type i = 0; i < n_entries; ++i){
+			stream.read(reinterpret_cast<char*>(&manager.entries_[i].byte_offset), sizeof(U64));
+			stream.read(reinterpret_cast<char*>(&manager.entries_[i].checksum),    sizeof(U64));
+		}
+		return(stream);
+	}
+
+public:
+	TACHYON_CHECKSUM_TYPE type;
+
+private:
+	std::vector<Entry> entries_; // in file order
+};
+
+}
+}
+
+#endif /* ALGORITHM_BLOCK_CHECKSUM_H_ */
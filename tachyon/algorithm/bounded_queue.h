@@ -0,0 +1,89 @@
+#ifndef ALGORITHM_BOUNDED_QUEUE_H_
+#define ALGORITHM_BOUNDED_QUEUE_H_
+
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+
+namespace tachyon{
+namespace algorithm{
+
+/**<
+ * Blocking first-in first-out queue with a fixed upper bound
+ * on the number of elements it can hold. Producers block
+ * while the queue is full and consumers block while it is
+ * empty. Used to connect stages in multi-threaded pipelines
+ * where the bound provides back-pressure between producers
+ * and consumers.
+ */
+template <class T>
+class BoundedQueue{
+private:
+	typedef BoundedQueue self_type;
+	typedef T            value_type;
+	typedef std::size_t  size_type;
+
+public:
+	explicit BoundedQueue(const size_type capacity) : closed_(false), n_capacity_(capacity){}
+	~BoundedQueue(){}
+
+	/**<
+	 * Adds an element to the back of the queue. Blocks
+	 * while the queue is full.
+	 * @param value Target element
+	 * @return      Returns TRUE upon success or FALSE if the queue is closed
+	 */
+	bool push(const value_type& value){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->cv_not_full_.wait(lock, [this]{ return(this->closed_ || this->queue_.size() < this->n_capacity_); });
+		if(this->closed_) return false;
+		this->queue_.push(value);
+		lock.unlock();
+		this->cv_not_empty_.notify_one();
+		return true;
+	}
+
+	/**<
+	 * Retrieves the element at the front of the queue. Blocks
+	 * while the queue is empty and has not been closed.
+	 * @param value Destination element
+	 * @return      Returns TRUE upon success or FALSE if the queue is closed and drained
+	 */
+	bool pop(value_type& value){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->cv_not_empty_.wait(lock, [this]{ return(this->closed_ || this->queue_.size()); });
+		if(this->queue_.size() == 0) return false;
+		value = this->queue_.front();
+		this->queue_.pop();
+		lock.unlock();
+		this->cv_not_full_.notify_one();
+		return true;
+	}
+
+	/**<
+	 * Signal that no more elements will be added. Consumers
+	 * drain any remaining elements before pop() returns FALSE.
+	 */
+	void close(void){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->closed_ = true;
+		lock.unlock();
+		this->cv_not_empty_.notify_all();
+		this->cv_not_full_.notify_all();
+	}
+
+	inline const size_type& capacity(void) const{ return(this->n_capacity_); }
+
+private:
+	bool                    closed_;
+	size_type               n_capacity_;
+	std::queue<value_type>  queue_;
+	std::mutex              mutex_;
+	std::condition_variable cv_not_empty_;
+	std::condition_variable cv_not_full_;
+};
+
+}
+}
+
+#endif /* ALGORITHM_BOUNDED_QUEUE_H_ */
@@ -3,8 +3,18 @@
 namespace tachyon{
 namespace algorithm{
 
-CompressionManager::CompressionManager(){}
-CompressionManager::~CompressionManager(){}
+CompressionManager::CompressionManager() : n_threads_(1), slaves_(nullptr), profiler_(nullptr){
+	this->zstd_codec.setDictionaries(&this->dictionaries);
+}
+CompressionManager::~CompressionManager(){ delete [] this->slaves_; }
+
+void CompressionManager::setThreads(const U32 n_threads){
+	delete [] this->slaves_;
+	this->slaves_    = nullptr;
+	this->n_threads_ = (n_threads == 0 ? 1 : n_threads);
+	if(this->n_threads_ > 1)
+		this->slaves_ = new slave_type[this->n_threads_];
+}
 
 bool CompressionManager::compress(variant_block_type& block){
 	const BYTE zstd_compression_level = 20;
@@ -12,106 +22,139 @@ bool CompressionManager::compress(variant_block_type& block){
 	zstd_codec.setCompressionLevelData(3);
 	if(block.header.controller.hasGTPermuted)            zstd_codec.compress(block.ppa_manager);
 	zstd_codec.setCompressionLevel(zstd_compression_level);
-	if(block.meta_contig_container.header.n_entries)     zstd_codec.compress(block.meta_contig_container);
-	if(block.meta_positions_container.header.n_entries)  zstd_codec.compress(block.meta_positions_container);
-	if(block.meta_refalt_container.header.n_entries)     zstd_codec.compress(block.meta_refalt_container);
-	if(block.meta_controller_container.header.n_entries) zstd_codec.compress(block.meta_controller_container);
-	if(block.meta_quality_container.header.n_entries)    zstd_codec.compress(block.meta_quality_container);
-	if(block.meta_names_container.header.n_entries){
-		//zpaq_codec.compress(block.meta_names_container, false);
-		zstd_codec.compress(block.meta_names_container);
-	}
-
-	//const std::string zpaq_cmd = "4";
-	if(block.gt_rle8_container.header.n_entries){
-		zstd_codec.compress(block.gt_rle8_container);
-		//zstd_codec.compressStrides(block.gt_rle8_container);
-	}
-	if(block.gt_rle16_container.header.n_entries){
-		zstd_codec.compress(block.gt_rle16_container);
-		//zstd_codec.compressStrides(block.gt_rle16_container);
-	}
-	if(block.gt_rle32_container.header.n_entries){
-		zstd_codec.compress(block.gt_rle32_container);
-		//zstd_codec.compressStrides(block.gt_rle32_container);
-	}
-	if(block.gt_rle64_container.header.n_entries){
-		zstd_codec.compress(block.gt_rle64_container);
-		//zstd_codec.compressStrides(block.gt_rle64_container);
-	}
-
-	if(block.meta_alleles_container.header.n_entries){
-		zstd_codec.compress(block.meta_alleles_container);
-		//zstd_codec.compressStrides(block.meta_alleles_container);
-	}
-
-	if(block.gt_simple8_container.header.n_entries)      zstd_codec.compress(block.gt_simple8_container);
-	if(block.gt_simple16_container.header.n_entries)     zstd_codec.compress(block.gt_simple16_container);
-	if(block.gt_simple32_container.header.n_entries)     zstd_codec.compress(block.gt_simple32_container);
-	if(block.gt_simple64_container.header.n_entries)     zstd_codec.compress(block.gt_simple64_container);
-	if(block.gt_support_data_container.header.n_entries) zstd_codec.compress(block.gt_support_data_container);
-	if(block.meta_info_map_ids.header.n_entries)         zstd_codec.compress(block.meta_info_map_ids);
-	if(block.meta_filter_map_ids.header.n_entries)       zstd_codec.compress(block.meta_filter_map_ids);
-	if(block.meta_format_map_ids.header.n_entries)       zstd_codec.compress(block.meta_format_map_ids);
 
+	// Collect the containers to compress together with their
+	// compression levels in the order they are processed
+	std::vector<task_type> tasks;
+	tasks.reserve(19 + block.footer.n_info_streams + block.footer.n_format_streams);
+	if(block.meta_contig_container.header.n_entries)     tasks.push_back(task_type(&block.meta_contig_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 2));
+	if(block.meta_positions_container.header.n_entries)  tasks.push_back(task_type(&block.meta_positions_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 3));
+	if(block.meta_refalt_container.header.n_entries)     tasks.push_back(task_type(&block.meta_refalt_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 4));
+	if(block.meta_controller_container.header.n_entries) tasks.push_back(task_type(&block.meta_controller_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 5));
+	if(block.meta_quality_container.header.n_entries)    tasks.push_back(task_type(&block.meta_quality_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 6));
+	if(block.meta_names_container.header.n_entries)      tasks.push_back(task_type(&block.meta_names_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 7));
+	if(block.gt_rle8_container.header.n_entries)         tasks.push_back(task_type(&block.gt_rle8_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 13));
+	if(block.gt_rle16_container.header.n_entries)        tasks.push_back(task_type(&block.gt_rle16_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 14));
+	if(block.gt_rle32_container.header.n_entries)        tasks.push_back(task_type(&block.gt_rle32_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 15));
+	if(block.gt_rle64_container.header.n_entries)        tasks.push_back(task_type(&block.gt_rle64_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 16));
+	if(block.meta_alleles_container.header.n_entries)    tasks.push_back(task_type(&block.meta_alleles_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 8));
+	if(block.gt_simple8_container.header.n_entries)      tasks.push_back(task_type(&block.gt_simple8_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 17));
+	if(block.gt_simple16_container.header.n_entries)     tasks.push_back(task_type(&block.gt_simple16_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 18));
+	if(block.gt_simple32_container.header.n_entries)     tasks.push_back(task_type(&block.gt_simple32_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 19));
+	if(block.gt_simple64_container.header.n_entries)     tasks.push_back(task_type(&block.gt_simple64_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 20));
+	if(block.gt_support_data_container.header.n_entries) tasks.push_back(task_type(&block.gt_support_data_container, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 12));
+	if(block.meta_info_map_ids.header.n_entries)         tasks.push_back(task_type(&block.meta_info_map_ids, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 9));
+	if(block.meta_filter_map_ids.header.n_entries)       tasks.push_back(task_type(&block.meta_filter_map_ids, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 11));
+	if(block.meta_format_map_ids.header.n_entries)       tasks.push_back(task_type(&block.meta_format_map_ids, zstd_compression_level, zstd_compression_level, YON_POLICY_BASIC, 10));
+
+	// Floating point data compresses poorly: use a fast level for data
 	for(U32 i = 0; i < block.footer.n_info_streams; ++i){
 		if(block.info_containers[i].header.data_header.controller.type == YON_TYPE_FLOAT ||
 		   block.info_containers[i].header.data_header.controller.type == YON_TYPE_DOUBLE){
-			zstd_codec.setCompressionLevelData(3);
-			zstd_codec.setCompressionLevelStrides(zstd_compression_level);
-			//zpaq_codec.compress(block.info_containers[i]);
-			//zstd_codec.compress(block.info_containers[i]);
-			//zstd_codec.compress(block.info_containers[i]);
+			tasks.push_back(task_type(&block.info_containers[i], 3, zstd_compression_level, YON_POLICY_INFO, block.footer.info_offsets[i].data_header.global_key));
 		}
 		else {
-			zstd_codec.setCompressionLevel(zstd_compression_level);
-			//zstd_codec.compress(block.info_containers[i]);
-			//zpaq_codec.compress(block.info_containers[i]);
-			//zstd_codec.compress(block.info_containers[i]);
+			const U32 global_key = block.footer.info_offsets[i].data_header.global_key;
+			tasks.push_back(task_type(&block.info_containers[i], zstd_compression_level, zstd_compression_level, YON_POLICY_INFO, global_key, this->dictionaries.getCompressionDictionary(YON_DICTIONARY_INFO, global_key)));
 		}
-		//zstd_codec.compress(block.info_containers[i]);
-		//zpaq_codec.compress(block.info_containers[i], "4");
-		zstd_codec.compress(block.info_containers[i]);
 	}
 
 	for(U32 i = 0; i < block.footer.n_format_streams; ++i){
 		if(block.format_containers[i].header.data_header.controller.type == YON_TYPE_FLOAT ||
 		   block.format_containers[i].header.data_header.controller.type == YON_TYPE_DOUBLE){
-			zstd_codec.setCompressionLevelData(3);
-			zstd_codec.setCompressionLevelStrides(zstd_compression_level);
-			//zpaq_codec.compress(block.format_containers[i]);
-			//zstd_codec.compress(block.format_containers[i]);
+			tasks.push_back(task_type(&block.format_containers[i], 3, zstd_compression_level, YON_POLICY_FORMAT, block.footer.format_offsets[i].data_header.global_key));
 		}
 		else {
-			zstd_codec.setCompressionLevel(zstd_compression_level);
-			//zstd_codec.compress(block.format_containers[i]);
-			//zpaq_codec.compress(block.format_containers[i]);
+			const U32 global_key = block.footer.format_offsets[i].data_header.global_key;
+			tasks.push_back(task_type(&block.format_containers[i], zstd_compression_level, zstd_compression_level, YON_POLICY_FORMAT, global_key, this->dictionaries.getCompressionDictionary(YON_DICTIONARY_FORMAT, global_key)));
+		}
+	}
+
+	// Single-threaded
+	if(this->n_threads_ <= 1 || tasks.size() <= 1){
+		Timer timer;
+		for(U32 i = 0; i < tasks.size(); ++i){
+			if(this->profiler_ != nullptr) timer.Start();
+
+			bool compressed = false;
+			if(tasks[i].dictionary != nullptr){
+				zstd_codec.setCompressionLevelData(tasks[i].level_data);
+				zstd_codec.setCompressionLevelStrides(tasks[i].level_strides);
+				compressed = zstd_codec.compress(*tasks[i].container, tasks[i].dictionary);
+			} else if(this->policy.isActive()){
+				compressed = this->policy.compress(*tasks[i].container, tasks[i].group, tasks[i].key, zstd_codec, zpaq_codec);
+			} else {
+				zstd_codec.setCompressionLevelData(tasks[i].level_data);
+				zstd_codec.setCompressionLevelStrides(tasks[i].level_strides);
+				compressed = zstd_codec.compress(*tasks[i].container);
+			}
+
+			if(!compressed){
+				std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to compress container..." << std::endl;
+				return false;
+			}
+			if(this->profiler_ != nullptr) tasks[i].addProfile(*this->profiler_, timer);
+		}
+		return true;
+	}
+
+	// Multi-threaded: each slave compresses every N-th container
+	// using its own compression context
+	const U32 n_threads = tasks.size() < this->n_threads_ ? tasks.size() : this->n_threads_;
+	std::vector<std::thread*> threads(n_threads);
+	for(U32 i = 0; i < n_threads; ++i) threads[i] = this->slaves_[i].Start(i, n_threads, tasks, this->policy, this->profiler_);
+	for(U32 i = 0; i < n_threads; ++i) threads[i]->join();
+
+	for(U32 i = 0; i < n_threads; ++i){
+		if(!this->slaves_[i].success){
+			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to compress container in thread " << i << "..." << std::endl;
+			return false;
 		}
-		zstd_codec.compress(block.format_containers[i]);
 	}
 
 	return true;
 }
 
 bool CompressionManager::decompress(variant_block_type& block){
-	if(block.ppa_manager.PPA.size()){
-		if(!this->decompress(block.ppa_manager)){
-			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress GT permutation information!" << std::endl;
+	if(!this->decompressMeta(block))      return false;
+	if(!this->decompressGenotypes(block)) return false;
+
+	for(U32 i = 0; i < block.footer.n_info_streams; ++i){
+		if(!this->decompressInfo(block, i))
 			return false;
-		}
 	}
 
+	for(U32 i = 0; i < block.footer.n_format_streams; ++i){
+		if(!this->decompressFormat(block, i))
+			return false;
+	}
+
+	return true;
+}
+
+bool CompressionManager::decompressMeta(variant_block_type& block){
 	if(block.meta_contig_container.getSizeCompressed())     if(!this->decompress(block.meta_contig_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta contig information!" << std::endl; return false; }
 	if(block.meta_positions_container.getSizeCompressed())  if(!this->decompress(block.meta_positions_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta positions information!" << std::endl; return false; }
 	if(block.meta_refalt_container.getSizeCompressed())     if(!this->decompress(block.meta_refalt_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta ref_alt information!" << std::endl; return false; }
 	if(block.meta_alleles_container.getSizeCompressed())    if(!this->decompress(block.meta_alleles_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta alleles information!" << std::endl; return false; }
 	if(block.meta_controller_container.getSizeCompressed()) if(!this->decompress(block.meta_controller_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta controller information!" << std::endl; return false; }
 	if(block.meta_quality_container.getSizeCompressed())    if(!this->decompress(block.meta_quality_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta quality information!" << std::endl; return false; }
-	if(block.gt_support_data_container.getSizeCompressed()) if(!this->decompress(block.gt_support_data_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotype support information!" << std::endl; return false; }
 	if(block.meta_info_map_ids.getSizeCompressed())         if(!this->decompress(block.meta_info_map_ids)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta INFO maps information!" << std::endl; return false; }
 	if(block.meta_names_container.getSizeCompressed())      if(!this->decompress(block.meta_names_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta names information!" << std::endl; return false; }
 	if(block.meta_filter_map_ids.getSizeCompressed())       if(!this->decompress(block.meta_filter_map_ids)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta FILTER maps information!" << std::endl; return false; }
 	if(block.meta_format_map_ids.getSizeCompressed())       if(!this->decompress(block.meta_format_map_ids)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress meta FORMAT maps information!" << std::endl; return false; }
+	return true;
+}
+
+bool CompressionManager::decompressGenotypes(variant_block_type& block){
+	if(block.ppa_manager.PPA.size()){
+		if(!this->decompress(block.ppa_manager)){
+			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress GT permutation information!" << std::endl;
+			return false;
+		}
+	}
+
+	if(block.gt_support_data_container.getSizeCompressed()) if(!this->decompress(block.gt_support_data_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotype support information!" << std::endl; return false; }
 	if(block.gt_rle8_container.getSizeCompressed())         if(!this->decompress(block.gt_rle8_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotypes (RLE-8) information!" << std::endl; return false; }
 	if(block.gt_rle16_container.getSizeCompressed())        if(!this->decompress(block.gt_rle16_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotypes (RLE-16) information!" << std::endl; return false; }
 	if(block.gt_rle32_container.getSizeCompressed())        if(!this->decompress(block.gt_rle32_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotypes (RLE-32) information!" << std::endl; return false; }
@@ -120,25 +163,26 @@ bool CompressionManager::decompress(variant_block_type& block){
 	if(block.gt_simple16_container.getSizeCompressed())     if(!this->decompress(block.gt_simple16_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotypes (simple-16) information!" << std::endl; return false; }
 	if(block.gt_simple32_container.getSizeCompressed())     if(!this->decompress(block.gt_simple32_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotypes (simple-32) information!" << std::endl; return false; }
 	if(block.gt_simple64_container.getSizeCompressed())     if(!this->decompress(block.gt_simple64_container)){ std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress genotypes (simple-64) information!" << std::endl; return false; }
+	return true;
+}
 
-	for(U32 i = 0; i < block.footer.n_info_streams; ++i){
-		if(block.info_containers[i].getSizeCompressed()){
-			if(!this->decompress(block.info_containers[i])){
-				std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress INFO container " << i << "/" << block.footer.n_info_streams << "!" << std::endl;
-				return false;
-			}
+bool CompressionManager::decompressInfo(variant_block_type& block, const U32 local_id){
+	if(block.info_containers[local_id].getSizeCompressed()){
+		if(!this->decompress(block.info_containers[local_id])){
+			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress INFO container " << local_id << "/" << block.footer.n_info_streams << "!" << std::endl;
+			return false;
 		}
 	}
+	return true;
+}
 
-	for(U32 i = 0; i < block.footer.n_format_streams; ++i){
-		if(block.format_containers[i].getSizeCompressed()){
-			if(!this->decompress(block.format_containers[i])){
-				std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress FORMAT container " << i << "/" << block.footer.n_format_streams << "!" << std::endl;
-				return false;
-			}
+bool CompressionManager::decompressFormat(variant_block_type& block, const U32 local_id){
+	if(block.format_containers[local_id].getSizeCompressed()){
+		if(!this->decompress(block.format_containers[local_id])){
+			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to decompress FORMAT container " << local_id << "/" << block.footer.n_format_streams << "!" << std::endl;
+			return false;
 		}
 	}
-
 	return true;
 }
 
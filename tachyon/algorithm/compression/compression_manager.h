@@ -1,14 +1,126 @@
 #ifndef ALGORITHM_COMPRESSION_COMPRESSION_MANAGER_H_
 #define ALGORITHM_COMPRESSION_COMPRESSION_MANAGER_H_
 
+#include <thread>
+#include <vector>
+
 #include "../../containers/variantblock.h"
 #include "uncompressed_codec.h"
 #include "zstd_codec.h"
 #include "zpaq_codec.h"
+#include "compression_policy.h"
+#include "../stage_profiler.h"
 
 namespace tachyon{
 namespace algorithm{
 
+/**<
+ * Unit of work for compressing a single data container
+ * with a given set of compression levels
+ */
+struct CompressionTask{
+	typedef containers::DataContainer container_type;
+
+	typedef struct ZSTD_CDict_s       ZSTD_CDict;
+
+	CompressionTask(container_type* container, const S32 level_data, const S32 level_strides, const TACHYON_POLICY_GROUP group, const U32 key, const ZSTD_CDict* dictionary = nullptr) :
+		level_data(level_data),
+		level_strides(level_strides),
+		group(group),
+		key(key),
+		dictionary(dictionary),
+		container(container)
+	{}
+
+	/**<
+	 * Add the measurements of compressing this task to its
+	 * field in the profiler
+	 * @param profiler Target profiler
+	 * @param timer    Timer started before compressing
+	 */
+	inline void addProfile(StageProfiler& profiler, const Timer& timer) const{
+		StageProfile* field = profiler.getField(this->group, this->key);
+		if(field != nullptr) field->add(timer, this->container->getObjectSizeUncompressed(), this->container->getObjectSize(), 1);
+	}
+
+	S32 level_data;
+	S32 level_strides;
+	TACHYON_POLICY_GROUP group; // field group used by the compression policy
+	U32 key;                    // field identifier used by the compression policy
+	const ZSTD_CDict* dictionary; // trained dictionary for this field or nullptr
+	container_type* container;
+};
+
+/**<
+ * Parallel support structure: this object encapsulates
+ * a thread that compresses data containers with a
+ * stride size of N_THREADS. Every slave owns its own
+ * compression context.
+ */
+struct CompressionSlave{
+	typedef CompressionSlave self_type;
+	typedef ZSTDCodec        zstd_codec_type;
+	typedef ZPAQContainer    zpaq_codec_type;
+	typedef CompressionTask  task_type;
+	typedef CompressionPolicy policy_type;
+
+	CompressionSlave() : thread_idx(0), n_threads(0), success(true), tasks(nullptr), policy(nullptr), profiler(nullptr){}
+	~CompressionSlave(){}
+
+	std::thread* Start(const U32 thread_idx, const U32 n_threads, std::vector<task_type>& tasks, policy_type& policy, StageProfiler* profiler){
+		this->thread_idx = thread_idx;
+		this->n_threads  = n_threads;
+		this->tasks      = &tasks;
+		this->policy     = &policy;
+		this->profiler   = profiler;
+		this->success    = true;
+
+		this->thread = std::thread(&self_type::Run_, this);
+		return(&this->thread);
+	}
+
+private:
+	void Run_(void){
+		Timer timer, task_timer;
+		if(this->profiler != nullptr) timer.Start();
+
+		for(U32 i = this->thread_idx; i < this->tasks->size(); i += this->n_threads){
+			const task_type& task = (*this->tasks)[i];
+			if(this->profiler != nullptr) task_timer.Start();
+
+			bool compressed = false;
+			if(task.dictionary != nullptr){
+				this->codec.setCompressionLevelData(task.level_data);
+				this->codec.setCompressionLevelStrides(task.level_strides);
+				compressed = this->codec.compress(*task.container, task.dictionary);
+			} else if(this->policy->isActive()){
+				compressed = this->policy->compress(*task.container, task.group, task.key, this->codec, this->zpaq_codec);
+			} else {
+				this->codec.setCompressionLevelData(task.level_data);
+				this->codec.setCompressionLevelStrides(task.level_strides);
+				compressed = this->codec.compress(*task.container);
+			}
+
+			if(!compressed) this->success = false;
+			if(this->profiler != nullptr) task.addProfile(*this->profiler, task_timer);
+		}
+
+		if(this->profiler != nullptr)
+			(*this->profiler)[YON_PROFILE_COMPRESS].addCPU(timer.ElapsedCPU());
+	}
+
+public:
+	U32 thread_idx;
+	U32 n_threads;
+	bool success;
+	std::vector<task_type>* tasks;
+	policy_type* policy;
+	StageProfiler* profiler;
+	zstd_codec_type codec;
+	zpaq_codec_type zpaq_codec;
+	std::thread thread;
+};
+
 class CompressionManager{
 private:
 	typedef CompressionManager        self_type;
@@ -17,13 +129,48 @@ private:
 	typedef ZPAQContainer             zpaq_codec_type;
 	typedef containers::VariantBlock  variant_block_type;
 	typedef containers::DataContainer container_type;
+	typedef CompressionTask           task_type;
+	typedef CompressionSlave          slave_type;
+	typedef CompressionPolicy         policy_type;
+	typedef ZSTDDictionaryManager     dictionary_manager_type;
 
 public:
 	CompressionManager();
 	~CompressionManager();
 
+	/**<
+	 * Set the number of threads used to compress the containers of
+	 * a block. Containers are compressed independently with their
+	 * own compression context so the output is identical to the
+	 * single-threaded path.
+	 * @param n_threads Number of threads
+	 */
+	void setThreads(const U32 n_threads);
+
+	/**<
+	 * Set a profiler receiving per-field compression times. Worker
+	 * threads add their CPU time to the compression stage.
+	 * @param profiler Target profiler or nullptr to disable profiling
+	 */
+	inline void setProfiler(StageProfiler* profiler){ this->profiler_ = profiler; }
+
 	bool compress(variant_block_type& block);
 	bool decompress(variant_block_type& block);
+
+	/**<
+	 * Decompress one group of containers of a block: used by blocks
+	 * that defer decompression until their data is first accessed.
+	 * The meta group covers every container read by `MetaContainer`
+	 * and the genotype group covers the permutation array and all
+	 * genotype streams.
+	 * @param block    Target block
+	 * @param local_id Local INFO or FORMAT stream
+	 * @return         Returns TRUE upon success or FALSE otherwise
+	 */
+	bool decompressMeta(variant_block_type& block);
+	bool decompressGenotypes(variant_block_type& block);
+	bool decompressInfo(variant_block_type& block, const U32 local_id);
+	bool decompressFormat(variant_block_type& block, const U32 local_id);
 	bool decompress(algorithm::PermutationManager& permutation_manager);
 
 	/**<
@@ -37,6 +184,13 @@ public:
 	no_codec_type   no_codec;
 	zstd_codec_type zstd_codec;
 	zpaq_codec_type zpaq_codec;
+	policy_type     policy;  // adaptive codec selection: inactive by default
+	dictionary_manager_type dictionaries; // trained per-field ZSTD dictionaries
+
+private:
+	U32         n_threads_;
+	slave_type* slaves_;
+	StageProfiler* profiler_;
 };
 
 }
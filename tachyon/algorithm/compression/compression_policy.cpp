@@ -0,0 +1,217 @@
+#include <stdexcept>
+
+#include "compression_policy.h"
+#include "../timer.h"
+
+namespace tachyon{
+namespace algorithm{
+
+CompressionPolicy::CompressionPolicy() :
+	objective_(YON_OBJECTIVE_FIXED),
+	n_sample_blocks_(3),
+	decode_budget_(500)
+{
+	this->candidates_.push_back(candidate_type(YON_ENCODE_NONE, 0));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZSTD, 1));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZSTD, 3));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZSTD, 7));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZSTD, 12));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZSTD, 20));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZPAQ, 1));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZPAQ, 2));
+	this->candidates_.push_back(candidate_type(YON_ENCODE_ZPAQ, 3));
+}
+
+CompressionPolicy::~CompressionPolicy(){}
+
+void CompressionPolicy::setFields(const U32 n_basic, const U32 n_info, const U32 n_format){
+	const U32 n_fields[3] = {n_basic, n_info, n_format};
+	for(U32 i = 0; i < 3; ++i){
+		this->fields_[i].resize(n_fields[i]);
+		for(U32 j = 0; j < n_fields[i]; ++j)
+			this->fields_[i][j].measurements.resize(this->candidates_.size());
+	}
+}
+
+bool CompressionPolicy::compressWith(container_type& container, const candidate_type& candidate, zstd_codec_type& zstd, zpaq_codec_type& zpaq){
+	bool success = false;
+	if(candidate.codec == YON_ENCODE_ZSTD){
+		zstd.setCompressionLevel(candidate.level);
+		success = zstd.compress(container);
+	} else if(candidate.codec == YON_ENCODE_ZPAQ){
+		success = zpaq.compress(container, std::to_string(candidate.level));
+	} else {
+		no_codec_type no_codec;
+		success = no_codec.compress(container);
+	}
+
+	// Not all codecs set the uncompressed lengths
+	container.header.data_header.uLength = container.buffer_data_uncompressed.size();
+	if(container.header.data_header.controller.mixedStride)
+		container.header.stride_header.uLength = container.buffer_strides_uncompressed.size();
+
+	return(success);
+}
+
+/**<
+ * Time the decoding of a compressed buffer into a scratch buffer.
+ * The codec calls are made directly as the container decompress
+ * functions would overwrite the uncompressed buffers.
+ * @return Returns TRUE upon success or FALSE if the data could not be decoded
+ */
+static bool timeDecode(const TACHYON_CORE_COMPRESSION codec, io::BasicBuffer& compressed, const U32 u_length, io::BasicBuffer& scratch, double& elapsed){
+	scratch.reset();
+	scratch.resize(u_length + 65536);
+
+	Timer timer;
+	timer.Start();
+	if(codec == YON_ENCODE_ZSTD){
+		const size_t ret = ZSTD_decompress(scratch.data(), scratch.capacity(), compressed.data(), compressed.size());
+		if(ZSTD_isError(ret)){
+			std::cerr << utility::timestamp("ERROR","POLICY") << "Failed to decode sample: " << ZSTD_getErrorString(ZSTD_getErrorCode(ret)) << std::endl;
+			return false;
+		}
+		if(ret != u_length){
+			std::cerr << utility::timestamp("ERROR","POLICY") << "Failed to decode sample: " << ret << "/" << u_length << " bytes..." << std::endl;
+			return false;
+		}
+	} else if(codec == YON_ENCODE_ZPAQ){
+		ZpaqWrapperIn  in(compressed);
+		ZpaqWrapperOut out(scratch);
+		try {
+			libzpaq::decompress(&in, &out);
+		} catch(const std::exception& e){
+			std::cerr << utility::timestamp("ERROR","POLICY") << "Failed to decode sample: " << e.what() << std::endl;
+			return false;
+		}
+		if(scratch.size() != u_length){
+			std::cerr << utility::timestamp("ERROR","POLICY") << "Failed to decode sample: " << scratch.size() << "/" << u_length << " bytes..." << std::endl;
+			return false;
+		}
+	} else {
+		memcpy(scratch.data(), compressed.data(), compressed.size());
+	}
+	elapsed = timer.Elapsed().count();
+	return true;
+}
+
+bool CompressionPolicy::sample(container_type& container, field_type& field, zstd_codec_type& zstd, zpaq_codec_type& zpaq){
+	buffer_type scratch;
+	const bool mixed = container.header.data_header.controller.mixedStride;
+
+	for(U32 i = 0; i < this->candidates_.size(); ++i){
+		if(!this->compressWith(container, this->candidates_[i], zstd, zpaq))
+			return false;
+
+		double elapsed = 0;
+		if(!timeDecode(static_cast<TACHYON_CORE_COMPRESSION>(container.header.data_header.controller.encoder), container.buffer_data, container.header.data_header.uLength, scratch, elapsed))
+			return false;
+
+		measurement_type& m = field.measurements[i];
+		m.u_length    += container.header.data_header.uLength;
+		m.c_length    += container.header.data_header.cLength;
+		m.decode_time += elapsed;
+		if(mixed){
+			if(!timeDecode(static_cast<TACHYON_CORE_COMPRESSION>(container.header.stride_header.controller.encoder), container.buffer_strides, container.header.stride_header.uLength, scratch, elapsed))
+				return false;
+
+			m.u_length    += container.header.stride_header.uLength;
+			m.c_length    += container.header.stride_header.cLength;
+			m.decode_time += elapsed;
+		}
+	}
+
+	++field.n_samples;
+	field.chosen = this->choose(field);
+	return(this->compressWith(container, this->candidates_[field.chosen], zstd, zpaq));
+}
+
+S32 CompressionPolicy::choose(const field_type& field) const{
+	S32 best = 0;
+	switch(this->objective_){
+	case(YON_OBJECTIVE_SIZE):
+		for(U32 i = 1; i < field.measurements.size(); ++i){
+			if(field.measurements[i].c_length < field.measurements[best].c_length)
+				best = i;
+		}
+		break;
+
+	case(YON_OBJECTIVE_DECODE):
+		// Fastest decode among candidates that compress: otherwise uncompressed
+		for(U32 i = 1; i < field.measurements.size(); ++i){
+			if(field.measurements[i].ratio() < MIN_COMPRESSION_FOLD) continue;
+			if(best == 0 || field.measurements[i].decodeSpeed() > field.measurements[best].decodeSpeed())
+				best = i;
+		}
+		break;
+
+	case(YON_OBJECTIVE_BUDGET):
+		{
+		// Smallest output among candidates that decode above the budget:
+		// otherwise the fastest decoding candidate
+		S32 fastest = 0;
+		best = -1;
+		for(U32 i = 0; i < field.measurements.size(); ++i){
+			if(field.measurements[i].decodeSpeed() > field.measurements[fastest].decodeSpeed())
+				fastest = i;
+
+			if(field.measurements[i].decodeSpeed() < this->decode_budget_) continue;
+			if(best == -1 || field.measurements[i].c_length < field.measurements[best].c_length)
+				best = i;
+		}
+		if(best == -1) best = fastest;
+		}
+		break;
+
+	default:
+		break;
+	}
+	return(best);
+}
+
+bool CompressionPolicy::compress(container_type& container, const TACHYON_POLICY_GROUP group, const U32 key, zstd_codec_type& zstd, zpaq_codec_type& zpaq){
+	field_type* field = this->getField(group, key);
+	if(field == nullptr){
+		std::cerr << utility::timestamp("ERROR","POLICY") << "Illegal field identifier: " << key << "..." << std::endl;
+		return false;
+	}
+
+	if(field->isLocked(this->n_sample_blocks_))
+		return(this->compressWith(container, this->candidates_[field->chosen], zstd, zpaq));
+
+	return(this->sample(container, *field, zstd, zpaq));
+}
+
+void CompressionPolicy::print(std::ostream& stream, const std::string& name, const TACHYON_POLICY_GROUP group, const U32 key) const{
+	const field_type* field = this->getField(group, key);
+	if(field == nullptr || field->n_samples == 0) return;
+
+	stream << "POLICY\t" << name << '\t' << this->candidates_[field->chosen].toString() << '\t' << field->n_samples;
+	for(U32 i = 0; i < field->measurements.size(); ++i){
+		stream << '\t' << this->candidates_[i].toString() << ':'
+		       << field->measurements[i].ratio() << ','
+		       << field->measurements[i].decodeSpeed();
+	}
+	stream << '\n';
+}
+
+bool CompressionPolicy::parseObjective(const std::string& string, TACHYON_COMPRESSION_OBJECTIVE& objective){
+	if(string == "fixed")       objective = YON_OBJECTIVE_FIXED;
+	else if(string == "size")   objective = YON_OBJECTIVE_SIZE;
+	else if(string == "decode") objective = YON_OBJECTIVE_DECODE;
+	else if(string == "budget") objective = YON_OBJECTIVE_BUDGET;
+	else return false;
+	return true;
+}
+
+std::string CompressionPolicy::objectiveString(const TACHYON_COMPRESSION_OBJECTIVE objective){
+	switch(objective){
+	case(YON_OBJECTIVE_SIZE):   return("size");
+	case(YON_OBJECTIVE_DECODE): return("decode");
+	case(YON_OBJECTIVE_BUDGET): return("budget");
+	default:                    return("fixed");
+	}
+}
+
+}
+}
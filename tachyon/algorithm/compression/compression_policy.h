@@ -0,0 +1,187 @@
+#ifndef ALGORITHM_COMPRESSION_COMPRESSION_POLICY_H_
+#define ALGORITHM_COMPRESSION_COMPRESSION_POLICY_H_
+
+#include <vector>
+
+#include "../../containers/variantblock.h"
+#include "uncompressed_codec.h"
+#include "zstd_codec.h"
+#include "zpaq_codec.h"
+
+namespace tachyon{
+namespace algorithm{
+
+/**<
+ * Objective used by the adaptive compression policy to
+ * select a codec for each field
+ */
+enum TACHYON_COMPRESSION_OBJECTIVE{
+	YON_OBJECTIVE_FIXED,  // default fixed codec levels: no sampling
+	YON_OBJECTIVE_SIZE,   // smallest output
+	YON_OBJECTIVE_DECODE, // fastest decode among candidates that compress
+	YON_OBJECTIVE_BUDGET  // smallest output with decode throughput above a budget
+};
+
+/**<
+ * Field groups tracked by the compression policy
+ */
+enum TACHYON_POLICY_GROUP{
+	YON_POLICY_BASIC,
+	YON_POLICY_INFO,
+	YON_POLICY_FORMAT
+};
+
+/**<
+ * A codec and compression level pair evaluated
+ * by the adaptive compression policy
+ */
+struct CompressionCandidate{
+	typedef CompressionCandidate self_type;
+
+	CompressionCandidate(const TACHYON_CORE_COMPRESSION codec, const S32 level) : codec(codec), level(level){}
+
+	std::string toString(void) const{
+		if(this->codec == YON_ENCODE_ZSTD) return("ZSTD-" + std::to_string(this->level));
+		if(this->codec == YON_ENCODE_ZPAQ) return("ZPAQ-" + std::to_string(this->level));
+		return("NONE");
+	}
+
+	TACHYON_CORE_COMPRESSION codec;
+	S32 level;
+};
+
+/**<
+ * Accumulated measurements for a candidate over
+ * all sampled blocks
+ */
+struct CompressionMeasurement{
+	typedef CompressionMeasurement self_type;
+
+	CompressionMeasurement() : u_length(0), c_length(0), decode_time(0){}
+
+	inline const double ratio(void) const{ return(this->c_length ? (double)this->u_length/this->c_length : 0); }
+	// Decode throughput in MB/s of uncompressed data
+	inline const double decodeSpeed(void) const{ return(this->decode_time > 0 ? this->u_length/this->decode_time/1e6 : 0); }
+
+	U64    u_length;
+	U64    c_length;
+	double decode_time; // seconds
+};
+
+/**<
+ * Per-field state of the adaptive compression policy
+ */
+struct CompressionFieldPolicy{
+	typedef CompressionFieldPolicy self_type;
+
+	CompressionFieldPolicy() : n_samples(0), chosen(-1){}
+
+	inline const bool isLocked(const U32 n_sample_blocks) const{ return(this->n_samples >= n_sample_blocks); }
+
+	U32 n_samples; // number of blocks sampled
+	S32 chosen;    // index of the chosen candidate
+	std::vector<CompressionMeasurement> measurements;
+};
+
+/**<
+ * Adaptive compression policy: for each field the first blocks
+ * are compressed with every candidate codec/level and the
+ * compressed size and decode speed is recorded. After a given
+ * number of sampled blocks the best candidate for the selected
+ * objective is locked in and used for the remaining blocks.
+ */
+class CompressionPolicy{
+private:
+	typedef CompressionPolicy         self_type;
+	typedef CompressionCandidate      candidate_type;
+	typedef CompressionMeasurement    measurement_type;
+	typedef CompressionFieldPolicy    field_type;
+	typedef containers::DataContainer container_type;
+	typedef UncompressedCodec         no_codec_type;
+	typedef ZSTDCodec                 zstd_codec_type;
+	typedef ZPAQContainer             zpaq_codec_type;
+	typedef io::BasicBuffer           buffer_type;
+
+public:
+	CompressionPolicy();
+	~CompressionPolicy();
+
+	inline void setObjective(const TACHYON_COMPRESSION_OBJECTIVE objective){ this->objective_ = objective; }
+	inline void setDecodeBudget(const double mb_per_second){ this->decode_budget_ = mb_per_second; }
+	inline void setSampleBlocks(const U32 n_blocks){ this->n_sample_blocks_ = n_blocks; }
+	inline const bool isActive(void) const{ return(this->objective_ != YON_OBJECTIVE_FIXED); }
+	inline const TACHYON_COMPRESSION_OBJECTIVE& getObjective(void) const{ return(this->objective_); }
+	inline const double& getDecodeBudget(void) const{ return(this->decode_budget_); }
+
+	/**<
+	 * Allocate policy state for every field. Has to be called
+	 * before compressing as the state is accessed concurrently
+	 * by compression threads.
+	 * @param n_basic  Number of basic fields
+	 * @param n_info   Number of INFO fields in the header
+	 * @param n_format Number of FORMAT fields in the header
+	 */
+	void setFields(const U32 n_basic, const U32 n_info, const U32 n_format);
+
+	/**<
+	 * Compress a data container using the policy for the target field.
+	 * Fields that have not been sampled enough are compressed with all
+	 * candidates first. It is safe to call this function concurrently
+	 * for different fields.
+	 * @param container Target data container
+	 * @param group     Field group
+	 * @param key       Field identifier in the group
+	 * @param zstd      ZSTD codec owned by the calling thread
+	 * @param zpaq      ZPAQ codec owned by the calling thread
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	bool compress(container_type& container, const TACHYON_POLICY_GROUP group, const U32 key, zstd_codec_type& zstd, zpaq_codec_type& zpaq);
+
+	/**<
+	 * Write the choice and measurements for a field as a tab-delimited line
+	 * @param stream Output stream
+	 * @param name   Name of the field
+	 * @param group  Field group
+	 * @param key    Field identifier in the group
+	 */
+	void print(std::ostream& stream, const std::string& name, const TACHYON_POLICY_GROUP group, const U32 key) const;
+
+	/**<
+	 * Parse an objective from its string representation: one of
+	 * "fixed", "size", "decode", or "budget"
+	 * @param string    Input string
+	 * @param objective Destination objective
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	static bool parseObjective(const std::string& string, TACHYON_COMPRESSION_OBJECTIVE& objective);
+	static std::string objectiveString(const TACHYON_COMPRESSION_OBJECTIVE objective);
+
+private:
+	inline field_type* getField(const TACHYON_POLICY_GROUP group, const U32 key){
+		std::vector<field_type>& fields = this->fields_[group];
+		if(key >= fields.size()) return(nullptr);
+		return(&fields[key]);
+	}
+
+	inline const field_type* getField(const TACHYON_POLICY_GROUP group, const U32 key) const{
+		const std::vector<field_type>& fields = this->fields_[group];
+		if(key >= fields.size()) return(nullptr);
+		return(&fields[key]);
+	}
+
+	bool compressWith(container_type& container, const candidate_type& candidate, zstd_codec_type& zstd, zpaq_codec_type& zpaq);
+	bool sample(container_type& container, field_type& field, zstd_codec_type& zstd, zpaq_codec_type& zpaq);
+	S32 choose(const field_type& field) const;
+
+private:
+	TACHYON_COMPRESSION_OBJECTIVE objective_;
+	U32    n_sample_blocks_;
+	double decode_budget_; // MB/s
+	std::vector<candidate_type> candidates_;
+	std::vector<field_type>     fields_[3];
+};
+
+}
+}
+
+#endif /* ALGORITHM_COMPRESSION_COMPRESSION_POLICY_H_ */
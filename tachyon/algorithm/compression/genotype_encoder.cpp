@@ -1,15 +1,25 @@
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "genotype_encoder.h"
 
 namespace tachyon{
 namespace algorithm{
 
 GenotypeEncoder::GenotypeEncoder() :
-	n_samples(0)
+	n_samples(0),
+	pbwt_(false),
+	bitplane_(false),
+	profiler_(nullptr)
 {
 }
 
 GenotypeEncoder::GenotypeEncoder(const U64 samples) :
-	n_samples(samples)
+	n_samples(samples),
+	pbwt_(false),
+	bitplane_(false),
+	profiler_(nullptr)
 {
 }
 
@@ -48,7 +58,20 @@ bool GenotypeEncoder::Encode(const bcf_type& bcf_entry,
 	// Assess cost and encode
 	rle_helper_type cost;
 	if(meta.controller.biallelic && meta.controller.diploid && meta.controller.mixed_ploidy == false){ // Case diploid and biallelic
-		cost = this->assessDiploidRLEBiallelic(bcf_entry, ppa);
+		cost = this->assessDiploidRLEBiallelic(bcf_entry, ppa, this->runs_);
+		const rle_runs_type& runs = this->runs_;
+
+		// Bit-planes are smaller than the runs
+		if(this->bitplane_ && this->assessDiploidBitplane(bcf_entry, cost)){
+			meta.controller.gt_compression_type = YON_GT_BITPLANE_DIPLOID_BIALLELIC;
+			meta.controller.gt_primtive_type    = YON_GT_U64;
+			block.gt_support_data_container.Add((U32)this->n_samples);
+			++block.gt_support_data_container;
+			this->EncodeDiploidBitplane(bcf_entry, block.gt_rle64_container, ppa);
+			++block.gt_rle64_container;
+			++this->stats_.bitplane_counts;
+			return true;
+		}
 
 		meta.controller.gt_compression_type = YON_GT_RLE_DIPLOID_BIALLELIC;
 		block.gt_support_data_container.Add((U32)cost.n_runs);
@@ -56,25 +79,25 @@ bool GenotypeEncoder::Encode(const bcf_type& bcf_entry,
 
 		switch(cost.word_width){
 		case 1:
-			this->EncodeDiploidRLEBiallelic<BYTE>(bcf_entry, block.gt_rle8_container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<BYTE>(runs, block.gt_rle8_container, cost);
 			meta.controller.gt_primtive_type = YON_GT_BYTE;
 			++block.gt_rle8_container;
 			++this->stats_.rle_counts[0];
 			break;
 		case 2:
-			this->EncodeDiploidRLEBiallelic<U16>(bcf_entry, block.gt_rle16_container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<U16>(runs, block.gt_rle16_container, cost);
 			meta.controller.gt_primtive_type = YON_GT_U16;
 			++block.gt_rle16_container;
 			++this->stats_.rle_counts[1];
 			break;
 		case 4:
-			this->EncodeDiploidRLEBiallelic<U32>(bcf_entry, block.gt_rle32_container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<U32>(runs, block.gt_rle32_container, cost);
 			meta.controller.gt_primtive_type = YON_GT_U32;
 			++block.gt_rle32_container;
 			++this->stats_.rle_counts[2];
 			break;
 		case 8:
-			this->EncodeDiploidRLEBiallelic<U64>(bcf_entry, block.gt_rle64_container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<U64>(runs, block.gt_rle64_container, cost);
 			meta.controller.gt_primtive_type = YON_GT_U64;
 			++block.gt_rle64_container;
 			++this->stats_.rle_counts[3];
@@ -95,8 +118,9 @@ bool GenotypeEncoder::Encode(const bcf_type& bcf_entry,
 		else if(bcf_entry.body->n_allele + 1 < 128)   costBCFStyle *= sizeof(S16);
 		else if(bcf_entry.body->n_allele + 1 < 32768) costBCFStyle *= sizeof(S32);
 
-		// RLE is cheaper
-		if(cost.word_width * cost.n_runs < costBCFStyle){
+		// RLE is cheaper or the variant has EOV values that
+		// the BCF-style encoding cannot represent
+		if(cost.word_width * cost.n_runs < costBCFStyle || bcf_entry.gt_support.hasEOV){
 			meta.controller.gt_compression_type = YON_GT_RLE_DIPLOID_NALLELIC;
 			block.gt_support_data_container.Add((U32)cost.n_runs);
 			++block.gt_support_data_container;
@@ -169,9 +193,76 @@ bool GenotypeEncoder::Encode(const bcf_type& bcf_entry,
 			return true;
 		}
 	}
-	// temp
-	else {
-		std::cerr << "other bcf style: n_alleles: " << bcf_entry.body->n_allele << ",ploidy: " << bcf_entry.gt_support.ploidy << std::endl;
+	else { // Case haploid or polyploid
+		const bool biallelic = meta.controller.biallelic && bcf_entry.gt_support.hasEOV == false;
+		if(biallelic) cost = this->assessMploidRLEBiallelic(bcf_entry, ppa);
+		else          cost = this->assessMploidRLEnAllelic(bcf_entry, ppa);
+
+		// RLE is possible and cheaper
+		if(cost.word_width){
+			meta.controller.gt_compression_type = biallelic ? YON_GT_RLE_MPLOID_BIALLELIC : YON_GT_RLE_MPLOID_NALLELIC;
+			block.gt_support_data_container.Add((U32)cost.n_runs);
+			++block.gt_support_data_container;
+
+			U64 n_runs = 0;
+			switch(cost.word_width){
+			case 1:
+				meta.controller.gt_primtive_type = YON_GT_BYTE;
+				if(biallelic){
+					this->EncodeMploidRLEBiallelic<BYTE>(bcf_entry, block.gt_rle8_container, n_runs, ppa);
+					++block.gt_rle8_container;
+					++this->stats_.mploid_rle_counts[0];
+				} else {
+					this->EncodeMploidRLENallelic<BYTE>(bcf_entry, block.gt_simple8_container, n_runs, ppa);
+					++block.gt_simple8_container;
+					++this->stats_.mploid_simple_counts[0];
+				}
+				break;
+			case 2:
+				meta.controller.gt_primtive_type = YON_GT_U16;
+				if(biallelic){
+					this->EncodeMploidRLEBiallelic<U16>(bcf_entry, block.gt_rle16_container, n_runs, ppa);
+					++block.gt_rle16_container;
+					++this->stats_.mploid_rle_counts[1];
+				} else {
+					this->EncodeMploidRLENallelic<U16>(bcf_entry, block.gt_simple16_container, n_runs, ppa);
+					++block.gt_simple16_container;
+					++this->stats_.mploid_simple_counts[1];
+				}
+				break;
+			case 4:
+				meta.controller.gt_primtive_type = YON_GT_U32;
+				if(biallelic){
+					this->EncodeMploidRLEBiallelic<U32>(bcf_entry, block.gt_rle32_container, n_runs, ppa);
+					++block.gt_rle32_container;
+					++this->stats_.mploid_rle_counts[2];
+				} else {
+					this->EncodeMploidRLENallelic<U32>(bcf_entry, block.gt_simple32_container, n_runs, ppa);
+					++block.gt_simple32_container;
+					++this->stats_.mploid_simple_counts[2];
+				}
+				break;
+			case 8:
+				meta.controller.gt_primtive_type = YON_GT_U64;
+				if(biallelic){
+					this->EncodeMploidRLEBiallelic<U64>(bcf_entry, block.gt_rle64_container, n_runs, ppa);
+					++block.gt_rle64_container;
+					++this->stats_.mploid_rle_counts[3];
+				} else {
+					this->EncodeMploidRLENallelic<U64>(bcf_entry, block.gt_simple64_container, n_runs, ppa);
+					++block.gt_simple64_container;
+					++this->stats_.mploid_simple_counts[3];
+				}
+				break;
+			default:
+				std::cerr << utility::timestamp("ERROR","ENCODER") << "Illegal word width (" << (int)cost.word_width << ")... " << std::endl;
+				return false;
+			}
+			assert(n_runs == cost.n_runs);
+			return true;
+		}
+
+		// Otherwise fall back to BCF-style encoding
 		meta.controller.gt_compression_type = YON_GT_BCF_STYLE;
 		block.gt_support_data_container.Add((U32)this->n_samples*bcf_entry.gt_support.ploidy);
 		++block.gt_support_data_container;
@@ -218,6 +309,19 @@ bool GenotypeEncoder::EncodeParallel(const bcf_reader_type& bcf_reader,
 	std::vector<std::thread*> threads(n_threads);
 	for(U32 i = 0; i < n_threads; ++i) threads[i] = slaves[i].Start(*this, i, n_threads, bcf_reader, meta_entries, ppa, helpers);
 	for(U32 i = 0; i < n_threads; ++i) threads[i]->join();
+	if(this->profiler_ != nullptr){
+		for(U32 i = 0; i < n_threads; ++i) (*this->profiler_)[YON_PROFILE_GT_ENCODE].addCPU(slaves[i].cpu_time);
+	}
+
+	// Variants in PBWT order depend on the previous variants
+	// and are encoded serially afterwards
+	if(this->pbwt_){
+		Timer timer;
+		timer.Start();
+		this->EncodeDiploidPBWT(bcf_reader, meta_entries, ppa, helpers);
+		if(this->profiler_ != nullptr) (*this->profiler_)[YON_PROFILE_GT_ENCODE].addCPU(timer.ElapsedCPU());
+	}
+
 	for(U32 i = 0; i < bcf_reader.size(); ++i) {
 		block += helpers[i];
 		this->updateStatistics(helpers[i]);
@@ -269,7 +373,25 @@ bool GenotypeEncoder::EncodeParallel(const bcf_type& bcf_entry,
 	// Assess cost and encode
 	rle_helper_type cost;
 	if(meta.controller.biallelic && meta.controller.diploid && meta.controller.mixed_ploidy == false){ // Case diploid and biallelic
-		cost = this->assessDiploidRLEBiallelic(bcf_entry, ppa);
+		// Deferred to EncodeDiploidPBWT
+		if(this->pbwt_){
+			slave.encoding_type = YON_GT_RLE_DIPLOID_BIALLELIC_PBWT;
+			meta.controller.gt_compression_type = YON_GT_RLE_DIPLOID_BIALLELIC_PBWT;
+			return true;
+		}
+
+		rle_runs_type runs;
+		cost = this->assessDiploidRLEBiallelic(bcf_entry, ppa, runs);
+
+		// Bit-planes are smaller than the runs
+		if(this->bitplane_ && this->assessDiploidBitplane(bcf_entry, cost)){
+			slave.encoding_type = YON_GT_BITPLANE_DIPLOID_BIALLELIC;
+			slave.gt_primitive  = YON_GT_U64;
+			slave.n_runs        = this->n_samples;
+			meta.controller.gt_compression_type = YON_GT_BITPLANE_DIPLOID_BIALLELIC;
+			meta.controller.gt_primtive_type    = YON_GT_U64;
+			return(this->EncodeDiploidBitplane(bcf_entry, slave.container, ppa));
+		}
 
 		slave.encoding_type = YON_GT_RLE_DIPLOID_BIALLELIC;
 		slave.n_runs = cost.n_runs;
@@ -280,28 +402,28 @@ bool GenotypeEncoder::EncodeParallel(const bcf_type& bcf_entry,
 
 		switch(cost.word_width){
 		case 1:
-			this->EncodeDiploidRLEBiallelic<BYTE>(bcf_entry, slave.container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<BYTE>(runs, slave.container, cost);
 			meta.controller.gt_primtive_type = YON_GT_BYTE;
 			slave.gt_primitive = YON_GT_BYTE;
 			//++block.gt_rle8_container;
 			//++this->stats_.rle_counts[0];
 			break;
 		case 2:
-			this->EncodeDiploidRLEBiallelic<U16>(bcf_entry, slave.container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<U16>(runs, slave.container, cost);
 			meta.controller.gt_primtive_type = YON_GT_U16;
 			slave.gt_primitive = YON_GT_U16;
 			//++block.gt_rle16_container;
 			//++this->stats_.rle_counts[1];
 			break;
 		case 4:
-			this->EncodeDiploidRLEBiallelic<U32>(bcf_entry, slave.container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<U32>(runs, slave.container, cost);
 			meta.controller.gt_primtive_type = YON_GT_U32;
 			slave.gt_primitive = YON_GT_U32;
 			//++block.gt_rle32_container;
 			//++this->stats_.rle_counts[2];
 			break;
 		case 8:
-			this->EncodeDiploidRLEBiallelic<U64>(bcf_entry, slave.container, ppa, cost);
+			this->EncodeDiploidRLEBiallelic<U64>(runs, slave.container, cost);
 			meta.controller.gt_primtive_type = YON_GT_U64;
 			slave.gt_primitive = YON_GT_U64;
 			//++block.gt_rle64_container;
@@ -323,8 +445,9 @@ bool GenotypeEncoder::EncodeParallel(const bcf_type& bcf_entry,
 		else if(bcf_entry.body->n_allele + 1 < 128)   costBCFStyle *= sizeof(S16);
 		else if(bcf_entry.body->n_allele + 1 < 32768) costBCFStyle *= sizeof(S32);
 
-		// RLE is cheaper
-		if(cost.word_width * cost.n_runs < costBCFStyle){
+		// RLE is cheaper or the variant has EOV values that
+		// the BCF-style encoding cannot represent
+		if(cost.word_width * cost.n_runs < costBCFStyle || bcf_entry.gt_support.hasEOV){
 			meta.controller.gt_compression_type = YON_GT_RLE_DIPLOID_NALLELIC;
 			//block.gt_support_data_container.Add((U32)cost.n_runs);
 
@@ -412,8 +535,49 @@ bool GenotypeEncoder::EncodeParallel(const bcf_type& bcf_entry,
 			return true;
 		}
 	}
-	else {
-		std::cerr << "other bcf style: n_alleles: " << bcf_entry.body->n_allele << ",ploidy: " << bcf_entry.gt_support.ploidy << std::endl;
+	else { // Case haploid or polyploid
+		const bool biallelic = meta.controller.biallelic && bcf_entry.gt_support.hasEOV == false;
+		if(biallelic) cost = this->assessMploidRLEBiallelic(bcf_entry, ppa);
+		else          cost = this->assessMploidRLEnAllelic(bcf_entry, ppa);
+
+		// RLE is possible and cheaper
+		if(cost.word_width){
+			slave.encoding_type = biallelic ? YON_GT_RLE_MPLOID_BIALLELIC : YON_GT_RLE_MPLOID_NALLELIC;
+			slave.n_runs = cost.n_runs;
+			meta.controller.gt_compression_type = slave.encoding_type;
+
+			U64 n_runs = 0;
+			switch(cost.word_width){
+			case 1:
+				slave.gt_primitive = YON_GT_BYTE;
+				if(biallelic) this->EncodeMploidRLEBiallelic<BYTE>(bcf_entry, slave.container, n_runs, ppa);
+				else          this->EncodeMploidRLENallelic<BYTE>(bcf_entry, slave.container, n_runs, ppa);
+				break;
+			case 2:
+				slave.gt_primitive = YON_GT_U16;
+				if(biallelic) this->EncodeMploidRLEBiallelic<U16>(bcf_entry, slave.container, n_runs, ppa);
+				else          this->EncodeMploidRLENallelic<U16>(bcf_entry, slave.container, n_runs, ppa);
+				break;
+			case 4:
+				slave.gt_primitive = YON_GT_U32;
+				if(biallelic) this->EncodeMploidRLEBiallelic<U32>(bcf_entry, slave.container, n_runs, ppa);
+				else          this->EncodeMploidRLENallelic<U32>(bcf_entry, slave.container, n_runs, ppa);
+				break;
+			case 8:
+				slave.gt_primitive = YON_GT_U64;
+				if(biallelic) this->EncodeMploidRLEBiallelic<U64>(bcf_entry, slave.container, n_runs, ppa);
+				else          this->EncodeMploidRLENallelic<U64>(bcf_entry, slave.container, n_runs, ppa);
+				break;
+			default:
+				std::cerr << utility::timestamp("ERROR","ENCODER") << "Illegal word width (" << (int)cost.word_width << ")... " << std::endl;
+				return false;
+			}
+			meta.controller.gt_primtive_type = slave.gt_primitive;
+			assert(n_runs == cost.n_runs);
+			return true;
+		}
+
+		// Otherwise fall back to BCF-style encoding
 		meta.controller.gt_compression_type = YON_GT_BCF_STYLE;
 		//block.gt_support_data_container.Add((U32)this->n_samples*bcf_entry.gt_support.ploidy);
 
@@ -456,72 +620,75 @@ bool GenotypeEncoder::EncodeParallel(const bcf_type& bcf_entry,
 	return false;
 }
 
-const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEBiallelic(const bcf_type& bcf_entry, const U32* const ppa) const{
+const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEBiallelic(const bcf_type& bcf_entry, const U32* const ppa, rle_runs_type& runs) const{
 	// Setup
 	const BYTE ploidy = 2;
-	const BYTE shift    = bcf_entry.gt_support.hasMissing    ? 2 : 1;
-	const BYTE add      = bcf_entry.gt_support.mixedPhasing  ? 1 : 0;
-	U32 n_runs_byte = 0; U32 run_length_byte = 1;
-	U32 n_runs_u16  = 0; U32 run_length_u16  = 1;
-	U32 n_runs_u32  = 0; U32 run_length_u32  = 1;
-	U64 n_runs_u64  = 0; U64 run_length_u64  = 1;
-
-	// Run limits
-	const BYTE BYTE_limit = pow(2, 8*sizeof(BYTE) - (ploidy*shift + add)) - 1;
-	const U16  U16_limit  = pow(2, 8*sizeof(U16)  - (ploidy*shift + add)) - 1;
-	const U32  U32_limit  = pow(2, 8*sizeof(U32)  - (ploidy*shift + add)) - 1;
-	const U64  U64_limit  = pow(2, 8*sizeof(U64)  - (ploidy*shift + add)) - 1;
-
-	// First ref
-	const char* const data = &bcf_entry.data[bcf_entry.formatID[0].l_offset];
-	const BYTE& allele1_2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[0]]);
-	const BYTE& allele2_2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[0] + sizeof(BYTE)]);
-	U32 ref = YON_PACK_GT_DIPLOID(allele2_2, allele1_2, shift, add);
-
-	// Cycle over GT values
-	U32 ppa_pos = 1;
-	for(U32 i = ploidy; i < this->n_samples * ploidy; i += ploidy){
-		const BYTE& allele1 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[ppa_pos]]);
-		const BYTE& allele2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[ppa_pos] + sizeof(BYTE)]);
-		U32 internal = YON_PACK_GT_DIPLOID(allele2, allele1, shift, add);
+	const BYTE shift  = bcf_entry.gt_support.hasMissing    ? 2 : 1;
+	const BYTE add    = bcf_entry.gt_support.mixedPhasing  ? 1 : 0;
+	runs.bits = ploidy*shift + add;
+	runs.packed.resize(this->n_samples);
+	runs.values.clear();
+	runs.lengths.clear();
+
+	// Gather the packed genotypes in the order of the permutation
+	const BYTE* const data = reinterpret_cast<const BYTE* const>(&bcf_entry.data[bcf_entry.formatID[0].l_offset]);
+	BYTE* const packed = &runs.packed[0];
+	for(U32 i = 0; i < this->n_samples; ++i){
+		const BYTE* const alleles = &data[ploidy*ppa[i]];
+		packed[i] = YON_PACK_GT_DIPLOID(alleles[1], alleles[0], shift, add);
+	}
 
-		// Extend or break run
-		if(ref != internal){
-			++n_runs_byte; run_length_byte = 0;
-			++n_runs_u16;  run_length_u16  = 0;
-			++n_runs_u32;  run_length_u32  = 0;
-			++n_runs_u64;  run_length_u64  = 0;
-			ref = internal;
+	// Find the maximal runs: a run ends wherever a packed genotype
+	// differs from the preceding one
+	U32 run_start = 0;
+	U32 i = 1;
+#if defined(__SSE2__)
+	for(; i + 16 <= this->n_samples; i += 16){
+		const __m128i current  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&packed[i]));
+		const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&packed[i - 1]));
+		U32 breaks = ~_mm_movemask_epi8(_mm_cmpeq_epi8(current, previous)) & 0xFFFF;
+		while(breaks){
+			const U32 end = i + __builtin_ctz(breaks);
+			runs.values.push_back(packed[run_start]);
+			runs.lengths.push_back(end - run_start);
+			run_start = end;
+			breaks &= breaks - 1;
 		}
-
-		// Overflow: trigger a break
-		if(run_length_byte == BYTE_limit){ ++n_runs_byte; run_length_byte = 0; }
-		if(run_length_u16  == U16_limit) { ++n_runs_u16;  run_length_u16  = 0; }
-		if(run_length_u32  == U32_limit) { ++n_runs_u32;  run_length_u32  = 0; }
-		if(run_length_u64  == U64_limit) { ++n_runs_u64;  run_length_u64  = 0; }
-
-		// Update all counts
-		++run_length_byte;
-		++run_length_u16;
-		++run_length_u32;
-		++run_length_u64;
-		++ppa_pos;
 	}
-	// Final runs
-	++n_runs_byte;
-	++n_runs_u16;
-	++n_runs_u32;
-	++n_runs_u64;
+#endif
+	for(; i < this->n_samples; ++i){
+		if(packed[i] != packed[i - 1]){
+			runs.values.push_back(packed[run_start]);
+			runs.lengths.push_back(i - run_start);
+			run_start = i;
+		}
+	}
+	// Final run
+	runs.values.push_back(packed[run_start]);
+	runs.lengths.push_back(this->n_samples - run_start);
+
+	// Maximal runs are split into ceil(length/limit) runs of a word
+	const U64 BYTE_limit = ((U64)1 << (8*sizeof(BYTE) - runs.bits)) - 1;
+	const U64 U16_limit  = ((U64)1 << (8*sizeof(U16)  - runs.bits)) - 1;
+	const U64 U32_limit  = ((U64)1 << (8*sizeof(U32)  - runs.bits)) - 1;
+	U64 n_runs_byte = 0;
+	U64 n_runs_u16  = 0;
+	U64 n_runs_u32  = 0;
+	const U64 n_runs_u64 = runs.lengths.size();
+	for(U32 j = 0; j < runs.lengths.size(); ++j){
+		n_runs_byte += (runs.lengths[j] + BYTE_limit - 1) / BYTE_limit;
+		n_runs_u16  += (runs.lengths[j] + U16_limit  - 1) / U16_limit;
+		n_runs_u32  += (runs.lengths[j] + U32_limit  - 1) / U32_limit;
+	}
 
 	// Determine best action
-	U32 smallest_cost = n_runs_byte*sizeof(BYTE);
+	U64 smallest_cost = n_runs_byte*sizeof(BYTE);
 	U64 chosen_runs = n_runs_byte;
 	BYTE word_width = sizeof(BYTE);
 	if(n_runs_u16*sizeof(U16) < smallest_cost){ smallest_cost = n_runs_u16*sizeof(U16); word_width = sizeof(U16); chosen_runs = n_runs_u16; }
 	if(n_runs_u32*sizeof(U32) < smallest_cost){ smallest_cost = n_runs_u32*sizeof(U32); word_width = sizeof(U32); chosen_runs = n_runs_u32; }
 	if(n_runs_u64*sizeof(U64) < smallest_cost){ smallest_cost = n_runs_u64*sizeof(U64); word_width = sizeof(U64); chosen_runs = n_runs_u64; }
 
-	assert(ppa_pos == n_samples);
 	return(rle_helper_type(word_width, chosen_runs));
 }
 
@@ -557,7 +724,7 @@ const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEnAllelic
 		allele1 = 0;
 	}
 	else if(allele1 == 0x81){
-		allele1 = 1;
+		allele1 = 1 << 1; // EOV is packed as 1
 		//std::cerr << "eov" << std::endl;
 	} else {
 		// Add 1 to value
@@ -568,7 +735,7 @@ const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEnAllelic
 		allele2 = 0;
 	}
 	else if(allele2 == 0x81){
-		allele2 = 1;
+		allele2 = 1 << 1; // EOV is packed as 1
 		//std::cerr << "eov" << std::endl;
 	} else {
 		allele2 = (((allele2 >> 1) + bcf_entry.gt_support.hasEOV) << 1) | (allele2 & 1);
@@ -583,7 +750,7 @@ const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEnAllelic
 			allele1 = 0;
 		}
 		else if(allele1 == 0x81){
-			allele1 = 1;
+			allele1 = 1 << 1; // EOV is packed as 1
 			//std::cerr << "eov" << std::endl;
 		} else {
 			// Add 1 to value
@@ -594,7 +761,7 @@ const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEnAllelic
 			allele2 = 0;
 		}
 		else if(allele2 == 0x81){
-			allele2 = 1;
+			allele2 = 1 << 1; // EOV is packed as 1
 			//std::cerr << "eov" << std::endl;
 		} else {
 			allele2 = (((allele2 >> 1) + bcf_entry.gt_support.hasEOV) << 1) | (allele2 & 1);
@@ -641,6 +808,248 @@ const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessDiploidRLEnAllelic
 	return(rle_helper_type(word_width, chosen_runs));
 }
 
+const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessMploidRLEBiallelic(const bcf_type& bcf_entry, const U32* const ppa) const{
+	return(this->assessMploidRLE(bcf_entry, ppa, true));
+}
+
+const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessMploidRLEnAllelic(const bcf_type& bcf_entry, const U32* const ppa) const{
+	return(this->assessMploidRLE(bcf_entry, ppa, false));
+}
+
+const GenotypeEncoder::rle_helper_type GenotypeEncoder::assessMploidRLE(const bcf_type& bcf_entry, const U32* const ppa, const bool biallelic) const{
+	// Todo: other primitives
+	if(bcf_entry.formatID[0].primitive_type != bcf::YON_BCF_PRIMITIVE_TYPES::BCF_BYTE)
+		return(rle_helper_type(0, 0));
+
+	const BYTE ploidy = bcf_entry.gt_support.ploidy;
+	const BYTE shift  = biallelic ? (bcf_entry.gt_support.hasMissing ? 2 : 1)
+	                              : ceil(log2(bcf_entry.body->n_allele + bcf_entry.gt_support.hasMissing + bcf_entry.gt_support.hasEOV + 1));
+	const BYTE add    = bcf_entry.gt_support.mixedPhasing ? 1 : 0;
+	const U32  bits   = ploidy*shift + add;
+
+	// Word widths that can hold the packed genotypes and
+	// their run limits
+	const BYTE word_widths[4] = {sizeof(BYTE), sizeof(U16), sizeof(U32), sizeof(U64)};
+	U64 limits[4];
+	U64 n_runs[4];
+	U64 run_lengths[4];
+	for(U32 w = 0; w < 4; ++w){
+		limits[w]      = bits < 8*word_widths[w] ? ((U64)1 << (8*word_widths[w] - bits)) - 1 : 0;
+		n_runs[w]      = 0;
+		run_lengths[w] = 1;
+	}
+
+	const BYTE* const data = reinterpret_cast<const BYTE*>(&bcf_entry.data[bcf_entry.formatID[0].l_offset]);
+	U64 ref = 0;
+	if(this->packMploid(&data[ploidy*ppa[0]], bcf_entry, shift, add, biallelic, ref) == false)
+		return(rle_helper_type(0, 0));
+
+	for(U32 i = 1; i < this->n_samples; ++i){
+		U64 internal = 0;
+		if(this->packMploid(&data[ploidy*ppa[i]], bcf_entry, shift, add, biallelic, internal) == false)
+			return(rle_helper_type(0, 0));
+
+		// Extend or break run
+		if(ref != internal){
+			for(U32 w = 0; w < 4; ++w){ ++n_runs[w]; run_lengths[w] = 0; }
+			ref = internal;
+		}
+
+		// Overflow: trigger a break
+		for(U32 w = 0; w < 4; ++w){
+			if(run_lengths[w] == limits[w]){ ++n_runs[w]; run_lengths[w] = 0; }
+			++run_lengths[w];
+		}
+	}
+	// Final runs
+	for(U32 w = 0; w < 4; ++w) ++n_runs[w];
+
+	// BCF-style cost
+	U64 smallest_cost = this->n_samples * ploidy;
+	if(bcf_entry.body->n_allele + 1 >= 128)    smallest_cost *= sizeof(S32);
+	else if(bcf_entry.body->n_allele + 1 >= 8) smallest_cost *= sizeof(S16);
+
+	// Determine best action: the ploidy is stored
+	// as an additional word
+	rle_helper_type helper(0, 0);
+	for(U32 w = 0; w < 4; ++w){
+		if(limits[w] == 0) continue;
+		if((n_runs[w] + 1) * word_widths[w] < smallest_cost){
+			smallest_cost     = (n_runs[w] + 1) * word_widths[w];
+			helper.word_width = word_widths[w];
+			helper.n_runs     = n_runs[w];
+		}
+	}
+	return(helper);
+}
+
+bool GenotypeEncoder::packMploid(const BYTE* const alleles,
+                                 const bcf_type&   bcf_entry,
+                                 const BYTE        shift,
+                                 const BYTE        add,
+                                 const bool        biallelic,
+                                 U64&              packed) const
+{
+	const BYTE ploidy = bcf_entry.gt_support.ploidy;
+	BYTE phase = 2; // unset
+
+	packed = 0;
+	for(U32 p = 0; p < ploidy; ++p){
+		U64 allele = 0;
+		if(alleles[p] == 0x81) allele = 1; // EOV
+		else {
+			if(biallelic)                   allele = bcf::BCF_UNPACK_GENOTYPE(alleles[p]);
+			else if((alleles[p] >> 1) == 0) allele = 0; // missing
+			else                            allele = (alleles[p] >> 1) + bcf_entry.gt_support.hasEOV;
+
+			// The phasing of all alleles but the first
+			// has to be identical
+			if(p != 0){
+				if(phase != 2 && phase != (alleles[p] & 1)) return false;
+				phase = alleles[p] & 1;
+			}
+		}
+		packed |= allele << (add + p*shift);
+	}
+
+	// Samples without phased alleles, such as haploid samples,
+	// are stored as unphased
+	if(add) packed |= (phase == 2 ? 0 : phase);
+	else if(phase != 2 && phase != bcf_entry.gt_support.phase) return false;
+
+	return true;
+}
+
+bool GenotypeEncoder::EncodeDiploidPBWT(const bcf_reader_type& bcf_reader,
+		                                           meta_type* meta_entries,
+		                                    const U32* const  ppa,
+		                          GenotypeEncoderSlaveHelper* helpers) const
+{
+	// The first variant is encoded in the order of the block
+	// permutation
+	std::vector<U32> order(ppa, ppa + this->n_samples);
+	std::vector<U32> sorted(this->n_samples);
+	rle_runs_type runs;
+
+	for(U32 i = 0; i < bcf_reader.size(); ++i){
+		if(helpers[i].encoding_type != YON_GT_RLE_DIPLOID_BIALLELIC_PBWT)
+			continue;
+
+		const bcf_type& bcf_entry = bcf_reader[i];
+		meta_type& meta = meta_entries[i];
+		GenotypeEncoderSlaveHelper& slave = helpers[i];
+
+		const rle_helper_type cost = this->assessDiploidRLEBiallelic(bcf_entry, &order[0], runs);
+		slave.n_runs = cost.n_runs;
+
+		switch(cost.word_width){
+		case 1:
+			this->EncodeDiploidRLEBiallelic<BYTE>(runs, slave.container, cost);
+			meta.controller.gt_primtive_type = YON_GT_BYTE;
+			slave.gt_primitive = YON_GT_BYTE;
+			break;
+		case 2:
+			this->EncodeDiploidRLEBiallelic<U16>(runs, slave.container, cost);
+			meta.controller.gt_primtive_type = YON_GT_U16;
+			slave.gt_primitive = YON_GT_U16;
+			break;
+		case 4:
+			this->EncodeDiploidRLEBiallelic<U32>(runs, slave.container, cost);
+			meta.controller.gt_primtive_type = YON_GT_U32;
+			slave.gt_primitive = YON_GT_U32;
+			break;
+		case 8:
+			this->EncodeDiploidRLEBiallelic<U64>(runs, slave.container, cost);
+			meta.controller.gt_primtive_type = YON_GT_U64;
+			slave.gt_primitive = YON_GT_U64;
+			break;
+		default:
+			std::cerr << utility::timestamp("ERROR","ENCODER") << "Illegal word width (" << (int)cost.word_width << ")... " << std::endl;
+			return false;
+		}
+
+		this->updatePBWTOrder(bcf_entry, order, sorted);
+	}
+
+	return true;
+}
+
+void GenotypeEncoder::updatePBWTOrder(const bcf_type& bcf_entry, std::vector<U32>& order, std::vector<U32>& sorted) const{
+	const BYTE ploidy = 2;
+	const BYTE shift  = bcf_entry.gt_support.hasMissing    ? 2 : 1;
+	const BYTE add    = bcf_entry.gt_support.mixedPhasing  ? 1 : 0;
+	const char* const data = &bcf_entry.data[bcf_entry.formatID[0].l_offset];
+
+	// Counting sort on the packed genotypes: at most 2^5 values
+	U32 offsets[32 + 1];
+	memset(offsets, 0, sizeof(U32)*(32 + 1));
+	for(U32 i = 0; i < this->n_samples; ++i){
+		const BYTE& allele1 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*order[i]]);
+		const BYTE& allele2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*order[i] + sizeof(BYTE)]);
+		++offsets[(YON_PACK_GT_DIPLOID(allele2, allele1, shift, add)) + 1];
+	}
+
+	for(U32 i = 1; i <= 32; ++i) offsets[i] += offsets[i - 1];
+
+	for(U32 i = 0; i < this->n_samples; ++i){
+		const BYTE& allele1 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*order[i]]);
+		const BYTE& allele2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*order[i] + sizeof(BYTE)]);
+		sorted[offsets[YON_PACK_GT_DIPLOID(allele2, allele1, shift, add)]++] = order[i];
+	}
+
+	order.swap(sorted);
+}
+
+bool GenotypeEncoder::assessDiploidBitplane(const bcf_type& bcf_entry, const rle_helper_type& rle_cost) const{
+	// Bit-planes cannot store per-sample phasing
+	if(bcf_entry.gt_support.mixedPhasing) return false;
+
+	const BYTE n_planes = bcf_entry.gt_support.hasMissing ? 3 : 2;
+	if(n_planes * YON_GT_BITPLANE_WORDS(this->n_samples) * sizeof(U64) >= rle_cost.n_runs * rle_cost.word_width)
+		return false;
+
+	// Bit-planes cannot store genotypes with a single missing allele
+	if(bcf_entry.gt_support.hasMissing){
+		const BYTE* const data = reinterpret_cast<const BYTE* const>(&bcf_entry.data[bcf_entry.formatID[0].l_offset]);
+		for(U32 i = 0; i < 2*this->n_samples; i += 2){
+			if(((data[i] >> 1) == 0) != ((data[i+1] >> 1) == 0))
+				return false;
+		}
+	}
+	return true;
+}
+
+bool GenotypeEncoder::EncodeDiploidBitplane(const bcf_type& bcf_entry, container_type& planes, const U32* const ppa) const{
+	const U32  n_words  = YON_GT_BITPLANE_WORDS(this->n_samples);
+	const BYTE n_planes = bcf_entry.gt_support.hasMissing ? 3 : 2;
+	const BYTE* const data = reinterpret_cast<const BYTE* const>(&bcf_entry.data[bcf_entry.formatID[0].l_offset]);
+
+	// Planes are stored consecutively: allele A, allele B, missing
+	std::vector<U64> words(n_planes * n_words, 0);
+	U64* const alleleA = &words[0];
+	U64* const alleleB = &words[n_words];
+	U64* const missing = &words[(n_planes - 1) * n_words];
+
+	for(U32 i = 0; i < this->n_samples; ++i){
+		const BYTE allele1 = bcf::BCF_UNPACK_GENOTYPE(data[2*ppa[i]]);
+		const BYTE allele2 = bcf::BCF_UNPACK_GENOTYPE(data[2*ppa[i] + 1]);
+		const U64  bit     = (U64)1 << (i & 63);
+
+		if(allele1 == 2){
+			missing[i >> 6] |= bit;
+			continue;
+		}
+		if(allele1 == 1) alleleA[i >> 6] |= bit;
+		if(allele2 == 1) alleleB[i >> 6] |= bit;
+	}
+
+	for(U32 i = 0; i < words.size(); ++i)
+		planes.AddLiteral(words[i]);
+
+	planes.header.n_additions += words.size();
+	return(true);
+}
+
 void GenotypeEncoder::updateStatistics(const GenotypeEncoderSlaveHelper& helper){
 	if(helper.encoding_type == YON_GT_RLE_DIPLOID_BIALLELIC){
 		if(helper.gt_primitive == YON_GT_BYTE){
@@ -678,6 +1087,38 @@ void GenotypeEncoder::updateStatistics(const GenotypeEncoderSlaveHelper& helper)
 		} else if(helper.gt_primitive == YON_GT_U32){
 			++this->stats_.bcf_counts[2];
 		}
+	} else if(helper.encoding_type == YON_GT_BITPLANE_DIPLOID_BIALLELIC){
+		++this->stats_.bitplane_counts;
+	} else if(helper.encoding_type == YON_GT_RLE_MPLOID_BIALLELIC){
+		if(helper.gt_primitive == YON_GT_BYTE){
+			++this->stats_.mploid_rle_counts[0];
+		} else if(helper.gt_primitive == YON_GT_U16){
+			++this->stats_.mploid_rle_counts[1];
+		} else if(helper.gt_primitive == YON_GT_U32){
+			++this->stats_.mploid_rle_counts[2];
+		} else if(helper.gt_primitive == YON_GT_U64){
+			++this->stats_.mploid_rle_counts[3];
+		}
+	} else if(helper.encoding_type == YON_GT_RLE_MPLOID_NALLELIC){
+		if(helper.gt_primitive == YON_GT_BYTE){
+			++this->stats_.mploid_simple_counts[0];
+		} else if(helper.gt_primitive == YON_GT_U16){
+			++this->stats_.mploid_simple_counts[1];
+		} else if(helper.gt_primitive == YON_GT_U32){
+			++this->stats_.mploid_simple_counts[2];
+		} else if(helper.gt_primitive == YON_GT_U64){
+			++this->stats_.mploid_simple_counts[3];
+		}
+	} else if(helper.encoding_type == YON_GT_RLE_DIPLOID_BIALLELIC_PBWT){
+		if(helper.gt_primitive == YON_GT_BYTE){
+			++this->stats_.pbwt_counts[0];
+		} else if(helper.gt_primitive == YON_GT_U16){
+			++this->stats_.pbwt_counts[1];
+		} else if(helper.gt_primitive == YON_GT_U32){
+			++this->stats_.pbwt_counts[2];
+		} else if(helper.gt_primitive == YON_GT_U64){
+			++this->stats_.pbwt_counts[3];
+		}
 	}
 }
 
@@ -5,11 +5,13 @@
 #include <bitset>
 #include <cassert>
 #include <thread>
+#include <vector>
 
 #include "../../containers/variantblock.h"
 #include "../../core/variant_controller.h"
 #include "../../io/bcf/BCFReader.h"
 #include "../../core/genotype_summary.h"
+#include "../stage_profiler.h"
 
 namespace tachyon{
 namespace algorithm{
@@ -19,11 +21,24 @@ namespace algorithm{
 #define YON_PACK_GT_DIPLOID_NALLELIC(A, B, SHIFT, ADD) (((A) >> 1) << ((SHIFT) + (ADD))) | (((B) >> 1) << (ADD)) | ((A) & (ADD))
 
 struct GenotypeEncoderStatistics{
-	GenotypeEncoderStatistics(){}
+	GenotypeEncoderStatistics(){
+		for(U32 i = 0; i < 4; ++i) this->rle_counts[i] = 0;
+		for(U32 i = 0; i < 4; ++i) this->rle_simple_counts[i] = 0;
+		for(U32 i = 0; i < 3; ++i) this->diploid_bcf_counts[i] = 0;
+		for(U32 i = 0; i < 3; ++i) this->bcf_counts[i] = 0;
+		for(U32 i = 0; i < 4; ++i) this->pbwt_counts[i] = 0;
+		this->bitplane_counts = 0;
+		for(U32 i = 0; i < 4; ++i) this->mploid_rle_counts[i] = 0;
+		for(U32 i = 0; i < 4; ++i) this->mploid_simple_counts[i] = 0;
+	}
 
 	const U64 getTotal(void) const{
 		U64 total = 0;
 		for(U32 i = 0; i < 4; ++i) total += this->rle_counts[i];
+		for(U32 i = 0; i < 4; ++i) total += this->pbwt_counts[i];
+		total += this->bitplane_counts;
+		for(U32 i = 0; i < 4; ++i) total += this->mploid_rle_counts[i];
+		for(U32 i = 0; i < 4; ++i) total += this->mploid_simple_counts[i];
 		for(U32 i = 0; i < 4; ++i) total += this->rle_simple_counts[i];
 		for(U32 i = 0; i < 3; ++i) total += this->diploid_bcf_counts[i];
 		for(U32 i = 0; i < 3; ++i) total += this->bcf_counts[i];
@@ -34,6 +49,10 @@ struct GenotypeEncoderStatistics{
 	U64 rle_simple_counts[4];
 	U64 diploid_bcf_counts[3];
 	U64 bcf_counts[3];
+	U64 pbwt_counts[4];
+	U64 bitplane_counts;
+	U64 mploid_rle_counts[4];
+	U64 mploid_simple_counts[4];
 };
 
 /**<
@@ -68,7 +87,7 @@ public:
 		block.gt_support_data_container.Add((U32)helper.n_runs);
 		++block.gt_support_data_container;
 
-		if(helper.encoding_type == YON_GT_RLE_DIPLOID_BIALLELIC){
+		if(helper.encoding_type == YON_GT_RLE_DIPLOID_BIALLELIC || helper.encoding_type == YON_GT_RLE_DIPLOID_BIALLELIC_PBWT || helper.encoding_type == YON_GT_BITPLANE_DIPLOID_BIALLELIC || helper.encoding_type == YON_GT_RLE_MPLOID_BIALLELIC){
 			if(helper.gt_primitive == YON_GT_BYTE){
 				block.gt_rle8_container += helper.container;
 				++block.gt_rle8_container;
@@ -82,7 +101,7 @@ public:
 				block.gt_rle64_container += helper.container;
 				++block.gt_rle64_container;
 			}
-		} else if(helper.encoding_type == YON_GT_RLE_DIPLOID_NALLELIC){
+		} else if(helper.encoding_type == YON_GT_RLE_DIPLOID_NALLELIC || helper.encoding_type == YON_GT_RLE_MPLOID_NALLELIC){
 			if(helper.gt_primitive == YON_GT_BYTE){
 				block.gt_simple8_container += helper.container;
 				++block.gt_simple8_container;
@@ -158,6 +177,22 @@ private:
 
 	} rle_helper_type;
 
+	/**<
+	 * Maximal runs of identical packed genotypes of a diploid
+	 * biallelic variant in the order of the permutation. The runs
+	 * are found once and used both to choose the word width and
+	 * to emit the run-length encoded words.
+	 */
+	typedef struct __RLERunHelper{
+		__RLERunHelper(void) : bits(0){}
+		~__RLERunHelper(){}
+
+		BYTE bits;                 // bits occupied by a packed genotype
+		std::vector<BYTE> packed;  // packed genotypes in the order of the permutation
+		std::vector<BYTE> values;  // packed genotype of each run
+		std::vector<U32>  lengths; // length of each run
+	} rle_runs_type;
+
 public:
 	GenotypeEncoder();
 	GenotypeEncoder(const U64 samples);
@@ -166,20 +201,114 @@ public:
 	bool EncodeParallel(const bcf_reader_type& bcf_reader, meta_type* meta_entries, block_type& block, const U32* const ppa, const U32 n_threads);
 	bool EncodeParallel(const bcf_type& bcf_entry, meta_type& meta, const U32* const ppa, GenotypeEncoderSlaveHelper& slave_helper) const;
 	inline void setSamples(const U64 samples){ this->n_samples = samples; }
+
+	/**<
+	 * Encode diploid biallelic genotypes in positional BWT order:
+	 * every variant is run-length encoded in the order of the
+	 * samples sorted by the genotypes of the previous variants
+	 * in the block. Only used by `EncodeParallel`.
+	 * @param yes Use PBWT ordering or not
+	 */
+	inline void setPBWT(const bool yes){ this->pbwt_ = yes; }
+	inline const bool usePBWT(void) const{ return(this->pbwt_); }
+
+	/**<
+	 * Store the genotypes of diploid biallelic variants as bit-planes
+	 * of allele A, allele B, and missing in the order of the block
+	 * permutation if these are smaller than the runs. Not used for
+	 * variants deferred to the positional BWT encoding.
+	 * @param yes Use bit-planes or not
+	 */
+	inline void setBitplane(const bool yes){ this->bitplane_ = yes; }
+	inline const bool useBitplane(void) const{ return(this->bitplane_); }
 	inline const stats_type& getUsageStats(void) const{ return(this->stats_); }
+	// Worker threads add their CPU time to this profiler if set
+	inline void setProfiler(StageProfiler* profiler){ this->profiler_ = profiler; }
 
 private:
-	const rle_helper_type assessDiploidRLEBiallelic(const bcf_type& bcf_entry, const U32* const ppa) const;
+	/**<
+	 * Assess the cost of run-length encoding the genotypes of a
+	 * diploid biallelic variant. The packed genotypes are gathered
+	 * in the order of the permutation and split into maximal runs
+	 * in a single pass: the runs of each word width follow from
+	 * splitting these at the run limit of the word.
+	 * @param bcf_entry Current variant
+	 * @param ppa       Permutation of the samples in the block
+	 * @param runs      Maximal runs used by `EncodeDiploidRLEBiallelic`
+	 * @return          Returns the word width and the number of runs
+	 */
+	const rle_helper_type assessDiploidRLEBiallelic(const bcf_type& bcf_entry, const U32* const ppa, rle_runs_type& runs) const;
 	const rle_helper_type assessDiploidRLEnAllelic(const bcf_type& bcf_entry, const U32* const ppa) const;
 	const rle_helper_type assessMploidRLEBiallelic(const bcf_type& bcf_entry, const U32* const ppa) const;
 	const rle_helper_type assessMploidRLEnAllelic(const bcf_type& bcf_entry, const U32* const ppa) const;
 
+	/**<
+	 * Assess the cost of run-length encoding the genotypes of a
+	 * haploid or polyploid variant. The word width is 0 if no word
+	 * can hold the packed genotypes, if the phasing of the alleles
+	 * of a sample differs, or if the BCF-style encoding is smaller.
+	 * @param bcf_entry Current variant
+	 * @param ppa       Permutation of the samples in the block
+	 * @param biallelic Encode the alleles as biallelic or not
+	 * @return          Returns the word width and the number of runs
+	 */
+	const rle_helper_type assessMploidRLE(const bcf_type& bcf_entry, const U32* const ppa, const bool biallelic) const;
+
+	/**<
+	 * Pack the genotype of a haploid or polyploid sample as
+	 * allele_P-1 | ... | allele_0 | phase. The phase is that of the
+	 * last allele that is not EOV and is only stored if the phasing
+	 * is mixed.
+	 * @param alleles   BCF genotype values of the sample
+	 * @param bcf_entry Current variant
+	 * @param shift     Bits occupied per allele
+	 * @param add       Bits occupied by the phase
+	 * @param biallelic Encode the alleles as biallelic or not
+	 * @param packed    Packed genotype
+	 * @return          Returns FALSE if the phasing of the alleles of the sample differs or TRUE otherwise
+	 */
+	bool packMploid(const BYTE* const alleles, const bcf_type& bcf_entry, const BYTE shift, const BYTE add, const bool biallelic, U64& packed) const;
+
 	template <class YON_STORE_TYPE, class BCF_GT_TYPE = BYTE> bool EncodeBCFStyle(const bcf_type& bcf_entry, container_type& container, U64& n_runs) const;
 	template <class YON_RLE_TYPE, class BCF_GT_TYPE = BYTE> bool EncodeDiploidBCF(const bcf_type& bcf_entry, container_type& runs, U64& n_runs, const U32* const ppa) const;
-	template <class YON_RLE_TYPE> bool EncodeDiploidRLEBiallelic(const bcf_type& bcf_entry, container_type& runs, const U32* const ppa, const rle_helper_type& helper) const;
+	template <class YON_RLE_TYPE> bool EncodeDiploidRLEBiallelic(const rle_runs_type& runs, container_type& container, const rle_helper_type& helper) const;
 	template <class YON_RLE_TYPE> bool EncodeDiploidRLEnAllelic(const bcf_type& bcf_entry, container_type& runs, const U32* const ppa, const rle_helper_type& helper) const;
 	template <class T> bool EncodeMploidRLEBiallelic(const bcf_type& bcf_entry, container_type& runs, U64& n_runs, const U32* const ppa) const;
 	template <class T> bool EncodeMploidRLENallelic(const bcf_type& bcf_entry, container_type& runs, U64& n_runs, const U32* const ppa) const;
+	template <class T> bool EncodeMploidRLE(const bcf_type& bcf_entry, container_type& runs, U64& n_runs, const U32* const ppa, const bool biallelic) const;
+
+	/**<
+	 * Encode the variants of a block that were deferred to the
+	 * positional BWT encoding by `EncodeParallel`. Variants are
+	 * visited in order as each order depends on the previous one.
+	 * @param bcf_reader   Variants of the block
+	 * @param meta_entries Meta entries of the variants
+	 * @param ppa          Permutation of the samples in the block
+	 * @param helpers      Encoded genotypes of the variants
+	 * @return             Returns TRUE upon success or FALSE otherwise
+	 */
+	bool EncodeDiploidPBWT(const bcf_reader_type& bcf_reader, meta_type* meta_entries, const U32* const ppa, GenotypeEncoderSlaveHelper* helpers) const;
+
+	/**<
+	 * Stable sort of the samples on their packed genotypes to give
+	 * the positional BWT order used by the next variant
+	 * @param bcf_entry Current variant
+	 * @param order     Samples in the order of the current variant
+	 * @param sorted    Scratch space of the same size as `order`
+	 */
+	void updatePBWTOrder(const bcf_type& bcf_entry, std::vector<U32>& order, std::vector<U32>& sorted) const;
+
+	/**<
+	 * Check if the genotypes of a diploid biallelic variant can be
+	 * stored as bit-planes and if these are smaller than the runs.
+	 * Bit-planes cannot store mixed phasing or genotypes with a
+	 * single missing allele.
+	 * @param bcf_entry Current variant
+	 * @param rle_cost  Cost of run-length encoding the variant
+	 * @return          Returns TRUE if bit-planes should be used or FALSE otherwise
+	 */
+	bool assessDiploidBitplane(const bcf_type& bcf_entry, const rle_helper_type& rle_cost) const;
+	bool EncodeDiploidBitplane(const bcf_type& bcf_entry, container_type& planes, const U32* const ppa) const;
 
 	/**<
 	 * Supportive reduce function for updating local import statistics
@@ -192,7 +321,11 @@ private:
 
 private:
 	U64 n_samples; // number of samples
+	bool pbwt_;    // diploid biallelic genotypes in PBWT order
+	bool bitplane_; // diploid biallelic genotypes as bit-planes if smaller
 	stats_type stats_;
+	rle_runs_type runs_; // scratch runs of the serial encoder
+	StageProfiler* profiler_;
 };
 
 template <class YON_STORE_TYPE, class BCF_GT_TYPE>
@@ -212,9 +345,8 @@ bool GenotypeEncoder::EncodeBCFStyle(const bcf_type& bcf_entry,
 	for(U32 i = 0; i < this->n_samples * ploidy; i += ploidy, ++j){
 		for(U32 p = 0; p < ploidy; ++p){
 			const BCF_GT_TYPE& allele = *reinterpret_cast<const BCF_GT_TYPE* const>(&bcf_entry.data[bcf_gt_pos]);
-			if((allele >> 1) == 0) simple.AddLiteral((YON_STORE_TYPE)0); // missing
-			else if(allele == EOV_value) simple.AddLiteral((YON_STORE_TYPE)1); // eov
-			else { // otherwise
+			if(allele == EOV_value) simple.AddLiteral((YON_STORE_TYPE)1); // eov
+			else { // otherwise: missing is stored as 2 to keep its phase
 				// Add 1 because 1 is reserved for EOV
 				const YON_STORE_TYPE val = ((allele >> 1) + 1) << 1 | (allele & 1);
 				simple.AddLiteral(val);
@@ -263,68 +395,26 @@ bool GenotypeEncoder::EncodeDiploidBCF(const bcf_type& bcf_entry,
 }
 
 template <class YON_RLE_TYPE>
-bool GenotypeEncoder::EncodeDiploidRLEBiallelic(const bcf_type& bcf_entry,
-		                                        container_type& runs,
-                                              const U32* const  ppa,
+bool GenotypeEncoder::EncodeDiploidRLEBiallelic(const rle_runs_type& runs,
+		                                          container_type& container,
 								         const rle_helper_type& helper) const
 {
-	const BYTE ploidy   = 2;
-	U32 sumLength       = 0;
-	YON_RLE_TYPE length = 1;
-	YON_RLE_TYPE RLE    = 0;
-	const BYTE shift    = bcf_entry.gt_support.hasMissing    ? 2 : 1;
-	const BYTE add      = bcf_entry.gt_support.mixedPhasing  ? 1 : 0;
+	const YON_RLE_TYPE run_limit = ((U64)1 << (8*sizeof(YON_RLE_TYPE) - runs.bits)) - 1;
 
-	// Run limits
-	const YON_RLE_TYPE run_limit = pow(2, 8*sizeof(YON_RLE_TYPE) - (ploidy*shift + add)) - 1;
-	const char* const data       = &bcf_entry.data[bcf_entry.formatID[0].l_offset];
-	const BYTE& allele1 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[0]]);
-	const BYTE& allele2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[0] + sizeof(BYTE)]);
-	YON_RLE_TYPE packed = YON_PACK_GT_DIPLOID(allele2, allele1, shift, add);
-
-	U32 ppa_pos = 1;
+	// Maximal runs longer than the run limit of the word are split
+	// into runs of the limit followed by the remainder
 	U64 n_runs = 0;
-	for(U32 i = ploidy; i < this->n_samples * ploidy; i += ploidy){
-		const BYTE& allele1 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[ppa_pos]]);
-		const BYTE& allele2 = *reinterpret_cast<const BYTE* const>(&data[ploidy*sizeof(BYTE)*ppa[ppa_pos] + sizeof(BYTE)]);
-		const YON_RLE_TYPE packed_internal = YON_PACK_GT_DIPLOID(allele2, allele1, shift, add);
-
-		if(packed != packed_internal || length == run_limit){
-			// Prepare RLE
-			RLE = length;
-			RLE <<= (ploidy*shift + add);
-			RLE |= packed;
-			assert((RLE >> (ploidy*shift + add)) == length);
-
-			// Push RLE to buffer
-			runs.AddLiteral((YON_RLE_TYPE)RLE);
+	for(U32 i = 0; i < runs.values.size(); ++i){
+		U32 length = runs.lengths[i];
+		for(; length > run_limit; length -= run_limit, ++n_runs)
+			container.AddLiteral((YON_RLE_TYPE)(((YON_RLE_TYPE)run_limit << runs.bits) | runs.values[i]));
 
-			// Reset and update
-			sumLength += length;
-			length = 0;
-			packed = packed_internal;
-			++n_runs;
-		}
-		++length;
-		++ppa_pos;
+		container.AddLiteral((YON_RLE_TYPE)(((YON_RLE_TYPE)length << runs.bits) | runs.values[i]));
+		++n_runs;
 	}
-	// Last entry
-	// Prepare RLE
-	RLE = length;
-	RLE <<= (ploidy*shift + add);
-	RLE |= packed;
-	assert((RLE >> (ploidy*shift + add)) == length);
 
-	// Push RLE to buffer
-	runs.AddLiteral((YON_RLE_TYPE)RLE);
-	++n_runs;
-
-	// Reset and update
-	sumLength += length;
-	assert(sumLength == this->n_samples);
 	assert(helper.n_runs == n_runs);
-	runs.header.n_additions += n_runs;
-	assert(ppa_pos == n_samples);
+	container.header.n_additions += n_runs;
 
 #if ENCODER_GT_DEBUG == 1
 	std::cout << 0 << '\t' << n_runs << '\t' << sizeof(YON_RLE_TYPE) << '\n';
@@ -355,7 +445,7 @@ bool GenotypeEncoder::EncodeDiploidRLEnAllelic(const bcf_type& bcf_entry,
 		allele1 = 0;
 	}
 	else if(allele1 == 0x81){
-		allele1 = 1;
+		allele1 = 1 << 1; // EOV is packed as 1
 		//std::cerr << "eov and: " << bcf_entry.gt_support.hasEOV << std::endl;
 	} else {
 		// Add 1 to value
@@ -366,7 +456,7 @@ bool GenotypeEncoder::EncodeDiploidRLEnAllelic(const bcf_type& bcf_entry,
 		allele2 = 0;
 	}
 	else if(allele2 == 0x81){
-		allele2 = 1;
+		allele2 = 1 << 1; // EOV is packed as 1
 		//std::cerr << "eov and: " << bcf_entry.gt_support.hasEOV << std::endl;
 	} else {
 		allele2 = (((allele2 >> 1) + bcf_entry.gt_support.hasEOV) << 1) | (allele2 & 1);
@@ -384,7 +474,7 @@ bool GenotypeEncoder::EncodeDiploidRLEnAllelic(const bcf_type& bcf_entry,
 			allele1 = 0;
 		}
 		else if(allele1 == 0x81){
-			allele1 = 1;
+			allele1 = 1 << 1; // EOV is packed as 1
 			//std::cerr << "eov" << std::endl;
 		} else {
 			// Add 1 to value
@@ -395,7 +485,7 @@ bool GenotypeEncoder::EncodeDiploidRLEnAllelic(const bcf_type& bcf_entry,
 			allele2 = 0;
 		}
 		else if(allele2 == 0x81){
-			allele2 = 1;
+			allele2 = 1 << 1; // EOV is packed as 1
 			//std::cerr << "eov" << std::endl;
 		} else {
 			allele2 = (((allele2 >> 1) + bcf_entry.gt_support.hasEOV) << 1) | (allele2 & 1);
@@ -446,6 +536,74 @@ bool GenotypeEncoder::EncodeDiploidRLEnAllelic(const bcf_type& bcf_entry,
 	return(true);
 }
 
+template <class T>
+bool GenotypeEncoder::EncodeMploidRLEBiallelic(const bcf_type& bcf_entry,
+                                              container_type& runs,
+                                                         U64& n_runs,
+                                            const U32* const  ppa) const
+{
+	return(this->EncodeMploidRLE<T>(bcf_entry, runs, n_runs, ppa, true));
+}
+
+template <class T>
+bool GenotypeEncoder::EncodeMploidRLENallelic(const bcf_type& bcf_entry,
+                                             container_type& runs,
+                                                        U64& n_runs,
+                                           const U32* const  ppa) const
+{
+	return(this->EncodeMploidRLE<T>(bcf_entry, runs, n_runs, ppa, false));
+}
+
+template <class T>
+bool GenotypeEncoder::EncodeMploidRLE(const bcf_type& bcf_entry,
+                                     container_type& runs,
+                                                U64& n_runs,
+                                   const U32* const  ppa,
+                                          const bool biallelic) const
+{
+	const BYTE ploidy = bcf_entry.gt_support.ploidy;
+	const BYTE shift  = biallelic ? (bcf_entry.gt_support.hasMissing ? 2 : 1)
+	                              : ceil(log2(bcf_entry.body->n_allele + bcf_entry.gt_support.hasMissing + bcf_entry.gt_support.hasEOV + 1));
+	const BYTE add    = bcf_entry.gt_support.mixedPhasing ? 1 : 0;
+	const U32  bits   = ploidy*shift + add;
+	if(bits >= 8*sizeof(T)) return false;
+
+	const U64 run_limit = ((U64)1 << (8*sizeof(T) - bits)) - 1;
+	const BYTE* const data = reinterpret_cast<const BYTE*>(&bcf_entry.data[bcf_entry.formatID[0].l_offset]);
+
+	// The runs are preceded by the ploidy as the meta
+	// data only stores if the variant is diploid
+	runs.AddLiteral((T)ploidy);
+
+	U64 packed = 0;
+	if(this->packMploid(&data[ploidy*ppa[0]], bcf_entry, shift, add, biallelic, packed) == false)
+		return false;
+
+	U64 length = 1;
+	n_runs = 0;
+	for(U32 i = 1; i < this->n_samples; ++i){
+		U64 packed_internal = 0;
+		if(this->packMploid(&data[ploidy*ppa[i]], bcf_entry, shift, add, biallelic, packed_internal) == false)
+			return false;
+
+		if(packed != packed_internal || length == run_limit){
+			runs.AddLiteral((T)((length << bits) | packed));
+			++n_runs;
+			length  = 0;
+			packed  = packed_internal;
+		}
+		++length;
+	}
+	// Last entry
+	runs.AddLiteral((T)((length << bits) | packed));
+	++n_runs;
+
+#if ENCODER_GT_DEBUG == 1
+	std::cout << 6 << '\t' << n_runs << '\t' << sizeof(T) << '\n';
+#endif
+	return(true);
+}
+
 /**<
  * Parallel support structure: this object encapsulates
  * a thread that runs the `EncodeParallel` function with
@@ -458,7 +616,7 @@ struct CalcSlave{
 	typedef core::MetaEntry meta_type;
 	typedef GenotypeEncoderSlaveHelper helper_type;
 
-	CalcSlave(){}
+	CalcSlave() : cpu_time(0){}
 	~CalcSlave(){}
 
 	std::thread* Start(const GenotypeEncoder& encoder, const U32 thread_idx, const U32 n_threads, const bcf_reader_type& reader, meta_type* meta_entries, const U32* const ppa, helper_type* helpers){
@@ -484,12 +642,16 @@ private:
 	helper_type* helpers;
 
 	void Run_(void){
+		Timer timer;
+		timer.Start();
 		for(U32 i = this->thread_idx; i < this->reader->size(); i += this->n_threads){
 			encoder->EncodeParallel((*reader)[i], meta_entries[i], ppa, helpers[i]);
 		}
+		this->cpu_time = timer.ElapsedCPU();
 	}
 
 public:
+	double cpu_time; // CPU time used by this thread
 	std::thread thread;
 };
 
@@ -20,14 +20,28 @@ public:
 	~UncompressedCodec(){ }
 	inline const bool compress(permutation_type& manager){ return true; }
 	inline const bool compress(container_type& container){
+		container.generateCRC();
 		container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 		memcpy(container.buffer_data.data(), container.buffer_data_uncompressed.data(), container.buffer_data_uncompressed.size());
 		container.header.data_header.controller.encoder = YON_ENCODE_NONE;
 		container.buffer_data.n_chars                   = container.buffer_data_uncompressed.size();
 		container.header.data_header.cLength            = container.buffer_data_uncompressed.size();
+		container.header.data_header.uLength            = container.buffer_data_uncompressed.size();
+
+		if(container.header.data_header.controller.mixedStride == true)
+			return(this->compressStrides(container));
+		else return true;
+	}
+
+	inline const bool compressStrides(container_type& container){
+		container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
+		memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
+		container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
+		container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
+		container.header.stride_header.cLength            = container.buffer_strides_uncompressed.size();
+		container.header.stride_header.uLength            = container.buffer_strides_uncompressed.size();
 		return true;
 	}
-	inline const bool compressStrides(container_type& container){ return true; }
 
 	const bool decompress(container_type& container){
 		if(container.header.data_header.controller.encryption != YON_ENCRYPTION_NONE){
@@ -39,6 +53,13 @@ public:
 			std::cerr << utility::timestamp("ERROR","ENCODER") << "Wrong codec used..." << std::endl;
 			return false;
 		}
+		// Data read from a memory-mapped file is used in place
+		if(container.buffer_data.isView()){
+			container.buffer_data_uncompressed.view(container.buffer_data.data(), container.buffer_data.size());
+			assert(container.checkCRC(0));
+			return true;
+		}
+
 		container.buffer_data_uncompressed.resize(container.buffer_data.n_chars + 16536);
 		memcpy(container.buffer_data_uncompressed.buffer, container.buffer_data.buffer, container.buffer_data.n_chars);
 		container.buffer_data_uncompressed.n_chars = container.buffer_data.n_chars;
@@ -62,6 +83,12 @@ public:
 			return false;
 		}
 
+		if(container.buffer_strides.isView()){
+			container.buffer_strides_uncompressed.view(container.buffer_strides.data(), container.buffer_strides.size());
+			assert(container.checkCRC(1));
+			return true;
+		}
+
 		container.buffer_strides_uncompressed.resize(container.buffer_strides.n_chars + 16536);
 		memcpy(container.buffer_strides_uncompressed.buffer, container.buffer_strides.buffer, container.buffer_strides.n_chars);
 		container.buffer_strides_uncompressed.n_chars = container.buffer_strides.n_chars;
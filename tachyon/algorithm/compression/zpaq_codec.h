@@ -26,6 +26,7 @@ public:
 		container.generateCRC();
 
 		if(container.header.data_header.controller.uniform || container.buffer_data_uncompressed.size() < 100){
+			container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 			memcpy(container.buffer_data.data(),
                    container.buffer_data_uncompressed.data(),
                    container.buffer_data_uncompressed.size());
@@ -49,6 +50,7 @@ public:
 
 		const float fold = (float)container.buffer_data_uncompressed.size() / out.buffer.size();
 		if(fold < MIN_COMPRESSION_FOLD){
+			container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 			memcpy(container.buffer_data.data(),
                    container.buffer_data_uncompressed.data(),
                    container.buffer_data_uncompressed.size());
@@ -80,6 +82,7 @@ public:
 		container.generateCRC();
 
 		if(container.header.data_header.controller.uniform || container.buffer_data_uncompressed.size() < 100){
+			container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 			memcpy(container.buffer_data.data(),
                    container.buffer_data_uncompressed.data(),
                    container.buffer_data_uncompressed.size());
@@ -103,6 +106,7 @@ public:
 
 		const float fold = (float)container.buffer_data_uncompressed.size() / out.buffer.size();
 		if(fold < MIN_COMPRESSION_FOLD){
+			container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 			memcpy(container.buffer_data.data(),
                    container.buffer_data_uncompressed.data(),
                    container.buffer_data_uncompressed.size());
@@ -129,6 +133,7 @@ public:
 
 	const bool compressStrides(container_type& container, const std::string& command){
 		if(container.header.stride_header.controller.uniform || container.buffer_strides_uncompressed.size() < 100){
+			container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
 			memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
 			container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
@@ -144,6 +149,7 @@ public:
 
 		const float fold = (float)container.buffer_strides_uncompressed.size()/out.buffer.size();
 		if(fold < MIN_COMPRESSION_FOLD){
+			container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
 			memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
 			container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
@@ -161,6 +167,7 @@ public:
 
 	const bool compressStrides(container_type& container){
 		if(container.header.stride_header.controller.uniform || container.buffer_strides_uncompressed.size() < 100){
+			container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
 			memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
 			container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
@@ -176,6 +183,7 @@ public:
 
 		const float fold = (float)container.buffer_strides_uncompressed.size()/out.buffer.size();
 		if(fold < MIN_COMPRESSION_FOLD){
+			container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
 			memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
 			container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
@@ -201,7 +209,6 @@ public:
 		ZpaqWrapperIn in(container.buffer_data);
 		ZpaqWrapperOut out(container.buffer_data_uncompressed);
 		libzpaq::decompress(&in, &out);
-		std::cerr << "zpaq decode: " << container.buffer_data.size() << "->" << container.buffer_data_uncompressed.size() << std::endl;
 
 		assert(out.buffer.size() == container.header.data_header.uLength);
 		assert(container.checkCRC(0));
@@ -15,9 +15,8 @@ public:
 	ZpaqWrapperIn(buffer_type& buffer) : iterator_pos(0), buffer(buffer){}
 	~ZpaqWrapperIn(){ }
 	inline int get(){
-		if(this->iterator_pos + 1 == this->buffer.size()) return(-1); // eof
+		if(this->iterator_pos == this->buffer.size()) return(-1); // eof
 		return((BYTE)this->buffer[this->iterator_pos++]);
-		getchar();
 	}  // returns byte 0..255 or -1 at EOF
 
 	inline void reset(void){
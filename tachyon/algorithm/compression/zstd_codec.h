@@ -4,6 +4,7 @@
 #include "compression_container.h"
 #include "zstd.h"
 #include "zstd_errors.h"
+#include "zstd_dictionary.h"
 
 namespace tachyon{
 namespace algorithm{
@@ -13,13 +14,16 @@ private:
 	typedef        ZSTDCodec   self_type;
 	typedef struct ZSTD_CCtx_s ZSTD_CCtx;
 	typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+	typedef struct ZSTD_CDict_s ZSTD_CDict;
+	typedef ZSTDDictionaryManager dictionary_manager_type;
 
 public:
 	ZSTDCodec() :
 		compression_level_data(0),
 		compression_level_strides(0),
 		compression_context_(ZSTD_createCCtx()),
-		decompression_context_(ZSTD_createDCtx())
+		decompression_context_(ZSTD_createDCtx()),
+		dictionaries_(nullptr)
 	{
 
 	}
@@ -33,12 +37,31 @@ public:
 	inline void setCompressionLevelData(const S32& c){ this->compression_level_data = c; }
 	inline void setCompressionLevelStrides(const S32& c){ this->compression_level_strides = c; }
 
+	/**<
+	 * Set the dictionaries used to decompress data compressed
+	 * with a dictionary. The dictionaries are not owned by the codec.
+	 * @param dictionaries Pointer to dictionaries or nullptr
+	 */
+	inline void setDictionaries(const dictionary_manager_type* dictionaries){ this->dictionaries_ = dictionaries; }
+
 	/**
 	 *
 	 * @param stream
 	 * @return
 	 */
 	const bool compress(container_type& container){
+		return(this->compress(container, nullptr));
+	}
+
+	/**<
+	 * Compress a data container. If a dictionary is provided then the
+	 * data (but not strides) is compressed with the dictionary. The
+	 * compression level is the level the dictionary was digested with.
+	 * @param container  Target data container
+	 * @param dictionary Digested dictionary or nullptr
+	 * @return           Returns TRUE upon success or FALSE otherwise
+	 */
+	const bool compress(container_type& container, const ZSTD_CDict* dictionary){
 		container.generateCRC();
 
 		if(container.header.n_entries == 0){
@@ -49,6 +72,7 @@ public:
 		}
 
 		if(container.header.data_header.controller.uniform || container.buffer_data_uncompressed.size() < 100){
+			container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 			memcpy(container.buffer_data.data(), container.buffer_data_uncompressed.data(), container.buffer_data_uncompressed.size());
 			container.header.data_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_data.n_chars                   = container.buffer_data_uncompressed.size();
@@ -62,12 +86,22 @@ public:
 
 		this->buffer.reset();
 		this->buffer.resize(container.buffer_data_uncompressed.size() + 65536);
-		const size_t ret = ZSTD_compressCCtx(this->compression_context_,
+		size_t ret = 0;
+		if(dictionary != nullptr){
+			ret = ZSTD_compress_usingCDict(this->compression_context_,
+			                               this->buffer.data(),
+			                               this->buffer.capacity(),
+			                               container.buffer_data_uncompressed.data(),
+			                               container.buffer_data_uncompressed.size(),
+			                               dictionary);
+		} else {
+			ret = ZSTD_compressCCtx(this->compression_context_,
                                    this->buffer.data(),
 								   this->buffer.capacity(),
 								   container.buffer_data_uncompressed.data(),
 								   container.buffer_data_uncompressed.size(),
 								   this->compression_level_data);
+		}
 
 		//std::cerr << utility::timestamp("LOG","COMPRESSION") << "Input: " << container.getSizeUncompressed() << " and output: " << ret << " -> " << (float)container.getSizeUncompressed()/ret << "-fold"  << std::endl;
 
@@ -79,6 +113,7 @@ public:
 
 		const float fold = (float)container.buffer_data_uncompressed.size() / ret;
 		if(fold < MIN_COMPRESSION_FOLD){
+			container.buffer_data.resize(container.buffer_data_uncompressed.size() + 65536);
 			memcpy(container.buffer_data.data(), container.buffer_data_uncompressed.data(), container.buffer_data_uncompressed.size());
 			container.header.data_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_data.n_chars                   = container.buffer_data_uncompressed.size();
@@ -109,6 +144,7 @@ public:
 	 */
 	const bool compressStrides(container_type& container){
 		if(container.header.stride_header.controller.uniform || container.buffer_strides_uncompressed.size() < 100){
+			container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
 			memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
 			container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
@@ -134,6 +170,7 @@ public:
 
 		const float fold = (float)container.buffer_strides_uncompressed.size()/ret;
 		if(fold < MIN_COMPRESSION_FOLD){
+			container.buffer_strides.resize(container.buffer_strides_uncompressed.size() + 65536);
 			memcpy(container.buffer_strides.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
 			container.header.stride_header.controller.encoder = YON_ENCODE_NONE;
 			container.buffer_strides.n_chars                  = container.buffer_strides_uncompressed.size();
@@ -233,10 +270,28 @@ public:
 
 		container.buffer_data_uncompressed.reset();
 		container.buffer_data_uncompressed.resize(container.header.data_header.uLength + 65536);
-		int ret = ZSTD_decompress(container.buffer_data_uncompressed.data(),
+
+		// Frames compressed with a dictionary carry its identifier
+		const U32 dict_id = ZSTD_getDictID_fromFrame(container.buffer_data.data(), container.buffer_data.size());
+		int ret = 0;
+		if(dict_id){
+			const ZSTD_DDict* dictionary = (this->dictionaries_ != nullptr ? this->dictionaries_->getDecompressionDictionary(dict_id) : nullptr);
+			if(dictionary == nullptr){
+				std::cerr << utility::timestamp("ERROR","ZSTD") << "Missing dictionary " << dict_id << "..." << std::endl;
+				return(false);
+			}
+			ret = ZSTD_decompress_usingDDict(this->decompression_context_,
+			                                 container.buffer_data_uncompressed.data(),
+			                                 container.buffer_data_uncompressed.capacity(),
+			                                 container.buffer_data.data(),
+			                                 container.buffer_data.size(),
+			                                 dictionary);
+		} else {
+			ret = ZSTD_decompress(container.buffer_data_uncompressed.data(),
 								  container.buffer_data_uncompressed.capacity(),
 								  container.buffer_data.data(),
 								  container.buffer_data.size());
+		}
 
 		if(ZSTD_isError(ret)){
 			std::cerr << utility::timestamp("ERROR","ZSTD") << ZSTD_getErrorString(ZSTD_getErrorCode(ret)) << std::endl;
@@ -326,6 +381,7 @@ private:
 	S32 compression_level_strides;
 	ZSTD_CCtx* compression_context_;
 	ZSTD_DCtx* decompression_context_;
+	const dictionary_manager_type* dictionaries_;
 };
 
 }
@@ -0,0 +1,225 @@
+#include "zstd_dictionary.h"
+#include "zstd_errors.h"
+
+namespace tachyon{
+namespace algorithm{
+
+/**< Maximum dictionary size in bytes */
+#define YON_DICTIONARY_MAX_SIZE   16384
+/**< Minimum amount of training data for a field in bytes */
+#define YON_DICTIONARY_MIN_DATA   4096
+/**< Number of samples each block is split into */
+#define YON_DICTIONARY_N_SPLITS   8
+
+ZSTDDictionaryManager::ZSTDDictionaryManager(){}
+
+ZSTDDictionaryManager::ZSTDDictionaryManager(const self_type& other){ *this = other; }
+
+ZSTDDictionaryManager::~ZSTDDictionaryManager(){ this->clear(); }
+
+ZSTDDictionaryManager& ZSTDDictionaryManager::operator=(const self_type& other){
+	if(this == &other) return(*this);
+
+	this->clear();
+	for(U32 i = 0; i < 2; ++i) this->lookup_[i] = other.lookup_[i];
+	for(U32 i = 0; i < other.dictionaries_.size(); ++i)
+		this->dictionaries_.push_back(new dictionary_type(*other.dictionaries_[i]));
+
+	this->prepareDecompression();
+	return(*this);
+}
+
+void ZSTDDictionaryManager::clear(void){
+	for(U32 i = 0; i < this->dictionaries_.size(); ++i)
+		delete this->dictionaries_[i];
+	this->dictionaries_.clear();
+	for(U32 i = 0; i < 2; ++i)
+		std::fill(this->lookup_[i].begin(), this->lookup_[i].end(), -1);
+}
+
+void ZSTDDictionaryManager::setFields(const U32 n_info, const U32 n_format){
+	this->samples_[YON_DICTIONARY_INFO].resize(n_info);
+	this->samples_[YON_DICTIONARY_FORMAT].resize(n_format);
+	this->lookup_[YON_DICTIONARY_INFO].resize(n_info, -1);
+	this->lookup_[YON_DICTIONARY_FORMAT].resize(n_format, -1);
+}
+
+void ZSTDDictionaryManager::addSample(const TACHYON_DICTIONARY_GROUP group, const U32 global_key, const buffer_type& data){
+	if(global_key >= this->samples_[group].size() || data.size() == 0)
+		return;
+
+	FieldSamples& samples = this->samples_[group][global_key];
+	samples.data.Add(data.data(), data.size());
+	samples.blocks.push_back(data.size());
+	++samples.n_blocks;
+
+	const size_t split = data.size() / YON_DICTIONARY_N_SPLITS;
+	if(split == 0){
+		samples.sizes.push_back(data.size());
+		samples.n_samples.push_back(1);
+		return;
+	}
+
+	for(U32 i = 0; i + 1 < YON_DICTIONARY_N_SPLITS; ++i)
+		samples.sizes.push_back(split);
+	samples.sizes.push_back(data.size() - split*(YON_DICTIONARY_N_SPLITS - 1));
+	samples.n_samples.push_back(YON_DICTIONARY_N_SPLITS);
+}
+
+bool ZSTDDictionaryManager::trainField(const TACHYON_DICTIONARY_GROUP group, const U32 global_key, FieldSamples& samples, const S32 compression_level, const double n_expected_blocks){
+	// At least one block for training and one held-out block for evaluation
+	if(samples.n_blocks < 2)
+		return false;
+
+	const size_t test_size  = samples.blocks.back();
+	const size_t train_size = samples.data.size() - test_size;
+	const U32    n_train_samples = samples.sizes.size() - samples.n_samples.back();
+	if(train_size < YON_DICTIONARY_MIN_DATA)
+		return false;
+
+	U32 capacity = train_size / 10;
+	if(capacity > YON_DICTIONARY_MAX_SIZE) capacity = YON_DICTIONARY_MAX_SIZE;
+	if(capacity < 256) capacity = 256;
+
+	dictionary_type* dictionary = new dictionary_type;
+	dictionary->data.resize(capacity);
+	const size_t dict_size = ZDICT_trainFromBuffer(dictionary->data.data(), capacity, samples.data.data(), &samples.sizes[0], n_train_samples);
+	if(ZDICT_isError(dict_size)){
+		// Not enough or too homogeneous data: not an error
+		delete dictionary;
+		return false;
+	}
+	dictionary->data.n_chars = dict_size;
+	dictionary->group        = group;
+	dictionary->global_key   = global_key;
+	dictionary->dict_id      = ZDICT_getDictID(dictionary->data.data(), dict_size);
+
+	// Identifiers are derived from the dictionary content: drop
+	// the unlikely case of a collision
+	if(dictionary->dict_id == 0 || this->getDecompressionDictionary(dictionary->dict_id) != nullptr){
+		delete dictionary;
+		return false;
+	}
+
+	dictionary->c_dict = ZSTD_createCDict(dictionary->data.data(), dict_size, compression_level);
+	if(dictionary->c_dict == nullptr){
+		delete dictionary;
+		return false;
+	}
+
+	// Compare the compressed size of the held-out block with and without the dictionary
+	ZSTD_CCtx* context = ZSTD_createCCtx();
+	buffer_type output(test_size + 65536);
+	const size_t c_plain = ZSTD_compressCCtx(context, output.data(), output.capacity(), &samples.data[train_size], test_size, compression_level);
+	const size_t c_dict  = ZSTD_compress_usingCDict(context, output.data(), output.capacity(), &samples.data[train_size], test_size, dictionary->c_dict);
+	ZSTD_freeCCtx(context);
+
+	if(ZSTD_isError(c_plain) || ZSTD_isError(c_dict) || c_dict >= c_plain || (c_plain - c_dict) * n_expected_blocks <= dict_size){
+		delete dictionary;
+		return false;
+	}
+	dictionary->c_saved = c_plain - c_dict;
+
+	dictionary->d_dict = ZSTD_createDDict(dictionary->data.data(), dict_size);
+	if(dictionary->d_dict == nullptr){
+		delete dictionary;
+		return false;
+	}
+
+	this->lookup_[group][global_key] = this->dictionaries_.size();
+	this->dictionaries_.push_back(dictionary);
+	return true;
+}
+
+U32 ZSTDDictionaryManager::train(const S32 compression_level, const double n_expected_blocks){
+	U32 n_trained = 0;
+	for(U32 g = 0; g < 2; ++g){
+		for(U32 i = 0; i < this->samples_[g].size(); ++i){
+			FieldSamples& samples = this->samples_[g][i];
+			n_trained += this->trainField((TACHYON_DICTIONARY_GROUP)g, i, samples, compression_level, n_expected_blocks);
+
+			// Release training data
+			buffer_type().swap(samples.data);
+			std::vector<size_t>().swap(samples.sizes);
+			std::vector<size_t>().swap(samples.blocks);
+			std::vector<U32>().swap(samples.n_samples);
+			samples.n_blocks = 0;
+		}
+	}
+	return(n_trained);
+}
+
+bool ZSTDDictionaryManager::merge(const self_type& other){
+	for(U32 i = 0; i < other.dictionaries_.size(); ++i){
+		const dictionary_type& dictionary = *other.dictionaries_[i];
+
+		bool found = false;
+		for(U32 j = 0; j < this->dictionaries_.size(); ++j){
+			const dictionary_type& existing = *this->dictionaries_[j];
+			if(existing.dict_id != dictionary.dict_id) continue;
+
+			if(existing.data.size() != dictionary.data.size() || memcmp(existing.data.data(), dictionary.data.data(), existing.data.size()) != 0){
+				std::cerr << utility::timestamp("ERROR","ZSTD") << "Different dictionaries share the identifier " << dictionary.dict_id << "..." << std::endl;
+				return false;
+			}
+			found = true;
+			break;
+		}
+
+		if(found == false)
+			this->dictionaries_.push_back(new dictionary_type(dictionary));
+	}
+	return true;
+}
+
+bool ZSTDDictionaryManager::prepareDecompression(void){
+	for(U32 i = 0; i < this->dictionaries_.size(); ++i){
+		dictionary_type& dictionary = *this->dictionaries_[i];
+		if(dictionary.d_dict != nullptr) continue;
+
+		dictionary.d_dict = ZSTD_createDDict(dictionary.data.data(), dictionary.data.size());
+		if(dictionary.d_dict == nullptr){
+			std::cerr << utility::timestamp("ERROR","ZSTD") << "Failed to load dictionary " << dictionary.dict_id << "..." << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ZSTDDictionaryManager::prepareCompression(const S32 compression_level){
+	for(U32 i = 0; i < this->dictionaries_.size(); ++i){
+		dictionary_type& dictionary = *this->dictionaries_[i];
+		if(dictionary.global_key >= this->lookup_[dictionary.group].size()){
+			std::cerr << utility::timestamp("ERROR","ZSTD") << "Dictionary " << dictionary.dict_id << " refers to an unknown field..." << std::endl;
+			return false;
+		}
+
+		if(dictionary.c_dict == nullptr){
+			dictionary.c_dict = ZSTD_createCDict(dictionary.data.data(), dictionary.data.size(), compression_level);
+			if(dictionary.c_dict == nullptr){
+				std::cerr << utility::timestamp("ERROR","ZSTD") << "Failed to load dictionary " << dictionary.dict_id << "..." << std::endl;
+				return false;
+			}
+		}
+		this->lookup_[dictionary.group][dictionary.global_key] = i;
+	}
+	return true;
+}
+
+const ZSTDDictionaryManager::ZSTD_CDict* ZSTDDictionaryManager::getCompressionDictionary(const TACHYON_DICTIONARY_GROUP group, const U32 global_key) const{
+	if(global_key >= this->lookup_[group].size()) return(nullptr);
+	const S32 offset = this->lookup_[group][global_key];
+	if(offset < 0) return(nullptr);
+	return(this->dictionaries_[offset]->c_dict);
+}
+
+const ZSTDDictionaryManager::ZSTD_DDict* ZSTDDictionaryManager::getDecompressionDictionary(const U32 dict_id) const{
+	for(U32 i = 0; i < this->dictionaries_.size(); ++i){
+		if(this->dictionaries_[i]->dict_id == dict_id)
+			return(this->dictionaries_[i]->d_dict);
+	}
+	return(nullptr);
+}
+
+}
+}
@@ -0,0 +1,217 @@
+#ifndef ALGORITHM_COMPRESSION_ZSTD_DICTIONARY_H_
+#define ALGORITHM_COMPRESSION_ZSTD_DICTIONARY_H_
+
+#include <vector>
+
+#include "zstd.h"
+#include "zdict.h"
+#include "../../io/basic_buffer.h"
+
+namespace tachyon{
+namespace algorithm{
+
+/**<
+ * Field groups that can be assigned a dictionary
+ */
+enum TACHYON_DICTIONARY_GROUP{
+	YON_DICTIONARY_INFO,
+	YON_DICTIONARY_FORMAT
+};
+
+/**<
+ * Trained ZSTD dictionary for a single INFO or FORMAT field.
+ * The dictionary identifier is stored in every ZSTD frame
+ * compressed with it and is used to find the dictionary
+ * again during decompression.
+ */
+struct ZSTDDictionary{
+	typedef ZSTDDictionary          self_type;
+	typedef io::BasicBuffer         buffer_type;
+	typedef struct ZSTD_CDict_s     ZSTD_CDict;
+	typedef struct ZSTD_DDict_s     ZSTD_DDict;
+
+	ZSTDDictionary() : group(YON_DICTIONARY_INFO), global_key(0), dict_id(0), c_saved(0), c_dict(nullptr), d_dict(nullptr){}
+
+	// Copies the dictionary content only: digested dictionaries
+	// have to be prepared again
+	ZSTDDictionary(const self_type& other) :
+		group(other.group),
+		global_key(other.global_key),
+		dict_id(other.dict_id),
+		c_saved(other.c_saved),
+		data(other.data.size() + 1),
+		c_dict(nullptr),
+		d_dict(nullptr)
+	{
+		this->data.Add(other.data.data(), other.data.size());
+	}
+
+	~ZSTDDictionary(){
+		ZSTD_freeCDict(this->c_dict);
+		ZSTD_freeDDict(this->d_dict);
+	}
+
+	friend io::BasicBuffer& operator<<(io::BasicBuffer& buffer, const self_type& entry){
+		buffer += (BYTE)entry.group;
+		buffer += entry.global_key;
+		buffer += entry.dict_id;
+		buffer += (U32)entry.data.size();
+		buffer.Add(entry.data.data(), entry.data.size());
+		return(buffer);
+	}
+
+	friend io::BasicBuffer& operator>>(io::BasicBuffer& buffer, self_type& entry){
+		BYTE group = 0;
+		U32 length = 0;
+		buffer >> group;
+		buffer >> entry.global_key;
+		buffer >> entry.dict_id;
+		buffer >> length;
+		entry.group = (TACHYON_DICTIONARY_GROUP)group;
+		entry.data.resize(length);
+		buffer.read(entry.data.data(), length);
+		entry.data.n_chars = length;
+		return(buffer);
+	}
+
+	TACHYON_DICTIONARY_GROUP group;
+	U32         global_key; // field identifier in the header
+	U32         dict_id;    // ZSTD dictionary identifier
+	U64         c_saved;    // bytes saved on the held-out block (import only)
+	buffer_type data;       // dictionary content
+	ZSTD_CDict* c_dict;     // digested dictionary used for compression
+	ZSTD_DDict* d_dict;     // digested dictionary used for decompression
+};
+
+/**<
+ * Trains, stores, and looks up per-field ZSTD dictionaries. Small
+ * per-block INFO and FORMAT streams compress poorly in isolation:
+ * a dictionary trained from the first blocks of a field and stored
+ * once in the file header provides the missing context.
+ *
+ * Digested dictionaries are read-only after training and can be
+ * shared between threads that each own their compression context.
+ */
+class ZSTDDictionaryManager{
+private:
+	typedef ZSTDDictionaryManager self_type;
+	typedef ZSTDDictionary        dictionary_type;
+	typedef io::BasicBuffer       buffer_type;
+	typedef struct ZSTD_CDict_s   ZSTD_CDict;
+	typedef struct ZSTD_DDict_s   ZSTD_DDict;
+
+	/**<
+	 * Training data collected for a single field
+	 */
+	struct FieldSamples{
+		FieldSamples() : n_blocks(0){}
+
+		U32 n_blocks;
+		buffer_type data;           // concatenated samples
+		std::vector<size_t> sizes;  // size of each sample
+		std::vector<size_t> blocks; // size of the data for each block
+		std::vector<U32> n_samples; // number of samples for each block
+	};
+
+public:
+	ZSTDDictionaryManager();
+	ZSTDDictionaryManager(const self_type& other);
+	~ZSTDDictionaryManager();
+	self_type& operator=(const self_type& other);
+
+	/**<
+	 * Allocate space for all fields in the header
+	 * @param n_info   Number of INFO fields
+	 * @param n_format Number of FORMAT fields
+	 */
+	void setFields(const U32 n_info, const U32 n_format);
+
+	/**<
+	 * Add the uncompressed data for a field in a block as training data.
+	 * The data is split into several samples as required by the trainer.
+	 * @param group      Field group
+	 * @param global_key Field identifier in the header
+	 * @param data       Uncompressed data
+	 */
+	void addSample(const TACHYON_DICTIONARY_GROUP group, const U32 global_key, const buffer_type& data);
+
+	/**<
+	 * Train a dictionary for every field with training data. The last
+	 * block is held out from training: a dictionary is only kept if the
+	 * bytes it saves on the held-out block, projected over the expected
+	 * number of blocks, are larger than the dictionary itself. Training
+	 * data is released afterwards.
+	 * @param compression_level ZSTD compression level
+	 * @param n_expected_blocks Expected total number of blocks in the file
+	 * @return                  Returns the number of dictionaries kept
+	 */
+	U32 train(const S32 compression_level, const double n_expected_blocks);
+
+	/**<
+	 * Prepare digested dictionaries for decompression. Called
+	 * after loading dictionaries from a file header.
+	 * @return Returns TRUE upon success or FALSE otherwise
+	 */
+	bool prepareDecompression(void);
+
+	/**<
+	 * Prepare digested dictionaries for compression and restore
+	 * the field lookup. Called after loading dictionaries from a
+	 * file header to compress additional blocks with them. The
+	 * fields have to be set beforehand.
+	 * @param compression_level ZSTD compression level
+	 * @return                  Returns TRUE upon success or FALSE otherwise
+	 */
+	bool prepareCompression(const S32 compression_level);
+
+	/**<
+	 * Add the dictionaries of another manager that are not present
+	 * in this one. Dictionaries are identified by their ZSTD
+	 * dictionary identifier. Digested dictionaries have to be
+	 * prepared again.
+	 * @param other Other manager
+	 * @return      Returns FALSE if different dictionaries share an identifier or TRUE otherwise
+	 */
+	bool merge(const self_type& other);
+
+	const ZSTD_CDict* getCompressionDictionary(const TACHYON_DICTIONARY_GROUP group, const U32 global_key) const;
+	const ZSTD_DDict* getDecompressionDictionary(const U32 dict_id) const;
+
+	inline const size_t size(void) const{ return(this->dictionaries_.size()); }
+	inline const bool empty(void) const{ return(this->dictionaries_.empty()); }
+	inline const dictionary_type& operator[](const U32 position) const{ return(*this->dictionaries_[position]); }
+
+private:
+	bool trainField(const TACHYON_DICTIONARY_GROUP group, const U32 global_key, FieldSamples& samples, const S32 compression_level, const double n_expected_blocks);
+
+	friend io::BasicBuffer& operator<<(io::BasicBuffer& buffer, const self_type& manager){
+		buffer += (U32)manager.dictionaries_.size();
+		for(U32 i = 0; i < manager.dictionaries_.size(); ++i)
+			buffer << *manager.dictionaries_[i];
+		return(buffer);
+	}
+
+	friend io::BasicBuffer& operator>>(io::BasicBuffer& buffer, self_type& manager){
+		manager.clear();
+		U32 n_dictionaries = 0;
+		buffer >> n_dictionaries;
+		for(U32 i = 0; i < n_dictionaries; ++i){
+			dictionary_type* dictionary = new dictionary_type;
+			buffer >> *dictionary;
+			manager.dictionaries_.push_back(dictionary);
+		}
+		return(buffer);
+	}
+
+	void clear(void);
+
+private:
+	std::vector<FieldSamples>     samples_[2];
+	std::vector<dictionary_type*> dictionaries_;
+	std::vector<S32>              lookup_[2]; // global key to dictionary offset
+};
+
+}
+}
+
+#endif /* ALGORITHM_COMPRESSION_ZSTD_DICTIONARY_H_ */
@@ -91,6 +91,22 @@ public:
 		return true;
 	}
 
+	// Compares finalized digests only
+	inline bool operator==(const self_type& other) const{
+		if(memcmp(&this->data_digest[0],   &other.data_digest[0],   64) != 0) return false;
+		if(memcmp(&this->stride_digest[0], &other.stride_digest[0], 64) != 0) return false;
+		return true;
+	}
+	inline bool operator!=(const self_type& other) const{ return(!(*this == other)); }
+
+	// Digests that were never computed are stored as zeroes
+	inline bool empty(void) const{
+		for(U32 i = 0; i < 64; ++i){
+			if(this->data_digest[i] || this->stride_digest[i]) return false;
+		}
+		return true;
+	}
+
 	/**<
 	 *
 	 */
@@ -174,11 +190,29 @@ public:
 		return true;
 	}
 
+	/**<
+	 * Finalize the digest of the compressed data only. The digest of
+	 * the uncompressed data is cleared to zeroes.
+	 * @return Returns TRUE upon success or FALSE otherwise
+	 */
+	inline bool finalizeCompressed(void){
+		this->uncompressed.clear();
+		return(this->compressed.finalize());
+	}
+
+	inline bool operator==(const self_type& other) const{ return(this->uncompressed == other.uncompressed && this->compressed == other.compressed); }
+	inline bool operator!=(const self_type& other) const{ return(!(*this == other)); }
+
 	void operator+=(const container_type& container){
 		this->compressed.update(container.buffer_data, container.buffer_strides, container.header.hasMixedStride());
 		this->uncompressed.update(container.buffer_data_uncompressed, container.buffer_strides_uncompressed, container.header.hasMixedStride());
 	}
 
+	// Update the digest of the compressed data only
+	inline void addCompressed(const container_type& container){
+		this->compressed.update(container.buffer_data, container.buffer_strides, container.header.hasMixedStride());
+	}
+
 private:
 	friend std::ostream& operator<<(std::ostream& stream, const self_type& entry){
 		stream << entry.compressed;
@@ -297,6 +331,18 @@ public:
 		for(U32 i = 0; i < this->size(); ++i) this->at(i).finalize();
 	}
 
+	void finalizeCompressed(void){
+		for(U32 i = 0; i < this->size(); ++i) this->at(i).finalizeCompressed();
+	}
+
+	bool operator==(const self_type& other) const{
+		if(this->size() != other.size()) return false;
+		for(U32 i = 0; i < this->size(); ++i){
+			if(this->at(i) != other.at(i)) return false;
+		}
+		return true;
+	}
+
 private:
 	friend std::ostream& operator<<(std::ostream& out, const self_type& container){
 		out.write((const char* const)reinterpret_cast<const size_type* const>(&container.n_entries_), sizeof(size_type));
@@ -384,36 +430,54 @@ public:
 		for(U32 i = 0; i < this->n_capacity_format ; ++i) this->atFORMAT(i).finalize();
 	}
 
+	/**<
+	 * Finalize the digests of the compressed data only: digests of
+	 * the uncompressed data are stored as zeroes. Used when blocks
+	 * are copied without being decompressed.
+	 */
+	void finalizeCompressed(void){
+		parent_type::finalizeCompressed();
+		for(U32 i = 0; i < this->n_capacity_info_; ++i) this->atINFO(i).finalizeCompressed();
+		for(U32 i = 0; i < this->n_capacity_format ; ++i) this->atFORMAT(i).finalizeCompressed();
+	}
+
+	/**<
+	 * Checks if the digests of the uncompressed data were computed
+	 * @return Returns TRUE if they were computed or FALSE if only the compressed data was digested
+	 */
+	bool hasUncompressed(void) const{
+		for(U32 i = 0; i < this->size(); ++i){
+			if(!this->at(i).uncompressed.empty()) return true;
+		}
+		return false;
+	}
+
+	bool operator==(const self_type& other) const{
+		if(!parent_type::operator==(other)) return false;
+		if(this->n_entries_info_ != other.n_entries_info_ || this->n_entries_format_ != other.n_entries_format_) return false;
+		for(U32 i = 0; i < this->n_entries_info_; ++i){
+			if(this->atINFO(i) != other.atINFO(i)) return false;
+		}
+		for(U32 i = 0; i < this->n_entries_format_; ++i){
+			if(this->atFORMAT(i) != other.atFORMAT(i)) return false;
+		}
+		return true;
+	}
+	inline bool operator!=(const self_type& other) const{ return(!(*this == other)); }
+
 	inline const_reference atINFO(const U32 position) const{ return(this->__entries_info[position]); }
 	inline const_reference atFORMAT(const U32 position) const{ return(this->__entries_format[position]); }
 	inline reference atINFO(const U32 position){ return(this->__entries_info[position]); }
 	inline reference atFORMAT(const U32 position){ return(this->__entries_format[position]); }
 
-	void operator+=(const variant_block_type& block){
-		this->at(1)  += block.meta_contig_container;
-		this->at(2)  += block.meta_positions_container;
-		this->at(3)  += block.meta_names_container;
-		this->at(4)  += block.meta_refalt_container;
-		this->at(5)  += block.meta_controller_container;
-		this->at(6)  += block.meta_quality_container;
-		this->at(7)  += block.meta_names_container;
-		this->at(8)  += block.meta_alleles_container;
-		this->at(9)  += block.meta_info_map_ids;
-		this->at(10) += block.meta_format_map_ids;
-		this->at(11) += block.meta_filter_map_ids;
-		this->at(12) += block.gt_support_data_container;
-		this->at(13) += block.gt_rle8_container;
-		this->at(14) += block.gt_rle16_container;
-		this->at(15) += block.gt_rle32_container;
-		this->at(16) += block.gt_rle64_container;
-		this->at(17) += block.gt_simple8_container;
-		this->at(18) += block.gt_simple16_container;
-		this->at(19) += block.gt_simple32_container;
-		this->at(20) += block.gt_simple64_container;
-
-		for(U32 i = 0; i < block.footer.n_info_streams; ++i) this->__entries_info[block.footer.info_offsets[i].data_header.global_key] += block.info_containers[i];
-		for(U32 i = 0; i < block.footer.n_format_streams; ++i) this->__entries_format[block.footer.format_offsets[i].data_header.global_key] += block.format_containers[i];
-	}
+	void operator+=(const variant_block_type& block){ this->update(block, true); }
+
+	/**<
+	 * Update the digests of the compressed data only. The block
+	 * has to be loaded but not decompressed.
+	 * @param block Target block
+	 */
+	void addCompressed(const variant_block_type& block){ this->update(block, false); }
 
 	friend std::ostream& operator<<(std::ostream& out, const self_type& container){
 		const parent_type* const parent = reinterpret_cast<const parent_type* const>(&container);
@@ -432,7 +496,9 @@ public:
 		stream >> *parent;
 
 		stream.read((char*)reinterpret_cast<size_type*>(&container.n_entries_info_), sizeof(size_type));
-		stream.read((char*)reinterpret_cast<size_type*>(&container.n_capacity_format), sizeof(size_type));
+		stream.read((char*)reinterpret_cast<size_type*>(&container.n_entries_format_), sizeof(size_type));
+		container.n_capacity_info_  = container.n_entries_info_;
+		container.n_capacity_format = container.n_entries_format_;
 
 		delete [] container.__entries_info;
 		delete [] container.__entries_format;
@@ -444,6 +510,38 @@ public:
 		return(stream);
 	}
 
+private:
+	inline void update(reference entry, const containers::DataContainer& container, const bool uncompressed){
+		if(uncompressed) entry += container;
+		else entry.addCompressed(container);
+	}
+
+	void update(const variant_block_type& block, const bool uncompressed){
+		this->update(this->at(1), block.meta_contig_container, uncompressed);
+		this->update(this->at(2), block.meta_positions_container, uncompressed);
+		this->update(this->at(3), block.meta_names_container, uncompressed);
+		this->update(this->at(4), block.meta_refalt_container, uncompressed);
+		this->update(this->at(5), block.meta_controller_container, uncompressed);
+		this->update(this->at(6), block.meta_quality_container, uncompressed);
+		this->update(this->at(7), block.meta_names_container, uncompressed);
+		this->update(this->at(8), block.meta_alleles_container, uncompressed);
+		this->update(this->at(9), block.meta_info_map_ids, uncompressed);
+		this->update(this->at(10), block.meta_format_map_ids, uncompressed);
+		this->update(this->at(11), block.meta_filter_map_ids, uncompressed);
+		this->update(this->at(12), block.gt_support_data_container, uncompressed);
+		this->update(this->at(13), block.gt_rle8_container, uncompressed);
+		this->update(this->at(14), block.gt_rle16_container, uncompressed);
+		this->update(this->at(15), block.gt_rle32_container, uncompressed);
+		this->update(this->at(16), block.gt_rle64_container, uncompressed);
+		this->update(this->at(17), block.gt_simple8_container, uncompressed);
+		this->update(this->at(18), block.gt_simple16_container, uncompressed);
+		this->update(this->at(19), block.gt_simple32_container, uncompressed);
+		this->update(this->at(20), block.gt_simple64_container, uncompressed);
+
+		for(U32 i = 0; i < block.footer.n_info_streams; ++i) this->update(this->__entries_info[block.footer.info_offsets[i].data_header.global_key], block.info_containers[i], uncompressed);
+		for(U32 i = 0; i < block.footer.n_format_streams; ++i) this->update(this->__entries_format[block.footer.format_offsets[i].data_header.global_key], block.format_containers[i], uncompressed);
+	}
+
 private:
 	size_type n_entries_info_;
 	size_type n_entries_format_;
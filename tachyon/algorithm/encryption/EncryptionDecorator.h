@@ -4,6 +4,9 @@
 #include <openssl/evp.h>
 #include <openssl/aes.h>
 #include <openssl/rand.h>
+#include <thread>
+#include <vector>
+
 #include "../../containers/variantblock.h"
 #include "../../support/enums.h"
 
@@ -247,6 +250,30 @@ public:
 		this->entries_[this->n_entries_++] = keychain;
 	}
 
+	/**<
+	 * Add the keys of another keychain. Keys are identified by the
+	 * field identifiers stored in the encrypted containers.
+	 * @param other Other keychain
+	 * @return      Returns FALSE if an identifier is already in use or TRUE otherwise
+	 */
+	bool merge(const self_type& other){
+		U32* match = nullptr;
+		for(U32 i = 0; i < other.size(); ++i){
+			U64 identifier = other[i].fieldIdentifier;
+			if(this->getHashIdentifier(identifier, match)){
+				std::cerr << utility::timestamp("ERROR", "KEYCHAIN") << "Duplicated field identifier " << identifier << "..." << std::endl;
+				return false;
+			}
+
+			if(!this->htable_identifiers_->SetItem(&identifier, this->size(), sizeof(U64))){
+				std::cerr << utility::timestamp("ERROR", "KEYCHAIN") << "Failed to add field identifier..." << std::endl;
+				return false;
+			}
+			*this += other[i];
+		}
+		return true;
+	}
+
 	void resize(const size_type new_capacity){
 		if(new_capacity < this->capacity()){
 			this->n_entries_ = new_capacity;
@@ -367,230 +394,164 @@ private:
     hash_table* htable_identifiers_;
 };
 
-class EncryptionDecorator{
+/**<
+ * Parallel support structure: this object encapsulates a thread
+ * that encrypts or decrypts data containers with a stride size of
+ * N_THREADS. Every slave owns its own cipher context and buffer
+ * such that containers can be processed independently.
+ */
+struct EncryptionSlave{
 public:
-	typedef EncryptionDecorator       self_type;
-	typedef containers::VariantBlock  variant_block_type;
+	typedef EncryptionSlave           self_type;
 	typedef containers::DataContainer stream_container;
 	typedef io::BasicBuffer           buffer_type;
 	typedef KeychainKeyGCM            aes256gcm_type;
-	typedef Keychain                  keychain_type;
 
-public:
-	bool encrypt(variant_block_type& block, keychain_type& keychain, TACHYON_ENCRYPTION encryption_type){
-		if(encryption_type == YON_ENCRYPTION_AES_256_GCM){
-			return(this->encryptAES256(block, keychain));
-		}
-		return(false);
-	}
+	struct Task{
+		Task() : container(nullptr), entry(nullptr){}
+		Task(stream_container* container, aes256gcm_type* entry) : container(container), entry(entry){}
 
-	bool decryptAES256(variant_block_type& block, keychain_type& keychain){
-		if(!this->decryptAES256(block.meta_contig_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_positions_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_refalt_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_controller_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_quality_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_names_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_rle8_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_rle16_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_rle32_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_rle64_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_alleles_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_simple8_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_simple16_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_simple32_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_simple64_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.gt_support_data_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_info_map_ids, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_filter_map_ids, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		if(!this->decryptAES256(block.meta_format_map_ids, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-
-		for(U32 i = 0; i < block.footer.n_info_streams; ++i){
-			if(!this->decryptAES256(block.info_containers[i], keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		}
-
-		for(U32 i = 0; i < block.footer.n_format_streams; ++i){
-			if(!this->decryptAES256(block.format_containers[i], keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl; return false; }
-		}
-
-		return(true);
-	}
-
-	bool encryptAES256(variant_block_type& block, keychain_type& keychain){
-		BYTE RANDOM_BYTES[32];
-		RAND_bytes(&RANDOM_BYTES[0], 32);
-		block.header.blockID = XXH64(&RANDOM_BYTES[0], 32, 1337);
-
-		if(!this->encryptAES256(block.meta_contig_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_positions_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_refalt_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_controller_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_quality_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_names_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_rle8_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_rle16_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_rle32_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_rle64_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_alleles_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_simple8_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_simple16_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_simple32_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_simple64_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.gt_support_data_container, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_info_map_ids, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_filter_map_ids, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		if(!this->encryptAES256(block.meta_format_map_ids, keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-
-		for(U32 i = 0; i < block.footer.n_info_streams; ++i){
-			if(!this->encryptAES256(block.info_containers[i], keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		}
-
-		for(U32 i = 0; i < block.footer.n_format_streams; ++i){
-			if(!this->encryptAES256(block.format_containers[i], keychain)){ std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl; return false; }
-		}
+		stream_container* container;
+		aes256gcm_type*   entry; // key of this container
+	};
+	typedef Task task_type;
 
-		return(true);
+public:
+	EncryptionSlave() : thread_idx(0), n_threads(0), encrypt(true), success(true), tasks(nullptr), ctx(EVP_CIPHER_CTX_new()), header_buffer(65536){}
+	~EncryptionSlave(){ EVP_CIPHER_CTX_free(this->ctx); }
+
+	std::thread* Start(const U32 thread_idx, const U32 n_threads, std::vector<task_type>& tasks, const bool encrypt){
+		this->thread_idx = thread_idx;
+		this->n_threads  = n_threads;
+		this->tasks      = &tasks;
+		this->encrypt    = encrypt;
+		this->success    = true;
+
+		this->thread = std::thread(&self_type::Run_, this);
+		return(&this->thread);
 	}
 
-	bool encryptAES256(stream_container& container, keychain_type& keychain){
-		KeychainKeyGCM entry;
-		entry.initiateRandom();
-		entry.encryption_type = YON_ENCRYPTION_AES_256_GCM;
-
-		EVP_CIPHER_CTX *ctx = NULL;
+	/**<
+	 * Encrypt a container with AES-256-GCM using the key and IV of
+	 * the provided entry. The header of the container is masked in
+	 * the encrypted message and the GCM tag is stored in the entry.
+	 * @param container Target container
+	 * @param entry     Keychain entry with the key, IV, and identifier
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	bool encryptAES256(stream_container& container, aes256gcm_type& entry){
 		S32 len = 0;
 
-		if(!(ctx = EVP_CIPHER_CTX_new())){
+		if(this->ctx == NULL){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the encryption context..." << std::endl;
 			return false;
 		}
 
-		if(1 != EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), NULL, NULL, NULL)){
+		// Passing the cipher resets a previously used context
+		if(1 != EVP_EncryptInit_ex(this->ctx, EVP_aes_256_gcm(), NULL, NULL, NULL)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the encryption..." << std::endl;
 			return false;
 		}
 
 		// 16 bytes = 128 bits
-		if(1 != EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, 16, NULL)){
+		if(1 != EVP_CIPHER_CTX_ctrl(this->ctx, EVP_CTRL_GCM_SET_IVLEN, 16, NULL)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the encryption tag..." << std::endl;
 			return false;
 		}
 
-		if(1 != EVP_EncryptInit_ex(ctx, NULL, NULL, entry.key, entry.iv)){
+		if(1 != EVP_EncryptInit_ex(this->ctx, NULL, NULL, entry.key, entry.iv)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the encryption key and IV..." << std::endl;
 			return false;
 		}
 
 		// Mask header in encrypted message
 		this->buffer.reset();
-		io::BasicBuffer temp(65536);
-		temp << container.header;
-		this->buffer.resize(container.buffer_data.size() + container.buffer_strides.size() + temp.size() + 65536);
+		this->header_buffer.reset();
+		this->header_buffer << container.header;
+		this->buffer.resize(container.buffer_data.size() + container.buffer_strides.size() + this->header_buffer.size() + 65536);
 
-		if(1 != EVP_EncryptUpdate(ctx, (BYTE*)this->buffer.data(), &len, (BYTE*)temp.data(), temp.size())){
+		if(1 != EVP_EncryptUpdate(this->ctx, (BYTE*)this->buffer.data(), &len, (BYTE*)this->header_buffer.data(), this->header_buffer.size())){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to update the encryption model..." << std::endl;
 			return false;
 		}
 		this->buffer.n_chars = len;
 
-		if(1 != EVP_EncryptUpdate(ctx, (BYTE*)&this->buffer[this->buffer.n_chars], &len, (BYTE*)container.buffer_data.data(), container.buffer_data.size())){
+		if(1 != EVP_EncryptUpdate(this->ctx, (BYTE*)&this->buffer[this->buffer.n_chars], &len, (BYTE*)container.buffer_data.data(), container.buffer_data.size())){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to update the encryption model..." << std::endl;
 			return false;
 		}
 		this->buffer.n_chars += len;
 
-		if(1 != EVP_EncryptUpdate(ctx, (BYTE*)&this->buffer[this->buffer.n_chars], &len, (BYTE*)container.buffer_strides.data(), container.buffer_strides.size())){
+		if(1 != EVP_EncryptUpdate(this->ctx, (BYTE*)&this->buffer[this->buffer.n_chars], &len, (BYTE*)container.buffer_strides.data(), container.buffer_strides.size())){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to update the encryption model..." << std::endl;
 			return false;
 		}
 		this->buffer.n_chars += len;
 
-		if(1 != EVP_EncryptFinal_ex(ctx, (BYTE*)this->buffer.data() + len, &len)){
+		if(1 != EVP_EncryptFinal_ex(this->ctx, (BYTE*)&this->buffer[this->buffer.n_chars], &len)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to finalise the encryption..." << std::endl;
 			return false;
 		}
 		this->buffer.n_chars += len;
 
-		container.buffer_data.resize(this->buffer.size());
-		if(1 != EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, 16, &entry.tag[0])){
+		if(1 != EVP_CIPHER_CTX_ctrl(this->ctx, EVP_CTRL_GCM_GET_TAG, 16, &entry.tag[0])){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to retrieve the GCM tag..." << std::endl;
 			return false;
 		}
 
-		EVP_CIPHER_CTX_free(ctx);
-
 		// Trigger encryption flag
 		container.header.reset(); // reset data
 		container.header.data_header.controller.encryption = YON_ENCRYPTION_AES_256_GCM;
+		container.buffer_data.resize(this->buffer.size());
 		memcpy(container.buffer_data.data(), this->buffer.data(), this->buffer.size());
 		container.buffer_data.n_chars = this->buffer.size();
 		container.header.data_header.eLength = this->buffer.size();
-
-		const U64 hashID = keychain.getRandomHashIdentifier();
-		container.header.identifier = hashID;
-		entry.fieldIdentifier = hashID;
-		keychain += entry; // add key to keychain
+		container.header.identifier = entry.fieldIdentifier;
 
 		return(true);
 	}
 
-	bool decryptAES256(stream_container& container, keychain_type& keychain){
-		if(container.buffer_data.size() == 0)
-			return true;
-
-		if(container.header.data_header.controller.encryption == YON_ENCRYPTION_NONE)
-			return true;
-
-		if(container.header.data_header.controller.encryption != YON_ENCRYPTION_AES_256_GCM){
-			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Wrong decryption algorithm used..." << std::endl;
-			return false;
-		}
-
-		U32* match = nullptr;
-		if(keychain.getHashIdentifier(container.header.identifier, match) == false){
-			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Did not find ID in keychain..." << std::endl;
-			return false;
-		}
-		KeychainKeyGCM& entry = keychain[*match];
-
-		EVP_CIPHER_CTX *ctx = NULL;
-		S32 len = 0, plaintext_len = 0, ret;
-
-		/* Create and initialise the context */
-		if(!(ctx = EVP_CIPHER_CTX_new())){
+	/**<
+	 * Decrypt a container encrypted with AES-256-GCM and unmask its
+	 * header. The GCM tag of the entry has to validate the message.
+	 * @param container Target container
+	 * @param entry     Keychain entry of the container
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	bool decryptAES256(stream_container& container, const aes256gcm_type& entry){
+		S32 len = 0, ret;
+
+		if(this->ctx == NULL){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the encryption context..." << std::endl;
 			return(false);
 		}
 
 		/* Initialise the decryption operation. */
-		if(!EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), NULL, NULL, NULL)){
+		if(!EVP_DecryptInit_ex(this->ctx, EVP_aes_256_gcm(), NULL, NULL, NULL)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the decryption..." << std::endl;
 			return(false);
 		}
 
-		if(!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, 16, NULL)){
+		if(!EVP_CIPHER_CTX_ctrl(this->ctx, EVP_CTRL_GCM_SET_IVLEN, 16, NULL)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the IV context..." << std::endl;
 			return(false);
 		}
 
 		/* Initialise key and IV */
-		if(!EVP_DecryptInit_ex(ctx, NULL, NULL, entry.key, entry.iv)){
+		if(!EVP_DecryptInit_ex(this->ctx, NULL, NULL, entry.key, entry.iv)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to initialise the decryption..." << std::endl;
 			return(false);
 		}
 
 		this->buffer.reset();
-		if(container.buffer_data.size()){
-			this->buffer.resize(container.buffer_data.size() + 65536);
-			if(!EVP_DecryptUpdate(ctx, (BYTE*)this->buffer.data(), &len, (BYTE*)container.buffer_data.data(), container.buffer_data.size())){
-				std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to update the decryption..." << std::endl;
-				return(false);
-			}
-			plaintext_len = len;
+		this->buffer.resize(container.buffer_data.size() + 65536);
+		if(!EVP_DecryptUpdate(this->ctx, (BYTE*)this->buffer.data(), &len, (BYTE*)container.buffer_data.data(), container.buffer_data.size())){
+			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to update the decryption..." << std::endl;
+			return(false);
 		}
 
 		/* Set expected tag value. Works in OpenSSL 1.0.1d and later */
-		if(!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, 16, entry.tag)){
+		if(!EVP_CIPHER_CTX_ctrl(this->ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)entry.tag)){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to set expected TAG value..." << std::endl;
 			return(false);
 		}
@@ -598,33 +559,306 @@ public:
 		/* Finalise the decryption. A positive return value indicates success,
 		 * anything else is a failure - the plaintext is not trustworthy.
 		 */
-		ret = EVP_DecryptFinal_ex(ctx, (BYTE*)this->buffer.data() + len, &len);
-		EVP_CIPHER_CTX_free(ctx);
-
-		if(ret > 0){
-			plaintext_len += len;
-			this->buffer >> container.header; // unmask encrypted header
-
-			container.buffer_data.reset();
-			container.buffer_strides.reset();
-			container.buffer_data.resize(container.header.data_header.cLength + 65536);
-			container.buffer_strides.resize(container.header.stride_header.cLength + 65536);
-			memcpy(container.buffer_data.data(), &this->buffer[this->buffer.iterator_position_], container.header.data_header.cLength);
-			memcpy(container.buffer_strides.data(), &this->buffer[this->buffer.iterator_position_ + container.header.data_header.cLength], container.header.stride_header.cLength);
-			container.header.data_header.controller.encryption = YON_ENCRYPTION_NONE;
-			container.buffer_data.n_chars = container.header.data_header.cLength;
-			container.buffer_strides.n_chars = container.header.stride_header.cLength;
-			container.header.data_header.eLength = 0;
-			return(true);
-		} else {
+		ret = EVP_DecryptFinal_ex(this->ctx, (BYTE*)this->buffer.data() + len, &len);
+		if(ret <= 0){
 			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Failed to validate decryption..." << std::endl;
 			return(false);
 		}
+
+		this->buffer >> container.header; // unmask encrypted header
+
+		container.buffer_data.reset();
+		container.buffer_strides.reset();
+		container.buffer_data.resize(container.header.data_header.cLength + 65536);
+		container.buffer_strides.resize(container.header.stride_header.cLength + 65536);
+		memcpy(container.buffer_data.data(), &this->buffer[this->buffer.iterator_position_], container.header.data_header.cLength);
+		memcpy(container.buffer_strides.data(), &this->buffer[this->buffer.iterator_position_ + container.header.data_header.cLength], container.header.stride_header.cLength);
+		container.header.data_header.controller.encryption = YON_ENCRYPTION_NONE;
+		container.buffer_data.n_chars = container.header.data_header.cLength;
+		container.buffer_strides.n_chars = container.header.stride_header.cLength;
+		container.header.data_header.eLength = 0;
+		return(true);
 	}
 
+private:
+	EncryptionSlave(const self_type& other);
+	self_type& operator=(const self_type& other);
+
+	void Run_(void){
+		for(U32 i = this->thread_idx; i < this->tasks->size(); i += this->n_threads){
+			const task_type& task = (*this->tasks)[i];
+			const bool ok = this->encrypt ? this->encryptAES256(*task.container, *task.entry)
+			                              : this->decryptAES256(*task.container, *task.entry);
+			if(!ok) this->success = false;
+		}
+	}
 
 public:
+	U32  thread_idx;
+	U32  n_threads;
+	bool encrypt;
+	bool success;
+	std::vector<task_type>* tasks;
+	EVP_CIPHER_CTX* ctx;
 	buffer_type buffer;
+	buffer_type header_buffer;
+	std::thread thread;
+};
+
+class EncryptionDecorator{
+public:
+	typedef EncryptionDecorator       self_type;
+	typedef containers::VariantBlock  variant_block_type;
+	typedef containers::DataContainer stream_container;
+	typedef core::DataBlockSettings   settings_type;
+	typedef io::BasicBuffer           buffer_type;
+	typedef KeychainKeyGCM            aes256gcm_type;
+	typedef Keychain                  keychain_type;
+	typedef EncryptionSlave           slave_type;
+	typedef slave_type::task_type     task_type;
+
+public:
+	EncryptionDecorator() : n_threads_(1), slaves_(new slave_type[1]){}
+	~EncryptionDecorator(){ delete [] this->slaves_; }
+
+	/**<
+	 * Set the number of threads used to encrypt or decrypt the
+	 * containers of a block. Every container has its own key and
+	 * IV so the output does not depend on the number of threads.
+	 * @param n_threads Number of threads
+	 */
+	void setThreads(const U32 n_threads){
+		delete [] this->slaves_;
+		this->n_threads_ = (n_threads == 0 ? 1 : n_threads);
+		this->slaves_    = new slave_type[this->n_threads_];
+	}
+
+	bool encrypt(variant_block_type& block, keychain_type& keychain, TACHYON_ENCRYPTION encryption_type){
+		if(encryption_type == YON_ENCRYPTION_AES_256_GCM){
+			return(this->encryptAES256(block, keychain));
+		}
+		return(false);
+	}
+
+	/**<
+	 * Decrypt every container of a block
+	 * @param block    Target block
+	 * @param keychain Keychain with the keys of the block
+	 * @return         Returns TRUE upon success or FALSE otherwise
+	 */
+	bool decryptAES256(variant_block_type& block, keychain_type& keychain){
+		std::vector<stream_container*> containers;
+		this->gatherContainers(block, containers);
+		return(this->decryptAES256(containers, keychain));
+	}
+
+	/**<
+	 * Decrypt the containers of a block that are loaded with the
+	 * provided settings. Other containers are left untouched.
+	 * @param block    Target block
+	 * @param keychain Keychain with the keys of the block
+	 * @param settings Settings used to read the block
+	 * @return         Returns TRUE upon success or FALSE otherwise
+	 */
+	bool decryptAES256(variant_block_type& block, keychain_type& keychain, const settings_type& settings){
+		std::vector<stream_container*> containers;
+		this->gatherContainers(block, settings, containers);
+		return(this->decryptAES256(containers, keychain));
+	}
+
+	bool encryptAES256(variant_block_type& block, keychain_type& keychain){
+		BYTE RANDOM_BYTES[32];
+		RAND_bytes(&RANDOM_BYTES[0], 32);
+		block.header.blockID = XXH64(&RANDOM_BYTES[0], 32, 1337);
+
+		std::vector<stream_container*> containers;
+		this->gatherContainers(block, containers);
+
+		// Keys are added to the keychain in container order before
+		// any work is started: the keychain is not thread-safe
+		const U32 first_key = keychain.size();
+		for(U32 i = 0; i < containers.size(); ++i){
+			aes256gcm_type entry;
+			entry.initiateRandom();
+			entry.encryption_type = YON_ENCRYPTION_AES_256_GCM;
+			entry.fieldIdentifier = keychain.getRandomHashIdentifier();
+			if(entry.fieldIdentifier == 0){
+				std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl;
+				return false;
+			}
+			keychain += entry; // add key to keychain
+		}
+
+		std::vector<task_type> tasks(containers.size());
+		for(U32 i = 0; i < containers.size(); ++i)
+			tasks[i] = task_type(containers[i], &keychain[first_key + i]);
+
+		if(!this->run(tasks, true)){
+			std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to encrypt!" << std::endl;
+			return false;
+		}
+		return(true);
+	}
+
+	bool encryptAES256(stream_container& container, keychain_type& keychain){
+		aes256gcm_type entry;
+		entry.initiateRandom();
+		entry.encryption_type = YON_ENCRYPTION_AES_256_GCM;
+		entry.fieldIdentifier = keychain.getRandomHashIdentifier();
+		if(!this->slaves_[0].encryptAES256(container, entry))
+			return false;
+
+		keychain += entry; // add key to keychain
+		return(true);
+	}
+
+	bool decryptAES256(stream_container& container, keychain_type& keychain){
+		const aes256gcm_type* entry = nullptr;
+		if(!this->findKey(container, keychain, entry)) return false;
+		if(entry == nullptr) return true;
+		return(this->slaves_[0].decryptAES256(container, *entry));
+	}
+
+private:
+	EncryptionDecorator(const self_type& other);
+	self_type& operator=(const self_type& other);
+
+	/**<
+	 * Find the key of an encrypted container. Containers that are
+	 * empty or not encrypted have no key.
+	 * @param container Target container
+	 * @param keychain  Keychain with the keys of the block
+	 * @param entry     Key of the container or nullptr if it has none
+	 * @return          Returns FALSE if the key is missing or TRUE otherwise
+	 */
+	bool findKey(const stream_container& container, keychain_type& keychain, const aes256gcm_type*& entry) const{
+		entry = nullptr;
+		if(container.buffer_data.size() == 0)
+			return true;
+
+		if(container.header.data_header.controller.encryption == YON_ENCRYPTION_NONE)
+			return true;
+
+		if(container.header.data_header.controller.encryption != YON_ENCRYPTION_AES_256_GCM){
+			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Wrong decryption algorithm used..." << std::endl;
+			return false;
+		}
+
+		U32* match = nullptr;
+		if(keychain.getHashIdentifier(container.header.identifier, match) == false){
+			std::cerr << utility::timestamp("ERROR", "ENCRYPTION") << "Did not find ID in keychain..." << std::endl;
+			return false;
+		}
+		entry = &keychain[*match];
+		return true;
+	}
+
+	bool decryptAES256(const std::vector<stream_container*>& containers, keychain_type& keychain){
+		// Keys are looked up before any work is started
+		std::vector<task_type> tasks;
+		tasks.reserve(containers.size());
+		for(U32 i = 0; i < containers.size(); ++i){
+			const aes256gcm_type* entry = nullptr;
+			if(!this->findKey(*containers[i], keychain, entry)){
+				std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl;
+				return false;
+			}
+			if(entry != nullptr) tasks.push_back(task_type(containers[i], const_cast<aes256gcm_type*>(entry)));
+		}
+
+		if(!this->run(tasks, false)){
+			std::cerr << utility::timestamp("ERROR","ENCRYPTION") << "Failed to decrypt!" << std::endl;
+			return false;
+		}
+		return(true);
+	}
+
+	bool run(std::vector<task_type>& tasks, const bool encrypt){
+		// Single-threaded
+		if(this->n_threads_ <= 1 || tasks.size() <= 1){
+			for(U32 i = 0; i < tasks.size(); ++i){
+				const bool ok = encrypt ? this->slaves_[0].encryptAES256(*tasks[i].container, *tasks[i].entry)
+				                        : this->slaves_[0].decryptAES256(*tasks[i].container, *tasks[i].entry);
+				if(!ok) return false;
+			}
+			return true;
+		}
+
+		// Multi-threaded: each slave processes every N-th container
+		const U32 n_threads = tasks.size() < this->n_threads_ ? tasks.size() : this->n_threads_;
+		std::vector<std::thread*> threads(n_threads);
+		for(U32 i = 0; i < n_threads; ++i) threads[i] = this->slaves_[i].Start(i, n_threads, tasks, encrypt);
+		for(U32 i = 0; i < n_threads; ++i) threads[i]->join();
+
+		for(U32 i = 0; i < n_threads; ++i){
+			if(!this->slaves_[i].success) return false;
+		}
+		return true;
+	}
+
+	void gatherContainers(variant_block_type& block, std::vector<stream_container*>& containers) const{
+		stream_container* const base[] = {
+			&block.meta_contig_container, &block.meta_positions_container, &block.meta_refalt_container,
+			&block.meta_controller_container, &block.meta_quality_container, &block.meta_names_container,
+			&block.gt_rle8_container, &block.gt_rle16_container, &block.gt_rle32_container, &block.gt_rle64_container,
+			&block.meta_alleles_container, &block.gt_simple8_container, &block.gt_simple16_container,
+			&block.gt_simple32_container, &block.gt_simple64_container, &block.gt_support_data_container,
+			&block.meta_info_map_ids, &block.meta_filter_map_ids, &block.meta_format_map_ids};
+
+		containers.assign(&base[0], &base[0] + sizeof(base)/sizeof(stream_container*));
+		for(U32 i = 0; i < block.footer.n_info_streams; ++i)   containers.push_back(&block.info_containers[i]);
+		for(U32 i = 0; i < block.footer.n_format_streams; ++i) containers.push_back(&block.format_containers[i]);
+	}
+
+	// Mirrors the containers loaded by VariantBlock::read
+	void gatherContainers(variant_block_type& block, const settings_type& settings, std::vector<stream_container*>& containers) const{
+		containers.clear();
+		if(settings.load_contig)     containers.push_back(&block.meta_contig_container);
+		if(settings.load_positons)   containers.push_back(&block.meta_positions_container);
+		if(settings.load_controller) containers.push_back(&block.meta_controller_container);
+		if(settings.load_quality)    containers.push_back(&block.meta_quality_container);
+		if(settings.load_names)      containers.push_back(&block.meta_names_container);
+		if(settings.load_alleles){
+			containers.push_back(&block.meta_refalt_container);
+			containers.push_back(&block.meta_alleles_container);
+		}
+		if(settings.load_genotypes_rle){
+			containers.push_back(&block.gt_rle8_container);
+			containers.push_back(&block.gt_rle16_container);
+			containers.push_back(&block.gt_rle32_container);
+			containers.push_back(&block.gt_rle64_container);
+		}
+		if(settings.load_genotypes_simple){
+			containers.push_back(&block.gt_simple8_container);
+			containers.push_back(&block.gt_simple16_container);
+			containers.push_back(&block.gt_simple32_container);
+			containers.push_back(&block.gt_simple64_container);
+		}
+		if(settings.load_genotypes_support) containers.push_back(&block.gt_support_data_container);
+		if(settings.load_set_membership){
+			containers.push_back(&block.meta_info_map_ids);
+			containers.push_back(&block.meta_filter_map_ids);
+			containers.push_back(&block.meta_format_map_ids);
+		}
+
+		if(settings.load_info){
+			for(U32 i = 0; i < block.footer.n_info_streams; ++i) containers.push_back(&block.info_containers[i]);
+		} else {
+			for(U32 i = 0; i < settings.load_info_ID_loaded.size(); ++i)
+				containers.push_back(&block.info_containers[settings.load_info_ID_loaded[i].iterator_index]);
+		}
+
+		if(settings.load_format){
+			for(U32 i = 0; i < block.footer.n_format_streams; ++i) containers.push_back(&block.format_containers[i]);
+		} else {
+			for(U32 i = 0; i < settings.load_format_ID_loaded.size(); ++i)
+				containers.push_back(&block.format_containers[settings.load_format_ID_loaded[i].iterator_index]);
+		}
+	}
+
+private:
+	U32         n_threads_;
+	slave_type* slaves_;
 };
 
 }
@@ -0,0 +1,114 @@
+#ifndef ALGORITHM_MEMORY_BUDGET_H_
+#define ALGORITHM_MEMORY_BUDGET_H_
+
+#include <mutex>
+#include <condition_variable>
+
+#include "../support/type_definitions.h"
+
+namespace tachyon{
+namespace algorithm{
+
+/**<
+ * Byte-counting gate shared between the stages of a multi-threaded
+ * pipeline. Producers acquire the number of bytes they expect to
+ * hold before loading data and block while this would exceed the
+ * limit. Consumers release the bytes once the data has been
+ * retired. A request is always granted if nothing is held such that
+ * a single unit of work larger than the limit cannot deadlock the
+ * pipeline. Bytes held by a stage that waits for further units
+ * before it can retire them are deferred: they cannot be released
+ * until the producer continues, so requests are also granted while
+ * only deferred bytes are held. A limit of 0 disables the gate.
+ */
+class MemoryBudget{
+private:
+	typedef MemoryBudget self_type;
+
+public:
+	MemoryBudget() : n_limit_(0), n_used_(0), n_deferred_(0), n_peak_(0){}
+	explicit MemoryBudget(const U64 limit) : n_limit_(limit), n_used_(0), n_deferred_(0), n_peak_(0){}
+	~MemoryBudget(){}
+
+	inline void setLimit(const U64 limit){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->n_limit_ = limit;
+	}
+
+	/**<
+	 * Reserve `bytes` from the budget. Blocks while the bytes
+	 * currently held plus the request would exceed the limit and
+	 * some of the bytes held are not deferred.
+	 * @param bytes Number of bytes
+	 */
+	void acquire(const U64 bytes){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->cv_released_.wait(lock, [this, bytes]{ return(this->n_limit_ == 0 || this->n_used_ <= this->n_deferred_ || this->n_used_ + bytes <= this->n_limit_); });
+		this->charge(bytes);
+	}
+
+	/**<
+	 * Reserve `bytes` from the budget without blocking. Used to
+	 * account for data that is already in memory.
+	 * @param bytes Number of bytes
+	 */
+	void force(const U64 bytes){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->charge(bytes);
+	}
+
+	/**<
+	 * Return `bytes` to the budget and wake up any blocked
+	 * producers.
+	 * @param bytes Number of bytes
+	 */
+	void release(const U64 bytes){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->n_used_ = (bytes > this->n_used_ ? 0 : this->n_used_ - bytes);
+		lock.unlock();
+		this->cv_released_.notify_all();
+	}
+
+	/**<
+	 * Mark `bytes` that are held as deferred: they are retained
+	 * until more units arrive and wake up any blocked producers.
+	 * @param bytes Number of bytes
+	 */
+	void defer(const U64 bytes){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->n_deferred_ += bytes;
+		lock.unlock();
+		this->cv_released_.notify_all();
+	}
+
+	/**<
+	 * Return deferred bytes to the bytes that are retired normally
+	 * @param bytes Number of bytes
+	 */
+	void resume(const U64 bytes){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->n_deferred_ = (bytes > this->n_deferred_ ? 0 : this->n_deferred_ - bytes);
+	}
+
+	inline const U64& limit(void) const{ return(this->n_limit_); }
+	inline const U64& peak(void) const{ return(this->n_peak_); }
+
+private:
+	inline void charge(const U64 bytes){
+		this->n_used_ += bytes;
+		if(this->n_used_ > this->n_peak_) this->n_peak_ = this->n_used_;
+	}
+
+private:
+	U64                     n_limit_; // maximum number of bytes held
+	U64                     n_used_;  // number of bytes currently held
+	U64                     n_deferred_; // bytes held until more units arrive
+	U64                     n_peak_;  // largest number of bytes held at once
+	std::mutex              mutex_;
+	std::condition_variable cv_released_;
+};
+
+}
+}
+
+#endif /* ALGORITHM_MEMORY_BUDGET_H_ */
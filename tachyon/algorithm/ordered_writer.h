@@ -0,0 +1,122 @@
+#ifndef ALGORITHM_ORDERED_WRITER_H_
+#define ALGORITHM_ORDERED_WRITER_H_
+
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+#include <ostream>
+
+#include "../io/basic_buffer.h"
+
+namespace tachyon{
+namespace algorithm{
+
+/**<
+ * Writes the output buffers of units of work that complete out of
+ * order to a stream in their original order. Producers acquire the
+ * buffer of unit `i`, fill it, and release it. Releasing a unit
+ * writes every consecutive completed unit starting at the next one
+ * to be written. At most `window` units beyond the next unit to be
+ * written can be held at any time: producers that run ahead block
+ * until the window moves. The unit at the start of the window can
+ * always be acquired, so the writer cannot deadlock as long as units
+ * are handed out in increasing order. A producer that fails closes
+ * the writer at its unit: units before it are still written in full.
+ */
+class OrderedWriter{
+private:
+	typedef OrderedWriter   self_type;
+	typedef io::BasicBuffer buffer_type;
+
+public:
+	OrderedWriter(std::ostream& stream, const U32 window) :
+		n_limit_(std::numeric_limits<U64>::max()),
+		n_window_(window == 0 ? 1 : window),
+		n_next_(0),
+		stream_(stream),
+		ready_(new bool[this->n_window_]),
+		buffers_(new buffer_type[this->n_window_])
+	{
+		for(U32 i = 0; i < this->n_window_; ++i)
+			this->ready_[i] = false;
+	}
+
+	~OrderedWriter(){
+		delete [] this->ready_;
+		delete [] this->buffers_;
+	}
+
+	/**<
+	 * Acquire the output buffer of unit `index`. Blocks while the
+	 * unit is outside the window.
+	 * @param index  Unit number
+	 * @param buffer Output buffer of the unit
+	 * @return       Returns TRUE upon success or FALSE if the writer is closed at or before the unit
+	 */
+	bool acquire(const U64 index, buffer_type*& buffer){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->cv_window_.wait(lock, [this, index]{ return(index >= this->n_limit_ || index < this->n_next_ + this->n_window_); });
+		if(index >= this->n_limit_) return false;
+
+		buffer = &this->buffers_[index % this->n_window_];
+		buffer->reset();
+		return true;
+	}
+
+	/**<
+	 * Mark unit `index` as completed and write all consecutive
+	 * completed units to the stream
+	 * @param index Unit number
+	 */
+	void release(const U64 index){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->ready_[index % this->n_window_] = true;
+
+		bool moved = false;
+		while(this->n_next_ < this->n_limit_ && this->ready_[this->n_next_ % this->n_window_]){
+			buffer_type& buffer = this->buffers_[this->n_next_ % this->n_window_];
+			this->stream_.write(buffer.data(), buffer.size());
+			this->ready_[this->n_next_ % this->n_window_] = false;
+			++this->n_next_;
+			moved = true;
+		}
+
+		if(moved){
+			this->stream_.flush();
+			lock.unlock();
+			this->cv_window_.notify_all();
+		}
+	}
+
+	/**<
+	 * Stop accepting units from `index` onwards and wake up all
+	 * blocked producers. Units before `index` are still written
+	 * when they are released; later units are discarded.
+	 * @param index First unit that will not be written
+	 */
+	void close(const U64 index = 0){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->n_limit_ = std::min(this->n_limit_, index);
+		lock.unlock();
+		this->cv_window_.notify_all();
+	}
+
+	// Number of units written so far
+	inline const U64& written(void) const{ return(this->n_next_); }
+
+private:
+	U64                     n_limit_; // first unit that will not be written
+	U32                     n_window_;
+	U64                     n_next_; // next unit to be written
+	std::ostream&           stream_;
+	bool*                   ready_;
+	buffer_type*            buffers_;
+	std::mutex              mutex_;
+	std::condition_variable cv_window_;
+};
+
+}
+}
+
+#endif /* ALGORITHM_ORDERED_WRITER_H_ */
@@ -55,6 +55,17 @@ private:
 		return(stream);
 	}
 
+	friend buffer_type& operator>>(buffer_type& buffer, self_type& manager){
+		buffer >> manager.n_samples;
+		buffer >> manager.u_length;
+		buffer >> manager.c_length;
+		buffer >> manager.crc;
+		manager.PPA.resize(manager.u_length);
+		buffer.read(manager.PPA.buffer, manager.c_length);
+		manager.PPA.n_chars = manager.c_length;
+		return(buffer);
+	}
+
 public:
 	U32 n_samples; // redundancy but convenient
 	U32 u_length;
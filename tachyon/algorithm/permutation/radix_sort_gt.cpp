@@ -1,24 +1,54 @@
-#include <bitset>
+#include <vector>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
 #include "radix_sort_gt.h"
 
 namespace tachyon {
 namespace algorithm {
 
+// Genotype encodings use 2 bits for each allele:
+// ref -> 00b, alt -> 01b, missing -> 10b. The 4-bit
+// code of a sample is (second << 2) | first and maps
+// to a radix bin:
+//
+// 0/0 -> 0000b = 0 -> 0
+// 1/0 -> 0001b = 1 -> 3
+// ./0 -> 0010b = 2 -> 4
+// 0/1 -> 0100b = 4 -> 2
+// 1/1 -> 0101b = 5 -> 1
+// ./1 -> 0110b = 6 -> 5
+// 0/. -> 1000b = 8 -> 6
+// 1/. -> 1001b = 9 -> 7
+// ./. -> 1010b = 10 -> 8
+//
+// Haploid samples have the code 11b for the second
+// allele:
+//
+// 0   -> 1100b = 12 -> 9
+// 1   -> 1101b = 13 -> 10
+// .   -> 1110b = 14 -> 11
+const BYTE YON_RADIX_GT_BIN_LOOKUP[16] = {0,3,4,0, 2,1,5,0, 6,7,8,0, 9,10,11,0};
+
 RadixSortGT::RadixSortGT() :
 	n_samples(0),
 	position(0),
+	n_threads(1),
 	GT_array(nullptr),
-	bins(new U32*[9]),
-	manager(nullptr)
+	keys(nullptr),
+	sorted(nullptr),
+	ranges(new Range[1]),
+	manager(nullptr),
+	profiler(nullptr)
 {
-	for(U32 i = 0; i < 9; ++i) bins[i] = nullptr;
-	memset(&p_i, 0, sizeof(U32)*9);
 }
 
 RadixSortGT::~RadixSortGT(){
 	delete [] this->GT_array;
-	for(U32 i = 0; i < 9; ++i) delete [] this->bins[i];
-	delete [] this->bins;
+	delete [] this->keys;
+	delete [] this->sorted;
+	delete [] this->ranges;
 }
 
 void RadixSortGT::setSamples(const U64 n_samples){
@@ -26,25 +56,29 @@ void RadixSortGT::setSamples(const U64 n_samples){
 
 	// Delete previous
 	delete [] this->GT_array;
+	delete [] this->keys;
+	delete [] this->sorted;
 
 	// Set new
-	this->GT_array = new BYTE[this->n_samples];
+	this->GT_array = new BYTE[(this->n_samples + 1) / 2];
+	this->keys     = new BYTE[this->n_samples];
+	this->sorted   = new U32[this->n_samples];
 
 	// Reset
-	for(U32 i = 0; i < 9; ++i){
-		this->bins[i] = new U32[n_samples];
-		memset(this->bins[i], 0, sizeof(U32)*n_samples);
-	}
-	memset(this->GT_array, 0, sizeof(BYTE)*n_samples);
+	memset(this->GT_array, 0, sizeof(BYTE)*((n_samples + 1) / 2));
 
 	this->manager->setSamples(n_samples);
 	this->manager->setSamples(n_samples*2);
 }
 
+void RadixSortGT::setThreads(const U32 n_threads){
+	this->n_threads = (n_threads == 0 ? 1 : n_threads);
+	delete [] this->ranges;
+	this->ranges = new Range[this->n_threads];
+}
+
 void RadixSortGT::reset(void){
 	this->position = 0;
-	memset(this->GT_array, 0, sizeof(BYTE)*n_samples);
-	memset(&p_i, 0, sizeof(U32)*9);
 	this->manager->reset();
 }
 
@@ -60,6 +94,84 @@ bool RadixSortGT::build(const bcf_reader_type& reader){
 	return(true);
 }
 
+void RadixSortGT::pack(const BYTE* data){
+	U32 i = 0;
+
+#if defined(__SSSE3__)
+	// Classify 16 samples (32 genotype values) per iteration
+	const __m128i mask_index = _mm_set1_epi8(0x7F);
+	const __m128i mask_low   = _mm_set1_epi16(0x00FF);
+	const __m128i weights    = _mm_set1_epi16(0x0401); // first allele * 1 + second allele * 4
+	const __m128i allele_lookup = _mm_setr_epi8(2,0,1,0, 0,0,0,0, 0,0,0,0, 0,0,0,0);
+	const __m128i bin_lookup    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(YON_RADIX_GT_BIN_LOOKUP));
+
+	for(; i + 16 <= this->n_samples; i += 16){
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[2*i]));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[2*i + 16]));
+
+		// BCF genotype value to 2-bit allele code
+		a = _mm_shuffle_epi8(allele_lookup, _mm_and_si128(_mm_srli_epi16(a, 1), mask_index));
+		b = _mm_shuffle_epi8(allele_lookup, _mm_and_si128(_mm_srli_epi16(b, 1), mask_index));
+
+		// Pairs of allele codes to 4-bit genotype codes to radix bins
+		a = _mm_maddubs_epi16(a, weights);
+		b = _mm_maddubs_epi16(b, weights);
+		__m128i bins = _mm_shuffle_epi8(bin_lookup, _mm_packus_epi16(a, b));
+
+		// Two bins per byte: the low nibble is the even sample
+		bins = _mm_and_si128(_mm_or_si128(bins, _mm_srli_epi16(bins, 4)), mask_low);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&this->GT_array[i >> 1]), _mm_packus_epi16(bins, bins));
+	}
+#endif
+
+	for(; i < this->n_samples; ++i){
+		const BYTE code = (bcf::BCF_UNPACK_GENOTYPE(data[2*i + 1]) << 2) | bcf::BCF_UNPACK_GENOTYPE(data[2*i]);
+		const BYTE bin  = YON_RADIX_GT_BIN_LOOKUP[code];
+		if(i & 1) this->GT_array[i >> 1] |= bin << 4;
+		else      this->GT_array[i >> 1]  = bin;
+	}
+}
+
+void RadixSortGT::packHaploid(const BYTE* data, const BYTE ploidy){
+	for(U32 i = 0; i < this->n_samples; ++i){
+		BYTE second = 3;
+		if(ploidy == 2 && data[2*i + 1] != 0x81)
+			second = bcf::BCF_UNPACK_GENOTYPE(data[2*i + 1]);
+
+		const BYTE code = (second << 2) | bcf::BCF_UNPACK_GENOTYPE(data[ploidy*i]);
+		const BYTE bin  = YON_RADIX_GT_BIN_LOOKUP[code];
+		if(i & 1) this->GT_array[i >> 1] |= bin << 4;
+		else      this->GT_array[i >> 1]  = bin;
+	}
+}
+
+void RadixSortGT::count(const U32 i){
+	Range& range = this->ranges[i];
+	memset(range.counts, 0, sizeof(U32)*YON_RADIX_GT_BINS);
+
+	const U32* ppa = this->manager->get();
+	for(U32 j = range.begin; j < range.end; ++j){
+		const BYTE bin = this->getBin(ppa[j]);
+		this->keys[j] = bin;
+		++range.counts[bin];
+	}
+}
+
+void RadixSortGT::scatter(const U32 i){
+	Range& range = this->ranges[i];
+	const U32* ppa = this->manager->get();
+	for(U32 j = range.begin; j < range.end; ++j)
+		this->sorted[range.counts[this->keys[j]]++] = ppa[j];
+}
+
+void RadixSortGT::runWorker(void (self_type::*function)(const U32), const U32 i){
+	Timer timer;
+	if(this->profiler != nullptr) timer.Start();
+	(this->*function)(i);
+	if(this->profiler != nullptr)
+		(*this->profiler)[YON_PROFILE_PERMUTE].addCPU(timer.ElapsedCPU());
+}
+
 bool RadixSortGT::update(const bcf_entry_type& entry){
 	// Check again because we might use it
 	// iteratively at some point in time
@@ -69,7 +181,7 @@ bool RadixSortGT::update(const bcf_entry_type& entry){
 	if(entry.hasGenotypes == false)
 		return false;
 
-	if(entry.gt_support.hasEOV || entry.gt_support.ploidy != 2)
+	if(entry.gt_support.ploidy != 1 && entry.gt_support.ploidy != 2)
 		return false;
 
 	// Has to be biallelic
@@ -77,78 +189,70 @@ bool RadixSortGT::update(const bcf_entry_type& entry){
 	if(!entry.isBiallelic())
 		return false;
 
-	// Cycle over genotypes at this position
-	// Ignore phasing at this stage
-	//
-	// Genotype encodings are thus:
-	// 0/0 -> 0000b = 0 -> 0
-	// 0/1 -> 0001b = 1 -> 3
-	// 0/. -> 0010b = 2	-> 4
-	// 1/0 -> 0100b = 4 -> 2
-	// 1/1 -> 0101b = 5 -> 1
-	// 1/. -> 0110b = 6 -> 5
-	// ./0 -> 1000b = 8 -> 6
-	// ./1 -> 1001b = 9 -> 7
-	// ./. -> 1010b = 10 -> 8
-	//
-	// Update GT_array
 	if(entry.formatID[0].primitive_type != 1){
 		std::cerr << "unexpected primitive: " << (int)entry.formatID[0].primitive_type << std::endl;
 		return false;
 	}
 
-	U32 internal_pos = entry.formatID[0].l_offset;
-	U32 k = 0;
-	for(U32 i = 0; i < 2*this->n_samples; i += 2, ++k){
-		const SBYTE& fmt_type_value1 = *reinterpret_cast<const SBYTE* const>(&entry.data[internal_pos++]);
-		const SBYTE& fmt_type_value2 = *reinterpret_cast<const SBYTE* const>(&entry.data[internal_pos++]);
-		const BYTE packed = (bcf::BCF_UNPACK_GENOTYPE(fmt_type_value2) << 2) | bcf::BCF_UNPACK_GENOTYPE(fmt_type_value1);
-		this->GT_array[k] = packed;
-	}
+	// Update GT_array
+	if(entry.gt_support.ploidy == 1 || entry.gt_support.hasEOV)
+		this->packHaploid(reinterpret_cast<const BYTE*>(&entry.data[entry.formatID[0].l_offset]), entry.gt_support.ploidy);
+	else
+		this->pack(reinterpret_cast<const BYTE*>(&entry.data[entry.formatID[0].l_offset]));
 
 	// Build PPA
 	// 3^2 = 9 state radix sort over
 	// states: alleles \in {00, 01, 10}
+	// and 3 haploid states
 	// b entries in a YON block B
 	// This is equivalent to a radix sort
-	// on the alphabet {0,1,...,8}
-	U32 target_ID = 0;
-	for(U32 j = 0; j < this->n_samples; ++j){
-		// Determine correct bin
-		switch(this->GT_array[(*this->manager)[j]]){
-		case 0:  target_ID = 0; break; // 0000: Ref, ref
-		case 1:  target_ID = 3; break; // 0001: Ref, alt
-		case 2:  target_ID = 4; break; // 0010: Ref, Missing
-		case 4:  target_ID = 2; break; // 0100: Alt, ref
-		case 5:  target_ID = 1; break; // 0101: Alt, alt
-		case 6:  target_ID = 5; break; // 0110: Alt, missing
-		case 8:  target_ID = 6; break; // 1000: Missing, ref
-		case 9:  target_ID = 7; break; // 1001: Missing, alt
-		case 10: target_ID = 8; break; // 1010: Missing, missing
-		default: std::cerr << "illegal in radix" << std::endl; exit(1);
-		}
+	// on the alphabet {0,1,...,11}
+	U32 n_ranges = this->n_samples / YON_RADIX_GT_THREAD_SAMPLES;
+	if(n_ranges > this->n_threads) n_ranges = this->n_threads;
+	if(n_ranges == 0) n_ranges = 1;
 
-		// Update bin i at position i with ppa[j]
-		this->bins[target_ID][this->p_i[target_ID]] = (*this->manager)[j];
-		++this->p_i[target_ID];
-	} // end loop over individuals at position i
+	const U32 range_size = this->n_samples / n_ranges;
+	for(U32 i = 0; i < n_ranges; ++i){
+		this->ranges[i].begin = i * range_size;
+		this->ranges[i].end   = (i + 1 == n_ranges ? this->n_samples : (i + 1) * range_size);
+	}
 
-	// Update PPA data
-	// Copy data in sorted order
-	U32 cum_pos = 0;
-	for(U32 i = 0; i < 9; ++i){
-		// Copy data in bin i to current position
-		memcpy(&this->manager->PPA[cum_pos*sizeof(U32)], this->bins[i], this->p_i[i]*sizeof(U32));
+	if(n_ranges == 1){
+		this->count(0);
+	} else {
+		std::vector<std::thread> threads;
+		for(U32 i = 1; i < n_ranges; ++i) threads.push_back(std::thread(&self_type::runWorker, this, &self_type::count, i));
+		this->count(0);
+		for(U32 i = 0; i < threads.size(); ++i) threads[i].join();
+	}
 
-		// Update cumulative position and reset
-		cum_pos += this->p_i[i];
-		this->p_i[i] = 0;
+	// Exclusive prefix sum over bins and then ranges keeps
+	// samples in the same bin in their previous order
+	U32 cum_pos = 0;
+	for(U32 bin = 0; bin < YON_RADIX_GT_BINS; ++bin){
+		for(U32 i = 0; i < n_ranges; ++i){
+			const U32 n_bin = this->ranges[i].counts[bin];
+			this->ranges[i].counts[bin] = cum_pos;
+			cum_pos += n_bin;
+		}
 	}
 	// Make sure the cumulative position
 	// equals the number of samples in the
 	// dataset
 	assert(cum_pos == this->n_samples);
 
+	if(n_ranges == 1){
+		this->scatter(0);
+	} else {
+		std::vector<std::thread> threads;
+		for(U32 i = 1; i < n_ranges; ++i) threads.push_back(std::thread(&self_type::runWorker, this, &self_type::scatter, i));
+		this->scatter(0);
+		for(U32 i = 0; i < threads.size(); ++i) threads[i].join();
+	}
+
+	// Update PPA data
+	memcpy(this->manager->get(), this->sorted, this->n_samples*sizeof(U32));
+
 	// Keep track of how many entries we've iterated over
 	++this->position;
 
@@ -1,17 +1,38 @@
 #ifndef ALGORITHM_COMPRESSION_RADIXSORTGT_H_
 #define ALGORITHM_COMPRESSION_RADIXSORTGT_H_
 
+#include <thread>
+
 #include "../../io/bcf/BCFReader.h"
 #include "../../algorithm/permutation/permutation_manager.h"
 #include "../../core/genotype_summary.h"
+#include "../stage_profiler.h"
 
 namespace tachyon {
 namespace algorithm {
 
+/**< Number of radix bins: 3^2 allele states {ref, alt, missing} and 3 haploid states */
+#define YON_RADIX_GT_BINS           12
+/**< Minimum number of samples handled by each thread */
+#define YON_RADIX_GT_THREAD_SAMPLES 65536
+
 /*
  * This class performs a radix sort on a
  * block of variant lines given they are
- * bi-allelic diploid.
+ * bi-allelic haploid or diploid. Haploid
+ * samples, also those in diploid lines with
+ * EOV values, are sorted into their own bins.
+ *
+ * Each allele is packed into a 2-bit code
+ * and the 4-bit genotype code of a sample is
+ * mapped to its radix bin directly: two samples
+ * are stored per byte. The previous PPA order is
+ * then scanned once to count bin sizes and once
+ * to scatter sample identifiers into the new order.
+ * For very large sample numbers the PPA is split
+ * into contiguous ranges that are counted and
+ * scattered in parallel: the prefix sum over
+ * (bin, range) keeps the sort stable.
  */
 class RadixSortGT {
 	typedef RadixSortGT        self_type;
@@ -19,6 +40,17 @@ class RadixSortGT {
 	typedef bcf::BCFEntry      bcf_entry_type;
 	typedef PermutationManager manager_type;
 
+	/**<
+	 * Per-thread range of the PPA and its bin counts
+	 */
+	struct Range{
+		Range() : begin(0), end(0){ memset(this->counts, 0, sizeof(U32)*YON_RADIX_GT_BINS); }
+
+		U32 begin;
+		U32 end;
+		U32 counts[YON_RADIX_GT_BINS]; // bin sizes, then scatter offsets
+	};
+
 public:
 	RadixSortGT();
 	RadixSortGT(const U64 n_samples);
@@ -30,6 +62,14 @@ public:
 	void reset(void);
 	void setSamples(const U64 n_samples);
 
+	/**<
+	 * Set the maximum number of threads used to sort a
+	 * single variant. Threads are only used if every thread
+	 * has at least YON_RADIX_GT_THREAD_SAMPLES samples.
+	 * @param n_threads Number of threads
+	 */
+	void setThreads(const U32 n_threads);
+
 	// Construct given a reader with a block
 	// of BCF entries loaded in it
 	bool build(const bcf_reader_type& reader);
@@ -38,13 +78,44 @@ public:
 	inline const U64& getSamples(void) const{ return(this->n_samples); }
 	inline const U32& size(void) const{ return(this->position); }
 
+private:
+	/**<
+	 * Pack the radix bin of each sample into GT_array
+	 * @param data Interleaved BCF genotype values for all samples
+	 */
+	void pack(const BYTE* data);
+
+	/**<
+	 * Pack the radix bin of each sample into GT_array for haploid
+	 * lines or diploid lines with EOV values
+	 * @param data   Interleaved BCF genotype values for all samples
+	 * @param ploidy Number of genotype values for each sample
+	 */
+	void packHaploid(const BYTE* data, const BYTE ploidy);
+
+	// Radix bin of a sample
+	inline const BYTE getBin(const U32 sample) const{
+		return((this->GT_array[sample >> 1] >> ((sample & 1) << 2)) & 0xF);
+	}
+
+	// Count bin sizes in range i of the PPA
+	void count(const U32 i);
+	// Scatter sample identifiers in range i of the PPA
+	void scatter(const U32 i);
+	// Run `function` on range i in a worker thread and add its
+	// CPU time to the profiler
+	void runWorker(void (self_type::*function)(const U32), const U32 i);
+
 public:
 	U64           n_samples; // total number of entries in file
 	U32           position;  // number of entries parsed
-	U32           p_i[9];    // number of entries in bin i
-	BYTE*         GT_array;  // packed genotype array
-	U32**         bins;      // bin i
+	U32           n_threads; // maximum number of threads
+	BYTE*         GT_array;  // packed radix bins: two samples per byte
+	BYTE*         keys;      // radix bin of each sample in PPA order
+	U32*          sorted;    // sample identifiers in sorted order
+	Range*        ranges;    // per-thread ranges of the PPA
 	manager_type* manager;   // permutation manager
+	StageProfiler* profiler; // worker threads add their CPU time to this profiler if set
 };
 
 } /* namespace Algorithm */
@@ -0,0 +1,189 @@
+#ifndef ALGORITHM_STAGE_PROFILER_H_
+#define ALGORITHM_STAGE_PROFILER_H_
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "../support/type_definitions.h"
+#include "timer.h"
+
+namespace tachyon{
+namespace algorithm{
+
+/**<
+ * Hot-path stages of the import pipeline
+ */
+enum TACHYON_PROFILE_STAGE{
+	YON_PROFILE_INFLATE,   // BGZF/gzip inflate (units: compressed blocks)
+	YON_PROFILE_PARSE,     // BCF parsing or VCF conversion (units: variants)
+	YON_PROFILE_PERMUTE,   // genotype permutation (units: variants)
+	YON_PROFILE_GT_ENCODE, // genotype encoding (units: variants)
+	YON_PROFILE_COMPRESS,  // container compression (units: variants)
+	YON_PROFILE_CHECKSUM,  // digests (units: variants)
+	YON_PROFILE_ENCRYPT,   // encryption (units: variants)
+	YON_PROFILE_WRITE      // output (units: variants)
+};
+
+/**< Number of stages in TACHYON_PROFILE_STAGE */
+#define YON_PROFILE_N_STAGES 8
+
+/**<
+ * Accumulated measurements of a stage or field. Counters are
+ * atomic such that worker threads can add to them directly.
+ * Times are stored in nanoseconds.
+ */
+struct StageProfile{
+	typedef StageProfile self_type;
+
+	StageProfile() : n_calls(0), n_records(0), b_in(0), b_out(0), t_wall(0), t_cpu(0){}
+
+	/**<
+	 * Add a timed call of this stage
+	 * @param wall      Wall time in seconds
+	 * @param cpu       CPU time in seconds
+	 * @param b_in      Number of bytes consumed
+	 * @param b_out     Number of bytes produced
+	 * @param n_records Number of units processed
+	 */
+	inline void add(const double wall, const double cpu, const U64 b_in, const U64 b_out, const U64 n_records){
+		++this->n_calls;
+		this->n_records += n_records;
+		this->b_in      += b_in;
+		this->b_out     += b_out;
+		this->t_wall    += (U64)(wall * 1e9);
+		this->t_cpu     += (U64)(cpu * 1e9);
+	}
+
+	// Add a call timed by `timer` on the calling thread
+	inline void add(const Timer& timer, const U64 b_in, const U64 b_out, const U64 n_records){
+		this->add(timer.Elapsed().count(), timer.ElapsedCPU(), b_in, b_out, n_records);
+	}
+
+	// Add CPU time spent by a worker thread on behalf of this stage
+	inline void addCPU(const double cpu){ this->t_cpu += (U64)(cpu * 1e9); }
+
+	// Add wall time of the driving thread for work that is
+	// accounted for by worker threads
+	inline void addWall(const double wall){ this->t_wall += (U64)(wall * 1e9); }
+
+	inline double wall(void) const{ return(this->t_wall / 1e9); }
+	inline double cpu(void) const{ return(this->t_cpu / 1e9); }
+
+	std::atomic<U64> n_calls;
+	std::atomic<U64> n_records;
+	std::atomic<U64> b_in;
+	std::atomic<U64> b_out;
+	std::atomic<U64> t_wall;
+	std::atomic<U64> t_cpu;
+};
+
+/**<
+ * Per-stage and per-field profiler for the importer. The wall time
+ * of a stage is measured on the thread driving it. The CPU time
+ * additionally includes the worker threads the stage fans out to,
+ * so CPU time can exceed wall time for parallel stages. Per-field
+ * measurements cover the compression of each container.
+ *
+ * All counters are thread-safe. Components hold a pointer to a
+ * shared profiler: a null pointer disables profiling.
+ */
+class StageProfiler{
+private:
+	typedef StageProfiler self_type;
+	typedef StageProfile  value_type;
+
+public:
+	StageProfiler() : n_fields_{0, 0, 0}, fields_{nullptr, nullptr, nullptr}{}
+	~StageProfiler(){
+		for(U32 i = 0; i < 3; ++i) delete [] this->fields_[i];
+	}
+
+	/**<
+	 * Allocate per-field counters for the basic, INFO, and FORMAT
+	 * field groups. Group identifiers follow TACHYON_POLICY_GROUP.
+	 * @param n_basic  Number of basic fields
+	 * @param n_info   Number of INFO fields
+	 * @param n_format Number of FORMAT fields
+	 */
+	void setFields(const U32 n_basic, const U32 n_info, const U32 n_format){
+		const U32 n_fields[3] = {n_basic, n_info, n_format};
+		for(U32 i = 0; i < 3; ++i){
+			delete [] this->fields_[i];
+			this->n_fields_[i] = n_fields[i];
+			this->fields_[i]   = new value_type[n_fields[i]];
+		}
+	}
+
+	inline value_type& operator[](const TACHYON_PROFILE_STAGE stage){ return(this->stages_[stage]); }
+	inline const value_type& operator[](const TACHYON_PROFILE_STAGE stage) const{ return(this->stages_[stage]); }
+
+	inline value_type* getField(const U32 group, const U32 key){
+		if(group >= 3 || key >= this->n_fields_[group]) return(nullptr);
+		return(&this->fields_[group][key]);
+	}
+
+	/**<
+	 * Write the profile as a JSON document
+	 * @param stream    Output stream
+	 * @param elapsed   Total wall time of the import in seconds
+	 * @param names     Field names for the basic, INFO, and FORMAT groups
+	 */
+	void printJSON(std::ostream& stream, const double elapsed, const std::vector<std::string> (&names)[3]) const{
+		static const char* const stage_names[YON_PROFILE_N_STAGES] = {"inflate", "parse", "permute", "gt_encode", "compress", "checksum", "encrypt", "write"};
+		static const char* const group_names[3] = {"", "INFO_", "FORMAT_"};
+
+		stream << "{\n\t\"elapsed_seconds\": " << elapsed << ",\n\t\"stages\": [";
+		for(U32 i = 0; i < YON_PROFILE_N_STAGES; ++i){
+			stream << (i ? ",\n" : "\n") << "\t\t{\"stage\": \"" << stage_names[i] << "\", ";
+			this->printJSON(stream, this->stages_[i]);
+			stream << '}';
+		}
+		stream << "\n\t],\n\t\"fields\": [";
+
+		bool first = true;
+		for(U32 group = 0; group < 3; ++group){
+			for(U32 key = 0; key < this->n_fields_[group]; ++key){
+				const value_type& field = this->fields_[group][key];
+				if(field.n_calls == 0) continue;
+
+				stream << (first ? "\n" : ",\n") << "\t\t{\"field\": \"" << group_names[group];
+				if(key < names[group].size()) this->printEscaped(stream, names[group][key]);
+				else stream << key;
+				stream << "\", ";
+				this->printJSON(stream, field);
+				stream << '}';
+				first = false;
+			}
+		}
+		stream << "\n\t]\n}\n";
+	}
+
+private:
+	void printJSON(std::ostream& stream, const value_type& profile) const{
+		const double wall = profile.wall();
+		stream << "\"calls\": " << profile.n_calls << ", \"records\": " << profile.n_records
+		       << ", \"wall_seconds\": " << wall << ", \"cpu_seconds\": " << profile.cpu()
+		       << ", \"bytes_in\": " << profile.b_in << ", \"bytes_out\": " << profile.b_out
+		       << ", \"records_per_second\": " << (wall > 0 ? profile.n_records / wall : 0)
+		       << ", \"mb_in_per_second\": " << (wall > 0 ? profile.b_in / wall / 1e6 : 0);
+	}
+
+	void printEscaped(std::ostream& stream, const std::string& string) const{
+		for(U32 i = 0; i < string.size(); ++i){
+			if(string[i] == '"' || string[i] == '\\') stream << '\\';
+			stream << string[i];
+		}
+	}
+
+private:
+	value_type  stages_[YON_PROFILE_N_STAGES];
+	U32         n_fields_[3];
+	value_type* fields_[3];
+};
+
+}
+}
+
+#endif /* ALGORITHM_STAGE_PROFILER_H_ */
@@ -2,20 +2,40 @@
 #define TIMER_H_
 
 #include <chrono>
+#include <ctime>
 
 namespace tachyon{
 namespace algorithm{
 
 class Timer {
 public:
-	explicit Timer(){}
+	explicit Timer() :
+		_start(std::chrono::high_resolution_clock::now()),
+		_start_cpu(0)
+	{}
 
-	void Start(void){ this->_start = std::chrono::high_resolution_clock::now(); }
+	void Start(void){
+		this->_start     = std::chrono::high_resolution_clock::now();
+		this->_start_cpu = ThreadCPUTime();
+	}
 
 	std::chrono::duration<double> Elapsed() const{
 		return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - this->_start);
 	}
 
+	/**<
+	 * CPU time in seconds used by the calling thread since Start().
+	 * Only meaningful if called from the thread that called Start().
+	 * @return Returns the CPU time in seconds
+	 */
+	double ElapsedCPU() const{ return(ThreadCPUTime() - this->_start_cpu); }
+
+	static double ThreadCPUTime(void){
+		timespec time;
+		if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) return(0);
+		return(time.tv_sec + time.tv_nsec / 1e9);
+	}
+
 	template <typename T, typename Traits>
 	friend std::basic_ostream<T, Traits>& operator<<(std::basic_ostream<T, Traits>& out, const Timer& timer){
 		return out << timer.Elapsed().count();
@@ -57,6 +77,7 @@ private:
 private:
 	char buffer[64];
 	std::chrono::high_resolution_clock::time_point _start;
+	double _start_cpu;
 
 };
 
@@ -0,0 +1,126 @@
+/*
+Copyright (C) 2017-2018 Genome Research Ltd.
+Author: Marcus D. R. Klarqvist <mk819@cam.ac.uk>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include <iostream>
+#include <fstream>
+#include <getopt.h>
+
+#include "core/variant_concatenator.h"
+#include "utility.h"
+
+void concat_usage(void){
+	programMessage();
+	std::cerr <<
+	"Brief:  Concatenate YON files with compatible headers without decompressing them\n"
+	"Usage:  " << tachyon::constants::PROGRAM_NAME << " concat [options] -o <output.yon> <input.yon> [<input.yon> ...]\n\n"
+	"Input files have to be given in sorted order, for example one file per chromosome\n"
+	"or chunk of a parallel import. Keychains of encrypted files are read from the\n"
+	"'.kyon' files next to them.\n\n"
+	"Options:\n"
+	"  -o FILE  output file prefix (required)\n"
+	"  -l FILE  file listing one input file per line\n"
+	"  -s       Hide all program messages [null]\n";
+}
+
+int concat(int argc, char** argv){
+	if(argc <= 2){
+		concat_usage();
+		return(1);
+	}
+
+	int c;
+	int option_index = 0;
+	static struct option long_options[] = {
+		{"output",  required_argument, 0, 'o' },
+		{"list",    required_argument, 0, 'l' },
+		{"silent",  no_argument,       0, 's' },
+		{0,0,0,0}
+	};
+
+	std::string output;
+	std::string list;
+	SILENT = 0;
+
+	while ((c = getopt_long(argc, argv, "o:l:s?", long_options, &option_index)) != -1){
+		switch (c){
+		case 0:
+			std::cerr << "Case 0: " << option_index << '\t' << long_options[option_index].name << std::endl;
+			break;
+		case 'o':
+			output = std::string(optarg);
+			break;
+		case 'l':
+			list = std::string(optarg);
+			break;
+		case 's':
+			SILENT = 1;
+			break;
+
+		default:
+			concat_usage();
+			std::cerr << tachyon::utility::timestamp("ERROR") << "Unrecognized option: " << (char)c << std::endl;
+			return(1);
+		}
+	}
+
+	// Skip the command name
+	std::vector<std::string> inputs;
+	for(int i = optind + 1; i < argc; ++i)
+		inputs.push_back(std::string(argv[i]));
+
+	if(list.size()){
+		std::ifstream list_reader(list);
+		if(!list_reader.good()){
+			std::cerr << tachyon::utility::timestamp("ERROR") << "Failed to open: " << list << "..." << std::endl;
+			return(1);
+		}
+
+		std::string line;
+		while(std::getline(list_reader, line)){
+			if(line.size()) inputs.push_back(line);
+		}
+	}
+
+	if(output.length() == 0){
+		concat_usage();
+		std::cerr << tachyon::utility::timestamp("ERROR") << "No output value specified..." << std::endl;
+		return(1);
+	}
+
+	if(inputs.size() == 0){
+		concat_usage();
+		std::cerr << tachyon::utility::timestamp("ERROR") << "No input files specified..." << std::endl;
+		return(1);
+	}
+
+	// Print messages
+	if(!SILENT){
+		programMessage();
+		std::cerr << tachyon::utility::timestamp("LOG") << "Calling concat..." << std::endl;
+	}
+
+	tachyon::VariantConcatenator concatenator(inputs, output);
+	if(!concatenator.Build())
+		return 1;
+
+	return 0;
+}
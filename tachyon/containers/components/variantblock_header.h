@@ -25,6 +25,7 @@ public:
 		hasGT(0),
 		hasGTPermuted(0),
 		anyEncrypted(0),
+		hasGTSeparateEOV(0),
 		unused(0)
 	{}
 	~VariantBlockHeaderController(){}
@@ -35,7 +36,8 @@ public:
 		const U16 c = controller.hasGT |
                       controller.hasGTPermuted << 1 |
                       controller.anyEncrypted  << 2 |
-                      controller.unused        << 3;
+                      controller.hasGTSeparateEOV << 3 |
+                      controller.unused        << 4;
 
 		stream.write(reinterpret_cast<const char*>(&c), sizeof(U16));
 		return(stream);
@@ -51,7 +53,8 @@ public:
 	U16 hasGT:         1,  // This block has GT FORMAT data
 		hasGTPermuted: 1,  // have the GT fields been permuted
 		anyEncrypted:  1,  // any data encrypted
-		unused:        13; // reserved for future use
+		hasGTSeparateEOV: 1, // EOV is packed apart from missing in diploid GT
+		unused:        12; // reserved for future use
 };
 
 /** @brief Fixed-sized components of an IndexBlockEntry
@@ -103,6 +106,18 @@ public:
 		return(stream);
 	}
 
+	friend io::BasicBuffer& operator>>(io::BasicBuffer& buffer, self_type& entry){
+		buffer >> entry.l_offset_footer;
+		buffer >> entry.blockID;
+		buffer.read(reinterpret_cast<char*>(&entry.controller), sizeof(U16));
+		buffer >> entry.contigID;
+		buffer >> entry.minPosition;
+		buffer >> entry.maxPosition;
+		buffer >> entry.n_variants;
+
+		return(buffer);
+	}
+
 	void reset(void){
 		this->l_offset_footer    = 0;
 		this->blockID            = 0;
@@ -6,11 +6,16 @@
 namespace tachyon{
 namespace containers{
 
-GenotypeContainer::GenotypeContainer(const block_type& block, const MetaContainer& meta) :
+GenotypeContainer::GenotypeContainer(const block_type& block, const MetaContainer& meta, const U64 n_samples) :
 	n_entries(0),
 	__meta_container(block),
 	__iterators(nullptr)
 {
+	// Decompress the genotype streams if the block deferred it: the
+	// container is left empty if they cannot be decompressed
+	if(!block.prepareGenotypes())
+		return;
+
 	// Todo: if anything is uniform
 	// Support
 	const bool uniform_stride = block.gt_support_data_container.header.data_header.isUniform();
@@ -41,6 +46,19 @@ GenotypeContainer::GenotypeContainer(const block_type& block, const MetaContaine
 	BYTE incrementor = 1;
 	if(uniform_stride) incrementor = 0;
 
+	// Blocks written before EOV was packed apart from missing in
+	// diploid genotypes are decoded as before
+	const bool separate_eov = block.header.controller.hasGTSeparateEOV;
+
+	// BCF-style genotypes are stored in the order of the samples in the
+	// file and are gathered in the order of the permutation if available
+	const permutation_type* const ppa = (block.header.controller.hasGTPermuted && block.ppa_manager.PPA.size() >= n_samples*sizeof(U32)) ? &block.ppa_manager : nullptr;
+
+	// Positional BWT order carried between variants
+	std::vector<U32>  pbwt_order;
+	std::vector<BYTE> pbwt_values;
+	std::vector<U32>  pbwt_sorted;
+
 	for(U32 i = 0; i < meta.size(); ++i){
 		if(meta[i].hasGT()){
 			// Case run-length encoding diploid and biallelic and no missing
@@ -66,16 +84,16 @@ GenotypeContainer::GenotypeContainer(const block_type& block, const MetaContaine
 			// Case run-length encoding diploid and biallelic/EOV or n-allelic
 			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_DIPLOID_NALLELIC) {
 				if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_BYTE){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<BYTE>( &simple8[offset_simple8], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<BYTE>( &simple8[offset_simple8], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple8 += lengths[gt_offset]*sizeof(BYTE);
 				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U16){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<U16>( &simple16[offset_simple16], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<U16>( &simple16[offset_simple16], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple16 += lengths[gt_offset]*sizeof(U16);
 				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U32){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<U32>( &simple32[offset_simple32], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<U32>( &simple32[offset_simple32], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple32 += lengths[gt_offset]*sizeof(U32);
 				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U64){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<U64>( &simple64[offset_simple64], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidSimple<U64>( &simple64[offset_simple64], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple64 += lengths[gt_offset]*sizeof(U64);
 				} else {
 					std::cerr << "unknwn type" << std::endl;
@@ -85,22 +103,105 @@ GenotypeContainer::GenotypeContainer(const block_type& block, const MetaContaine
 			// Case BCF-style encoding of diploids
 			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_BCF_DIPLOID) {
 				if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_BYTE){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<BYTE>( &simple8[offset_simple8], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<BYTE>( &simple8[offset_simple8], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple8 += lengths[gt_offset]*sizeof(BYTE);
 				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U16){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<U16>( &simple16[offset_simple8], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<U16>( &simple16[offset_simple16], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple16 += lengths[gt_offset]*sizeof(U16);
 				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U32){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<U32>( &simple32[offset_simple8], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<U32>( &simple32[offset_simple32], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple32 += lengths[gt_offset]*sizeof(U32);
 				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U64){
-					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<U64>( &simple64[offset_simple8], lengths[gt_offset], this->__meta_container[i] );
+					new( &this->__iterators[i] ) GenotypeContainerDiploidBCF<U64>( &simple64[offset_simple64], lengths[gt_offset], this->__meta_container[i], separate_eov );
 					offset_simple64 += lengths[gt_offset]*sizeof(U64);
 				}  else {
 					std::cerr << "unknwn type" << std::endl;
 					exit(1);
 				}
 			}
+			// Case run-length encoding diploid and biallelic in PBWT order
+			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_DIPLOID_BIALLELIC_PBWT){
+				if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_BYTE){
+					this->__decodePBWT<BYTE>( &rle8[offset_rle8], lengths[gt_offset], i, pbwt_order, pbwt_values, pbwt_sorted );
+					offset_rle8 += lengths[gt_offset]*sizeof(BYTE);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U16){
+					this->__decodePBWT<U16>( &rle16[offset_rle16], lengths[gt_offset], i, pbwt_order, pbwt_values, pbwt_sorted );
+					offset_rle16 += lengths[gt_offset]*sizeof(U16);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U32){
+					this->__decodePBWT<U32>( &rle32[offset_rle32], lengths[gt_offset], i, pbwt_order, pbwt_values, pbwt_sorted );
+					offset_rle32 += lengths[gt_offset]*sizeof(U32);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U64){
+					this->__decodePBWT<U64>( &rle64[offset_rle64], lengths[gt_offset], i, pbwt_order, pbwt_values, pbwt_sorted );
+					offset_rle64 += lengths[gt_offset]*sizeof(U64);
+				} else {
+					std::cerr << "unknwn type" << std::endl;
+					exit(1);
+				}
+			}
+			// Case bit-planes diploid and biallelic
+			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_BITPLANE_DIPLOID_BIALLELIC){
+				new( &this->__iterators[i] ) GenotypeContainerDiploidBitplane( &rle64[offset_rle64], lengths[gt_offset], this->__meta_container[i] );
+				offset_rle64 += GenotypeContainerDiploidBitplane::getBytes(lengths[gt_offset], this->__meta_container[i]);
+			}
+			// Case run-length encoding haploid and polyploid and biallelic
+			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_MPLOID_BIALLELIC){
+				if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_BYTE){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<BYTE>( &rle8[offset_rle8], lengths[gt_offset], this->__meta_container[i] );
+					offset_rle8 += GenotypeContainerMploidRLE<BYTE>::getBytes(lengths[gt_offset]);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U16){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<U16>( &rle16[offset_rle16], lengths[gt_offset], this->__meta_container[i] );
+					offset_rle16 += GenotypeContainerMploidRLE<U16>::getBytes(lengths[gt_offset]);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U32){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<U32>( &rle32[offset_rle32], lengths[gt_offset], this->__meta_container[i] );
+					offset_rle32 += GenotypeContainerMploidRLE<U32>::getBytes(lengths[gt_offset]);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U64){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<U64>( &rle64[offset_rle64], lengths[gt_offset], this->__meta_container[i] );
+					offset_rle64 += GenotypeContainerMploidRLE<U64>::getBytes(lengths[gt_offset]);
+				} else {
+					std::cerr << "unknwn type" << std::endl;
+					exit(1);
+				}
+			}
+			// Case run-length encoding haploid and polyploid and n-allelic/EOV
+			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_MPLOID_NALLELIC){
+				if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_BYTE){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<BYTE>( &simple8[offset_simple8], lengths[gt_offset], this->__meta_container[i] );
+					offset_simple8 += GenotypeContainerMploidRLE<BYTE>::getBytes(lengths[gt_offset]);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U16){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<U16>( &simple16[offset_simple16], lengths[gt_offset], this->__meta_container[i] );
+					offset_simple16 += GenotypeContainerMploidRLE<U16>::getBytes(lengths[gt_offset]);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U32){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<U32>( &simple32[offset_simple32], lengths[gt_offset], this->__meta_container[i] );
+					offset_simple32 += GenotypeContainerMploidRLE<U32>::getBytes(lengths[gt_offset]);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U64){
+					new( &this->__iterators[i] ) GenotypeContainerMploidRLE<U64>( &simple64[offset_simple64], lengths[gt_offset], this->__meta_container[i] );
+					offset_simple64 += GenotypeContainerMploidRLE<U64>::getBytes(lengths[gt_offset]);
+				} else {
+					std::cerr << "unknwn type" << std::endl;
+					exit(1);
+				}
+			}
+			// Case BCF-style encoding of haploids and polyploids: values
+			// are stored per allele in the order of the samples in the file
+			else if(meta[i].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_BCF_STYLE){
+				const BYTE ploidy = n_samples ? lengths[gt_offset] / n_samples : 0;
+				if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_BYTE){
+					new( &this->__iterators[i] ) GenotypeContainerBCF<BYTE>( &simple8[offset_simple8], lengths[gt_offset], this->__meta_container[i], ploidy, ppa );
+					offset_simple8 += lengths[gt_offset]*sizeof(BYTE);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U16){
+					new( &this->__iterators[i] ) GenotypeContainerBCF<U16>( &simple16[offset_simple16], lengths[gt_offset], this->__meta_container[i], ploidy, ppa );
+					offset_simple16 += lengths[gt_offset]*sizeof(U16);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U32){
+					new( &this->__iterators[i] ) GenotypeContainerBCF<U32>( &simple32[offset_simple32], lengths[gt_offset], this->__meta_container[i], ploidy, ppa );
+					offset_simple32 += lengths[gt_offset]*sizeof(U32);
+				} else if(meta[i].getGenotypeType() == TACHYON_GT_PRIMITIVE_TYPE::YON_GT_U64){
+					new( &this->__iterators[i] ) GenotypeContainerBCF<U64>( &simple64[offset_simple64], lengths[gt_offset], this->__meta_container[i], ploidy, ppa );
+					offset_simple64 += lengths[gt_offset]*sizeof(U64);
+				} else {
+					std::cerr << "unknwn type" << std::endl;
+					exit(1);
+				}
+			}
 			// Case other potential encodings
 			else {
 				std::cerr << "not implemented" << std::endl;
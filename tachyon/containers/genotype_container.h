@@ -4,6 +4,9 @@
 #include "genotype_container_diploid_rle.h"
 #include "genotype_container_diploid_simple.h"
 #include "genotype_container_diploid_bcf.h"
+#include "genotype_container_diploid_bitplane.h"
+#include "genotype_container_mploid_rle.h"
+#include "genotype_container_bcf.h"
 #include "meta_container.h"
 #include "variantblock.h"
 
@@ -29,9 +32,10 @@ private:
     typedef io::BasicBuffer            buffer_type;
     typedef containers::GenotypeSummary      gt_summary_type;
     typedef VariantBlock               block_type;
+    typedef algorithm::PermutationManager permutation_type;
 
 public:
-    GenotypeContainer(const block_type& block, const MetaContainer& meta);
+    GenotypeContainer(const block_type& block, const MetaContainer& meta, const U64 n_samples);
     ~GenotypeContainer();
 
     class iterator{
@@ -98,7 +102,40 @@ public:
 	inline const GenotypeContainerDiploidRLE<U32>*     getDiploidRLEU32(const U32 position) const{ return(reinterpret_cast<GenotypeContainerDiploidRLE<U32>*>(&this->__iterators[position])); }
 	inline const GenotypeContainerDiploidRLE<U64>*     getDiploidRLEU64(const U32 position) const{ return(reinterpret_cast<GenotypeContainerDiploidRLE<U64>*>(&this->__iterators[position])); }
 
+	// Bit-planes of a diploid biallelic variant for popcount-based kernels
+	inline const bool isDiploidBitplane(const U32 position) const{ return(this->__meta_container[position].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_BITPLANE_DIPLOID_BIALLELIC); }
+	inline GenotypeContainerDiploidBitplane*       getDiploidBitplane(const U32 position){ return(reinterpret_cast<GenotypeContainerDiploidBitplane*>(&this->__iterators[position])); }
+	inline const GenotypeContainerDiploidBitplane* getDiploidBitplane(const U32 position) const{ return(reinterpret_cast<GenotypeContainerDiploidBitplane*>(&this->__iterators[position])); }
+
+	// Runs of a haploid or polyploid variant
+	inline const bool isMploidRLE(const U32 position) const{
+		return(this->__meta_container[position].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_MPLOID_BIALLELIC ||
+		       this->__meta_container[position].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_MPLOID_NALLELIC);
+	}
+	template <class T> inline GenotypeContainerMploidRLE<T>*       getMploidRLE(const U32 position){ return(reinterpret_cast<GenotypeContainerMploidRLE<T>*>(&this->__iterators[position])); }
+	template <class T> inline const GenotypeContainerMploidRLE<T>* getMploidRLE(const U32 position) const{ return(reinterpret_cast<GenotypeContainerMploidRLE<T>*>(&this->__iterators[position])); }
+
+	// BCF-style genotypes of a haploid or polyploid variant
+	inline const bool isBCF(const U32 position) const{ return(this->__meta_container[position].getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_BCF_STYLE); }
+	template <class T> inline GenotypeContainerBCF<T>*       getBCF(const U32 position){ return(reinterpret_cast<GenotypeContainerBCF<T>*>(&this->__iterators[position])); }
+	template <class T> inline const GenotypeContainerBCF<T>* getBCF(const U32 position) const{ return(reinterpret_cast<GenotypeContainerBCF<T>*>(&this->__iterators[position])); }
+
 private:
+    /**<
+     * Decode a diploid biallelic variant run-length encoded in
+     * positional BWT order. The genotypes are re-encoded in the
+     * order of the block permutation such that the variant is
+     * represented by a GenotypeContainerDiploidRLE and the PBWT
+     * order is advanced to that of the next variant.
+     * @param data     Runs of the variant
+     * @param n_runs   Number of runs
+     * @param position Position of the variant in the block
+     * @param order    PBWT order of the positions of the block permutation
+     * @param values   Scratch space for the packed genotypes
+     * @param sorted   Scratch space for the next order
+     */
+    template <class T> void __decodePBWT(const char* const data, const U32 n_runs, const U32 position, std::vector<U32>& order, std::vector<BYTE>& values, std::vector<U32>& sorted);
+
     template <class intrinsic_primitive> inline const U32 getNative(const buffer_type& buffer, const U32 position) const{
     	return(*reinterpret_cast<const intrinsic_primitive* const>(&buffer.buffer[position*sizeof(intrinsic_primitive)]));
     }
@@ -109,6 +146,63 @@ private:
     pointer             __iterators;
 };
 
+// IMPLEMENTATION -------------------------------------------------------------
+
+template <class T>
+void GenotypeContainer::__decodePBWT(const char* const data, const U32 n_runs, const U32 position, std::vector<U32>& order, std::vector<BYTE>& values, std::vector<U32>& sorted){
+	const meta_type& meta = this->__meta_container[position];
+	const BYTE shift  = meta.isAnyGTMissing()   ? 2 : 1;
+	const BYTE add    = meta.isGTMixedPhasing() ? 1 : 0;
+	const BYTE n_bits = 2*shift + add;
+	const T* const runs = reinterpret_cast<const T* const>(data);
+
+	// The first variant in PBWT order is in the order of the
+	// block permutation
+	if(order.size() == 0){
+		U64 n_samples = 0;
+		for(U32 i = 0; i < n_runs; ++i) n_samples += YON_GT_RLE_LENGTH(runs[i], shift, add);
+		order.resize(n_samples);
+		for(U32 i = 0; i < n_samples; ++i) order[i] = i;
+	}
+	const U32 n_samples = order.size();
+	values.resize(n_samples);
+	sorted.resize(n_samples);
+
+	// Scatter runs to the positions of the block permutation and
+	// count genotypes for the stable sort
+	U32 offsets[32 + 1];
+	memset(offsets, 0, sizeof(U32)*(32 + 1));
+	U32 k = 0;
+	for(U32 i = 0; i < n_runs; ++i){
+		const BYTE packed = runs[i] & ((1 << n_bits) - 1);
+		const U64  length = YON_GT_RLE_LENGTH(runs[i], shift, add);
+		for(U64 j = 0; j < length; ++j, ++k) values[order[k]] = packed;
+		offsets[packed + 1] += length;
+	}
+	assert(k == n_samples);
+
+	for(U32 i = 1; i <= 32; ++i) offsets[i] += offsets[i - 1];
+	for(U32 i = 0; i < n_samples; ++i) sorted[offsets[values[order[i]]]++] = order[i];
+	order.swap(sorted);
+
+	// Run-length encode in the order of the block permutation
+	const U64 run_limit = ((U64)1 << (8*sizeof(T) - n_bits)) - 1;
+	std::vector<T> rle;
+	BYTE packed = values[0];
+	U64 length  = 1;
+	for(U32 i = 1; i < n_samples; ++i){
+		if(values[i] != packed || length == run_limit){
+			rle.push_back(((T)length << n_bits) | packed);
+			packed = values[i];
+			length = 0;
+		}
+		++length;
+	}
+	rle.push_back(((T)length << n_bits) | packed);
+
+	new( &this->__iterators[position] ) GenotypeContainerDiploidRLE<T>( reinterpret_cast<const char*>(&rle[0]), rle.size(), meta );
+}
+
 }
 }
 
@@ -0,0 +1,288 @@
+#ifndef CONTAINERS_GENOTYPE_CONTAINER_BCF_H_
+#define CONTAINERS_GENOTYPE_CONTAINER_BCF_H_
+
+#include "genotype_container_interface.h"
+
+namespace tachyon{
+namespace containers{
+
+/**<
+ * BCF-style genotypes of haploid and polyploid variants that cannot be
+ * run-length encoded. Every sample stores one word per allele in the
+ * order of the samples in the file. A word is 1 for EOV, 0 or 2 for a
+ * missing allele, and allele + 2 | phase otherwise, where the phase bit
+ * is set if the allele is separated from the previous one by '|'. The
+ * samples are gathered in the order of the permutation when the container
+ * is constructed such that they match the other genotype encodings.
+ */
+template <class T>
+class GenotypeContainerBCF : public GenotypeContainerInterface{
+private:
+	typedef GenotypeContainerInterface       parent_type;
+    typedef GenotypeContainerBCF             self_type;
+    typedef T                                value_type;
+    typedef value_type&                      reference;
+    typedef const value_type&                const_reference;
+    typedef value_type*                      pointer;
+    typedef const value_type*                const_pointer;
+    typedef std::ptrdiff_t                   difference_type;
+    typedef std::size_t                      size_type;
+
+public:
+    GenotypeContainerBCF();
+    GenotypeContainerBCF(const char* const data, const U32 n_entries, const meta_type& meta_entry, const BYTE ploidy, const permutation_type* const ppa_manager = nullptr);
+    ~GenotypeContainerBCF();
+
+    // Element access
+    inline const_reference at(const size_type& position) const{ return(*reinterpret_cast<const T* const>(&this->__data[position * sizeof(value_type)])); }
+    inline const_reference operator[](const size_type& position) const{ return(*reinterpret_cast<const T* const>(&this->__data[position * sizeof(value_type)])); }
+    inline const_reference front(void) const{ return(this->at(0)); }
+    inline const_reference back(void) const{ return(this->at(this->n_entries - 1)); }
+    inline const_reference getAllele(const U32 sample, const BYTE allele) const{ return(this->at(sample*this->__ploidy + allele)); }
+
+    inline const BYTE getPloidy(void) const{ return(this->__ploidy); }
+    inline const U32 getNumberSamples(void) const{ return(this->__ploidy ? this->n_entries / this->__ploidy : 0); }
+
+    /**<
+     * Map a stored allele to the allele of a genotype object:
+     * -1 is missing and -2 is EOV
+     * @param allele Stored allele
+     * @return       Returns the allele of a genotype object
+     */
+    inline const SBYTE getLiteralAllele(const T& allele) const{
+    	if(allele == 1) return(-2);
+    	if((allele >> 1) <= 1) return(-1);
+    	return((allele >> 1) - 2);
+    }
+
+    /**<
+     * Map a stored allele to the allele index of a genotype summary:
+     * 0 is EOV, 1 is missing, and 2 + k is allele k
+     * @param allele Stored allele
+     * @return       Returns the allele index of a genotype summary
+     */
+    inline const U32 getSummaryAllele(const T& allele) const{
+    	if(allele == 1) return(0);
+    	if((allele >> 1) <= 1) return(1);
+    	return(allele >> 1);
+    }
+
+    // GT-specific
+	U32 getSum(void) const;
+	square_matrix_type& comparePairwise(square_matrix_type& square_matrix) const;
+	std::vector<gt_object> getLiteralObjects(void) const;
+	std::vector<gt_object> getObjects(const U64& n_samples) const;
+	std::vector<gt_object> getObjects(const U64& n_samples, const permutation_type& ppa_manager) const;
+    void getLiteralObjects(std::vector<gt_object>& objects) const;
+	void getObjects(std::vector<gt_object>& objects, const U64& n_samples) const;
+	void getObjects(std::vector<gt_object>& objects, const U64& n_samples, const permutation_type& ppa_manager) const;
+	gt_summary& updateSummary(gt_summary& gt_summary_object) const;
+	gt_summary getSummary(void) const;
+	gt_summary& getSummary(gt_summary& gt_summary_object) const;
+    void getTsTv(std::vector<ts_tv_object_type>& objects) const;
+
+private:
+    // Construct a genotype object for the sample at `sample`
+    void __setObject(gt_object& object, const U32 sample) const;
+};
+
+
+// IMPLEMENTATION -------------------------------------------------------------
+
+
+template <class return_type>
+GenotypeContainerBCF<return_type>::GenotypeContainerBCF(){
+
+}
+
+template <class return_type>
+GenotypeContainerBCF<return_type>::GenotypeContainerBCF(const char* const data, const U32 n_entries, const meta_type& meta_entry, const BYTE ploidy, const permutation_type* const ppa_manager) :
+	parent_type(data, n_entries, n_entries*sizeof(value_type), meta_entry)
+{
+	this->__ploidy = ploidy;
+	if(ppa_manager == nullptr) return;
+
+	// Gather the samples in the order of the permutation
+	const value_type* const source = reinterpret_cast<const value_type* const>(data);
+	value_type* const target = reinterpret_cast<value_type* const>(this->__data);
+	for(U32 i = 0; i < this->getNumberSamples(); ++i){
+		for(U32 p = 0; p < this->__ploidy; ++p)
+			target[i*this->__ploidy + p] = source[(*ppa_manager)[i]*this->__ploidy + p];
+	}
+}
+
+template <class return_type>
+GenotypeContainerBCF<return_type>::~GenotypeContainerBCF(){  }
+
+template <class return_type>
+U32 GenotypeContainerBCF<return_type>::getSum(void) const{
+	return(this->getNumberSamples());
+}
+
+template <class return_type>
+math::SquareMatrix<double>& GenotypeContainerBCF<return_type>::comparePairwise(square_matrix_type& square_matrix) const{
+	// Score the number of identical alleles between every
+	// pair of samples
+	for(U32 i = 0; i < this->getNumberSamples(); ++i){
+		for(U32 j = i + 1; j < this->getNumberSamples(); ++j){
+			float score = 0;
+			for(U32 p = 0; p < this->__ploidy; ++p)
+				score += (this->getLiteralAllele(this->getAllele(i, p)) == this->getLiteralAllele(this->getAllele(j, p)));
+
+			square_matrix(i, j) += score;
+		}
+	}
+	return(square_matrix);
+}
+
+template <class return_type>
+void GenotypeContainerBCF<return_type>::__setObject(gt_object& object, const U32 sample) const{
+	delete [] object.alleles;
+	object.alleles = new std::pair<char,char>[this->__ploidy];
+	for(U32 p = 0; p < this->__ploidy; ++p){
+		const value_type& allele = this->getAllele(sample, p);
+		object.alleles[p].first  = this->getLiteralAllele(allele);
+		object.alleles[p].second = allele == 1 ? 0 : allele & 1;
+	}
+	object.n_objects = 1;
+	object.n_alleles = this->__ploidy;
+}
+
+template <class return_type>
+std::vector<tachyon::core::GTObject> GenotypeContainerBCF<return_type>::getLiteralObjects(void) const{
+	std::vector<tachyon::core::GTObject> ret(this->getNumberSamples());
+	this->getLiteralObjects(ret);
+	return(ret);
+}
+
+template <class return_type>
+std::vector<tachyon::core::GTObject> GenotypeContainerBCF<return_type>::getObjects(const U64& n_samples) const{
+	std::vector<tachyon::core::GTObject> ret(n_samples);
+	this->getObjects(ret, n_samples);
+	return(ret);
+}
+
+template <class return_type>
+std::vector<tachyon::core::GTObject> GenotypeContainerBCF<return_type>::getObjects(const U64& n_samples, const permutation_type& ppa_manager) const{
+	std::vector<tachyon::core::GTObject> ret(n_samples);
+	this->getObjects(ret, n_samples, ppa_manager);
+	return(ret);
+}
+
+template <class return_type>
+void GenotypeContainerBCF<return_type>::getLiteralObjects(std::vector<tachyon::core::GTObject>& objects) const{
+	if(objects.size() < this->getNumberSamples()) objects.resize(this->getNumberSamples());
+	for(U32 i = 0; i < this->getNumberSamples(); ++i)
+		this->__setObject(objects[i], i);
+}
+
+template <class return_type>
+void GenotypeContainerBCF<return_type>::getObjects(std::vector<tachyon::core::GTObject>& objects, const U64& n_samples) const{
+	if(objects.size() < n_samples) objects.resize(n_samples);
+	assert(this->getNumberSamples() == n_samples);
+	for(U32 i = 0; i < this->getNumberSamples(); ++i)
+		this->__setObject(objects[i], i);
+}
+
+template <class return_type>
+void GenotypeContainerBCF<return_type>::getObjects(std::vector<tachyon::core::GTObject>& objects, const U64& n_samples, const permutation_type& ppa_manager) const{
+	if(objects.size() < n_samples) objects.resize(n_samples);
+	assert(this->getNumberSamples() == n_samples);
+	for(U32 i = 0; i < this->getNumberSamples(); ++i)
+		this->__setObject(objects[ppa_manager[i]], i);
+}
+
+template <class return_type>
+GenotypeSummary& GenotypeContainerBCF<return_type>::updateSummary(gt_summary& gt_summary_object) const{
+	gt_summary_object += *this;
+	return(gt_summary_object);
+}
+
+template <class return_type>
+GenotypeSummary GenotypeContainerBCF<return_type>::getSummary(void) const{
+	gt_summary summary;
+	summary += *this;
+	return(summary);
+}
+
+template <class return_type>
+GenotypeSummary& GenotypeContainerBCF<return_type>::getSummary(gt_summary& gt_summary_object) const{
+	gt_summary_object += *this;
+	return(gt_summary_object);
+}
+
+template <class return_type>
+void GenotypeContainerBCF<return_type>::getTsTv(std::vector<ts_tv_object_type>& objects) const{
+	if(this->size() == 0) return;
+	if(this->getMeta().alleles[0].size() != 1) return;
+
+	// Targets of the summary allele indices: 0 = EOV, 1 = missing,
+	// and 2 + k = allele k
+	const U32 n_references = this->getMeta().getNumberAlleles() + 2;
+	BYTE* references = new BYTE[n_references];
+	references[0] = constants::REF_ALT_MISSING;
+	references[1] = constants::REF_ALT_MISSING;
+
+	for(U32 i = 0; i < this->getMeta().getNumberAlleles(); ++i){
+		if(this->getMeta().alleles[i].size() != 1){
+			references[2 + i] = constants::REF_ALT_MISSING;
+			continue;
+		}
+
+		switch(this->getMeta().alleles[i].allele[0]){
+		case('A'): references[2 + i] = constants::REF_ALT_A; break;
+		case('T'): references[2 + i] = constants::REF_ALT_T; break;
+		case('G'): references[2 + i] = constants::REF_ALT_G; break;
+		case('C'): references[2 + i] = constants::REF_ALT_C; break;
+		default:   references[2 + i] = constants::REF_ALT_MISSING; break;
+		}
+	}
+
+	if(references[2] == constants::REF_ALT_MISSING){
+		std::cerr << "ref cannot be 0" << std::endl;
+		delete [] references;
+		return;
+	}
+
+	const BYTE& from_reference = references[2];
+	const BYTE* const transition_map_target   = constants::TRANSITION_MAP[from_reference];
+	const BYTE* const transversion_map_target = constants::TRANSVERSION_MAP[from_reference];
+
+	// Cycle over samples
+	for(U32 i = 0; i < this->getNumberSamples(); ++i){
+		for(U32 p = 0; p < this->__ploidy; ++p){
+			const U32 allele  = this->getSummaryAllele(this->getAllele(i, p));
+			const BYTE target = allele < n_references ? references[allele] : constants::REF_ALT_MISSING;
+
+			objects[i].n_insertions += (target == constants::REF_ALT_INSERTION);
+			++objects[i].base_conversions[from_reference][target];
+			objects[i].n_transitions   += transition_map_target[target];
+			objects[i].n_transversions += transversion_map_target[target];
+		}
+	}
+
+	// Cleanup
+	delete [] references;
+}
+
+// Defined here as the summary only has a forward declaration of the container
+template <class T>
+inline void GenotypeSummary::operator+=(const GenotypeContainerBCF<T>& gt_bcf_container){
+	if(gt_bcf_container.getMeta().getNumberAlleles() + 2 > this->n_alleles_){
+		std::cerr << "too many alleles: " << gt_bcf_container.getMeta().getNumberAlleles() + 2 << "/" << (int)this->n_alleles_ << std::endl;
+		return;
+	}
+
+	// The first allele is counted in vector A and the
+	// remaining alleles in vector B
+	for(U32 i = 0; i < gt_bcf_container.getNumberSamples(); ++i){
+		++this->vectorA_[gt_bcf_container.getSummaryAllele(gt_bcf_container.getAllele(i, 0))];
+		for(U32 p = 1; p < gt_bcf_container.getPloidy(); ++p)
+			++this->vectorB_[gt_bcf_container.getSummaryAllele(gt_bcf_container.getAllele(i, p))];
+	}
+}
+
+}
+}
+
+#endif /* CONTAINERS_GENOTYPE_CONTAINER_BCF_H_ */
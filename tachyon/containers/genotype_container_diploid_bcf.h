@@ -21,7 +21,7 @@ private:
 
 public:
     GenotypeContainerDiploidBCF();
-    GenotypeContainerDiploidBCF(const char* const data, const U32 n_entries, const meta_type& meta_entry);
+    GenotypeContainerDiploidBCF(const char* const data, const U32 n_entries, const meta_type& meta_entry, const bool separate_eov = true);
     ~GenotypeContainerDiploidBCF();
 
     // Element access
@@ -34,6 +34,21 @@ public:
     inline reference back(void){ return(*reinterpret_cast<const T* const>(&this->__data[(this->n_entries - 1) * sizeof(value_type)])); }
     inline const_reference back(void) const{ return(*reinterpret_cast<const T* const>(&this->__data[(this->n_entries - 1) * sizeof(value_type)])); }
 
+    /**<
+     * Map a stored allele to the allele of a genotype object: -1 is
+     * missing and -2 is EOV. Blocks written before EOV was packed apart
+     * from missing store the BCF EOV value shifted into the allele
+     * bits, which is 0 for BYTE words, if the ploidy is mixed.
+     * @param allele Stored allele
+     * @return       Returns the allele of a genotype object
+     */
+    inline const SBYTE getLiteralAllele(const U64 allele) const{
+    	const BYTE shift = (sizeof(T)*8 - 1) / 2;
+    	if(!this->__separate_eov && this->__meta.isMixedPloidy() && allele == (0x40 & (((U64)1 << shift) - 1)))
+    		return(-2);
+    	return(YON_GT_DIPLOID_BCF_ALLELE(allele));
+    }
+
     // GT-specific
     U32 getSum(void) const;
     square_matrix_type& comparePairwise(square_matrix_type& square_matrix) const;
@@ -61,10 +76,11 @@ GenotypeContainerDiploidBCF<T>::GenotypeContainerDiploidBCF(){
 template <class T>
 GenotypeContainerDiploidBCF<T>::GenotypeContainerDiploidBCF(const char* const  data,
                                                                     const U32  n_entries,
-                                                              const meta_type& meta_entry) :
+                                                              const meta_type& meta_entry,
+                                                                   const bool  separate_eov) :
 	parent_type(data, n_entries, n_entries*sizeof(value_type), meta_entry)
 {
-
+	this->__separate_eov = separate_eov;
 }
 
 template <class T>
@@ -101,8 +117,8 @@ std::vector<core::GTObject> GenotypeContainerDiploidBCF<T>::getObjects(const U64
 
 	for(U32 i = 0; i < this->n_entries; ++i){
 		entries[i].alleles = new std::pair<char,char>[2];
-		entries[i].alleles[0].first  = YON_GT_DIPLOID_BCF_A(this->at(i), shift);
-		entries[i].alleles[1].first  = YON_GT_DIPLOID_BCF_B(this->at(i), shift);
+		entries[i].alleles[0].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_A(this->at(i), shift));
+		entries[i].alleles[1].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_B(this->at(i), shift));
 		entries[i].alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
 		entries[i].alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
 		entries[i].n_objects = 1;
@@ -119,15 +135,14 @@ std::vector<core::GTObject> GenotypeContainerDiploidBCF<T>::getObjects(const U64
 
 	const BYTE shift = (sizeof(T)*8 - 1) / 2;
 
-	U32 cum_pos = 0;
 	for(U32 i = 0; i < this->n_entries; ++i){
-		entries[ppa_manager[cum_pos]].alleles = new std::pair<char,char>[2];
-		entries[ppa_manager[cum_pos]].alleles[0].first  = YON_GT_DIPLOID_BCF_A(this->at(i), shift);
-		entries[ppa_manager[cum_pos]].alleles[1].first  = YON_GT_DIPLOID_BCF_B(this->at(i), shift);
-		entries[ppa_manager[cum_pos]].alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
-		entries[ppa_manager[cum_pos]].alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
-		entries[ppa_manager[cum_pos]].n_objects = 1;
-		entries[ppa_manager[cum_pos]].n_alleles = 2;
+		entries[ppa_manager[i]].alleles = new std::pair<char,char>[2];
+		entries[ppa_manager[i]].alleles[0].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_A(this->at(i), shift));
+		entries[ppa_manager[i]].alleles[1].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_B(this->at(i), shift));
+		entries[ppa_manager[i]].alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
+		entries[ppa_manager[i]].alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
+		entries[ppa_manager[i]].n_objects = 1;
+		entries[ppa_manager[i]].n_alleles = 2;
 	}
 
 	//assert(cum_pos == n_samples);
@@ -152,8 +167,8 @@ void GenotypeContainerDiploidBCF<T>::getObjects(std::vector<core::GTObject>& obj
 	for(U32 i = 0; i < this->n_entries; ++i){
 		delete [] entries[i].alleles;
 		entries[i].alleles = new std::pair<char,char>[2];
-		entries[i].alleles[0].first  = YON_GT_DIPLOID_BCF_A(this->at(i), shift);
-		entries[i].alleles[1].first  = YON_GT_DIPLOID_BCF_B(this->at(i), shift);
+		entries[i].alleles[0].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_A(this->at(i), shift));
+		entries[i].alleles[1].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_B(this->at(i), shift));
 		entries[i].alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
 		entries[i].alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
 		entries[i].n_objects = 1;
@@ -168,16 +183,15 @@ void GenotypeContainerDiploidBCF<T>::getObjects(std::vector<core::GTObject>& obj
 
 	const BYTE shift = (sizeof(T)*8 - 1) / 2;
 
-	U32 cum_pos = 0;
 	for(U32 i = 0; i < this->n_entries; ++i){
-		delete [] entries[ppa_manager[cum_pos]].alleles;
-		entries[ppa_manager[cum_pos]].alleles = new std::pair<char,char>[2];
-		entries[ppa_manager[cum_pos]].alleles[0].first  = YON_GT_DIPLOID_BCF_A(this->at(i), shift);
-		entries[ppa_manager[cum_pos]].alleles[1].first  = YON_GT_DIPLOID_BCF_B(this->at(i), shift);
-		entries[ppa_manager[cum_pos]].alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
-		entries[ppa_manager[cum_pos]].alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
-		entries[ppa_manager[cum_pos]].n_objects = 1;
-		entries[ppa_manager[cum_pos]].n_alleles = 2;
+		delete [] entries[ppa_manager[i]].alleles;
+		entries[ppa_manager[i]].alleles = new std::pair<char,char>[2];
+		entries[ppa_manager[i]].alleles[0].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_A(this->at(i), shift));
+		entries[ppa_manager[i]].alleles[1].first  = this->getLiteralAllele(YON_GT_DIPLOID_BCF_B(this->at(i), shift));
+		entries[ppa_manager[i]].alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
+		entries[ppa_manager[i]].alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(this->at(i));
+		entries[ppa_manager[i]].n_objects = 1;
+		entries[ppa_manager[i]].n_alleles = 2;
 	}
 }
 
@@ -0,0 +1,341 @@
+#ifndef CONTAINERS_GENOTYPE_CONTAINER_DIPLOID_BITPLANE_H_
+#define CONTAINERS_GENOTYPE_CONTAINER_DIPLOID_BITPLANE_H_
+
+#include "genotype_container_interface.h"
+
+namespace tachyon{
+namespace containers{
+
+/**<
+ * Genotypes of a diploid biallelic variant stored as bit-planes in
+ * the order of the block permutation. Bit `i` of a plane refers to
+ * sample `i` and is stored in word `i / 64` at position `i % 64`.
+ * Planes are stored consecutively as aligned 64-bit words:
+ *   1) allele A is the alternative allele
+ *   2) allele B is the alternative allele
+ *   3) both alleles are missing (only if any genotype is missing)
+ * Missing samples have no bits set in the allele planes and unused
+ * bits in the last word of each plane are zero such that allele
+ * counts and comparisons reduce to AND and POPCNT loops.
+ */
+class GenotypeContainerDiploidBitplane : public GenotypeContainerInterface{
+private:
+	typedef GenotypeContainerInterface       parent_type;
+    typedef GenotypeContainerDiploidBitplane self_type;
+    typedef U64                              value_type;
+    typedef value_type&                      reference;
+    typedef const value_type&                const_reference;
+    typedef value_type*                      pointer;
+    typedef const value_type*                const_pointer;
+    typedef std::ptrdiff_t                   difference_type;
+    typedef std::size_t                      size_type;
+
+public:
+    /**<
+     * Words of the three planes at the same position
+     */
+    struct word_type{
+    	word_type(const U64 alleleA, const U64 alleleB, const U64 missing) : alleleA(alleleA), alleleB(alleleB), missing(missing){}
+
+    	U64 alleleA;
+    	U64 alleleB;
+    	U64 missing;
+    };
+
+    /**<
+     * Iterator over the words of the planes for analysis kernels
+     */
+    class const_iterator{
+	private:
+		typedef const_iterator self_type;
+		typedef std::forward_iterator_tag iterator_category;
+
+	public:
+		const_iterator(const U64* alleleA, const U64* alleleB, const U64* missing) : alleleA_(alleleA), alleleB_(alleleB), missing_(missing){}
+		void operator++(){ ++this->alleleA_; ++this->alleleB_; if(this->missing_ != nullptr) ++this->missing_; }
+		void operator++(int junk){ ++(*this); }
+		word_type operator*() const{ return(word_type(*this->alleleA_, *this->alleleB_, this->missing_ == nullptr ? 0 : *this->missing_)); }
+		bool operator==(const self_type& rhs) const{ return(this->alleleA_ == rhs.alleleA_); }
+		bool operator!=(const self_type& rhs) const{ return(this->alleleA_ != rhs.alleleA_); }
+
+	private:
+		const U64* alleleA_;
+		const U64* alleleB_;
+		const U64* missing_;
+	};
+
+public:
+    GenotypeContainerDiploidBitplane();
+    GenotypeContainerDiploidBitplane(const char* const data, const U32 n_samples, const meta_type& meta_entry);
+    ~GenotypeContainerDiploidBitplane();
+
+    /**<
+     * Number of bytes occupied by the planes of a variant
+     * @param n_samples  Number of samples
+     * @param meta_entry Meta entry of the variant
+     * @return           Returns the number of bytes
+     */
+    static inline U64 getBytes(const U32 n_samples, const meta_type& meta_entry){
+    	return((meta_entry.isAnyGTMissing() ? 3 : 2) * YON_GT_BITPLANE_WORDS(n_samples) * sizeof(value_type));
+    }
+
+    // Raw planes
+    inline const U32 getNumberWords(void) const{ return(YON_GT_BITPLANE_WORDS(this->n_entries)); }
+    inline const_pointer getAlleleA(void) const{ return(reinterpret_cast<const_pointer>(this->__data)); }
+    inline const_pointer getAlleleB(void) const{ return(reinterpret_cast<const_pointer>(this->__data) + this->getNumberWords()); }
+    inline const_pointer getMissing(void) const{ return(this->__meta.isAnyGTMissing() ? reinterpret_cast<const_pointer>(this->__data) + 2*this->getNumberWords() : nullptr); }
+
+    // Iterator
+    inline const_iterator begin(void) const{ return(const_iterator(this->getAlleleA(), this->getAlleleB(), this->getMissing())); }
+    inline const_iterator end(void) const{
+    	const U32 n_words = this->getNumberWords();
+    	return(const_iterator(this->getAlleleA() + n_words, this->getAlleleB() + n_words, this->getMissing() == nullptr ? nullptr : this->getMissing() + n_words));
+    }
+
+    // Element access: alleles of sample `position` (0 = ref, 1 = alt, 2 = missing)
+    inline const BYTE getAlleleA(const U32 position) const{
+    	if(this->isMissing(position)) return(2);
+    	return((this->getAlleleA()[position >> 6] >> (position & 63)) & 1);
+    }
+    inline const BYTE getAlleleB(const U32 position) const{
+    	if(this->isMissing(position)) return(2);
+    	return((this->getAlleleB()[position >> 6] >> (position & 63)) & 1);
+    }
+    inline const bool isMissing(const U32 position) const{
+    	const_pointer missing = this->getMissing();
+    	return(missing != nullptr && ((missing[position >> 6] >> (position & 63)) & 1));
+    }
+
+    // Kernels
+    U64 getAlleleCount(void) const;  // number of alternative alleles
+    U64 getMissingCount(void) const; // number of missing genotypes
+
+    // GT-specific
+    U32 getSum(void) const;
+    square_matrix_type& comparePairwise(square_matrix_type& square_matrix) const;
+    std::vector<gt_object> getLiteralObjects(void) const;
+    std::vector<gt_object> getObjects(const U64& n_samples) const;
+    std::vector<gt_object> getObjects(const U64& n_samples, const permutation_type& ppa_manager) const;
+    void getLiteralObjects(std::vector<gt_object>& objects) const;
+	void getObjects(std::vector<gt_object>& objects, const U64& n_samples) const;
+	void getObjects(std::vector<gt_object>& objects, const U64& n_samples, const permutation_type& ppa_manager) const;
+
+    gt_summary& updateSummary(gt_summary& gt_summary_object) const;
+    gt_summary getSummary(void) const;
+    gt_summary& getSummary(gt_summary& gt_summary_object) const;
+    void getTsTv(std::vector<ts_tv_object_type>& objects) const;
+
+private:
+    // Construct a genotype object for the sample at `position`
+    void __setObject(gt_object& object, const U32 position) const;
+};
+
+
+// IMPLEMENTATION -------------------------------------------------------------
+
+
+inline GenotypeContainerDiploidBitplane::GenotypeContainerDiploidBitplane(){
+
+}
+
+inline GenotypeContainerDiploidBitplane::GenotypeContainerDiploidBitplane(const char* const data, const U32 n_samples, const meta_type& meta_entry) :
+	parent_type(data, n_samples, self_type::getBytes(n_samples, meta_entry), meta_entry)
+{
+
+}
+
+inline GenotypeContainerDiploidBitplane::~GenotypeContainerDiploidBitplane(){  }
+
+inline U64 GenotypeContainerDiploidBitplane::getAlleleCount(void) const{
+	U64 count = 0;
+	for(const_iterator it = this->begin(); it != this->end(); ++it){
+		const word_type word = *it;
+		count += __builtin_popcountll(word.alleleA) + __builtin_popcountll(word.alleleB);
+	}
+	return(count);
+}
+
+inline U64 GenotypeContainerDiploidBitplane::getMissingCount(void) const{
+	const_pointer missing = this->getMissing();
+	if(missing == nullptr) return(0);
+
+	U64 count = 0;
+	for(U32 i = 0; i < this->getNumberWords(); ++i)
+		count += __builtin_popcountll(missing[i]);
+
+	return(count);
+}
+
+inline U32 GenotypeContainerDiploidBitplane::getSum(void) const{ return(this->n_entries); }
+
+inline math::SquareMatrix<double>& GenotypeContainerDiploidBitplane::comparePairwise(square_matrix_type& square_matrix) const{
+	// Has to be a SNV
+	if(this->getMeta().isBiallelicSNV() == false)
+		return square_matrix;
+
+	for(U32 i = 0; i < this->n_entries; ++i){
+		const BYTE ref_alleleA = this->getAlleleA(i);
+		const BYTE ref_alleleB = this->getAlleleB(i);
+
+		for(U32 j = i + 1; j < this->n_entries; ++j){
+			const float score = this->comparatorSamplesDiploid(this->getAlleleA(j), ref_alleleA, this->getAlleleB(j), ref_alleleB);
+			if(score == 0) continue;
+			square_matrix(i, j) += score;
+		}
+	}
+	return(square_matrix);
+}
+
+inline void GenotypeContainerDiploidBitplane::__setObject(gt_object& object, const U32 position) const{
+	SBYTE alleleA = this->getAlleleA(position);
+	SBYTE alleleB = this->getAlleleB(position);
+	if(alleleA == 2) alleleA = -1;
+	if(alleleB == 2) alleleB = -1;
+
+	delete [] object.alleles;
+	object.alleles = new std::pair<char,char>[2];
+	object.alleles[0].first  = alleleA;
+	object.alleles[1].first  = alleleB;
+	object.alleles[0].second = this->__meta.getControllerPhase();
+	object.alleles[1].second = this->__meta.getControllerPhase();
+	object.n_objects = 1;
+	object.n_alleles = 2;
+}
+
+inline std::vector<tachyon::core::GTObject> GenotypeContainerDiploidBitplane::getLiteralObjects(void) const{
+	std::vector<tachyon::core::GTObject> ret(this->n_entries);
+	for(U32 i = 0; i < this->n_entries; ++i)
+		this->__setObject(ret[i], i);
+
+	return(ret);
+}
+
+inline std::vector<tachyon::core::GTObject> GenotypeContainerDiploidBitplane::getObjects(const U64& n_samples) const{
+	std::vector<tachyon::core::GTObject> ret(n_samples);
+	for(U32 i = 0; i < this->n_entries; ++i)
+		this->__setObject(ret[i], i);
+
+	return(ret);
+}
+
+inline std::vector<tachyon::core::GTObject> GenotypeContainerDiploidBitplane::getObjects(const U64& n_samples, const permutation_type& ppa_manager) const{
+	std::vector<tachyon::core::GTObject> ret(n_samples);
+	for(U32 i = 0; i < this->n_entries; ++i)
+		this->__setObject(ret[ppa_manager[i]], i);
+
+	return(ret);
+}
+
+inline void GenotypeContainerDiploidBitplane::getLiteralObjects(std::vector<tachyon::core::GTObject>& objects) const{
+	if(objects.size() < this->size()) objects.resize(this->size());
+	for(U32 i = 0; i < this->n_entries; ++i)
+		this->__setObject(objects[i], i);
+}
+
+inline void GenotypeContainerDiploidBitplane::getObjects(std::vector<tachyon::core::GTObject>& objects, const U64& n_samples) const{
+	if(objects.size() < n_samples) objects.resize(n_samples);
+	for(U32 i = 0; i < this->n_entries; ++i)
+		this->__setObject(objects[i], i);
+}
+
+inline void GenotypeContainerDiploidBitplane::getObjects(std::vector<tachyon::core::GTObject>& objects, const U64& n_samples, const permutation_type& ppa_manager) const{
+	if(objects.size() != n_samples) objects.resize(n_samples);
+	for(U32 i = 0; i < this->n_entries; ++i)
+		this->__setObject(objects[ppa_manager[i]], i);
+}
+
+inline GenotypeSummary& GenotypeContainerDiploidBitplane::updateSummary(gt_summary& gt_summary_object) const{
+	gt_summary_object += *this;
+	return(gt_summary_object);
+}
+
+inline GenotypeSummary GenotypeContainerDiploidBitplane::getSummary(void) const{
+	gt_summary summary;
+	summary += *this;
+	return(summary);
+}
+
+inline GenotypeSummary& GenotypeContainerDiploidBitplane::getSummary(gt_summary& gt_summary_object) const{
+	gt_summary_object += *this;
+	return(gt_summary_object);
+}
+
+inline void GenotypeContainerDiploidBitplane::getTsTv(std::vector<ts_tv_object_type>& objects) const{
+	if(this->size() == 0) return;
+	if(this->getMeta().isDiploid() == false) return;
+	if(this->getMeta().alleles[0].size() != 1) return;
+	assert(this->getMeta().getNumberAlleles() == 2);
+
+	BYTE references[3];
+	switch(this->getMeta().alleles[0].allele[0]){
+	case('A'): references[0] = constants::REF_ALT_A; break;
+	case('T'): references[0] = constants::REF_ALT_T; break;
+	case('G'): references[0] = constants::REF_ALT_G; break;
+	case('C'): references[0] = constants::REF_ALT_C; break;
+	default:   references[0] = constants::REF_ALT_MISSING; break;
+	}
+
+	if(references[0] == constants::REF_ALT_MISSING){
+		std::cerr << "ref cannot be 0" << std::endl;
+		return;
+	}
+
+	switch(this->getMeta().alleles[1].allele[0]){
+	case('A'): references[1] = constants::REF_ALT_A; break;
+	case('T'): references[1] = constants::REF_ALT_T; break;
+	case('G'): references[1] = constants::REF_ALT_G; break;
+	case('C'): references[1] = constants::REF_ALT_C; break;
+	case('N'):
+	default:   references[1] = constants::REF_ALT_MISSING; break;
+	}
+	references[2] = 4;
+
+	const BYTE* const transition_map_target   = constants::TRANSITION_MAP[references[0]];
+	const BYTE* const transversion_map_target = constants::TRANSVERSION_MAP[references[0]];
+
+	for(U32 i = 0; i < this->n_entries; ++i){
+		const BYTE targetA = references[this->getAlleleA(i)];
+		const BYTE targetB = references[this->getAlleleB(i)];
+
+		objects[i].n_insertions += (targetA == constants::REF_ALT_INSERTION) + (targetB == constants::REF_ALT_INSERTION);
+		++objects[i].base_conversions[references[0]][targetA];
+		++objects[i].base_conversions[references[0]][targetB];
+		objects[i].n_transitions   += transition_map_target[targetA];
+		objects[i].n_transversions += transversion_map_target[targetA];
+		objects[i].n_transitions   += transition_map_target[targetB];
+		objects[i].n_transversions += transversion_map_target[targetB];
+	}
+}
+
+// Defined here as the summary only has a forward declaration of the container
+inline void GenotypeSummary::operator+=(const GenotypeContainerDiploidBitplane& gt_bitplane_container){
+	const U64* const alleleA = gt_bitplane_container.getAlleleA();
+	const U64* const alleleB = gt_bitplane_container.getAlleleB();
+
+	U64 n_alt_alt = 0, n_alt_ref = 0, n_ref_alt = 0;
+	for(U32 i = 0; i < gt_bitplane_container.getNumberWords(); ++i){
+		n_alt_alt += __builtin_popcountll(alleleA[i] & alleleB[i]);
+		n_alt_ref += __builtin_popcountll(alleleA[i] & ~alleleB[i]);
+		n_ref_alt += __builtin_popcountll(~alleleA[i] & alleleB[i]);
+	}
+	const U64 n_missing = gt_bitplane_container.getMissingCount();
+	const U64 n_ref_ref = gt_bitplane_container.size() - n_missing - n_alt_alt - n_alt_ref - n_ref_alt;
+
+	// Remapped as TACHYON_GT_SUMMARY_REMAP: missing = 1, ref = 2, alt = 3
+	this->matrix_[2][2] += n_ref_ref;
+	this->matrix_[2][3] += n_ref_alt;
+	this->matrix_[3][2] += n_alt_ref;
+	this->matrix_[3][3] += n_alt_alt;
+	this->matrix_[1][1] += n_missing;
+	this->vectorA_[2] += n_ref_ref + n_ref_alt;
+	this->vectorA_[3] += n_alt_ref + n_alt_alt;
+	this->vectorA_[1] += n_missing;
+	this->vectorB_[2] += n_ref_ref + n_alt_ref;
+	this->vectorB_[3] += n_ref_alt + n_alt_alt;
+	this->vectorB_[1] += n_missing;
+}
+
+}
+}
+
+#endif /* CONTAINERS_GENOTYPE_CONTAINER_DIPLOID_BITPLANE_H_ */
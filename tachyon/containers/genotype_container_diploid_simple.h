@@ -21,7 +21,7 @@ private:
 
 public:
     GenotypeContainerDiploidSimple();
-    GenotypeContainerDiploidSimple(const char* const data, const U32 n_entries, const meta_type& meta_entry);
+    GenotypeContainerDiploidSimple(const char* const data, const U32 n_entries, const meta_type& meta_entry, const bool separate_eov = true);
     ~GenotypeContainerDiploidSimple();
 
     void operator()(const char* const data, const U32 n_entries, const meta_type& meta_entry){
@@ -43,6 +43,23 @@ public:
    inline reference back(void){ return(*reinterpret_cast<const T* const>(&this->__data[(this->n_entries - 1) * sizeof(value_type)])); }
    inline const_reference back(void) const{ return(*reinterpret_cast<const T* const>(&this->__data[(this->n_entries - 1) * sizeof(value_type)])); }
 
+    /**<
+     * Map a stored allele to the allele of a genotype object: -1 is
+     * missing and -2 is EOV. Alleles are offset by one, or by two if
+     * the ploidy is mixed, and 0 is missing and 1 is EOV. Blocks
+     * written before EOV was packed apart from missing store both as
+     * 0 which is read as EOV if the ploidy is mixed.
+     * @param allele Stored allele
+     * @return       Returns the allele of a genotype object
+     */
+    inline const SBYTE getLiteralAllele(const BYTE allele) const{
+    	if(this->__separate_eov){
+    		if(allele == 0) return(-1);
+    		if(allele == 1 && this->__meta.isMixedPloidy()) return(-2);
+    	}
+    	return(allele - 1 - this->__meta.isMixedPloidy());
+    }
+
     // GT-specific
 	U32 getSum(void) const;
 	square_matrix_type& comparePairwise(square_matrix_type& square_matrix) const;
@@ -69,10 +86,10 @@ GenotypeContainerDiploidSimple<return_type>::GenotypeContainerDiploidSimple(){
 }
 
 template <class return_type>
-GenotypeContainerDiploidSimple<return_type>::GenotypeContainerDiploidSimple(const char* const data, const U32 n_entries, const meta_type& meta_entry) :
+GenotypeContainerDiploidSimple<return_type>::GenotypeContainerDiploidSimple(const char* const data, const U32 n_entries, const meta_type& meta_entry, const bool separate_eov) :
 	parent_type(data, n_entries, n_entries*sizeof(value_type), meta_entry)
 {
-
+	this->__separate_eov = separate_eov;
 }
 
 template <class return_type>
@@ -165,17 +182,11 @@ std::vector<tachyon::core::GTObject> GenotypeContainerDiploidSimple<return_type>
 
 	U32 cum_pos = 0;
 	for(U32 i = 0; i < this->n_entries; ++i){
-		const U32 length = YON_GT_RLE_LENGTH(this->at(i), shift, add);
-		BYTE alleleA     = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
-		BYTE alleleB     = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
-
-		// 0 is missing, 1 is EOV
-		if(this->at(i) == 0)      alleleA = -1;
-		else if(this->at(i) == 1) alleleA = -2;
-		else {
-			alleleA -= 2;
-			alleleB -= 2;
-		}
+		const U32 length    = YON_GT_RLE_LENGTH(this->at(i), shift, add);
+		const BYTE packedA  = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
+		const BYTE packedB  = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
+		const SBYTE alleleA = this->getLiteralAllele(packedA);
+		const SBYTE alleleB = this->getLiteralAllele(packedB);
 
 		BYTE phasing = 0;
 		if(add) phasing = this->at(i) & 1;
@@ -199,16 +210,16 @@ std::vector<tachyon::core::GTObject> GenotypeContainerDiploidSimple<return_type>
 	std::vector<tachyon::core::GTObject> ret(n_samples);
 	tachyon::core::GTObjectDiploidSimple* entries = reinterpret_cast<tachyon::core::GTObjectDiploidSimple*>(&ret[0]);
 
-	const BYTE shift    = ceil(log2(this->__meta.getNumberAlleles() + 1 + this->__meta.isAnyGTMissing() + this->__meta.isMixedPloidy())); // Bits occupied per allele, 1 value for missing
-	const BYTE add      = this->__meta.isGTMixedPhasing() ? 1 : 0;
-	const BYTE subtract = this->__meta.isMixedPloidy()    ? 2 : 1;
+	const BYTE shift = ceil(log2(this->__meta.getNumberAlleles() + 1 + this->__meta.isAnyGTMissing() + this->__meta.isMixedPloidy())); // Bits occupied per allele, 1 value for missing
+	const BYTE add   = this->__meta.isGTMixedPhasing() ? 1 : 0;
 
 	U32 cum_pos = 0;
 	for(U32 i = 0; i < this->n_entries; ++i){
-		const U32 length = YON_GT_RLE_LENGTH(this->at(i), shift, add);
-		SBYTE alleleA    = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
-		SBYTE alleleB    = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
-		alleleA -= subtract; alleleB -= subtract;
+		const U32 length    = YON_GT_RLE_LENGTH(this->at(i), shift, add);
+		const BYTE packedA  = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
+		const BYTE packedB  = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
+		const SBYTE alleleA = this->getLiteralAllele(packedA);
+		const SBYTE alleleB = this->getLiteralAllele(packedB);
 
 		BYTE phasing = 0;
 		if(add) phasing = this->at(i) & 1;
@@ -247,17 +258,11 @@ void GenotypeContainerDiploidSimple<return_type>::getObjects(std::vector<tachyon
 
 	U32 cum_pos = 0;
 	for(U32 i = 0; i < this->n_entries; ++i){
-		const U32 length = YON_GT_RLE_LENGTH(this->at(i), shift, add);
-		BYTE alleleA     = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
-		BYTE alleleB     = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
-
-		// 0 is missing, 1 is EOV
-		if(this->at(i) == 0)      alleleA = -1;
-		else if(this->at(i) == 1) alleleA = -2;
-		else {
-			alleleA -= 2;
-			alleleB -= 2;
-		}
+		const U32 length    = YON_GT_RLE_LENGTH(this->at(i), shift, add);
+		const BYTE packedA  = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
+		const BYTE packedB  = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
+		const SBYTE alleleA = this->getLiteralAllele(packedA);
+		const SBYTE alleleB = this->getLiteralAllele(packedB);
 
 		BYTE phasing = 0;
 		if(add) phasing = this->at(i) & 1;
@@ -281,16 +286,16 @@ void GenotypeContainerDiploidSimple<return_type>::getObjects(std::vector<tachyon
 	if(objects.size() < n_samples) objects.resize(n_samples);
 	tachyon::core::GTObjectDiploidSimple* entries = reinterpret_cast<tachyon::core::GTObjectDiploidSimple*>(&objects[0]);
 
-	const BYTE shift    = ceil(log2(this->__meta.getNumberAlleles() + 1 + this->__meta.isAnyGTMissing() + this->__meta.isMixedPloidy())); // Bits occupied per allele, 1 value for missing
-	const BYTE add      = this->__meta.isGTMixedPhasing() ? 1 : 0;
-	const BYTE subtract = this->__meta.isMixedPloidy()    ? 2 : 1;
+	const BYTE shift = ceil(log2(this->__meta.getNumberAlleles() + 1 + this->__meta.isAnyGTMissing() + this->__meta.isMixedPloidy())); // Bits occupied per allele, 1 value for missing
+	const BYTE add   = this->__meta.isGTMixedPhasing() ? 1 : 0;
 
 	U32 cum_pos = 0;
 	for(U32 i = 0; i < this->n_entries; ++i){
-		const U32 length = YON_GT_RLE_LENGTH(this->at(i), shift, add);
-		SBYTE alleleA    = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
-		SBYTE alleleB    = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
-		alleleA -= subtract; alleleB -= subtract;
+		const U32 length    = YON_GT_RLE_LENGTH(this->at(i), shift, add);
+		const BYTE packedA  = YON_GT_RLE_ALLELE_A(this->at(i), shift, add);
+		const BYTE packedB  = YON_GT_RLE_ALLELE_B(this->at(i), shift, add);
+		const SBYTE alleleA = this->getLiteralAllele(packedA);
+		const SBYTE alleleB = this->getLiteralAllele(packedB);
 
 		BYTE phasing = 0;
 		if(add) phasing = this->at(i) & 1;
@@ -341,6 +346,7 @@ void GenotypeContainerDiploidSimple<return_type>::getTsTv(std::vector<ts_tv_obje
 
 	references[0] = constants::REF_ALT_MISSING;
 	references[1 + this->__meta.isMixedPloidy()] = constants::REF_ALT_MISSING;
+	if(this->__meta.isMixedPloidy()) references[1] = constants::REF_ALT_MISSING; // EOV
 	U32 start_reference = 1 + this->__meta.isMixedPloidy();
 
 	switch(this->getMeta().alleles[0].allele[0]){
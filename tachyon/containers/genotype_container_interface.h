@@ -32,13 +32,17 @@ protected:
 public:
     GenotypeContainerInterface(void) :
     	n_entries(0),
-		__data(nullptr)
+		__data(nullptr),
+		__ploidy(0),
+		__separate_eov(true)
 	{}
 
     GenotypeContainerInterface(const char* const data, const size_type& n_entries, const U32& n_bytes, const meta_type& meta) :
     	n_entries(n_entries),
 		__data(new char[n_bytes]),
-		__meta(meta)
+		__meta(meta),
+		__ploidy(0),
+		__separate_eov(true)
     {
     	memcpy(this->__data, data, n_bytes);
     }
@@ -106,6 +110,10 @@ protected:
     size_type        n_entries;
     char*            __data;
     const meta_type  __meta;
+    // Containers are constructed in place in arrays of this type and
+    // cannot declare members of their own: state is kept here instead
+    BYTE             __ploidy;       // ploidy of BCF-style genotypes
+    bool             __separate_eov; // EOV and missing are packed apart
 };
 
 }
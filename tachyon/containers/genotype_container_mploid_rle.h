@@ -0,0 +1,352 @@
+#ifndef CONTAINERS_GENOTYPE_CONTAINER_MPLOID_RLE_H_
+#define CONTAINERS_GENOTYPE_CONTAINER_MPLOID_RLE_H_
+
+#include "genotype_container_interface.h"
+
+namespace tachyon{
+namespace containers{
+
+/**<
+ * Run-length encoded genotypes of haploid and polyploid variants.
+ * The runs are preceded by a single word storing the ploidy of the
+ * variant. Each run stores the length | allele_P-1 | ... | allele_0 | phase
+ * where the phase bit is only stored if the phasing is mixed. Biallelic
+ * variants store alleles as 0 = ref, 1 = alt, and 2 = missing. Other
+ * variants store alleles as 0 = missing, 1 = EOV if the ploidy is
+ * mixed, and the allele otherwise.
+ */
+template <class T>
+class GenotypeContainerMploidRLE : public GenotypeContainerInterface{
+private:
+	typedef GenotypeContainerInterface       parent_type;
+    typedef GenotypeContainerMploidRLE       self_type;
+    typedef T                                value_type;
+    typedef value_type&                      reference;
+    typedef const value_type&                const_reference;
+    typedef value_type*                      pointer;
+    typedef const value_type*                const_pointer;
+    typedef std::ptrdiff_t                   difference_type;
+    typedef std::size_t                      size_type;
+
+public:
+    GenotypeContainerMploidRLE();
+    GenotypeContainerMploidRLE(const char* const data, const U32 n_entries, const meta_type& meta_entry);
+    ~GenotypeContainerMploidRLE();
+
+    // Number of bytes used by a variant with n_entries runs
+    static inline const U64 getBytes(const U32 n_entries){ return((n_entries + 1) * sizeof(value_type)); }
+
+    // Element access: the runs follow the ploidy word
+    inline const_reference at(const size_type& position) const{ return(*reinterpret_cast<const T* const>(&this->__data[(position + 1) * sizeof(value_type)])); }
+    inline const_reference operator[](const size_type& position) const{ return(*reinterpret_cast<const T* const>(&this->__data[(position + 1) * sizeof(value_type)])); }
+    inline const_reference front(void) const{ return(this->at(0)); }
+    inline const_reference back(void) const{ return(this->at(this->n_entries - 1)); }
+
+    // Layout: derived from the data and meta as containers
+    // are constructed in place of the interface
+    inline const BYTE getPloidy(void) const{ return(*reinterpret_cast<const T* const>(this->__data)); }
+    inline const bool isBiallelic(void) const{ return(this->__meta.getGenotypeEncoding() == TACHYON_GT_ENCODING::YON_GT_RLE_MPLOID_BIALLELIC); }
+    inline const BYTE getAdd(void) const{ return(this->__meta.isGTMixedPhasing() ? 1 : 0); }
+    inline const BYTE getShift(void) const{
+    	if(this->isBiallelic()) return(this->__meta.isAnyGTMissing() ? 2 : 1);
+    	return(ceil(log2(this->__meta.getNumberAlleles() + 1 + this->__meta.isAnyGTMissing() + this->__meta.isMixedPloidy())));
+    }
+    inline const U64 getLength(const size_type& position) const{ return(this->at(position) >> (this->getPloidy()*this->getShift() + this->getAdd())); }
+    inline const BYTE getAllele(const size_type& position, const BYTE allele) const{
+    	return((this->at(position) >> (this->getAdd() + allele*this->getShift())) & ((1 << this->getShift()) - 1));
+    }
+
+    /**<
+     * Map a stored allele to the allele of a genotype object:
+     * -1 is missing and -2 is EOV
+     * @param allele Stored allele
+     * @return       Returns the allele of a genotype object
+     */
+    inline const SBYTE getLiteralAllele(const BYTE allele) const{
+    	if(this->isBiallelic()) return(allele == 2 ? -1 : allele);
+    	if(allele == 0) return(-1);
+    	if(allele == 1 && this->__meta.isMixedPloidy()) return(-2);
+    	return(allele - 1 - this->__meta.isMixedPloidy());
+    }
+
+    /**<
+     * Map a stored allele to the allele index of a genotype summary:
+     * 0 is EOV, 1 is missing, and 2 + k is allele k
+     * @param allele Stored allele
+     * @return       Returns the allele index of a genotype summary
+     */
+    inline const BYTE getSummaryAllele(const BYTE allele) const{
+    	const SBYTE literal = this->getLiteralAllele(allele);
+    	if(literal == -1) return(1);
+    	if(literal == -2) return(0);
+    	return(literal + 2);
+    }
+
+    // GT-specific
+	U32 getSum(void) const;
+	square_matrix_type& comparePairwise(square_matrix_type& square_matrix) const;
+	std::vector<gt_object> getLiteralObjects(void) const;
+	std::vector<gt_object> getObjects(const U64& n_samples) const;
+	std::vector<gt_object> getObjects(const U64& n_samples, const permutation_type& ppa_manager) const;
+    void getLiteralObjects(std::vector<gt_object>& objects) const;
+	void getObjects(std::vector<gt_object>& objects, const U64& n_samples) const;
+	void getObjects(std::vector<gt_object>& objects, const U64& n_samples, const permutation_type& ppa_manager) const;
+	gt_summary& updateSummary(gt_summary& gt_summary_object) const;
+	gt_summary getSummary(void) const;
+	gt_summary& getSummary(gt_summary& gt_summary_object) const;
+    void getTsTv(std::vector<ts_tv_object_type>& objects) const;
+
+private:
+    // Construct a genotype object for the run at `position`
+    void __setObject(gt_object& object, const U32 position) const;
+};
+
+
+// IMPLEMENTATION -------------------------------------------------------------
+
+
+template <class return_type>
+GenotypeContainerMploidRLE<return_type>::GenotypeContainerMploidRLE(){
+
+}
+
+template <class return_type>
+GenotypeContainerMploidRLE<return_type>::GenotypeContainerMploidRLE(const char* const data, const U32 n_entries, const meta_type& meta_entry) :
+	parent_type(data, n_entries, self_type::getBytes(n_entries), meta_entry)
+{
+
+}
+
+template <class return_type>
+GenotypeContainerMploidRLE<return_type>::~GenotypeContainerMploidRLE(){  }
+
+template <class return_type>
+U32 GenotypeContainerMploidRLE<return_type>::getSum(void) const{
+	U32 count = 0;
+	for(U32 i = 0; i < this->n_entries; ++i)
+		count += this->getLength(i);
+
+	return(count);
+}
+
+template <class return_type>
+math::SquareMatrix<double>& GenotypeContainerMploidRLE<return_type>::comparePairwise(square_matrix_type& square_matrix) const{
+	// Score the number of identical alleles for haploid and
+	// polyploid samples
+	U32 start_position = 0;
+	for(U32 i = 0; i < this->n_entries; ++i){
+		const U32 ref_length = this->getLength(i);
+
+		// Cycle over implicit elements in object
+		for(U32 start_sample = start_position; start_sample < start_position + ref_length; ++start_sample){
+			for(U32 end_sample = start_sample + 1; end_sample < start_position + ref_length; ++end_sample)
+				square_matrix(start_sample, end_sample) += this->getPloidy();
+		}
+
+		U32 internal_start = start_position + ref_length;
+
+		// Compare to next object
+		for(U32 j = i + 1; j < this->n_entries; ++j){
+			const U32 length = this->getLength(j);
+			float score = 0;
+			for(U32 p = 0; p < this->getPloidy(); ++p)
+				score += (this->getAllele(i, p) == this->getAllele(j, p));
+
+			if(score == 0){
+				internal_start += length;
+				continue;
+			}
+
+			for(U32 start_sample = start_position; start_sample < start_position + ref_length; ++start_sample){
+				for(U32 end_sample = internal_start; end_sample < internal_start + length; ++end_sample)
+					square_matrix(start_sample, end_sample) += score;
+			}
+			internal_start += length;
+		}
+		start_position += ref_length;
+	}
+	return(square_matrix);
+}
+
+template <class return_type>
+void GenotypeContainerMploidRLE<return_type>::__setObject(gt_object& object, const U32 position) const{
+	const BYTE ploidy = this->getPloidy();
+	BYTE phasing = 0;
+	if(this->getAdd()) phasing = this->at(position) & 1;
+	else               phasing = this->__meta.getControllerPhase();
+
+	delete [] object.alleles;
+	object.alleles = new std::pair<char,char>[ploidy];
+	for(U32 p = 0; p < ploidy; ++p){
+		object.alleles[p].first  = this->getLiteralAllele(this->getAllele(position, p));
+		object.alleles[p].second = phasing;
+	}
+	object.n_objects = 1;
+	object.n_alleles = ploidy;
+}
+
+template <class return_type>
+std::vector<tachyon::core::GTObject> GenotypeContainerMploidRLE<return_type>::getLiteralObjects(void) const{
+	std::vector<tachyon::core::GTObject> ret(this->n_entries);
+	for(U32 i = 0; i < this->n_entries; ++i){
+		this->__setObject(ret[i], i);
+		ret[i].n_objects = this->getLength(i);
+	}
+	return(ret);
+}
+
+template <class return_type>
+std::vector<tachyon::core::GTObject> GenotypeContainerMploidRLE<return_type>::getObjects(const U64& n_samples) const{
+	std::vector<tachyon::core::GTObject> ret(n_samples);
+	this->getObjects(ret, n_samples);
+	return(ret);
+}
+
+template <class return_type>
+std::vector<tachyon::core::GTObject> GenotypeContainerMploidRLE<return_type>::getObjects(const U64& n_samples, const permutation_type& ppa_manager) const{
+	std::vector<tachyon::core::GTObject> ret(n_samples);
+	this->getObjects(ret, n_samples, ppa_manager);
+	return(ret);
+}
+
+template <class return_type>
+void GenotypeContainerMploidRLE<return_type>::getLiteralObjects(std::vector<tachyon::core::GTObject>& objects) const{
+	if(objects.size() < this->size()) objects.resize(this->size());
+	for(U32 i = 0; i < this->n_entries; ++i){
+		this->__setObject(objects[i], i);
+		objects[i].n_objects = this->getLength(i);
+	}
+}
+
+template <class return_type>
+void GenotypeContainerMploidRLE<return_type>::getObjects(std::vector<tachyon::core::GTObject>& objects, const U64& n_samples) const{
+	if(objects.size() < n_samples) objects.resize(n_samples);
+
+	// Genotypes are decoded once per run
+	gt_object run_object;
+	U32 cum_pos = 0;
+	for(U32 i = 0; i < this->n_entries; ++i){
+		const U32 length = this->getLength(i);
+		this->__setObject(run_object, i);
+		for(U32 j = 0; j < length; ++j, cum_pos++)
+			objects[cum_pos] = run_object;
+	}
+	assert(cum_pos == n_samples);
+}
+
+template <class return_type>
+void GenotypeContainerMploidRLE<return_type>::getObjects(std::vector<tachyon::core::GTObject>& objects, const U64& n_samples, const permutation_type& ppa_manager) const{
+	if(objects.size() < n_samples) objects.resize(n_samples);
+
+	// Genotypes are decoded once per run
+	gt_object run_object;
+	U32 cum_pos = 0;
+	for(U32 i = 0; i < this->n_entries; ++i){
+		const U32 length = this->getLength(i);
+		this->__setObject(run_object, i);
+		for(U32 j = 0; j < length; ++j, cum_pos++)
+			objects[ppa_manager[cum_pos]] = run_object;
+	}
+	assert(cum_pos == n_samples);
+}
+
+template <class return_type>
+GenotypeSummary& GenotypeContainerMploidRLE<return_type>::updateSummary(gt_summary& gt_summary_object) const{
+	gt_summary_object += *this;
+	return(gt_summary_object);
+}
+
+template <class return_type>
+GenotypeSummary GenotypeContainerMploidRLE<return_type>::getSummary(void) const{
+	gt_summary summary;
+	summary += *this;
+	return(summary);
+}
+
+template <class return_type>
+GenotypeSummary& GenotypeContainerMploidRLE<return_type>::getSummary(gt_summary& gt_summary_object) const{
+	gt_summary_object += *this;
+	return(gt_summary_object);
+}
+
+template <class return_type>
+void GenotypeContainerMploidRLE<return_type>::getTsTv(std::vector<ts_tv_object_type>& objects) const{
+	if(this->size() == 0) return;
+	if(this->getMeta().alleles[0].size() != 1) return;
+
+	// Targets of the summary allele indices: 0 = EOV, 1 = missing,
+	// and 2 + k = allele k
+	const U32 n_references = this->getMeta().getNumberAlleles() + 2;
+	BYTE* references = new BYTE[n_references];
+	references[0] = constants::REF_ALT_MISSING;
+	references[1] = constants::REF_ALT_MISSING;
+
+	for(U32 i = 0; i < this->getMeta().getNumberAlleles(); ++i){
+		if(this->getMeta().alleles[i].size() != 1){
+			references[2 + i] = constants::REF_ALT_MISSING;
+			continue;
+		}
+
+		switch(this->getMeta().alleles[i].allele[0]){
+		case('A'): references[2 + i] = constants::REF_ALT_A; break;
+		case('T'): references[2 + i] = constants::REF_ALT_T; break;
+		case('G'): references[2 + i] = constants::REF_ALT_G; break;
+		case('C'): references[2 + i] = constants::REF_ALT_C; break;
+		default:   references[2 + i] = constants::REF_ALT_MISSING; break;
+		}
+	}
+
+	if(references[2] == constants::REF_ALT_MISSING){
+		std::cerr << "ref cannot be 0" << std::endl;
+		delete [] references;
+		return;
+	}
+
+	const BYTE& from_reference = references[2];
+	const BYTE* const transition_map_target   = constants::TRANSITION_MAP[from_reference];
+	const BYTE* const transversion_map_target = constants::TRANSVERSION_MAP[from_reference];
+
+	// Cycle over genotype objects
+	U32 cum_position = 0;
+	for(U32 i = 0; i < this->size(); ++i){
+		const U32 length = this->getLength(i);
+		for(U32 p = 0; p < this->getPloidy(); ++p){
+			const BYTE allele = this->getSummaryAllele(this->getAllele(i, p));
+			const BYTE target = allele < n_references ? references[allele] : constants::REF_ALT_MISSING;
+
+			for(U32 j = 0; j < length; ++j){
+				objects[cum_position + j].n_insertions += (target == constants::REF_ALT_INSERTION);
+				++objects[cum_position + j].base_conversions[from_reference][target];
+				objects[cum_position + j].n_transitions   += transition_map_target[target];
+				objects[cum_position + j].n_transversions += transversion_map_target[target];
+			}
+		}
+		cum_position += length;
+	}
+
+	// Cleanup
+	delete [] references;
+}
+
+// Defined here as the summary only has a forward declaration of the container
+template <class T>
+inline void GenotypeSummary::operator+=(const GenotypeContainerMploidRLE<T>& gt_mploid_container){
+	if(gt_mploid_container.getMeta().getNumberAlleles() + 2 > this->n_alleles_){
+		std::cerr << "too many alleles: " << gt_mploid_container.getMeta().getNumberAlleles() + 2 << "/" << (int)this->n_alleles_ << std::endl;
+		return;
+	}
+
+	// The first allele is counted in vector A and the
+	// remaining alleles in vector B
+	for(U32 i = 0; i < gt_mploid_container.size(); ++i){
+		const U64 length = gt_mploid_container.getLength(i);
+		this->vectorA_[gt_mploid_container.getSummaryAllele(gt_mploid_container.getAllele(i, 0))] += length;
+		for(U32 p = 1; p < gt_mploid_container.getPloidy(); ++p)
+			this->vectorB_[gt_mploid_container.getSummaryAllele(gt_mploid_container.getAllele(i, p))] += length;
+	}
+}
+
+}
+}
+
+#endif /* CONTAINERS_GENOTYPE_CONTAINER_MPLOID_RLE_H_ */
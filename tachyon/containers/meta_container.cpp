@@ -9,6 +9,8 @@ MetaContainer::MetaContainer(const block_type& block) :
 	n_entries(block.header.n_variants),
 	__entries(static_cast<pointer>(::operator new[](this->n_entries*sizeof(value_type))))
 {
+	// Decompress the meta streams if the block deferred it
+	block.prepareMeta();
 	this->__ctor_setup(block);
 	this->correctRelativePositions(block.header);
 }
@@ -3,6 +3,7 @@
 #include "../support/helpers.h"
 #include "../support/type_definitions.h"
 #include "../algorithm/compression/compression_container.h"
+#include "../algorithm/compression/compression_manager.h"
 
 namespace tachyon{
 namespace containers{
@@ -14,7 +15,10 @@ VariantBlock::VariantBlock() :
 	start_compressed_data_(0),
 	end_compressed_data_(0),
 	n_info_loaded(0),
-	n_format_loaded(0)
+	n_format_loaded(0),
+	lazy_codec_(nullptr),
+	pending_meta_(false),
+	pending_genotypes_(false)
 {
 	// Base container streams are always of type TYPE_STRUCT
 	this->meta_alleles_container.setType(YON_TYPE_STRUCT);
@@ -80,6 +84,88 @@ void VariantBlock::clear(void){
 	this->end_compressed_data_ = 0;
 
 	this->ppa_manager.reset();
+
+	this->lazy_codec_        = nullptr;
+	this->pending_meta_      = false;
+	this->pending_genotypes_ = false;
+	this->pending_info_.clear();
+	this->pending_format_.clear();
+}
+
+void VariantBlock::deferDecompression(codec_type& codec){
+	this->lazy_codec_        = &codec;
+	this->pending_meta_      = true;
+	this->pending_genotypes_ = true;
+	this->pending_info_.assign(this->footer.n_info_streams, true);
+	this->pending_format_.assign(this->footer.n_format_streams, true);
+}
+
+bool VariantBlock::prepareMeta(void) const{
+	if(this->pending_meta_ == false) return true;
+	this->pending_meta_ = false;
+
+	self_type& block = const_cast<self_type&>(*this);
+	if(this->lazy_codec_->decompressMeta(block)) return true;
+
+	container_type* group[] = {&block.meta_contig_container, &block.meta_positions_container, &block.meta_refalt_container,
+	                           &block.meta_controller_container, &block.meta_quality_container, &block.meta_names_container,
+	                           &block.meta_alleles_container, &block.meta_info_map_ids, &block.meta_format_map_ids,
+	                           &block.meta_filter_map_ids};
+	for(U32 i = 0; i < sizeof(group)/sizeof(container_type*); ++i){
+		group[i]->buffer_data_uncompressed.reset();
+		group[i]->buffer_strides_uncompressed.reset();
+	}
+	return false;
+}
+
+bool VariantBlock::prepareGenotypes(void) const{
+	if(this->pending_genotypes_ == false) return true;
+	this->pending_genotypes_ = false;
+
+	self_type& block = const_cast<self_type&>(*this);
+	if(this->lazy_codec_->decompressGenotypes(block)) return true;
+
+	container_type* group[] = {&block.gt_support_data_container, &block.gt_rle8_container, &block.gt_rle16_container,
+	                           &block.gt_rle32_container, &block.gt_rle64_container, &block.gt_simple8_container,
+	                           &block.gt_simple16_container, &block.gt_simple32_container, &block.gt_simple64_container};
+	for(U32 i = 0; i < sizeof(group)/sizeof(container_type*); ++i){
+		group[i]->buffer_data_uncompressed.reset();
+		group[i]->buffer_strides_uncompressed.reset();
+	}
+	block.ppa_manager.reset();
+	return false;
+}
+
+bool VariantBlock::prepareInfo(const U32 local_id) const{
+	if(local_id >= this->pending_info_.size() || this->pending_info_[local_id] == false) return true;
+	this->pending_info_[local_id] = false;
+
+	self_type& block = const_cast<self_type&>(*this);
+	if(this->lazy_codec_->decompressInfo(block, local_id)) return true;
+
+	block.info_containers[local_id].buffer_data_uncompressed.reset();
+	block.info_containers[local_id].buffer_strides_uncompressed.reset();
+	return false;
+}
+
+bool VariantBlock::prepareFormat(const U32 local_id) const{
+	if(local_id >= this->pending_format_.size() || this->pending_format_[local_id] == false) return true;
+	this->pending_format_[local_id] = false;
+
+	self_type& block = const_cast<self_type&>(*this);
+	if(this->lazy_codec_->decompressFormat(block, local_id)) return true;
+
+	block.format_containers[local_id].buffer_data_uncompressed.reset();
+	block.format_containers[local_id].buffer_strides_uncompressed.reset();
+	return false;
+}
+
+bool VariantBlock::prepareAll(void) const{
+	bool success = this->prepareMeta();
+	success &= this->prepareGenotypes();
+	for(U32 i = 0; i < this->pending_info_.size(); ++i)   success &= this->prepareInfo(i);
+	for(U32 i = 0; i < this->pending_format_.size(); ++i) success &= this->prepareFormat(i);
+	return(success);
 }
 
 void VariantBlock::resize(const U32 s){
@@ -298,6 +384,295 @@ bool VariantBlock::read(std::ifstream& stream, settings_type& settings){
 	return(true);
 }
 
+bool VariantBlock::readHeaderFooter(const io::MappedFile& file, const U64 offset){
+	// Fixed-size block header: footer offset, block identifier,
+	// controller, contig, minimum and maximum position, and the
+	// number of variants
+	const U64 header_length = sizeof(U32) + sizeof(U64) + sizeof(U16) + sizeof(S32) + 2*sizeof(S64) + sizeof(U32);
+	if(!file.contains(offset, header_length)){
+		std::cerr << utility::timestamp("ERROR","IO") << "Block header at offset " << offset << " is truncated..." << std::endl;
+		return false;
+	}
+
+	buffer_type buffer;
+	buffer.view(file.data() + offset, header_length);
+	buffer >> this->header; // load header
+	this->start_compressed_data_ = offset + header_length; // start of compressed data
+	this->end_compressed_data_   = this->start_compressed_data_ + this->header.l_offset_footer; // end of compressed data
+
+	if(!file.contains(this->end_compressed_data_, 3*sizeof(U32))){
+		std::cerr << utility::timestamp("ERROR","IO") << "Block footer at offset " << this->end_compressed_data_ << " is truncated..." << std::endl;
+		return false;
+	}
+
+	U32 footer_uLength = 0;
+	U32 footer_cLength = 0;
+	U32 footer_crc = 0;
+	buffer.view(file.data() + this->end_compressed_data_, 3*sizeof(U32));
+	buffer >> footer_uLength;
+	buffer >> footer_cLength;
+	buffer >> footer_crc;
+
+	const U64 start_footer = this->end_compressed_data_ + 3*sizeof(U32);
+	if(!file.contains(start_footer, footer_cLength + sizeof(U64))){
+		std::cerr << utility::timestamp("ERROR","IO") << "Block footer at offset " << this->end_compressed_data_ << " is truncated..." << std::endl;
+		return false;
+	}
+
+	this->footer_support.buffer_data.view(file.data() + start_footer, footer_cLength);
+	this->footer_support.buffer_data_uncompressed.resize(footer_uLength);
+	this->footer_support.header.data_header.controller.encoder = YON_ENCODE_ZSTD;
+	this->footer_support.header.data_header.cLength = footer_cLength;
+	this->footer_support.header.data_header.uLength = footer_uLength;
+	this->footer_support.header.data_header.crc     = footer_crc;
+
+	// Assert end-of-block marker
+	U64 eof_marker;
+	memcpy(&eof_marker, file.data() + start_footer + footer_cLength, sizeof(U64));
+	assert(eof_marker == constants::TACHYON_BLOCK_EOF);
+	this->end_block_ = start_footer + footer_cLength + sizeof(U64); // end-of-block offset
+	return true;
+}
+
+bool VariantBlock::read(const io::MappedFile& file, settings_type& settings){
+	if(settings.load_ppa){
+		if(this->header.controller.hasGTPermuted && this->header.controller.hasGT){
+			// The permutation array is decompressed in place and is
+			// therefore copied out of the mapping
+			const U64 start_ppa = this->start_compressed_data_ + this->footer.offset_ppa.data_header.offset;
+			if(start_ppa > this->end_compressed_data_ || !file.contains(start_ppa, this->end_compressed_data_ - start_ppa)){
+				std::cerr << utility::timestamp("ERROR","IO") << "Permutation array is outside the file..." << std::endl;
+				return false;
+			}
+			buffer_type buffer;
+			buffer.view(file.data() + start_ppa, this->end_compressed_data_ - start_ppa);
+			buffer >> this->ppa_manager;
+		}
+	}
+
+	bool loaded = true;
+	if(settings.load_contig){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_contig, this->meta_contig_container);
+	}
+
+	if(settings.load_positons){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_position, this->meta_positions_container);
+	}
+
+	if(settings.load_controller){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_controllers, this->meta_controller_container);
+	}
+
+	if(settings.load_quality){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_quality, this->meta_quality_container);
+	}
+
+	if(settings.load_names){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_names, this->meta_names_container);
+	}
+
+	if(settings.load_alleles){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_refalt, this->meta_refalt_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_alleles, this->meta_alleles_container);
+	}
+
+	if(settings.load_genotypes_rle){
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_8b, this->gt_rle8_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_16b, this->gt_rle16_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_32b, this->gt_rle32_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_64b, this->gt_rle64_container);
+	}
+
+	if(settings.load_genotypes_simple){
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_simple8, this->gt_simple8_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_simple16, this->gt_simple16_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_simple32, this->gt_simple32_container);
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_simple64, this->gt_simple64_container);
+	}
+
+	if(settings.load_genotypes_support){
+		loaded &= this->__viewContainer(file, this->footer.offset_gt_helper, this->gt_support_data_container);
+	}
+
+	if(settings.load_set_membership){
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_info_id, this->meta_info_map_ids);
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_filter_id, this->meta_filter_map_ids);
+		loaded &= this->__viewContainer(file, this->footer.offset_meta_format_id, this->meta_format_map_ids);
+	}
+
+	// Load all info
+	if(settings.load_info && this->footer.n_info_streams){
+		for(U32 i = 0; i < this->footer.n_info_streams; ++i){
+			loaded &= this->__viewContainer(file, this->footer.info_offsets[i], this->info_containers[i]);
+			++this->n_info_loaded;
+			settings.load_info_ID_loaded.push_back(core::SettingsMap(i,i,&this->footer.info_offsets[i]));
+		}
+	}
+	// If we have supplied a list of identifiers
+	else if(settings.load_info_ID_loaded.size()){
+		for(U32 i = 0; i < settings.load_info_ID_loaded.size(); ++i){
+			loaded &= this->__viewContainer(file, this->footer.info_offsets[settings.load_info_ID_loaded[i].target_stream_local], this->info_containers[settings.load_info_ID_loaded[i].iterator_index]);
+			++this->n_info_loaded;
+		}
+	} // end case load_info_ID
+
+	// Load all FORMAT data
+	if(settings.load_format && this->footer.n_format_streams){
+		for(U32 i = 0; i < this->footer.n_format_streams; ++i){
+			loaded &= this->__viewContainer(file, this->footer.format_offsets[i], this->format_containers[i]);
+			++this->n_format_loaded;
+			settings.load_format_ID_loaded.push_back(core::SettingsMap(i,i,&this->footer.format_offsets[i]));
+		}
+	} // If we have supplied a list of identifiers
+	else if(settings.load_format_ID_loaded.size()){
+		for(U32 i = 0; i < settings.load_format_ID_loaded.size(); ++i){
+			loaded &= this->__viewContainer(file, this->footer.format_offsets[settings.load_format_ID_loaded[i].target_stream_local], this->format_containers[settings.load_format_ID_loaded[i].iterator_index]);
+			++this->n_format_loaded;
+		}
+	} // end case load_format_ID
+
+	if(!loaded){
+		std::cerr << utility::timestamp("ERROR","IO") << "Container data is outside the file: the file is truncated..." << std::endl;
+		return false;
+	}
+	return(true);
+}
+
+bool VariantBlock::read(const self_type& source, settings_type& settings){
+	if(settings.load_ppa){
+		if(this->header.controller.hasGTPermuted && this->header.controller.hasGT){
+			// The permutation array is rewritten when the block is
+			// cleared and is therefore copied
+			this->ppa_manager.n_samples = source.ppa_manager.n_samples;
+			this->ppa_manager.u_length  = source.ppa_manager.u_length;
+			this->ppa_manager.c_length  = source.ppa_manager.c_length;
+			this->ppa_manager.crc       = source.ppa_manager.crc;
+			this->ppa_manager.PPA.reset();
+			this->ppa_manager.PPA.resize(std::max(source.ppa_manager.PPA.size(), (U64)source.ppa_manager.n_samples*sizeof(U32)));
+			memcpy(this->ppa_manager.PPA.data(), source.ppa_manager.PPA.data(), source.ppa_manager.PPA.size());
+			this->ppa_manager.PPA.n_chars = source.ppa_manager.PPA.size();
+		}
+	}
+
+	if(settings.load_contig){
+		this->__viewContainer(source.meta_contig_container, this->meta_contig_container);
+	}
+
+	if(settings.load_positons){
+		this->__viewContainer(source.meta_positions_container, this->meta_positions_container);
+	}
+
+	if(settings.load_controller){
+		this->__viewContainer(source.meta_controller_container, this->meta_controller_container);
+	}
+
+	if(settings.load_quality){
+		this->__viewContainer(source.meta_quality_container, this->meta_quality_container);
+	}
+
+	if(settings.load_names){
+		this->__viewContainer(source.meta_names_container, this->meta_names_container);
+	}
+
+	if(settings.load_alleles){
+		this->__viewContainer(source.meta_refalt_container, this->meta_refalt_container);
+		this->__viewContainer(source.meta_alleles_container, this->meta_alleles_container);
+	}
+
+	if(settings.load_genotypes_rle){
+		this->__viewContainer(source.gt_rle8_container, this->gt_rle8_container);
+		this->__viewContainer(source.gt_rle16_container, this->gt_rle16_container);
+		this->__viewContainer(source.gt_rle32_container, this->gt_rle32_container);
+		this->__viewContainer(source.gt_rle64_container, this->gt_rle64_container);
+	}
+
+	if(settings.load_genotypes_simple){
+		this->__viewContainer(source.gt_simple8_container, this->gt_simple8_container);
+		this->__viewContainer(source.gt_simple16_container, this->gt_simple16_container);
+		this->__viewContainer(source.gt_simple32_container, this->gt_simple32_container);
+		this->__viewContainer(source.gt_simple64_container, this->gt_simple64_container);
+	}
+
+	if(settings.load_genotypes_support){
+		this->__viewContainer(source.gt_support_data_container, this->gt_support_data_container);
+	}
+
+	if(settings.load_set_membership){
+		this->__viewContainer(source.meta_info_map_ids, this->meta_info_map_ids);
+		this->__viewContainer(source.meta_filter_map_ids, this->meta_filter_map_ids);
+		this->__viewContainer(source.meta_format_map_ids, this->meta_format_map_ids);
+	}
+
+	if(this->footer.n_info_streams != source.footer.n_info_streams || this->footer.n_format_streams != source.footer.n_format_streams){
+		std::cerr << utility::timestamp("ERROR","CACHE") << "Cached block does not match the block footer..." << std::endl;
+		return false;
+	}
+
+	// Load all info
+	if(settings.load_info && this->footer.n_info_streams){
+		for(U32 i = 0; i < this->footer.n_info_streams; ++i){
+			this->__viewContainer(source.info_containers[i], this->info_containers[i]);
+			++this->n_info_loaded;
+			settings.load_info_ID_loaded.push_back(core::SettingsMap(i,i,&this->footer.info_offsets[i]));
+		}
+	}
+	// If we have supplied a list of identifiers
+	else if(settings.load_info_ID_loaded.size()){
+		for(U32 i = 0; i < settings.load_info_ID_loaded.size(); ++i){
+			const U32 local = settings.load_info_ID_loaded[i].target_stream_local;
+			this->__viewContainer(source.info_containers[local], this->info_containers[settings.load_info_ID_loaded[i].iterator_index]);
+			++this->n_info_loaded;
+		}
+	} // end case load_info_ID
+
+	// Load all FORMAT data
+	if(settings.load_format && this->footer.n_format_streams){
+		for(U32 i = 0; i < this->footer.n_format_streams; ++i){
+			this->__viewContainer(source.format_containers[i], this->format_containers[i]);
+			++this->n_format_loaded;
+			settings.load_format_ID_loaded.push_back(core::SettingsMap(i,i,&this->footer.format_offsets[i]));
+		}
+	} // If we have supplied a list of identifiers
+	else if(settings.load_format_ID_loaded.size()){
+		for(U32 i = 0; i < settings.load_format_ID_loaded.size(); ++i){
+			const U32 local = settings.load_format_ID_loaded[i].target_stream_local;
+			this->__viewContainer(source.format_containers[local], this->format_containers[settings.load_format_ID_loaded[i].iterator_index]);
+			++this->n_format_loaded;
+		}
+	} // end case load_format_ID
+
+	return(true);
+}
+
+void VariantBlock::detach(void){
+	this->__detachContainer(this->meta_contig_container);
+	this->__detachContainer(this->meta_positions_container);
+	this->__detachContainer(this->meta_refalt_container);
+	this->__detachContainer(this->meta_controller_container);
+	this->__detachContainer(this->meta_quality_container);
+	this->__detachContainer(this->meta_names_container);
+	this->__detachContainer(this->meta_alleles_container);
+	this->__detachContainer(this->meta_info_map_ids);
+	this->__detachContainer(this->meta_format_map_ids);
+	this->__detachContainer(this->meta_filter_map_ids);
+	this->__detachContainer(this->gt_support_data_container);
+	this->__detachContainer(this->gt_rle8_container);
+	this->__detachContainer(this->gt_rle16_container);
+	this->__detachContainer(this->gt_rle32_container);
+	this->__detachContainer(this->gt_rle64_container);
+	this->__detachContainer(this->gt_simple8_container);
+	this->__detachContainer(this->gt_simple16_container);
+	this->__detachContainer(this->gt_simple32_container);
+	this->__detachContainer(this->gt_simple64_container);
+
+	for(U32 i = 0; i < this->footer.n_info_streams; ++i)   this->__detachContainer(this->info_containers[i]);
+	for(U32 i = 0; i < this->footer.n_format_streams; ++i) this->__detachContainer(this->format_containers[i]);
+
+	// The footer has been parsed
+	buffer_type().swap(this->footer_support.buffer_data);
+	buffer_type().swap(this->footer_support.buffer_data_uncompressed);
+}
+
 const U64 VariantBlock::__determineCompressedSize(void) const{
 	U64 total = 0;
 	if(this->header.controller.hasGT && this->header.controller.hasGTPermuted)
@@ -329,6 +704,37 @@ const U64 VariantBlock::__determineCompressedSize(void) const{
 	return(total);
 }
 
+const U64 VariantBlock::determineUncompressedSize(void) const{
+	U64 total = 0;
+	if(this->header.controller.hasGT && this->header.controller.hasGTPermuted)
+		total += this->ppa_manager.getObjectSize();
+
+	total += this->meta_contig_container.getObjectSizeUncompressed();
+	total += this->meta_positions_container.getObjectSizeUncompressed();
+	total += this->meta_refalt_container.getObjectSizeUncompressed();
+	total += this->meta_controller_container.getObjectSizeUncompressed();
+	total += this->meta_quality_container.getObjectSizeUncompressed();
+	total += this->meta_names_container.getObjectSizeUncompressed();
+	total += this->meta_alleles_container.getObjectSizeUncompressed();
+	total += this->meta_info_map_ids.getObjectSizeUncompressed();
+	total += this->meta_format_map_ids.getObjectSizeUncompressed();
+	total += this->meta_filter_map_ids.getObjectSizeUncompressed();
+	total += this->gt_support_data_container.getObjectSizeUncompressed();
+	total += this->gt_rle8_container.getObjectSizeUncompressed();
+	total += this->gt_rle16_container.getObjectSizeUncompressed();
+	total += this->gt_rle32_container.getObjectSizeUncompressed();
+	total += this->gt_rle64_container.getObjectSizeUncompressed();
+	total += this->gt_simple8_container.getObjectSizeUncompressed();
+	total += this->gt_simple16_container.getObjectSizeUncompressed();
+	total += this->gt_simple32_container.getObjectSizeUncompressed();
+	total += this->gt_simple64_container.getObjectSizeUncompressed();
+
+	for(U32 i = 0; i < this->footer.n_info_streams; ++i)   total += this->info_containers[i].getObjectSizeUncompressed();
+	for(U32 i = 0; i < this->footer.n_format_streams; ++i) total += this->format_containers[i].getObjectSizeUncompressed();
+
+	return(total);
+}
+
 void VariantBlock::updateOutputStatistics(import_stats_type& stats_basic, import_stats_type& stats_info, import_stats_type& stats_format){
 	if(this->header.controller.hasGT && this->header.controller.hasGTPermuted){
 		stats_basic[1].cost_uncompressed += this->ppa_manager.getObjectSize();
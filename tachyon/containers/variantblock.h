@@ -1,9 +1,12 @@
 #ifndef CORE_BLOCKENTRY_H_
 #define CORE_BLOCKENTRY_H_
 
+#include <vector>
+
 #include "../algorithm/permutation/permutation_manager.h"
 #include "../core/variant_importer_container_stats.h"
 #include "../io/vcf/VCFHeader.h"
+#include "../io/mapped_file.h"
 #include "datablock_settings.h"
 #include "datacontainer.h"
 #include "../core/meta_entry.h"
@@ -11,6 +14,7 @@
 #include "components/variantblock_header.h"
 
 namespace tachyon{
+namespace algorithm{ class CompressionManager; }
 namespace containers{
 
 /**
@@ -31,6 +35,7 @@ class VariantBlock{
 	typedef support::VariantImporterContainerStats import_stats_type;
 	typedef DataContainerHeader             offset_type;
 	typedef tachyon::core::MetaEntry        meta_entry_type;
+	typedef algorithm::CompressionManager   codec_type;
 
 public:
 	VariantBlock();
@@ -148,6 +153,87 @@ public:
 	 */
 	bool readHeaderFooter(std::ifstream& stream);
 
+	/**<
+	 * Reads the containers of a block from a memory-mapped file.
+	 * The compressed containers point directly at the mapped pages:
+	 * no data is copied and no system calls are made. The block is
+	 * only valid for as long as the mapping is open.
+	 * @param file     Memory-mapped input file
+	 * @param settings Settings record describing reading parameters
+	 * @return         Returns FALSE if there was a problem, TRUE otherwise
+	 */
+	bool read(const io::MappedFile& file, settings_type& settings);
+
+	/**<
+	 * Reads the header and footer of the block starting at `offset`
+	 * in a memory-mapped file
+	 * @param file   Memory-mapped input file
+	 * @param offset Start of the block in the file
+	 * @return       Returns FALSE if the block is truncated, TRUE otherwise
+	 */
+	bool readHeaderFooter(const io::MappedFile& file, const U64 offset);
+
+	/**<
+	 * Loads the containers of a block from a decoded copy of the same
+	 * block, such as one held by a `VariantBlockCache`. The decoded
+	 * data is not copied: the containers point at the buffers of
+	 * `source`, which must outlive this block. The header and footer
+	 * of this block must have been read already.
+	 * @param source   Decoded block holding every container
+	 * @param settings Settings record describing reading parameters
+	 * @return         Returns FALSE if there was a problem, TRUE otherwise
+	 */
+	bool read(const self_type& source, settings_type& settings);
+
+	/**<
+	 * Release the compressed data of a decoded block and copy any
+	 * decoded data that points into a file mapping or into the
+	 * released buffers. Afterwards the block depends on nothing else.
+	 */
+	void detach(void);
+
+	// End-of-block offset of the last block read
+	inline const U64& getEndOfBlock(void) const{ return(this->end_block_); }
+
+	/**<
+	 * Defer decompression of the containers loaded into this block
+	 * until they are first accessed. The compressed data is kept and
+	 * each group of containers is decompressed by the prepare
+	 * functions below: `MetaContainer` and `GenotypeContainer` call
+	 * them on construction. Blocks that defer decompression must not
+	 * be shared between threads.
+	 * @param codec Codec manager used to decompress: must outlive the block
+	 */
+	void deferDecompression(codec_type& codec);
+
+	/**<
+	 * Decompress a group of containers if it is still compressed.
+	 * If decompression fails the uncompressed data of the group is
+	 * left empty.
+	 * @param local_id Local INFO or FORMAT stream
+	 * @return         Returns TRUE upon success or FALSE otherwise
+	 */
+	bool prepareMeta(void) const;
+	bool prepareGenotypes(void) const;
+	bool prepareInfo(const U32 local_id) const;
+	bool prepareFormat(const U32 local_id) const;
+	bool prepareAll(void) const;
+
+	/**<
+	 * Determine the uncompressed size of the data in this block.
+	 * Execute this function after finalizing the block and prior
+	 * to compressing it
+	 * @return Returns the sum total uncompressed size
+	 */
+	const U64 determineUncompressedSize(void) const;
+
+	/**<
+	 * Determine compressed block-size. Execute this function prior to writing a
+	 * block
+	 * @return Returns the sum total disk size
+	 */
+	const U64 __determineCompressedSize(void) const;
+
 	/**<
 	 * Standard way of writing out a YON block.
 	 * @param stream       Target output stream
@@ -177,13 +263,6 @@ private:
 	 */
 	void updateContainers(void);
 
-	/**<
-	 * Determine compressed block-size. Execute this function prior to writing a
-	 * block
-	 * @return Returns the sum total disk size
-	 */
-	const U64 __determineCompressedSize(void) const;
-
 	/**<
 	 *
 	 * @param stats_basic
@@ -278,6 +357,73 @@ private:
 		return(stream.good());
 	}
 
+	/**<
+	 * Wrapper function to point a data container at the decoded data
+	 * of the same container in another block. The header is taken from
+	 * the source as decryption restores the headers of the containers.
+	 * @param source    Decoded source container
+	 * @param container Destination container object
+	 */
+	inline void __viewContainer(const container_type& source, container_type& container){
+		container.header = source.header;
+		container.buffer_data_uncompressed.view(source.buffer_data_uncompressed.data(), source.buffer_data_uncompressed.size());
+		container.buffer_strides_uncompressed.view(source.buffer_strides_uncompressed.data(), source.buffer_strides_uncompressed.size());
+	}
+
+	/**<
+	 * Wrapper function to give a data container its own copy of decoded
+	 * data it does not own and release its compressed data
+	 * @param container Target container
+	 */
+	inline void __detachContainer(container_type& container){
+		if(container.buffer_data_uncompressed.isView()){
+			buffer_type copy(container.buffer_data_uncompressed.size() + 1);
+			memcpy(copy.data(), container.buffer_data_uncompressed.data(), container.buffer_data_uncompressed.size());
+			copy.n_chars = container.buffer_data_uncompressed.size();
+			container.buffer_data_uncompressed.swap(copy);
+		}
+
+		if(container.buffer_strides_uncompressed.isView()){
+			buffer_type copy(container.buffer_strides_uncompressed.size() + 1);
+			memcpy(copy.data(), container.buffer_strides_uncompressed.data(), container.buffer_strides_uncompressed.size());
+			copy.n_chars = container.buffer_strides_uncompressed.size();
+			container.buffer_strides_uncompressed.swap(copy);
+		}
+
+		buffer_type().swap(container.buffer_data);
+		buffer_type().swap(container.buffer_strides);
+	}
+
+	/**<
+	 * Wrapper function to point a data container at its data in a
+	 * memory-mapped YON block without copying it
+	 * @param file      Memory-mapped input file
+	 * @param offset    Header object
+	 * @param container Destination container object
+	 * @return          Returns FALSE if the data is outside the file or TRUE otherwise
+	 */
+	inline bool __viewContainer(const io::MappedFile& file, const offset_type& offset, container_type& container){
+		container.header = offset;
+		const U64 start = this->start_compressed_data_ + offset.data_header.offset;
+
+		// Encrypted data is concatenated
+		if(offset.data_header.controller.encryption != YON_ENCRYPTION_NONE){
+			if(!file.contains(start, offset.data_header.eLength)) return false;
+			container.buffer_data.view(file.data() + start, offset.data_header.eLength);
+			return true;
+		}
+
+		if(!file.contains(start, offset.data_header.cLength)) return false;
+		container.buffer_data.view(file.data() + start, offset.data_header.cLength);
+
+		if(offset.data_header.hasMixedStride()){
+			const U64 start_strides = start + offset.data_header.cLength;
+			if(!file.contains(start_strides, offset.stride_header.cLength)) return false;
+			container.buffer_strides.view(file.data() + start_strides, offset.stride_header.cLength);
+		}
+		return true;
+	}
+
 public:
 	block_header_type header;
 	block_footer_type footer;
@@ -322,6 +468,14 @@ public:
 	U32 n_info_loaded;
 	U32 n_format_loaded;
 	container_type footer_support; // used internally only
+
+private:
+	// Containers still compressed when decompression is deferred
+	codec_type*               lazy_codec_;
+	mutable bool              pending_meta_;
+	mutable bool              pending_genotypes_;
+	mutable std::vector<bool> pending_info_;
+	mutable std::vector<bool> pending_format_;
 };
 
 }
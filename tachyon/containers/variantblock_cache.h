@@ -0,0 +1,169 @@
+#ifndef CONTAINERS_VARIANTBLOCK_CACHE_H_
+#define CONTAINERS_VARIANTBLOCK_CACHE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+
+#include "variantblock.h"
+
+namespace tachyon{
+namespace containers{
+
+/**<
+ * Least-recently used cache of decoded blocks keyed by file
+ * identity and block number. The file identity (see identify())
+ * includes the size and modification time of the file, so blocks
+ * cached before an append to the same path are never served for
+ * the new file. The cache holds at most `budget` bytes of
+ * uncompressed data: inserting a block evicts the least recently
+ * used blocks until the total fits. Cached blocks are immutable
+ * and handed out as shared pointers, so a block that is evicted
+ * while a reader still uses it is released when that reader moves
+ * on. A single cache can be shared by any number of readers and
+ * threads.
+ */
+class VariantBlockCache{
+private:
+	typedef VariantBlockCache                 self_type;
+	typedef VariantBlock                      block_type;
+	typedef std::pair<std::string, U32>       key_type; // file identity and block number
+
+public:
+	typedef std::shared_ptr<const block_type> pointer;
+
+private:
+	struct Entry{
+		Entry(const key_type& key, const pointer& block, const U64 bytes) : key(key), bytes(bytes), block(block){}
+
+		key_type key;
+		U64      bytes; // uncompressed size of the block
+		pointer  block;
+	};
+	typedef std::list<Entry>                        list_type;
+	typedef std::map<key_type, list_type::iterator> map_type;
+
+public:
+	explicit VariantBlockCache(const U64 budget) :
+		n_budget_(budget),
+		n_bytes_(0),
+		n_hits_(0),
+		n_misses_(0),
+		n_evictions_(0)
+	{}
+	~VariantBlockCache(){}
+
+	/**<
+	 * Identity of a file for keying its blocks: the path together with
+	 * the size and modification time of the file. Falls back to the path
+	 * if the file cannot be stat'ed.
+	 * @param file Path of the file
+	 * @return     Returns the identity of the file
+	 */
+	static std::string identify(const std::string& file){
+		struct stat file_stats;
+		if(stat(file.c_str(), &file_stats) != 0)
+			return(file);
+
+		return(file + '\t' + std::to_string(file_stats.st_size) + '\t' + std::to_string(file_stats.st_mtim.tv_sec) + '.' + std::to_string(file_stats.st_mtim.tv_nsec));
+	}
+
+	/**<
+	 * Retrieve a block and mark it as most recently used
+	 * @param file    Identity of the file the block belongs to
+	 * @param blockID Block number in file order
+	 * @return        Returns the cached block or nullptr if it is not cached
+	 */
+	pointer find(const std::string& file, const U32 blockID){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		map_type::iterator it = this->map_.find(key_type(file, blockID));
+		if(it == this->map_.end()){
+			++this->n_misses_;
+			return(pointer());
+		}
+
+		++this->n_hits_;
+		this->entries_.splice(this->entries_.begin(), this->entries_, it->second);
+		return(it->second->block);
+	}
+
+	/**<
+	 * Take ownership of a decoded block and cache it as the most
+	 * recently used block. Blocks larger than the budget are returned
+	 * without being cached. If another reader cached the same block
+	 * in the meantime that copy is returned instead.
+	 * @param file    Identity of the file the block belongs to
+	 * @param blockID Block number in file order
+	 * @param block   Decoded block allocated with new
+	 * @return        Returns the cached block
+	 */
+	pointer insert(const std::string& file, const U32 blockID, block_type* block){
+		pointer entry(block);
+		const U64 bytes = block->determineUncompressedSize();
+
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		const key_type key(file, blockID);
+		map_type::iterator it = this->map_.find(key);
+		if(it != this->map_.end()){
+			this->entries_.splice(this->entries_.begin(), this->entries_, it->second);
+			return(it->second->block);
+		}
+
+		if(bytes > this->n_budget_)
+			return(entry);
+
+		while(this->n_bytes_ + bytes > this->n_budget_){
+			this->n_bytes_ -= this->entries_.back().bytes;
+			this->map_.erase(this->entries_.back().key);
+			this->entries_.pop_back();
+			++this->n_evictions_;
+		}
+
+		this->entries_.push_front(Entry(key, entry, bytes));
+		this->map_[key] = this->entries_.begin();
+		this->n_bytes_ += bytes;
+		return(entry);
+	}
+
+	// Drop all cached blocks and reset the counters
+	void clear(void){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->entries_.clear();
+		this->map_.clear();
+		this->n_bytes_     = 0;
+		this->n_hits_      = 0;
+		this->n_misses_    = 0;
+		this->n_evictions_ = 0;
+	}
+
+	// Accessors
+	inline U64 budget(void) const{ return(this->n_budget_); }
+	inline U64 size(void) const{ std::unique_lock<std::mutex> lock(this->mutex_); return(this->n_bytes_); }
+	inline U64 entries(void) const{ std::unique_lock<std::mutex> lock(this->mutex_); return(this->entries_.size()); }
+	inline U64 hits(void) const{ std::unique_lock<std::mutex> lock(this->mutex_); return(this->n_hits_); }
+	inline U64 misses(void) const{ std::unique_lock<std::mutex> lock(this->mutex_); return(this->n_misses_); }
+	inline U64 evictions(void) const{ std::unique_lock<std::mutex> lock(this->mutex_); return(this->n_evictions_); }
+
+private:
+	// A cache is shared by reference
+	VariantBlockCache(const self_type& other);
+	self_type& operator=(const self_type& other);
+
+private:
+	U64                n_budget_;
+	U64                n_bytes_;     // uncompressed bytes cached
+	U64                n_hits_;
+	U64                n_misses_;
+	U64                n_evictions_;
+	list_type          entries_;     // most recently used first
+	map_type           map_;
+	mutable std::mutex mutex_;
+};
+
+}
+}
+
+#endif /* CONTAINERS_VARIANTBLOCK_CACHE_H_ */
@@ -8,6 +8,7 @@ namespace tachyon{
 namespace core{
 
 #define YON_FOOTER_LENGTH (constants::TACHYON_FILE_EOF_LENGTH + sizeof(U64)*3 + sizeof(U16))
+#define YON_FOOTER_CHECKSUM_MASK 3 // controller bits of the checksum algorithm
 
 struct Footer{
 public:
@@ -52,6 +53,11 @@ public:
 	inline const U16& getController(void) const{ return(this->controller); }
 	inline U16& getController(void){ return(this->controller); }
 
+	// Checksum algorithm of the file: files without the bits
+	// set store SHA-512 digests
+	inline const U16 getChecksumType(void) const{ return(this->controller & YON_FOOTER_CHECKSUM_MASK); }
+	inline void setChecksumType(const U16 type){ this->controller = (this->controller & ~YON_FOOTER_CHECKSUM_MASK) | (type & YON_FOOTER_CHECKSUM_MASK); }
+
 	inline const bool validate(void) const{
 		if(this->offset_end_of_data == 0) return false;
 		if(this->n_blocks  == 0)          return false;
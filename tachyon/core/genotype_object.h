@@ -10,10 +10,14 @@ namespace core{
 #define YON_GT_RLE_ALLELE_B(PRIMITIVE, SHIFT, ADD)   (((PRIMITIVE) & ((1 << (SHIFT)) - 1) << ((ADD)+(SHIFT))) >> ((ADD)+(SHIFT)));
 #define YON_GT_RLE_LENGTH(PRIMITIVE, SHIFT, ADD)     ((PRIMITIVE) >> (2*(SHIFT) + (ADD)))
 #define YON_GT_DIPLOID_ALLELE_LOOKUP(A,B,shift,mask) (((A) & (mask)) << (shift)) | ((B) & (mask))
+#define YON_GT_BITPLANE_WORDS(N_SAMPLES)             (((N_SAMPLES) + 63) / 64)
 
-#define YON_GT_DIPLOID_BCF_A(PRIMITIVE, SHIFT)       (((PRIMITIVE) >> (SHIFT)) & ((1 << (SHIFT)) - 1))
-#define YON_GT_DIPLOID_BCF_B(PRIMITIVE, SHIFT)       ((PRIMITIVE) & ((1 << (SHIFT)) - 1))
+// BCF-style diploid words hold allele B | allele A | phase where each
+// allele is stored as in BCF: 0 is missing and otherwise the allele + 1
+#define YON_GT_DIPLOID_BCF_A(PRIMITIVE, SHIFT)       (((PRIMITIVE) >> 1) & (((U64)1 << (SHIFT)) - 1))
+#define YON_GT_DIPLOID_BCF_B(PRIMITIVE, SHIFT)       (((PRIMITIVE) >> ((SHIFT) + 1)) & (((U64)1 << (SHIFT)) - 1))
 #define YON_GT_DIPLOID_BCF_PHASE(PRIMITIVE)          ((PRIMITIVE) & 1)
+#define YON_GT_DIPLOID_BCF_ALLELE(CODE)              ((CODE) == 0 ? -1 : (SBYTE)((CODE) - 1))
 
 struct GTObject{
 private:
@@ -259,9 +263,10 @@ private:
 		const BYTE shift    = (sizeof(T)*8 - 1) / 2;
 
 		this->alleles[0].second = YON_GT_DIPLOID_BCF_PHASE(gt_primitive);
+		this->alleles[1].second = YON_GT_DIPLOID_BCF_PHASE(gt_primitive);
 		this->n_objects         = 1;
-		this->alleles[0].first  = YON_GT_DIPLOID_BCF_A(gt_primitive, shift);
-		this->alleles[1].first  = YON_GT_DIPLOID_BCF_B(gt_primitive, shift);
+		this->alleles[0].first  = YON_GT_DIPLOID_BCF_ALLELE(YON_GT_DIPLOID_BCF_A(gt_primitive, shift));
+		this->alleles[1].first  = YON_GT_DIPLOID_BCF_ALLELE(YON_GT_DIPLOID_BCF_B(gt_primitive, shift));
 	}
 };
 
@@ -11,6 +11,9 @@ class GenotypeContainerInterface;
 template <class T> class GenotypeContainerDiploidRLE;
 template <class T> class GenotypeContainerDiploidSimple;
 template <class T> class GenotypeContainerDiploidBCF;
+class GenotypeContainerDiploidBitplane;
+template <class T> class GenotypeContainerMploidRLE;
+template <class T> class GenotypeContainerBCF;
 
 // Remaps
 const BYTE TACHYON_GT_SUMMARY_REMAP[4] = {2, 3, 1, 1}; // 0 = EOV does not exist in this encoding
@@ -208,9 +211,38 @@ public:
 
 	template <class T>
 	inline void operator+=(const GenotypeContainerDiploidBCF<T>& gt_diploid_bcf_container){
+		const BYTE shift = (sizeof(T)*8 - 1) / 2;
 
+		if(gt_diploid_bcf_container.getMeta().n_alleles + 2 > this->n_alleles_){
+			std::cerr << "too many alleles: " << gt_diploid_bcf_container.getMeta().n_alleles + 2 << "/" << (int)this->n_alleles_ << std::endl;
+			return;
+		}
+
+		// Alleles are stored as allele + 1 and 0 is missing: EOV
+		// is never available in this encoding
+		for(U32 i = 0; i < gt_diploid_bcf_container.size(); ++i){
+			BYTE alleleA = YON_GT_DIPLOID_BCF_A(gt_diploid_bcf_container.at(i), shift);
+			BYTE alleleB = YON_GT_DIPLOID_BCF_B(gt_diploid_bcf_container.at(i), shift);
+			alleleA += alleleA > 0 ? 1 : 0;
+			alleleB += alleleB > 0 ? 1 : 0;
+
+			++this->matrix_[alleleA][alleleB];
+			++this->vectorA_[alleleA];
+			++this->vectorB_[alleleB];
+		}
 	}
 
+	// Defined in genotype_container_diploid_bitplane.h
+	inline void operator+=(const GenotypeContainerDiploidBitplane& gt_bitplane_container);
+
+	// Defined in genotype_container_mploid_rle.h
+	template <class T>
+	inline void operator+=(const GenotypeContainerMploidRLE<T>& gt_mploid_container);
+
+	// Defined in genotype_container_bcf.h
+	template <class T>
+	inline void operator+=(const GenotypeContainerBCF<T>& gt_bcf_container);
+
 	inline void operator+=(const bcf::BCFEntry& entry){
 		if(entry.hasGenotypes == false) return;
 
@@ -1,4 +1,5 @@
 #include "variant_header.h"
+#include "../../support/helpers.h"
 
 namespace tachyon{
 namespace core{
@@ -34,6 +35,7 @@ VariantHeader::VariantHeader(const vcf_header_type& vcf_header) :
 
 VariantHeader::VariantHeader(const self_type& other) :
 	header_magic(other.header_magic),
+	literals(other.literals),
 	contigs(new contig_type[this->header_magic.getNumberContigs()]),
 	samples(new sample_type[this->header_magic.getNumberSamples()]),
 	info_fields(new map_entry_type[this->header_magic.n_info_values]),
@@ -156,6 +158,54 @@ const core::HeaderMapEntry* VariantHeader::getFilterField(const std::string& p)
 	return nullptr;
 }
 
+bool VariantHeader::isCompatible(const self_type& other) const{
+	if(this->header_magic.n_samples != other.header_magic.n_samples){
+		std::cerr << utility::timestamp("ERROR","HEADER") << "Number of samples differ: " << this->header_magic.n_samples << " and " << other.header_magic.n_samples << "..." << std::endl;
+		return false;
+	}
+
+	for(U32 i = 0; i < this->header_magic.n_samples; ++i){
+		if(this->samples[i].name != other.samples[i].name){
+			std::cerr << utility::timestamp("ERROR","HEADER") << "Sample " << i << " differ: " << this->samples[i].name << " and " << other.samples[i].name << "..." << std::endl;
+			return false;
+		}
+	}
+
+	if(this->header_magic.n_contigs != other.header_magic.n_contigs){
+		std::cerr << utility::timestamp("ERROR","HEADER") << "Number of contigs differ: " << this->header_magic.n_contigs << " and " << other.header_magic.n_contigs << "..." << std::endl;
+		return false;
+	}
+
+	for(U32 i = 0; i < this->header_magic.n_contigs; ++i){
+		if(this->contigs[i].name != other.contigs[i].name || this->contigs[i].bp_length != other.contigs[i].bp_length){
+			std::cerr << utility::timestamp("ERROR","HEADER") << "Contig " << i << " differ: " << this->contigs[i].name << " and " << other.contigs[i].name << "..." << std::endl;
+			return false;
+		}
+	}
+
+	// Fields are identified by their offset in the header
+	const map_entry_type* const fields[3][2] = {{this->info_fields, other.info_fields}, {this->format_fields, other.format_fields}, {this->filter_fields, other.filter_fields}};
+	const U32 n_this[3]  = {this->header_magic.n_info_values, this->header_magic.n_format_values, this->header_magic.n_filter_values};
+	const U32 n_other[3] = {other.header_magic.n_info_values, other.header_magic.n_format_values, other.header_magic.n_filter_values};
+	const char* const group_names[3] = {"INFO", "FORMAT", "FILTER"};
+
+	for(U32 g = 0; g < 3; ++g){
+		if(n_this[g] != n_other[g]){
+			std::cerr << utility::timestamp("ERROR","HEADER") << "Number of " << group_names[g] << " fields differ: " << n_this[g] << " and " << n_other[g] << "..." << std::endl;
+			return false;
+		}
+
+		for(U32 i = 0; i < n_this[g]; ++i){
+			if(fields[g][0][i].ID != fields[g][1][i].ID || fields[g][0][i].primitive_type != fields[g][1][i].primitive_type){
+				std::cerr << utility::timestamp("ERROR","HEADER") << group_names[g] << " field " << i << " differ: " << fields[g][0][i].ID << " and " << fields[g][1][i].ID << "..." << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 bool VariantHeader::buildHashTables(void){
 	if(this->header_magic.n_contigs){
 		if(this->header_magic.n_contigs*2 < 5012){
@@ -51,6 +51,16 @@ public:
 	inline const U32& getContigNumber(void) const{ return(this->header_magic.n_contigs); }
 	inline U32& getContigNumber(void){ return(this->header_magic.n_contigs); }
 
+	/**<
+	 * Checks that the samples, contigs, and INFO, FORMAT, and FILTER
+	 * fields of another header are identical to this one such that
+	 * blocks encoded with either header can be used interchangeably.
+	 * The literals are not compared.
+	 * @param other Other header
+	 * @return      Returns TRUE if they are compatible or FALSE otherwise
+	 */
+	bool isCompatible(const self_type& other) const;
+
 	/**<
 	 * Interconvert a VCF header (provided during import) to
 	 * a Tachyon header
@@ -0,0 +1,320 @@
+#include <fstream>
+#include <algorithm>
+
+#include "../support/MagicConstants.h"
+#include "variant_concatenator.h"
+
+namespace tachyon {
+
+VariantConcatenator::VariantConcatenator(const std::vector<std::string>& input_files, const std::string& output_prefix) :
+	input_files_(input_files),
+	output_prefix_(output_prefix),
+	header_(nullptr),
+	n_blocks_(0),
+	n_variants_(0),
+	entries_(input_files.size())
+{}
+
+VariantConcatenator::~VariantConcatenator(){
+	delete this->header_;
+}
+
+bool VariantConcatenator::Build(void){
+	algorithm::Timer timer;
+	timer.Start();
+
+	if(this->input_files_.size() == 0){
+		std::cerr << utility::timestamp("ERROR","CONCAT") << "No input files provided..." << std::endl;
+		return false;
+	}
+
+	if(!this->validateInputs())
+		return false;
+
+	if(!this->writer_.open(this->output_prefix_)){
+		std::cerr << utility::timestamp("ERROR", "WRITER") << "Failed to open writer..." << std::endl;
+		return false;
+	}
+
+	if(!this->writeHeader())
+		return false;
+
+	checksum_type checksums(25, this->header_->header_magic.n_info_values, this->header_->header_magic.n_format_values);
+	for(U32 i = 0; i < this->input_files_.size(); ++i){
+		if(!this->copyBlocks(i, checksums))
+			return false;
+	}
+
+	this->writer_.stream->flush();
+
+	core::Footer footer;
+	footer.offset_end_of_data = this->writer_.stream->tellp();
+	footer.n_blocks           = this->n_blocks_;
+	footer.n_variants         = this->n_variants_;
+
+	footer.setChecksumType(this->block_checksums_.type);
+
+	this->writer_.index.number_blocks = this->n_blocks_;
+	this->writer_.writeIndex();
+	if(this->block_checksums_.type == algorithm::YON_CHECKSUM_SHA512){
+		checksums.finalizeCompressed();
+		*this->writer_.stream << checksums;
+	} else {
+		*this->writer_.stream << this->block_checksums_;
+	}
+	*this->writer_.stream << footer;
+	this->writer_.stream->flush();
+
+	if(!this->writer_.stream->good()){
+		std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to write output file..." << std::endl;
+		return false;
+	}
+
+	this->writeKeychain();
+
+	if(!SILENT){
+		std::cerr << utility::timestamp("PROGRESS","CONCAT") << "Wrote: " << utility::ToPrettyString(this->n_variants_) << " variants in " << utility::ToPrettyString(this->n_blocks_) << " blocks from "
+		          << this->input_files_.size() << " files in " << timer.ElapsedString() << " to " << utility::toPrettyDiskString((U64)this->writer_.stream->tellp()) << std::endl;
+	}
+
+	return true;
+}
+
+bool VariantConcatenator::openInput(const std::string& input_file, reader_type& reader) const{
+	// Keychains are stored next to the file they belong to
+	std::vector<std::string> paths = utility::filePathBaseExtension(input_file);
+	std::string keychain_file = paths[0];
+	if(keychain_file.size()) keychain_file += '/';
+	keychain_file += (paths[3] == constants::OUTPUT_SUFFIX ? paths[2] : paths[1]) + ".kyon";
+
+	std::ifstream keychain_reader(keychain_file, std::ios::binary | std::ios::in);
+	if(keychain_reader.good()){
+		keychain_reader >> reader.keychain;
+		if(!keychain_reader.good()){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to parse keychain: " << keychain_file << "..." << std::endl;
+			return false;
+		}
+	}
+
+	if(!reader.open(input_file)){
+		std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to open: " << input_file << "..." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool VariantConcatenator::validateInputs(void){
+	this->writer_.checkOutputNames(this->output_prefix_);
+	const std::string output_file = this->writer_.getOutputFile();
+
+	S32 previous_contig   = -1;
+	U64 previous_position = 0;
+	U64 n_blocks_total    = 0;
+	std::vector<bool> contig_seen;
+
+	for(U32 i = 0; i < this->input_files_.size(); ++i){
+		if(this->input_files_[i] == output_file){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Input file " << this->input_files_[i] << " is also the output file..." << std::endl;
+			return false;
+		}
+
+		reader_type reader;
+		if(!this->openInput(this->input_files_[i], reader))
+			return false;
+
+		if(this->header_ == nullptr){
+			this->header_ = new header_type(reader.header);
+			this->block_checksums_.type = (algorithm::TACHYON_CHECKSUM_TYPE)reader.footer.getChecksumType();
+			contig_seen.resize(this->header_->header_magic.n_contigs, false);
+
+			// Quad-trees adopt the layout of the first input with
+			// data for a contig
+			for(U32 c = 0; c < this->header_->header_magic.n_contigs; ++c)
+				this->writer_.index.index_.add(c, this->header_->contigs[c].bp_length, 0);
+
+		} else if(!this->header_->isCompatible(reader.header)){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "The header of " << this->input_files_[i] << " does not match the header of " << this->input_files_[0] << "..." << std::endl;
+			return false;
+		}
+
+		if(!this->dictionaries_.merge(reader.codec_manager.dictionaries))
+			return false;
+
+		if(reader.keychain.size() && !this->keychain_.merge(reader.keychain)){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to merge the keychain of " << this->input_files_[i] << "..." << std::endl;
+			return false;
+		}
+
+		// Blocks in file order
+		const index::VariantIndex& index = reader.index.getIndex();
+		if(index.size() != this->header_->header_magic.n_contigs){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Index of " << this->input_files_[i] << " does not match its header..." << std::endl;
+			return false;
+		}
+
+		std::vector<index_entry_type>& entries = this->entries_[i];
+		for(U32 c = 0; c < index.size(); ++c){
+			for(U32 j = 0; j < index.linear_at(c).size(); ++j)
+				entries.push_back(index.linear_at(c)[j]);
+		}
+		std::sort(entries.begin(), entries.end(), [](const index_entry_type& a, const index_entry_type& b){ return(a.byte_offset < b.byte_offset); });
+
+		if(entries.size() != reader.footer.n_blocks){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Index of " << this->input_files_[i] << " covers " << entries.size() << " of " << reader.footer.n_blocks << " blocks..." << std::endl;
+			return false;
+		}
+
+		// The output has to be sorted as if it was imported at once
+		for(U32 j = 0; j < entries.size(); ++j){
+			if(entries[j].contigID == previous_contig){
+				if(entries[j].minPosition < previous_position){
+					std::cerr << utility::timestamp("ERROR","CONCAT") << "Blocks of " << this->input_files_[i] << " are not sorted after the preceding blocks: "
+					          << this->header_->contigs[previous_contig].name << ":" << entries[j].minPosition << " follows " << previous_position << "..." << std::endl;
+					return false;
+				}
+			} else {
+				if(entries[j].contigID < 0 || entries[j].contigID >= (S32)contig_seen.size() || contig_seen[entries[j].contigID]){
+					std::cerr << utility::timestamp("ERROR","CONCAT") << "Blocks of " << this->input_files_[i] << " are not sorted after the preceding blocks: contig "
+					          << entries[j].contigID << " was seen before. Provide the input files in sorted order..." << std::endl;
+					return false;
+				}
+				contig_seen[entries[j].contigID] = true;
+				previous_contig = entries[j].contigID;
+			}
+			previous_position = entries[j].maxPosition;
+		}
+
+		// Block numbers in the quad-trees follow the blocks of
+		// the preceding inputs
+		for(U32 c = 0; c < index.size(); ++c){
+			if(!this->writer_.index.index_[c].merge(index[c], n_blocks_total)){
+				std::cerr << utility::timestamp("ERROR","CONCAT") << "Index of contig " << this->header_->contigs[c].name << " in " << this->input_files_[i] << " has an incompatible layout..." << std::endl;
+				return false;
+			}
+		}
+		n_blocks_total += reader.footer.n_blocks;
+	}
+
+	if(!SILENT){
+		std::cerr << utility::timestamp("LOG","CONCAT") << "Concatenating " << utility::ToPrettyString(n_blocks_total) << " blocks from " << this->input_files_.size() << " files..." << std::endl;
+	}
+
+	return true;
+}
+
+bool VariantConcatenator::writeHeader(void){
+	this->writer_.stream->write(&tachyon::constants::FILE_HEADER[0], tachyon::constants::FILE_HEADER_LENGTH);
+
+	header_type header(*this->header_);
+	if(this->literals_.size()){
+		header.literals = this->literals_;
+	} else {
+		header.literals += "\n##tachyon_concatVersion=" + tachyon::constants::PROGRAM_NAME + "-" + VERSION + ";";
+		header.literals += "libraries=" +  tachyon::constants::PROGRAM_NAME + '-' + tachyon::constants::TACHYON_LIB_VERSION + ","
+		                + SSLeay_version(SSLEAY_VERSION) + "," + "ZSTD-" + ZSTD_versionString() + "; timestamp=" + utility::datetime();
+		header.literals += "\n##tachyon_concatCommand=" + tachyon::constants::LITERAL_COMMAND_LINE;
+	}
+	header.header_magic.l_literals = header.literals.size();
+
+	// Dictionaries of all inputs are stored after the header literals
+	containers::DataContainer header_data;
+	header_data.resize(65536 + header.literals.size()*2);
+	header_data.buffer_data_uncompressed << header;
+	if(this->dictionaries_.size())
+		header_data.buffer_data_uncompressed << this->dictionaries_;
+
+	algorithm::ZSTDCodec codec;
+	if(!codec.compress(header_data)){
+		std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to compress header..." << std::endl;
+		return false;
+	}
+	*this->writer_.stream << header_data.header;
+	*this->writer_.stream << header_data.buffer_data;
+	return(this->writer_.stream->good());
+}
+
+bool VariantConcatenator::copyBlocks(const U32 input, checksum_type& checksums){
+	reader_type reader;
+	reader.getSettings().loadAll(true);
+	reader.getSettings().load_ppa = false; // not part of the digests
+	if(!this->openInput(this->input_files_[input], reader))
+		return false;
+
+	// Blocks with checksums are verified before they are copied
+	reader.setVerifyChecksums(reader.block_checksums.type != algorithm::YON_CHECKSUM_SHA512);
+
+	const std::vector<index_entry_type>& entries = this->entries_[input];
+	index::VariantIndex& index = this->writer_.index.index_;
+
+	for(U32 i = 0; i < entries.size(); ++i){
+		const U64 start = reader.stream.tellg();
+		if(start != entries[i].byte_offset){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Block " << i << " of " << this->input_files_[input] << " is not at the offset stored in its index..." << std::endl;
+			return false;
+		}
+
+		// Loads the compressed containers for the digests
+		if(!reader.nextBlockCompressed()){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to read block " << i << " of " << this->input_files_[input] << "..." << std::endl;
+			return false;
+		}
+		if(this->block_checksums_.type == algorithm::YON_CHECKSUM_SHA512)
+			checksums.addCompressed(reader.block);
+
+		const U64 end = reader.stream.tellg();
+		if(end != entries[i].byte_offset_end){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Block " << i << " of " << this->input_files_[input] << " does not end at the offset stored in its index..." << std::endl;
+			return false;
+		}
+
+		this->buffer_.reset();
+		this->buffer_.resize(end - start);
+		reader.stream.seekg(start);
+		reader.stream.read(this->buffer_.data(), end - start);
+		if(!reader.stream.good()){
+			std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to read block " << i << " of " << this->input_files_[input] << "..." << std::endl;
+			return false;
+		}
+
+		index_entry_type entry(entries[i]);
+		entry.byte_offset = this->writer_.stream->tellp();
+		this->writer_.stream->write(this->buffer_.data(), end - start);
+		entry.byte_offset_end = this->writer_.stream->tellp();
+		if(this->block_checksums_.type != algorithm::YON_CHECKSUM_SHA512)
+			this->block_checksums_.add(entry.byte_offset, algorithm::BlockChecksum::compute(this->block_checksums_.type, this->buffer_.data(), end - start));
+		index.linear_at(entry.contigID) += entry;
+
+		++this->n_blocks_;
+		this->n_variants_ += entry.n_variants;
+	}
+
+	if(!this->writer_.stream->good()){
+		std::cerr << utility::timestamp("ERROR","CONCAT") << "Failed to write blocks of " << this->input_files_[input] << "..." << std::endl;
+		return false;
+	}
+
+	if(!SILENT){
+		std::cerr << utility::timestamp("PROGRESS","CONCAT") << "Copied " << utility::ToPrettyString(entries.size()) << " blocks from " << this->input_files_[input] << "..." << std::endl;
+	}
+
+	return true;
+}
+
+void VariantConcatenator::writeKeychain(void){
+	if(this->keychain_.size() == 0)
+		return;
+
+	std::ofstream writer_keychain;
+	writer_keychain.open(this->writer_.basePath + this->writer_.baseName + ".kyon", std::ios::out);
+	if(!SILENT)
+		std::cerr << utility::timestamp("LOG") << "Writing encryption keychain to: " << (this->writer_.basePath + this->writer_.baseName) << ".kyon" << std::endl;
+
+	if(writer_keychain.good()){
+		writer_keychain << this->keychain_;
+		writer_keychain.flush();
+	}
+	writer_keychain.close();
+}
+
+}
@@ -0,0 +1,108 @@
+#ifndef CORE_VARIANT_CONCATENATOR_H_
+#define CORE_VARIANT_CONCATENATOR_H_
+
+#include <vector>
+#include <string>
+
+#include "../support/type_definitions.h"
+#include "../support/helpers.h"
+#include "../index/index_entry.h"
+#include "../variant_reader.h"
+#include "variant_import_writer.h"
+
+namespace tachyon {
+
+/**<
+ * Concatenates YON files with compatible headers into a single file.
+ * Blocks are copied byte-for-byte: containers are never decompressed
+ * or re-permuted. The quad-tree index, meta-index, digests, and
+ * footer are rebuilt for the output. Inputs have to be given in
+ * sorted order, such as the per-chromosome or per-chunk output of
+ * parallel imports.
+ *
+ * Digests of the uncompressed data cannot be computed without
+ * decompressing the blocks: only digests of the compressed data are
+ * stored and the others are left as zeroes. If the first input has
+ * per-block checksums then the checksums of the copied blocks are
+ * stored instead.
+ */
+class VariantConcatenator {
+private:
+	typedef VariantConcatenator                    self_type;
+	typedef VariantImportWriterFile                writer_type;
+	typedef VariantReader                          reader_type;
+	typedef io::BasicBuffer                        buffer_type;
+	typedef core::VariantHeader                    header_type;
+	typedef index::IndexEntry                      index_entry_type;
+	typedef algorithm::VariantDigitalDigestManager checksum_type;
+	typedef algorithm::BlockChecksumManager        block_checksum_type;
+	typedef algorithm::ZSTDDictionaryManager       dictionary_type;
+	typedef encryption::Keychain                   keychain_type;
+
+public:
+	VariantConcatenator(const std::vector<std::string>& input_files, const std::string& output_prefix);
+	~VariantConcatenator();
+	bool Build(void);
+
+	/**<
+	 * Replace the header literals of the output. By default the
+	 * literals of the first input are kept and the concatenation
+	 * is recorded.
+	 * @param literals Header literals of the output
+	 */
+	inline void setLiterals(const std::string& literals){ this->literals_ = literals; }
+
+private:
+	/**<
+	 * Open an input file and load its keychain, if any, from the
+	 * `.kyon` file next to it
+	 * @param input_file Target input file
+	 * @param reader     Reader to open the file with
+	 * @return           Returns TRUE upon success or FALSE otherwise
+	 */
+	bool openInput(const std::string& input_file, reader_type& reader) const;
+
+	/**<
+	 * Validate the headers, the order of blocks, and the indices of
+	 * all inputs. Merges their quad-tree indices, dictionaries, and
+	 * keychains for the output. Nothing is written.
+	 * @return Returns TRUE upon success or FALSE otherwise
+	 */
+	bool validateInputs(void);
+
+	/**<
+	 * Write the file magic and the header of the first input with
+	 * the dictionaries of all inputs
+	 * @return Returns TRUE upon success or FALSE otherwise
+	 */
+	bool writeHeader(void);
+
+	/**<
+	 * Copy all blocks of an input to the output and add them to the
+	 * linear index and the digests
+	 * @param input     Offset of the input file
+	 * @param checksums Digests of the output
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	bool copyBlocks(const U32 input, checksum_type& checksums);
+
+	void writeKeychain(void);
+
+private:
+	std::vector<std::string> input_files_;
+	std::string  output_prefix_;
+	std::string  literals_;     // header literals replacing the default literals
+	header_type* header_;       // header of the first input
+	dictionary_type dictionaries_;
+	keychain_type keychain_;
+	block_checksum_type block_checksums_; // per-block checksums of the output if used
+	U64          n_blocks_;     // blocks written
+	U64          n_variants_;   // variants written
+	std::vector< std::vector<index_entry_type> > entries_; // linear index of each input in file order
+	writer_type  writer_;
+	buffer_type  buffer_;       // raw block data
+};
+
+}
+
+#endif /* CORE_VARIANT_CONCATENATOR_H_ */
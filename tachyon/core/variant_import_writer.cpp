@@ -1,4 +1,5 @@
 #include <strings.h>
+#include <unistd.h>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -14,6 +15,7 @@ namespace tachyon {
 VariantImportWriterInterface::VariantImportWriterInterface() :
 	n_blocks_written(0),
 	n_variants_written(0),
+	silent(SILENT),
 	stream(nullptr)
 {}
 
@@ -44,13 +46,46 @@ bool VariantImportWriterFile::open(const std::string output){
 		return false;
 	}
 
-	if(!SILENT){
+	if(!this->silent){
 		std::cerr << utility::timestamp("LOG", "WRITER") << "Opening: " << this->basePath + this->baseName + '.' + constants::OUTPUT_SUFFIX << "..." << std::endl;
 	}
 
 	return true;
 }
 
+bool VariantImportWriterFile::openAppend(const std::string output){
+	if(output.size() == 0){
+		std::cerr << utility::timestamp("ERROR", "WRITER") << "No output file/file prefix provided!" << std::endl;
+		return false;
+	}
+	std::ofstream* ostream = reinterpret_cast<std::ofstream*>(this->stream);
+
+	this->filename = output;
+	this->checkOutputNames(output);
+	ostream->open(this->getOutputFile(), std::ios::in | std::ios::out | std::ios::binary);
+
+	// Check streams
+	if(!this->stream->good()){
+		std::cerr << utility::timestamp("ERROR", "WRITER") << "Could not open: " << this->getOutputFile() << " for appending!" << std::endl;
+		return false;
+	}
+
+	if(!this->silent){
+		std::cerr << utility::timestamp("LOG", "WRITER") << "Appending to: " << this->getOutputFile() << "..." << std::endl;
+	}
+
+	return true;
+}
+
+bool VariantImportWriterFile::truncate(const U64 length){
+	this->stream->flush();
+	if(::truncate(this->getOutputFile().c_str(), length) != 0){
+		std::cerr << utility::timestamp("ERROR", "WRITER") << "Could not truncate: " << this->getOutputFile() << "!" << std::endl;
+		return false;
+	}
+	return true;
+}
+
 void VariantImportWriterFile::checkOutputNames(const std::string& input){
 	std::vector<std::string> paths = utility::filePathBaseExtension(input);
 	this->basePath = paths[0];
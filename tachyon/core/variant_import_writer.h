@@ -6,6 +6,7 @@
 
 #include "../index/index.h"
 #include "../support/type_definitions.h"
+#include "../support/MagicConstants.h"
 
 namespace tachyon {
 
@@ -24,6 +25,7 @@ public:
 public:
 	U64 n_blocks_written;
 	U64 n_variants_written;
+	bool silent;            // suppress program messages
 	std::ostream* stream;
 	sorted_index_type index;
 };
@@ -37,7 +39,25 @@ public:
 	~VariantImportWriterFile();
 	bool open(const std::string output);
 
-private:
+	/**<
+	 * Open an existing output file for update without truncating
+	 * it. The caller positions the stream.
+	 * @param output Output file or file prefix
+	 * @return       Returns TRUE upon success or FALSE otherwise
+	 */
+	bool openAppend(const std::string output);
+
+	/**<
+	 * Cut the output file at `length` bytes. Pending output is
+	 * flushed beforehand.
+	 * @param length Length of the file in bytes
+	 * @return       Returns TRUE upon success or FALSE otherwise
+	 */
+	bool truncate(const U64 length);
+
+	inline std::string getOutputFile(void) const{ return(this->basePath + this->baseName + '.' + constants::OUTPUT_SUFFIX); }
+
+	// Set the output path and base name from a file or file prefix
 	void checkOutputNames(const std::string& input);
 
 public:
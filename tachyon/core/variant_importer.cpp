@@ -1,11 +1,14 @@
 #include <fstream>
 #include <regex>
+#include <cstdio>
 
 #include "../algorithm/digital_digest.h"
 #include "footer/footer.h"
 #include "../containers/checksum_container.h"
 #include "variant_importer.h"
+#include "../variant_reader.h"
 #include "../algorithm/encryption/EncryptionDecorator.h"
+#include "variant_concatenator.h"
 
 namespace tachyon {
 
@@ -18,34 +21,74 @@ VariantImporter::VariantImporter(std::string inputFile,
 	GT_available_(false),
 	permute(true),
 	encrypt(false),
+	train_dictionaries_(false),
+	append_(false),
+	checksum_algorithm_(algorithm::YON_CHECKSUM_SHA512),
 	checkpoint_n_snps(checkpoint_n_snps),
 	checkpoint_bases(checkpoint_bases),
 	n_threads_(std::thread::hardware_concurrency()),
+	n_shards_(1),
+	n_pipeline_batches_(4),
+	silent_(SILENT),
+	pipeline_failed_(false),
 	info_end_key_(-1),
 	info_svlen_key_(-1),
+	append_contig_(-1),
+	append_position_(0),
+	append_offset_(0),
 	inputFile(inputFile),
 	outputPrefix(outputPrefix),
 	writer(nullptr),
-	header(nullptr)
+	header(nullptr),
+	batches_(nullptr)
 {
 }
 
 VariantImporter::~VariantImporter(){
 	delete this->writer;
+	delete [] this->batches_;
 }
 
 bool VariantImporter::Build(){
-	std::ifstream temp(this->inputFile, std::ios::binary | std::ios::in);
-	if(!temp.good()){
+	// Standard input cannot be sniffed and reopened: it
+	// has to be a BCF stream
+	if(this->inputFile == "-"){
+		if(this->n_shards_ > 1)
+			std::cerr << utility::timestamp("WARNING","IMPORT") << "Standard input cannot be imported in parallel regions: importing serially..." << std::endl;
+
+		if(!this->BuildBCF()){
+			std::cerr << utility::timestamp("ERROR", "IMPORT") << "Failed build!" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// zlib reads uncompressed files transparently: this
+	// detects the format of plain and compressed input
+	gzFile temp = gzopen(this->inputFile.c_str(), "rb");
+	if(temp == nullptr){
 		std::cerr << utility::timestamp("ERROR", "IMPORT")  << "Failed to open file (" << this->inputFile << ")..." << std::endl;
 		return false;
 	}
-	char tempData[2];
-	temp.read(&tempData[0], 2);
-	temp.close();
+	char tempData[16];
+	const int n_read = gzread(temp, &tempData[0], 16);
+	gzclose(temp);
+
+	if(n_read >= 4 && strncmp(&tempData[0], "BCF\2", 4) == 0){
+		if(this->n_shards_ > 1){
+			if(!this->BuildSharded()){
+				std::cerr << utility::timestamp("ERROR", "IMPORT") << "Failed build!" << std::endl;
+				return false;
+			}
+		} else if(!this->BuildBCF()){
+			std::cerr << utility::timestamp("ERROR", "IMPORT") << "Failed build!" << std::endl;
+			return false;
+		}
+	} else if(n_read == 16 && strncmp(&tempData[0], "##fileformat=VCF", 16) == 0){
+		if(this->n_shards_ > 1)
+			std::cerr << utility::timestamp("WARNING","IMPORT") << "VCF files cannot be imported in parallel regions: importing serially..." << std::endl;
 
-	if((BYTE)tempData[0] == io::constants::GZIP_ID1 && (BYTE)tempData[1] == io::constants::GZIP_ID2){
-		if(!this->BuildBCF()){
+		if(!this->BuildVCF()){
 			std::cerr << utility::timestamp("ERROR", "IMPORT") << "Failed build!" << std::endl;
 			return false;
 		}
@@ -58,30 +101,256 @@ bool VariantImporter::Build(){
 
 bool VariantImporter::BuildBCF(void){
 	bcf_reader_type reader;
+	reader.setInflateThreads(this->n_threads_);
+	reader.setProfiler(&this->profiler_);
+	if(!reader.open(this->inputFile)){
+		std::cerr << utility::timestamp("ERROR", "BCF")  << "Failed to open BCF file..." << std::endl;
+		return false;
+	}
+
+	// Only import the records of a region
+	if(this->region_.n_records){
+		if(!reader.seek(this->region_.block_offset, this->region_.in_block_offset)){
+			std::cerr << utility::timestamp("ERROR", "BCF")  << "Failed to seek to region..." << std::endl;
+			return false;
+		}
+		reader.setLimit(this->region_.n_records);
+	}
+
+	return(this->BuildImport(reader, "BCF"));
+}
+
+bool VariantImporter::BuildSharded(void){
+	if(this->append_){
+		std::cerr << utility::timestamp("ERROR", "IMPORT") << "Cannot append to a file with a sharded import..." << std::endl;
+		return false;
+	}
+
+	if(this->outputPrefix.size() == 0){
+		std::cerr << utility::timestamp("ERROR", "IMPORT") << "Cannot write a sharded import to standard output..." << std::endl;
+		return false;
+	}
+
+	algorithm::Timer timer;
+	timer.Start();
+
+	bcf_reader_type reader;
+	reader.setInflateThreads(this->n_threads_);
 	if(!reader.open(this->inputFile)){
 		std::cerr << utility::timestamp("ERROR", "BCF")  << "Failed to open BCF file..." << std::endl;
 		return false;
 	}
 
+	std::vector<ImportRegion> regions;
+	if(!this->findRegions(reader, regions))
+		return false;
+
+	if(!this->silent_){
+		std::cerr << utility::timestamp("LOG","IMPORT") << "Importing " << utility::ToPrettyString(reader.n_read) << " variants in "
+		          << regions.size() << " regions in parallel (found in " << timer.ElapsedString() << ")..." << std::endl;
+	}
+
+	// Regions are imported into temporary files next to the output
+	writer_file_type names;
+	names.checkOutputNames(this->outputPrefix);
+	std::vector<std::string> region_prefixes(regions.size());
+	std::vector<std::string> region_files(regions.size());
+	for(U32 i = 0; i < regions.size(); ++i){
+		region_prefixes[i] = names.basePath + names.baseName + "_shard" + std::to_string(i);
+		region_files[i]    = region_prefixes[i] + '.' + constants::OUTPUT_SUFFIX;
+	}
+
+	std::vector<BYTE> succeeded(regions.size(), false);
+	std::vector<std::thread> workers;
+	for(U32 i = 0; i < regions.size(); ++i)
+		workers.push_back(std::thread(&self_type::buildRegion, this, std::cref(regions[i]), region_files[i], std::ref(succeeded[i])));
+
+	for(U32 i = 0; i < workers.size(); ++i)
+		workers[i].join();
+
+	bool success = true;
+	for(U32 i = 0; i < regions.size(); ++i){
+		if(!succeeded[i]){
+			std::cerr << utility::timestamp("ERROR","IMPORT") << "Failed to import region " << i << "..." << std::endl;
+			success = false;
+		}
+	}
+
+	// Blocks are copied without recompressing them: digests of the
+	// uncompressed data are not available for the output
+	if(success){
+		core::VariantHeader header(reader.header);
+		VariantConcatenator concatenator(region_files, this->outputPrefix);
+		concatenator.setLiterals(header.literals + this->getImportLiterals());
+		success = concatenator.Build();
+	}
+
+	for(U32 i = 0; i < regions.size(); ++i){
+		std::remove(region_files[i].c_str());
+		std::remove((region_prefixes[i] + "_yon_stats.txt").c_str());
+		std::remove((region_prefixes[i] + "_yon_profile.json").c_str());
+		std::remove((region_prefixes[i] + ".kyon").c_str());
+	}
+
+	if(success && !this->silent_)
+		std::cerr << utility::timestamp("PROGRESS","IMPORT") << "Imported " << regions.size() << " regions in " << timer.ElapsedString() << "..." << std::endl;
+
+	return(success);
+}
+
+bool VariantImporter::findRegions(bcf_reader_type& reader, std::vector<ImportRegion>& regions) const{
+	// Regions are balanced on the compressed size of the records
+	const U64 b_data = (reader.filesize > reader.block_offset ? reader.filesize - reader.block_offset : 0);
+	const U64 b_target = b_data / this->n_shards_;
+
+	S32 contig = -1;
+	S32 previous_contig = -1;
+	U64 block_offset = 0;
+	U32 in_block_offset = 0;
+	while(reader.nextRecordOffset(contig, block_offset, in_block_offset)){
+		if(regions.size() == 0){
+			regions.push_back(ImportRegion(block_offset, in_block_offset));
+		} else if(regions.size() < this->n_shards_){
+			// Prefer to split at a contig switch
+			const U64 b_region = block_offset - regions.back().block_offset;
+			if(b_region >= b_target || (contig != previous_contig && b_region >= b_target / 4 * 3))
+				regions.push_back(ImportRegion(block_offset, in_block_offset));
+		}
+
+		++regions.back().n_records;
+		previous_contig = contig;
+	}
+
+	if(!reader.good()){
+		std::cerr << utility::timestamp("ERROR","IMPORT") << "Failed to read input file..." << std::endl;
+		return false;
+	}
+
+	if(regions.size() == 0){
+		std::cerr << utility::timestamp("ERROR","IMPORT") << "No variants in input file..." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void VariantImporter::buildRegion(const ImportRegion& region, const std::string output, BYTE& success) const{
+	// Regions share the threads and the memory budget
+	VariantImporter importer(this->inputFile, output, this->checkpoint_n_snps, this->checkpoint_bases);
+	// Program messages of the regions would interleave
+	importer.setSilent(true);
+	importer.setThreads(std::max(this->n_threads_ / this->n_shards_, (U32)1));
+	importer.setPermute(this->permute);
+	importer.setPBWT(this->encoder.usePBWT());
+	importer.setBitplane(this->encoder.useBitplane());
+	importer.setEncrypt(this->encrypt);
+	importer.setCompressionObjective(this->compression_manager.policy.getObjective());
+	importer.setDecodeBudget(this->compression_manager.policy.getDecodeBudget());
+	importer.setDictionaries(this->train_dictionaries_);
+	importer.setChecksumType(this->checksum_algorithm_);
+	importer.setMemoryBudget(this->block_sizer_.getMemoryBudget() / this->n_shards_);
+	importer.setTargetBlockSize(this->block_sizer_.getTargetUncompressed(), this->block_sizer_.getTargetCompressed());
+	importer.region_ = region;
+
+	success = importer.BuildBCF();
+}
+
+std::string VariantImporter::getImportLiterals(void) const{
+	std::string literals = "\n##tachyon_importVersion=" + tachyon::constants::PROGRAM_NAME + "-" + VERSION + ";";
+	literals += "libraries=" +  tachyon::constants::PROGRAM_NAME + '-' + tachyon::constants::TACHYON_LIB_VERSION + ","
+	         + SSLeay_version(SSLEAY_VERSION) + "," + "ZSTD-" + ZSTD_versionString() + "; timestamp=" + utility::datetime();
+	literals += "\n##tachyon_importCommand=import -i " + this->inputFile + " -o " + this->outputPrefix + " -c " + std::to_string(this->checkpoint_n_snps) + " -C " + std::to_string(this->checkpoint_bases);
+	if(this->encrypt) literals += " -k";
+	if(this->permute) literals += " -P";
+	else literals += " -p";
+	if(this->compression_manager.policy.isActive()){
+		literals += " -O " + algorithm::CompressionPolicy::objectiveString(this->compression_manager.policy.getObjective());
+		if(this->compression_manager.policy.getObjective() == algorithm::YON_OBJECTIVE_BUDGET)
+			literals += " --decode-budget " + std::to_string(this->compression_manager.policy.getDecodeBudget());
+	}
+	if(this->train_dictionaries_) literals += " -D";
+	if(this->encoder.usePBWT()) literals += " -G pbwt";
+	else if(this->encoder.useBitplane()) literals += " -G bitplane";
+	if(this->block_sizer_.getMemoryBudget())       literals += " -m " + std::to_string((double)this->block_sizer_.getMemoryBudget() / 1e6);
+	if(this->block_sizer_.getTargetUncompressed()) literals += " -b " + std::to_string((double)this->block_sizer_.getTargetUncompressed() / 1e6);
+	if(this->block_sizer_.getTargetCompressed())   literals += " -z " + std::to_string((double)this->block_sizer_.getTargetCompressed() / 1e6);
+	if(this->checksum_algorithm_ != algorithm::YON_CHECKSUM_SHA512) literals += " -X " + algorithm::BlockChecksum::typeString(this->checksum_algorithm_);
+	if(this->n_shards_ > 1) literals += " -n " + std::to_string(this->n_shards_);
+	return(literals);
+}
+
+bool VariantImporter::BuildVCF(void){
+	vcf::VCFReader reader;
+	reader.setParseThreads(this->n_threads_);
+	reader.setProfiler(&this->profiler_);
+	if(!reader.open(this->inputFile)){
+		std::cerr << utility::timestamp("ERROR", "VCF")  << "Failed to open VCF file..." << std::endl;
+		return false;
+	}
+
+	return(this->BuildImport(reader, "VCF"));
+}
+
+template <class reader_type>
+bool VariantImporter::BuildImport(reader_type& reader, const std::string& input_type){
 	encryption::EncryptionDecorator encryptionManager;
 	encryption::Keychain keychain;
 
 	this->header = &reader.header;
 
-	// Spawn RLE controller and update PPA controller
+	// Spawn RLE controller
 	this->encoder.setSamples(this->header->samples);
-	this->block.ppa_manager.setSamples(this->header->samples);
-	// temp
-	//permutation_type haploid_permuter;
-	this->permutator.manager = &this->block.ppa_manager;
-	//this->permutator.manager_haploid = &haploid_permuter;
+	this->compression_manager.setThreads(this->n_threads_);
+	encryptionManager.setThreads(this->n_threads_);
+	this->compression_manager.policy.setFields(21, this->header->info_map.size(), this->header->format_map.size());
+	this->profiler_.setFields(21, this->header->info_map.size(), this->header->format_map.size());
+	this->compression_manager.setProfiler(&this->profiler_);
+	this->encoder.setProfiler(&this->profiler_);
+	this->permutator.profiler = &this->profiler_;
+	// The header of an existing file is not rewritten: blocks appended
+	// to it are compressed with the dictionaries it already has
+	if(this->append_ && this->train_dictionaries_){
+		std::cerr << utility::timestamp("WARNING","IMPORT") << "Dictionaries cannot be added to an existing file: using the dictionaries of the file..." << std::endl;
+		this->train_dictionaries_ = false;
+	}
+	if(this->train_dictionaries_)
+		this->compression_manager.dictionaries.setFields(this->header->info_map.size(), this->header->format_map.size());
+	// Recycled batches: the permutation manager of each block
+	// is sized for the permuter. The permuter itself only needs
+	// a valid manager to initialise
+	this->batches_ = new batch_type[this->n_pipeline_batches_];
+	this->permutator.manager = &this->batches_[0].block.ppa_manager;
 	this->permutator.setSamples(this->header->samples);
-	//haploid_permuter.setSamples(this->header->samples*2);
+	this->permutator.setThreads(this->n_threads_);
+	for(U32 i = 1; i < this->n_pipeline_batches_; ++i)
+		this->batches_[i].block.ppa_manager.setSamples(this->header->samples*2);
+
+	// Block sizes are chosen from the observed bytes per variant if
+	// a memory budget or target block size is set
+	this->block_sizer_.init(this->checkpoint_n_snps, this->header->samples, this->n_pipeline_batches_);
+	this->memory_budget_.setLimit(this->block_sizer_.getMemoryBudget());
+	if(this->block_sizer_.isActive() && !this->silent_){
+		std::cerr << utility::timestamp("LOG","IMPORT") << "Automatic block sizing: memory budget "
+		          << (this->block_sizer_.getMemoryBudget() ? utility::toPrettyDiskString(this->block_sizer_.getMemoryBudget()) : "none") << ", target block size "
+		          << (this->block_sizer_.getTargetUncompressed() ? utility::toPrettyDiskString(this->block_sizer_.getTargetUncompressed()) : "none") << " uncompressed and "
+		          << (this->block_sizer_.getTargetCompressed() ? utility::toPrettyDiskString(this->block_sizer_.getTargetCompressed()) : "none") << " compressed..." << std::endl;
+	}
 
 	if(this->outputPrefix.size() == 0) this->writer = new writer_stream_type;
 	else this->writer = new writer_file_type;
+	this->writer->silent = this->silent_;
 
-	if(!this->writer->open(this->outputPrefix)){
+	if(this->append_){
+		if(this->outputPrefix.size() == 0){
+			std::cerr << utility::timestamp("ERROR", "WRITER") << "Cannot append to standard output..." << std::endl;
+			return false;
+		}
+
+		if(!reinterpret_cast<writer_file_type*>(this->writer)->openAppend(this->outputPrefix)){
+			std::cerr << utility::timestamp("ERROR", "WRITER") << "Failed to open writer..." << std::endl;
+			return false;
+		}
+	} else if(!this->writer->open(this->outputPrefix)){
 		std::cerr << utility::timestamp("ERROR", "WRITER") << "Failed to open writer..." << std::endl;
 		return false;
 	}
@@ -109,25 +378,14 @@ bool VariantImporter::BuildBCF(void){
 	}
 
 	// Writer MAGIC
-	this->writer->stream->write(&tachyon::constants::FILE_HEADER[0], tachyon::constants::FILE_HEADER_LENGTH);
+	if(this->append_ == false)
+		this->writer->stream->write(&tachyon::constants::FILE_HEADER[0], tachyon::constants::FILE_HEADER_LENGTH);
 	// Convert VCF header to Tachyon heeader
 	core::VariantHeader header(*this->header);
-	header.literals += "\n##tachyon_importVersion=" + tachyon::constants::PROGRAM_NAME + "-" + VERSION + ";";
-	header.literals += "libraries=" +  tachyon::constants::PROGRAM_NAME + '-' + tachyon::constants::TACHYON_LIB_VERSION + ","
-			  + SSLeay_version(SSLEAY_VERSION) + "," + "ZSTD-" + ZSTD_versionString() + "; timestamp=" + utility::datetime();
-	header.literals += "\n##tachyon_importCommand=import -i " + this->inputFile + " -o " + this->outputPrefix + " -c " + std::to_string(this->checkpoint_n_snps) + " -C " + std::to_string(this->checkpoint_bases);
-	if(this->encrypt) header.literals += " -k";
-	if(this->permute) header.literals += " -P";
-	else header.literals += " -p";
+	header.literals += this->getImportLiterals();
 	header.header_magic.l_literals = header.literals.size();
-
-	// Convert header to byte stream, compress, and write to file
-	containers::DataContainer header_data;
-	header_data.resize(65536 + header.literals.size()*2);
-	header_data.buffer_data_uncompressed << header;
-	this->compression_manager.zstd_codec.compress(header_data);
-	*this->writer->stream << header_data.header; // write header
-	*this->writer->stream << header_data.buffer_data;
+	// The header is written by the write stage as dictionaries
+	// are trained on the first blocks
 
 	// Search for GT field in the header
 	this->GT_available_ = header.has_format_field("GT");
@@ -141,7 +399,8 @@ bool VariantImporter::BuildBCF(void){
 	for(U32 i = 0; i < this->header->info_map.size(); ++i){
 		if(this->header->info_map[i].ID == "END"){
 			this->info_end_key_ = this->header->info_map[i].IDX;
-			std::cerr << "Found END at: " << this->header->info_map[i].IDX << std::endl;
+			if(!this->silent_)
+				std::cerr << "Found END at: " << this->header->info_map[i].IDX << std::endl;
 		}
 	}
 
@@ -149,28 +408,35 @@ bool VariantImporter::BuildBCF(void){
 	for(U32 i = 0; i < this->header->info_map.size(); ++i){
 		if(this->header->info_map[i].ID == "SVLEN"){
 			this->info_svlen_key_ = this->header->info_map[i].IDX;
-			std::cerr << "Found SVLEN at: " << this->header->info_map[i].IDX << std::endl;
+			if(!this->silent_)
+				std::cerr << "Found SVLEN at: " << this->header->info_map[i].IDX << std::endl;
 		}
 	}
 
-	this->block.header.controller.hasGT = this->GT_available_;
-
 	// Resize containers
 	const U32 resize_to = this->checkpoint_n_snps * sizeof(U32) * 2; // small initial allocation
-	this->block.resize(resize_to);
+	for(U32 i = 0; i < this->n_pipeline_batches_; ++i)
+		this->batches_[i].block.resize(resize_to);
 
 	// Digest controller
-	algorithm::VariantDigitalDigestManager checksums(25, this->header->info_map.size(), this->header->format_map.size());
+	checksum_type checksums(25, this->header->info_map.size(), this->header->format_map.size());
+
+	// Continue the digests, index, and block numbering of the
+	// existing file
+	if(this->append_){
+		if(!this->openAppend(header, checksums, keychain))
+			return false;
+	}
 
 	// Start import
-	U32 previousFirst    = 0;
-	U32 previousLast     = 0;
-	S32 previousContigID = -1;
+	U32 previousFirst    = this->append_position_;
+	U32 previousLast     = this->append_position_;
+	S32 previousContigID = this->append_contig_;
 
 	// Begin import
 	// Get BCF entries
 	algorithm::Timer timer; timer.Start();
-	if(!SILENT){
+	if(!this->silent_){
 		std::cerr << utility::timestamp("PROGRESS") <<
 		std::setfill(' ') << std::setw(10) << "Variants" << ' ' <<
 		std::setfill(' ') << std::setw(10) << "Written" << '\t' <<
@@ -178,9 +444,51 @@ bool VariantImporter::BuildBCF(void){
 		"Elapsed " << "Contig:from->to" << std::endl;
 	}
 
-	while(true){
-		if(!reader.getVariants(this->checkpoint_n_snps, this->checkpoint_bases)){
+	// Pipeline: this thread reads and inflates BCF data while
+	// downstream threads permute/encode, compress, and write.
+	// Batches are recycled through the pool such that no more
+	// than `n_pipeline_batches_` blocks are in memory at once.
+	batch_queue_type pool(this->n_pipeline_batches_);
+	batch_queue_type encode_queue(this->n_pipeline_batches_);
+	batch_queue_type compress_queue(this->n_pipeline_batches_);
+	batch_queue_type write_queue(this->n_pipeline_batches_);
+	for(U32 i = 0; i < this->n_pipeline_batches_; ++i)
+		pool.push(&this->batches_[i]);
+
+	this->pipeline_failed_ = false;
+	std::thread encode_thread(&self_type::encodeStage, this, std::ref(encode_queue), std::ref(compress_queue), std::ref(pool));
+	std::thread compress_thread(&self_type::compressStage, this, std::ref(compress_queue), std::ref(write_queue), std::ref(pool), std::ref(checksums), std::ref(encryptionManager), std::ref(keychain));
+	std::thread write_thread(&self_type::writeStage, this, std::ref(write_queue), std::ref(pool), std::cref(header), std::ref(timer));
+
+	const U64 n_blocks_existing = this->writer->n_blocks_written;
+	U64 n_blocks_loaded = n_blocks_existing;
+	while(this->pipeline_failed_ == false){
+		batch_type* batch = nullptr;
+		if(!pool.pop(batch))
 			break;
+
+		// Wait until the batches in flight leave room for the next
+		// batch in the memory budget
+		const U32 n_variants = this->block_sizer_.nextBlockSize();
+		const U64 b_expected = this->block_sizer_.expectedFootprint(n_variants);
+		this->memory_budget_.acquire(b_expected);
+
+		if(!reader.getVariants(n_variants, this->checkpoint_bases)){
+			this->memory_budget_.release(b_expected);
+			break;
+		}
+
+		// Appended variants have to follow the last variant in the
+		// file and cannot return to a contig that has been written
+		if(this->append_ && n_blocks_loaded == n_blocks_existing){
+			const S32 contig = reader.front().body->CHROM;
+			if((contig == this->append_contig_ && (U64)reader.front().body->POS < this->append_position_) ||
+			   (contig != this->append_contig_ && this->writer->index.index_.linear_at(contig).size())){
+				std::cerr << utility::timestamp("ERROR","IMPORT") << "Appended variants have to be sorted after the variants in the existing file..." << std::endl;
+				this->memory_budget_.release(b_expected);
+				this->pipeline_failed_ = true;
+				break;
+			}
 		}
 
 		// Debug assertion
@@ -193,121 +501,45 @@ bool VariantImporter::BuildBCF(void){
 			}
 		}
 #endif
-		this->block.header.contigID    = reader.front().body->CHROM;
-		this->block.header.minPosition = reader.front().body->POS;
-		this->block.header.maxPosition = reader.back().body->POS;
-		this->block.header.controller.hasGT         = this->GT_available_;
-		this->block.header.controller.hasGTPermuted = this->permute;
-		// if there is 0 or 1 samples then GT data is never permuted
-		if(header.getSampleNumber() <= 1)
-			this->block.header.controller.hasGTPermuted = false;
-
-		// Permute GT if GT is available and the appropriate flag is triggered
-		if(this->block.header.controller.hasGT && this->block.header.controller.hasGTPermuted){
-			if(!this->permutator.build(reader)){
-				std::cerr << utility::timestamp("ERROR","PERMUTE") << "Failed to complete..." << std::endl;
-				return false;
-			}
-		}
-
-		//\////////////////////////////////////////////////
-		// Start new
-		// Perform parsing of BCF entries in memory
-		// Split out RLE compression and importing other INFO/FORMAT
-		meta_type* meta_entries = static_cast<meta_type*>(::operator new[](reader.size() * sizeof(meta_type)));
-
-		// Load meta data
-		for(U32 i = 0; i < reader.size(); ++i){
-			new( meta_entries + i ) meta_type( reader[i], this->block.header.minPosition );
-			if(!this->add(meta_entries[i], reader[i])){
-				std::cerr << utility::timestamp("ERROR","IMPORT") << "Failed to add BCF entry..." << std::endl;
-				return false;
-			}
-		}
-		// Add genotypes in parallel
-		this->addGenotypes(reader, meta_entries);
-		// Overload
-		for(U32 i = 0; i < reader.size(); ++i) this->block += meta_entries[i];
-
-		// Clean up
-		for(std::size_t i = 0; i < reader.size(); ++i) (meta_entries + i)->~MetaEntry();
-		::operator delete[](static_cast<void*>(meta_entries));
-		//\////////////////////////////////////////////////
-
-		// Update head meta
-		this->block.header.controller.hasGT = this->GT_available_;
-		this->block.header.n_variants       = reader.size();
-		this->block.finalize();
-
-		// Perform compression using standard parameters
-		if(!this->compression_manager.compress(this->block)){
-			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to compress..." << std::endl;
-			return false;
-		}
-
-		// Checksum have to come before encryption
-		checksums += this->block;
-
-		// Encryption
-		if(this->encrypt){
-			this->block.header.controller.anyEncrypted = true;
-			if(!encryptionManager.encrypt(this->block, keychain, YON_ENCRYPTION_AES_256_GCM)){
-				std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to encrypt..." << std::endl;
-			}
-		}
-
-		this->index_entry.byte_offset = this->writer->stream->tellp();
-		this->block.write(*this->writer->stream, this->stats_basic, this->stats_info, this->stats_format);
-
-		// Compress and write footer
-		this->block.footer_support.buffer_data_uncompressed << this->block.footer;
-		this->compression_manager.zstd_codec.compress(this->block.footer_support);
-		const U64 start_footer_pos = this->writer->stream->tellp();
-		const U32 footer_uLength   = this->block.footer_support.header.data_header.uLength;
-		const U32 footer_cLength   = this->block.footer_support.header.data_header.cLength;
-		const U32 footer_crc       = this->block.footer_support.header.data_header.crc;
-		this->writer->stream->write(reinterpret_cast<const char*>(&footer_uLength), sizeof(U32));
-		this->writer->stream->write(reinterpret_cast<const char*>(&footer_cLength), sizeof(U32));
-		this->writer->stream->write(reinterpret_cast<const char*>(&footer_crc),     sizeof(U32));
-		*this->writer->stream << this->block.footer_support.buffer_data;
-
-		stats_basic[0].cost_uncompressed += (U64)this->writer->stream->tellp() - start_footer_pos;
-
-		// Write EOB
-		this->writer->stream->write(reinterpret_cast<const char*>(&constants::TACHYON_BLOCK_EOF), sizeof(U64));
-
-		this->index_entry.blockID         = this->block.header.blockID;
-		this->index_entry.byte_offset_end = this->writer->stream->tellp();
-		this->index_entry.contigID        = reader.front().body->CHROM;
-		this->index_entry.minPosition     = reader.front().body->POS;
-		this->index_entry.maxPosition     = reader.back().body->POS;
-		this->index_entry.n_variants      = reader.size();
-		this->writer->index.index_.linear_at(index_entry.contigID) += this->index_entry; // Todo: beautify
-		//this->writer->index += this->index_entry;
-
-		this->index_entry.reset();
-		++this->writer->n_blocks_written;
-		this->writer->n_variants_written += reader.size();
-		++this->writer->index.number_blocks;
-
-		if(!SILENT){
-			std::cerr << utility::timestamp("PROGRESS") <<
-			std::setfill(' ') << std::setw(10) << this->writer->n_variants_written << ' ' <<
-			std::setfill(' ') << std::setw(10) << utility::toPrettyDiskString(this->writer->stream->tellp()) << '\t' <<
-			std::setfill(' ') << std::setw(8)  << (double)reader.stream.tellg()/reader.filesize*100 << "%" << ' ' <<
-			timer.ElapsedString() << ' ' <<
-			header.contigs[reader.front().body->CHROM].name << ":" << reader.front().body->POS+1 << "->" << reader.back().body->POS+1 << std::endl;
-		}
-
-		// Reset and update
-		this->block.clear();
-		this->permutator.reset();
-		this->writer->stream->flush();
 		previousContigID = reader.front().body->CHROM;
 		previousFirst    = reader.front().body->POS;
 		previousLast     = reader.back().body->POS;
-		this->index_entry.reset();
+
+		// Charge the batch for its actual size if the records
+		// are larger than expected
+		U64 b_records = 0;
+		for(U32 i = 0; i < reader.size(); ++i) b_records += reader[i].size();
+		const U64 b_loaded = this->block_sizer_.loadedFootprint(reader.size(), b_records);
+		if(b_loaded > b_expected) this->memory_budget_.force(b_loaded - b_expected);
+
+		// Hand off loaded entries to the batch
+		reader.transferEntries(batch->entries);
+		batch->block_number = n_blocks_loaded++;
+		batch->progress     = reader.getProgress();
+		batch->b_records    = b_records;
+		batch->b_memory     = (b_loaded > b_expected ? b_loaded : b_expected);
+		encode_queue.push(batch);
 	}
+	encode_queue.close();
+	encode_thread.join();
+	compress_thread.join();
+	write_thread.join();
+
+	if(this->pipeline_failed_){
+		std::cerr << utility::timestamp("ERROR","IMPORT") << "Failed to complete import pipeline..." << std::endl;
+		if(this->append_) this->abortAppend();
+		return false;
+	}
+
+	if(!reader.good()){
+		std::cerr << utility::timestamp("ERROR","IMPORT") << "Failed to read input file..." << std::endl;
+		if(this->append_) this->abortAppend();
+		return false;
+	}
+
+	if(this->block_sizer_.isActive() && !this->silent_)
+		std::cerr << utility::timestamp("LOG","IMPORT") << "Peak memory charged to batches in flight: " << utility::toPrettyDiskString(this->memory_budget_.peak()) << "..." << std::endl;
+
 	// Done importing
 	this->writer->stream->flush();
 
@@ -315,21 +547,35 @@ bool VariantImporter::BuildBCF(void){
 	footer.offset_end_of_data = this->writer->stream->tellp();
 	footer.n_blocks           = this->writer->n_blocks_written;
 	footer.n_variants         = this->writer->n_variants_written;
+	footer.setChecksumType(this->checksum_algorithm_);
 	assert(footer.n_blocks == this->writer->index.size());
 
 	U64 last_pos = this->writer->stream->tellp();
 	this->writer->writeIndex(); // Write index
-	std::cerr << utility::timestamp("PROGRESS") << "Index size: " << utility::toPrettyDiskString(this->writer->stream->tellp() - last_pos) << "..." << std::endl;
+	if(!this->silent_)
+		std::cerr << utility::timestamp("PROGRESS") << "Index size: " << utility::toPrettyDiskString(this->writer->stream->tellp() - last_pos) << "..." << std::endl;
 	last_pos = this->writer->stream->tellp();
-	checksums.finalize();       // Finalize SHA-512 digests
-	*this->writer->stream << checksums;
-	std::cerr << utility::timestamp("PROGRESS") << "Checksum size: " << utility::toPrettyDiskString(this->writer->stream->tellp() - last_pos) << "..." << std::endl;
+	if(this->checksum_algorithm_ == algorithm::YON_CHECKSUM_SHA512){
+		checksums.finalize();   // Finalize SHA-512 digests
+		*this->writer->stream << checksums;
+	} else {
+		*this->writer->stream << this->block_checksums_;
+	}
+	if(!this->silent_)
+		std::cerr << utility::timestamp("PROGRESS") << "Checksum size: " << utility::toPrettyDiskString(this->writer->stream->tellp() - last_pos) << "..." << std::endl;
 	last_pos = this->writer->stream->tellp();
 	*this->writer->stream << footer;
-	std::cerr << utility::timestamp("PROGRESS") << "Footer size: " << utility::toPrettyDiskString(this->writer->stream->tellp() - last_pos) << "..." << std::endl;
+	if(!this->silent_)
+		std::cerr << utility::timestamp("PROGRESS") << "Footer size: " << utility::toPrettyDiskString(this->writer->stream->tellp() - last_pos) << "..." << std::endl;
 
 	this->writer->stream->flush();
 
+	// The new tail can be shorter than the tail it replaced
+	if(this->append_){
+		if(!reinterpret_cast<writer_file_type*>(this->writer)->truncate(this->writer->stream->tellp()))
+			return false;
+	}
+
 	std::vector<std::string> usage_statistics_names = {
 		"FooterHeader","GT-PPA","MetaContig","MetaPositions","MetaRefAlt","MetaController","MetaQuality","MetaNames",
 		"MetaAlleles","MetaInfoMaps","MetaFormatMaps","MetaFilterMaps","GT-Support",
@@ -348,7 +594,7 @@ bool VariantImporter::BuildBCF(void){
 		writer_file_type* wstats = reinterpret_cast<writer_file_type*>(this->writer);
 		writer_stats.open(wstats->basePath + wstats->baseName + "_yon_stats.txt", std::ios::out);
 
-		if(!SILENT)
+		if(!this->silent_)
 			std::cerr << utility::timestamp("LOG") << "Writing statistics to: " << (wstats->basePath + wstats->baseName) << "_yon_stats.txt" << std::endl;
 
 		if(writer_stats.good()){
@@ -356,25 +602,73 @@ bool VariantImporter::BuildBCF(void){
 			for(U32 i = 0; i < header.header_magic.n_info_values; ++i)   writer_stats << "INFO_" << header.info_fields[i].ID << '\t' << this->stats_info[i] << std::endl;
 			for(U32 i = 0; i < header.header_magic.n_format_values; ++i) writer_stats << "FORMAT_" << header.format_fields[i].ID << '\t' << this->stats_format[i] << std::endl;
 
-			writer_stats << "BCF\t" << reader.filesize << "\t" << reader.b_data_read << '\t' << (float)reader.b_data_read/reader.filesize << std::endl;
+			// Trained dictionaries: size and bytes saved on the training blocks
+			for(U32 i = 0; i < this->compression_manager.dictionaries.size(); ++i){
+				const algorithm::ZSTDDictionary& dictionary = this->compression_manager.dictionaries[i];
+				writer_stats << "DICTIONARY\t"
+				             << (dictionary.group == algorithm::YON_DICTIONARY_INFO ? "INFO_" + header.info_fields[dictionary.global_key].ID : "FORMAT_" + header.format_fields[dictionary.global_key].ID)
+				             << '\t' << dictionary.dict_id << '\t' << dictionary.data.size() << '\t' << dictionary.c_saved << std::endl;
+			}
+
+			// Codec choices and measurements of the adaptive compression policy
+			if(this->compression_manager.policy.isActive()){
+				for(U32 i = 2; i < 21; ++i) this->compression_manager.policy.print(writer_stats, usage_statistics_names[i], algorithm::YON_POLICY_BASIC, i);
+				for(U32 i = 0; i < header.header_magic.n_info_values; ++i)   this->compression_manager.policy.print(writer_stats, "INFO_" + header.info_fields[i].ID, algorithm::YON_POLICY_INFO, i);
+				for(U32 i = 0; i < header.header_magic.n_format_values; ++i) this->compression_manager.policy.print(writer_stats, "FORMAT_" + header.format_fields[i].ID, algorithm::YON_POLICY_FORMAT, i);
+			}
+
+			// The size of standard input is not known
+			if(reader.filesize) writer_stats << input_type << '\t' << reader.filesize << "\t" << reader.b_data_read << '\t' << (float)reader.b_data_read/reader.filesize << std::endl;
+			else writer_stats << input_type << '\t' << reader.b_data_read << std::endl;
 			writer_stats << "YON\t" << this->writer->stream->tellp() << "\t" << total_uncompressed << '\t' << (float)reader.b_data_read/this->writer->stream->tellp() << std::endl;
 			writer_stats.close();
 		} else {
 			std::cerr << utility::timestamp("ERROR", "SUPPORT")  << "Failed to open: " << (wstats->basePath + wstats->baseName + "_yon_stats.txt") << "... Continuing..." << std::endl;
 		}
+
+		// Per-stage and per-field timings
+		std::ofstream writer_profile;
+		writer_profile.open(wstats->basePath + wstats->baseName + "_yon_profile.json", std::ios::out);
+
+		if(!this->silent_)
+			std::cerr << utility::timestamp("LOG") << "Writing profile to: " << (wstats->basePath + wstats->baseName) << "_yon_profile.json" << std::endl;
+
+		if(writer_profile.good()){
+			std::vector<std::string> field_names[3];
+			field_names[0] = usage_statistics_names;
+			for(U32 i = 0; i < header.header_magic.n_info_values; ++i)   field_names[1].push_back(header.info_fields[i].ID);
+			for(U32 i = 0; i < header.header_magic.n_format_values; ++i) field_names[2].push_back(header.format_fields[i].ID);
+			this->profiler_.printJSON(writer_profile, timer.Elapsed().count(), field_names);
+			writer_profile.close();
+		} else {
+			std::cerr << utility::timestamp("ERROR", "SUPPORT")  << "Failed to open: " << (wstats->basePath + wstats->baseName + "_yon_profile.json") << "... Continuing..." << std::endl;
+		}
 	}
 
 	const algorithm::GenotypeEncoderStatistics& gt_stats = this->encoder.getUsageStats();
 	const U64 n_total_gt = gt_stats.getTotal();
-	if(!SILENT){
+	if(!this->silent_){
 		std::cout << "GT-RLE-8\t"   << gt_stats.rle_counts[0] << '\t' << (float)gt_stats.rle_counts[0]/n_total_gt << std::endl;
 		std::cout << "GT-RLE-16\t"  << gt_stats.rle_counts[1] << '\t' << (float)gt_stats.rle_counts[1]/n_total_gt << std::endl;
 		std::cout << "GT-RLE-32\t"  << gt_stats.rle_counts[2] << '\t' << (float)gt_stats.rle_counts[2]/n_total_gt << std::endl;
 		std::cout << "GT-RLE-64\t"  << gt_stats.rle_counts[3] << '\t' << (float)gt_stats.rle_counts[3]/n_total_gt << std::endl;
+		std::cout << "GT-PBWT-8\t"  << gt_stats.pbwt_counts[0] << '\t' << (float)gt_stats.pbwt_counts[0]/n_total_gt << std::endl;
+		std::cout << "GT-PBWT-16\t" << gt_stats.pbwt_counts[1] << '\t' << (float)gt_stats.pbwt_counts[1]/n_total_gt << std::endl;
+		std::cout << "GT-PBWT-32\t" << gt_stats.pbwt_counts[2] << '\t' << (float)gt_stats.pbwt_counts[2]/n_total_gt << std::endl;
+		std::cout << "GT-PBWT-64\t" << gt_stats.pbwt_counts[3] << '\t' << (float)gt_stats.pbwt_counts[3]/n_total_gt << std::endl;
+		std::cout << "GT-BITPLANE\t" << gt_stats.bitplane_counts << '\t' << (float)gt_stats.bitplane_counts/n_total_gt << std::endl;
 		std::cout << "GT-RLES-8\t"  << gt_stats.rle_simple_counts[0] << '\t' << (float)gt_stats.rle_simple_counts[0]/n_total_gt << std::endl;
 		std::cout << "GT-RLES-16\t" << gt_stats.rle_simple_counts[1] << '\t' << (float)gt_stats.rle_simple_counts[1]/n_total_gt << std::endl;
 		std::cout << "GT-RLES-32\t" << gt_stats.rle_simple_counts[2] << '\t' << (float)gt_stats.rle_simple_counts[2]/n_total_gt << std::endl;
 		std::cout << "GT-RLES-64\t" << gt_stats.rle_simple_counts[3] << '\t' << (float)gt_stats.rle_simple_counts[3]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLE-8\t"  << gt_stats.mploid_rle_counts[0] << '\t' << (float)gt_stats.mploid_rle_counts[0]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLE-16\t" << gt_stats.mploid_rle_counts[1] << '\t' << (float)gt_stats.mploid_rle_counts[1]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLE-32\t" << gt_stats.mploid_rle_counts[2] << '\t' << (float)gt_stats.mploid_rle_counts[2]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLE-64\t" << gt_stats.mploid_rle_counts[3] << '\t' << (float)gt_stats.mploid_rle_counts[3]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLES-8\t"  << gt_stats.mploid_simple_counts[0] << '\t' << (float)gt_stats.mploid_simple_counts[0]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLES-16\t" << gt_stats.mploid_simple_counts[1] << '\t' << (float)gt_stats.mploid_simple_counts[1]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLES-32\t" << gt_stats.mploid_simple_counts[2] << '\t' << (float)gt_stats.mploid_simple_counts[2]/n_total_gt << std::endl;
+		std::cout << "GT-MPLOID-RLES-64\t" << gt_stats.mploid_simple_counts[3] << '\t' << (float)gt_stats.mploid_simple_counts[3]/n_total_gt << std::endl;
 		std::cout << "GT-DIPLOID-BCF-8\t"  << gt_stats.diploid_bcf_counts[0] << '\t' << (float)gt_stats.diploid_bcf_counts[0]/n_total_gt << std::endl;
 		std::cout << "GT-DIPLOID-BCF-16\t" << gt_stats.diploid_bcf_counts[1] << '\t' << (float)gt_stats.diploid_bcf_counts[1]/n_total_gt << std::endl;
 		std::cout << "GT-DIPLOID-BCF-32\t" << gt_stats.diploid_bcf_counts[2] << '\t' << (float)gt_stats.diploid_bcf_counts[2]/n_total_gt << std::endl;
@@ -390,7 +684,7 @@ bool VariantImporter::BuildBCF(void){
 			std::ofstream writer_keychain;
 			writer_file_type* wstats = reinterpret_cast<writer_file_type*>(this->writer);
 			writer_keychain.open(wstats->basePath + wstats->baseName + ".kyon", std::ios::out);
-			if(!SILENT)
+			if(!this->silent_)
 				std::cerr << utility::timestamp("LOG") << "Writing encryption keychain to: " << (wstats->basePath + wstats->baseName) << ".kyon" << std::endl;
 
 			if(writer_keychain.good()){
@@ -400,7 +694,7 @@ bool VariantImporter::BuildBCF(void){
 			}
 			const U32 keychain_size = writer_keychain.tellp();
 			writer_keychain.close();
-			if(!SILENT)
+			if(!this->silent_)
 				std::cerr << utility::timestamp("LOG") << "Wrote keychain with " << utility::ToPrettyString(keychain.size()) << " keys to " << utility::toPrettyDiskString(keychain_size) << "..." << std::endl;
 		}
 	}
@@ -421,13 +715,490 @@ bool VariantImporter::BuildBCF(void){
 	return(true);
 }
 
-bool VariantImporter::addGenotypes(bcf_reader_type& bcf_reader, meta_type* meta_entries){
+void VariantImporter::encodeStage(batch_queue_type& in, batch_queue_type& out, batch_queue_type& pool){
+	batch_type* batch = nullptr;
+	while(in.pop(batch)){
+		// If any stage has failed then drain the queue and
+		// return batches to the pool to unblock the reader
+		if(this->pipeline_failed_ || !this->encodeBatch(*batch)){
+			this->pipeline_failed_ = true;
+			this->recycleBatch(batch, pool);
+			continue;
+		}
+		out.push(batch);
+	}
+	out.close();
+}
+
+void VariantImporter::compressStage(batch_queue_type& in, batch_queue_type& out, batch_queue_type& pool, checksum_type& checksums, encryption_type& encryption_manager, keychain_type& keychain){
+	auto forward = [&](batch_type* batch){
+		if(this->pipeline_failed_ || !this->compressBatch(*batch, checksums, encryption_manager, keychain)){
+			this->pipeline_failed_ = true;
+			this->recycleBatch(batch, pool);
+			return;
+		}
+		out.push(batch);
+	};
+
+	// Dictionaries are trained on the first batches: these are held
+	// back until training is done. This stage can hold every batch
+	// in the pool without blocking the upstream stages. The held
+	// batches are deferred in the memory budget such that the reader
+	// can load the batches that complete the training window.
+	const U32 n_training_batches = this->n_pipeline_batches_ < 3 ? this->n_pipeline_batches_ : 3;
+	std::vector<batch_type*> training;
+	U64 b_training = 0;
+	bool trained = !this->train_dictionaries_;
+
+	batch_type* batch = nullptr;
+	while(in.pop(batch)){
+		if(trained){
+			forward(batch);
+			continue;
+		}
+
+		training.push_back(batch);
+		if(training.size() < n_training_batches){
+			this->memory_budget_.defer(batch->b_memory);
+			b_training += batch->b_memory;
+			continue;
+		}
+
+		this->memory_budget_.resume(b_training);
+		this->trainDictionaries(training);
+		trained = true;
+		for(U32 i = 0; i < training.size(); ++i) forward(training[i]);
+		training.clear();
+	}
+
+	// Input ended before the training window was filled
+	if(training.size()){
+		this->memory_budget_.resume(b_training);
+		this->trainDictionaries(training);
+		for(U32 i = 0; i < training.size(); ++i) forward(training[i]);
+	}
+	out.close();
+}
+
+void VariantImporter::trainDictionaries(const std::vector<batch_type*>& batches){
+	if(this->pipeline_failed_)
+		return;
+
+	for(U32 i = 0; i < batches.size(); ++i){
+		const block_type& block = batches[i]->block;
+		for(U32 j = 0; j < block.footer.n_info_streams; ++j){
+			const stream_container& container = block.info_containers[j];
+			if(container.header.data_header.controller.type == YON_TYPE_FLOAT ||
+			   container.header.data_header.controller.type == YON_TYPE_DOUBLE)
+				continue;
+
+			this->compression_manager.dictionaries.addSample(algorithm::YON_DICTIONARY_INFO, block.footer.info_offsets[j].data_header.global_key, container.buffer_data_uncompressed);
+		}
+
+		for(U32 j = 0; j < block.footer.n_format_streams; ++j){
+			const stream_container& container = block.format_containers[j];
+			if(container.header.data_header.controller.type == YON_TYPE_FLOAT ||
+			   container.header.data_header.controller.type == YON_TYPE_DOUBLE)
+				continue;
+
+			this->compression_manager.dictionaries.addSample(algorithm::YON_DICTIONARY_FORMAT, block.footer.format_offsets[j].data_header.global_key, container.buffer_data_uncompressed);
+		}
+	}
+
+	// Project the number of blocks in the file from the fraction of
+	// the input consumed by the training batches
+	const double progress = batches.back()->progress;
+	const double n_expected_blocks = (progress > 0 ? batches.size() / progress : batches.size());
+
+	const U32 n_trained = this->compression_manager.dictionaries.train(20, n_expected_blocks);
+	if(!this->silent_)
+		std::cerr << utility::timestamp("LOG","DICTIONARY") << "Trained " << n_trained << " dictionaries from " << batches.size() << " blocks..." << std::endl;
+}
+
+void VariantImporter::writeStage(batch_queue_type& in, batch_queue_type& pool, const core::VariantHeader& header, algorithm::Timer& timer){
+	// The footer codec is private to this stage as the
+	// compression codecs are not thread-safe
+	algorithm::ZSTDCodec footer_codec;
+	footer_codec.setCompressionLevel(20);
+
+	// The header is written when the first block arrives: at
+	// this point any dictionaries have been trained. A file
+	// that is appended to already has a header
+	bool header_written = this->append_;
+	batch_type* batch = nullptr;
+	while(in.pop(batch)){
+		if(header_written == false){
+			if(!this->writeHeader(header))
+				this->pipeline_failed_ = true;
+			header_written = true;
+		}
+
+		if(this->pipeline_failed_ == false){
+			if(!this->writeBatch(*batch, footer_codec, timer))
+				this->pipeline_failed_ = true;
+		}
+		this->recycleBatch(batch, pool);
+	}
+
+	if(header_written == false){
+		if(!this->writeHeader(header))
+			this->pipeline_failed_ = true;
+	}
+}
+
+void VariantImporter::recycleBatch(batch_type* batch, batch_queue_type& pool){
+	const U64 b_memory = batch->b_memory;
+	batch->reset();
+	pool.push(batch);
+	this->memory_budget_.release(b_memory);
+}
+
+bool VariantImporter::openAppend(const core::VariantHeader& header, checksum_type& checksums, keychain_type& keychain){
+	writer_file_type* writer = reinterpret_cast<writer_file_type*>(this->writer);
+
+	VariantReader yon(writer->getOutputFile());
+	yon.getSettings().loadAll(true);
+
+	// Encrypted blocks have to be decrypted to extend the digests.
+	// Keys of appended blocks are added to the same keychain
+	const std::string keychain_file = writer->basePath + writer->baseName + ".kyon";
+	std::ifstream keychain_reader(keychain_file, std::ios::binary | std::ios::in);
+	if(keychain_reader.good()){
+		keychain_reader >> keychain;
+		keychain_reader.seekg(0);
+		keychain_reader >> yon.keychain;
+		if(!keychain_reader.good()){
+			std::cerr << utility::timestamp("ERROR","APPEND") << "Failed to parse keychain: " << keychain_file << "..." << std::endl;
+			return false;
+		}
+	}
+
+	if(!yon.open()){
+		std::cerr << utility::timestamp("ERROR","APPEND") << "Failed to open existing file: " << writer->getOutputFile() << "..." << std::endl;
+		return false;
+	}
+
+	if(!yon.header.isCompatible(header)){
+		std::cerr << utility::timestamp("ERROR","APPEND") << "The header of the input does not match the existing file..." << std::endl;
+		return false;
+	}
+
+	// Blocks are compressed with the dictionaries in the header
+	if(yon.codec_manager.dictionaries.size()){
+		this->compression_manager.dictionaries = yon.codec_manager.dictionaries;
+		this->compression_manager.dictionaries.setFields(this->header->info_map.size(), this->header->format_map.size());
+		if(!this->compression_manager.dictionaries.prepareCompression(20))
+			return false;
+	}
+
+	// Merge the existing index into the index of the writer. The
+	// quad-tree of contigs without variants is not stored and
+	// is kept as built from the header
+	index::VariantIndex& index = this->writer->index.index_;
+	const index::VariantIndex& existing = yon.index.getIndex();
+	if(existing.size() != index.size()){
+		std::cerr << utility::timestamp("ERROR","APPEND") << "Index of the existing file does not match its header..." << std::endl;
+		return false;
+	}
+
+	for(U32 i = 0; i < existing.size(); ++i){
+		if(existing[i].size_sites()) index[i] = existing[i];
+		for(U32 j = 0; j < existing.linear_at(i).size(); ++j){
+			const index_entry_type& entry = existing.linear_at(i)[j];
+			index.linear_at(i) += entry;
+			if(entry.byte_offset_end == yon.footer.offset_end_of_data){
+				this->append_contig_   = i;
+				this->append_position_ = entry.maxPosition;
+			}
+		}
+	}
+
+	// Appended blocks are checksummed as the existing blocks
+	const algorithm::TACHYON_CHECKSUM_TYPE checksum_algorithm = (algorithm::TACHYON_CHECKSUM_TYPE)yon.footer.getChecksumType();
+	if(checksum_algorithm != this->checksum_algorithm_){
+		std::cerr << utility::timestamp("WARNING","APPEND") << "Using the " << algorithm::BlockChecksum::typeString(checksum_algorithm) << " checksums of the existing file..." << std::endl;
+		this->checksum_algorithm_ = checksum_algorithm;
+	}
+
+	// Per-block checksums are independent of each other: the
+	// existing blocks are not read again
+	if(this->checksum_algorithm_ != algorithm::YON_CHECKSUM_SHA512){
+		if(yon.block_checksums.size() != yon.footer.n_blocks){
+			std::cerr << utility::timestamp("ERROR","APPEND") << "Checksums of the existing file cover " << yon.block_checksums.size() << " of " << yon.footer.n_blocks << " blocks..." << std::endl;
+			return false;
+		}
+		this->block_checksums_ = yon.block_checksums;
+	} else {
+		// Digests cannot be resumed from their finalized values: rehash
+		// the existing blocks and verify them against the stored digests
+		if(!this->silent_)
+			std::cerr << utility::timestamp("LOG","APPEND") << "Rehashing " << utility::ToPrettyString(yon.footer.n_blocks) << " existing blocks..." << std::endl;
+
+		U64 n_blocks = 0;
+		while(yon.nextBlock()){
+			checksums += yon.block;
+			++n_blocks;
+		}
+
+		if(n_blocks != yon.footer.n_blocks){
+			std::cerr << utility::timestamp("ERROR","APPEND") << "Failed to read all blocks of the existing file (" << n_blocks << "/" << yon.footer.n_blocks << ")..." << std::endl;
+			return false;
+		}
+
+		// Files assembled by concat only carry digests of the compressed
+		// data. The rehashed digests cover both again
+		checksum_type verify(checksums);
+		if(yon.checksums.hasUncompressed()) verify.finalize();
+		else verify.finalizeCompressed();
+		if(verify != yon.checksums){
+			std::cerr << utility::timestamp("ERROR","APPEND") << "Existing data does not match the digests stored in the file..." << std::endl;
+			return false;
+		}
+	}
+
+	// Keep the tail of the file to restore it if the import fails
+	this->append_offset_ = yon.footer.offset_end_of_data;
+	const U64 l_tail = yon.filesize - this->append_offset_;
+	yon.stream.clear();
+	yon.stream.seekg(this->append_offset_);
+	this->append_tail_.resize(l_tail);
+	yon.stream.read(this->append_tail_.data(), l_tail);
+	this->append_tail_.n_chars = l_tail;
+	if(!yon.stream.good()){
+		std::cerr << utility::timestamp("ERROR","APPEND") << "Failed to read the index of the existing file..." << std::endl;
+		return false;
+	}
+
+	this->writer->n_blocks_written    = yon.footer.n_blocks;
+	this->writer->n_variants_written  = yon.footer.n_variants;
+	this->writer->index.number_blocks = yon.footer.n_blocks;
+
+	// New blocks overwrite the old index, digests, and footer
+	this->writer->stream->seekp(this->append_offset_);
+	if(!this->writer->stream->good()){
+		std::cerr << utility::timestamp("ERROR","APPEND") << "Failed to seek in the existing file..." << std::endl;
+		return false;
+	}
+
+	if(!this->silent_){
+		std::cerr << utility::timestamp("LOG","APPEND") << "Appending to " << utility::ToPrettyString(yon.footer.n_variants) << " variants in "
+		          << utility::ToPrettyString(yon.footer.n_blocks) << " blocks..." << std::endl;
+	}
+
+	return true;
+}
+
+void VariantImporter::abortAppend(void){
+	writer_file_type* writer = reinterpret_cast<writer_file_type*>(this->writer);
+	writer->stream->clear();
+	writer->stream->seekp(this->append_offset_);
+	writer->stream->write(this->append_tail_.data(), this->append_tail_.size());
+	if(!writer->stream->good() || !writer->truncate(this->append_offset_ + this->append_tail_.size())){
+		std::cerr << utility::timestamp("ERROR","APPEND") << "Failed to restore the existing file: it is corrupted..." << std::endl;
+		return;
+	}
+
+	if(!this->silent_)
+		std::cerr << utility::timestamp("LOG","APPEND") << "Restored the existing file..." << std::endl;
+}
+
+bool VariantImporter::writeHeader(const core::VariantHeader& header){
+	// Convert header to byte stream, compress, and write to file.
+	// Dictionaries are appended after the header literals.
+	containers::DataContainer header_data;
+	header_data.resize(65536 + header.literals.size()*2);
+	header_data.buffer_data_uncompressed << header;
+	if(this->compression_manager.dictionaries.size())
+		header_data.buffer_data_uncompressed << this->compression_manager.dictionaries;
+
+	// Codec private to the calling thread: default compression level
+	algorithm::ZSTDCodec codec;
+	if(!codec.compress(header_data)){
+		std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to compress header..." << std::endl;
+		return false;
+	}
+	*this->writer->stream << header_data.header; // write header
+	*this->writer->stream << header_data.buffer_data;
+	return(this->writer->stream->good());
+}
+
+bool VariantImporter::encodeBatch(batch_type& batch){
+	block_type& block = batch.block;
+	bcf_reader_type& entries = batch.entries;
+
+	block.header.contigID    = entries.front().body->CHROM;
+	block.header.minPosition = entries.front().body->POS;
+	block.header.maxPosition = entries.back().body->POS;
+	block.header.controller.hasGT         = this->GT_available_;
+	block.header.controller.hasGTPermuted = this->permute;
+	block.header.controller.hasGTSeparateEOV = this->GT_available_;
+	// if there is 0 or 1 samples then GT data is never permuted
+	if(this->header->samples <= 1)
+		block.header.controller.hasGTPermuted = false;
+
+	// Permute GT if GT is available and the appropriate flag is triggered
+	this->permutator.manager = &block.ppa_manager;
+	this->permutator.reset();
+	if(block.header.controller.hasGT && block.header.controller.hasGTPermuted){
+		algorithm::Timer timer;
+		timer.Start();
+		if(!this->permutator.build(entries)){
+			std::cerr << utility::timestamp("ERROR","PERMUTE") << "Failed to complete..." << std::endl;
+			return false;
+		}
+		this->profiler_[algorithm::YON_PROFILE_PERMUTE].add(timer, batch.b_records, block.ppa_manager.getObjectSize(), entries.size());
+	}
+
+	//\////////////////////////////////////////////////
+	// Start new
+	// Perform parsing of BCF entries in memory
+	// Split out RLE compression and importing other INFO/FORMAT
+	meta_type* meta_entries = static_cast<meta_type*>(::operator new[](entries.size() * sizeof(meta_type)));
+
+	// Load meta data
+	for(U32 i = 0; i < entries.size(); ++i){
+		new( meta_entries + i ) meta_type( entries[i], block.header.minPosition );
+		if(!this->add(meta_entries[i], entries[i], batch)){
+			std::cerr << utility::timestamp("ERROR","IMPORT") << "Failed to add BCF entry..." << std::endl;
+			for(std::size_t j = 0; j <= i; ++j) (meta_entries + j)->~MetaEntry();
+			::operator delete[](static_cast<void*>(meta_entries));
+			return false;
+		}
+	}
+	// Add genotypes in parallel
+	algorithm::Timer gt_timer;
+	gt_timer.Start();
+	this->addGenotypes(entries, meta_entries, block);
+	const U64 b_gt = block.gt_support_data_container.getSizeUncompressed() +
+	                 block.gt_rle8_container.getSizeUncompressed()    + block.gt_rle16_container.getSizeUncompressed() +
+	                 block.gt_rle32_container.getSizeUncompressed()   + block.gt_rle64_container.getSizeUncompressed() +
+	                 block.gt_simple8_container.getSizeUncompressed() + block.gt_simple16_container.getSizeUncompressed() +
+	                 block.gt_simple32_container.getSizeUncompressed() + block.gt_simple64_container.getSizeUncompressed();
+	this->profiler_[algorithm::YON_PROFILE_GT_ENCODE].add(gt_timer, batch.b_records, b_gt, entries.size());
+	// Overload
+	for(U32 i = 0; i < entries.size(); ++i) block += meta_entries[i];
+
+	// Clean up
+	for(std::size_t i = 0; i < entries.size(); ++i) (meta_entries + i)->~MetaEntry();
+	::operator delete[](static_cast<void*>(meta_entries));
+	//\////////////////////////////////////////////////
+
+	// Update head meta
+	block.header.controller.hasGT = this->GT_available_;
+	block.header.n_variants       = entries.size();
+	block.finalize();
+	batch.b_uncompressed = block.determineUncompressedSize();
+
+	return true;
+}
+
+bool VariantImporter::compressBatch(batch_type& batch, checksum_type& checksums, encryption_type& encryption_manager, keychain_type& keychain){
+	// Perform compression using standard parameters
+	algorithm::Timer timer;
+	timer.Start();
+	if(!this->compression_manager.compress(batch.block)){
+		std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to compress..." << std::endl;
+		return false;
+	}
+	const U64 b_compressed = batch.block.__determineCompressedSize();
+	this->profiler_[algorithm::YON_PROFILE_COMPRESS].add(timer, batch.b_uncompressed, b_compressed, batch.size());
+
+	// Checksum have to come before encryption. Per-block checksums
+	// are computed over the written data instead
+	if(this->checksum_algorithm_ == algorithm::YON_CHECKSUM_SHA512){
+		timer.Start();
+		checksums += batch.block;
+		this->profiler_[algorithm::YON_PROFILE_CHECKSUM].add(timer, batch.b_uncompressed + b_compressed, 0, batch.size());
+	}
+
+	// Encryption
+	if(this->encrypt){
+		timer.Start();
+		batch.block.header.controller.anyEncrypted = true;
+		if(!encryption_manager.encrypt(batch.block, keychain, YON_ENCRYPTION_AES_256_GCM)){
+			std::cerr << utility::timestamp("ERROR","COMPRESSION") << "Failed to encrypt..." << std::endl;
+		}
+		this->profiler_[algorithm::YON_PROFILE_ENCRYPT].add(timer, b_compressed, batch.block.__determineCompressedSize(), batch.size());
+	}
+
+	return true;
+}
+
+bool VariantImporter::writeBatch(batch_type& batch, algorithm::ZSTDCodec& footer_codec, algorithm::Timer& timer){
+	block_type& block = batch.block;
+	index_entry_type& index_entry = batch.index_entry;
+
+	algorithm::Timer write_timer;
+	write_timer.Start();
+	index_entry.byte_offset = this->writer->stream->tellp();
+
+	// Per-block checksums are computed over the bytes as they are
+	// written to the output
+	algorithm::BlockChecksumStreamBuffer checksum_buffer(this->writer->stream->rdbuf(), this->checksum_algorithm_);
+	std::streambuf* output_buffer = nullptr;
+	if(this->checksum_algorithm_ != algorithm::YON_CHECKSUM_SHA512)
+		output_buffer = this->writer->stream->rdbuf(&checksum_buffer);
+
+	block.write(*this->writer->stream, this->stats_basic, this->stats_info, this->stats_format);
+
+	// Compress and write footer
+	block.footer_support.buffer_data_uncompressed << block.footer;
+	footer_codec.compress(block.footer_support);
+	const U64 start_footer_pos = this->writer->stream->tellp();
+	const U32 footer_uLength   = block.footer_support.header.data_header.uLength;
+	const U32 footer_cLength   = block.footer_support.header.data_header.cLength;
+	const U32 footer_crc       = block.footer_support.header.data_header.crc;
+	this->writer->stream->write(reinterpret_cast<const char*>(&footer_uLength), sizeof(U32));
+	this->writer->stream->write(reinterpret_cast<const char*>(&footer_cLength), sizeof(U32));
+	this->writer->stream->write(reinterpret_cast<const char*>(&footer_crc),     sizeof(U32));
+	*this->writer->stream << block.footer_support.buffer_data;
+
+	stats_basic[0].cost_uncompressed += (U64)this->writer->stream->tellp() - start_footer_pos;
+
+	// Write EOB
+	this->writer->stream->write(reinterpret_cast<const char*>(&constants::TACHYON_BLOCK_EOF), sizeof(U64));
+
+	if(output_buffer != nullptr){
+		this->writer->stream->rdbuf(output_buffer);
+		this->block_checksums_.add(index_entry.byte_offset, checksum_buffer.digest());
+	}
+
+	index_entry.blockID         = block.header.blockID;
+	index_entry.byte_offset_end = this->writer->stream->tellp();
+	index_entry.contigID        = batch.front().body->CHROM;
+	index_entry.minPosition     = batch.front().body->POS;
+	index_entry.maxPosition     = batch.back().body->POS;
+	index_entry.n_variants      = batch.size();
+	this->writer->index.index_.linear_at(index_entry.contigID) += index_entry; // Todo: beautify
+
+	// Observed sizes drive automatic block sizing
+	this->block_sizer_.update(batch.size(), batch.b_records, batch.b_uncompressed, index_entry.byte_offset_end - index_entry.byte_offset);
+
+	++this->writer->n_blocks_written;
+	this->writer->n_variants_written += batch.size();
+	++this->writer->index.number_blocks;
+
+	if(!this->silent_){
+		std::cerr << utility::timestamp("PROGRESS") <<
+		std::setfill(' ') << std::setw(10) << this->writer->n_variants_written << ' ' <<
+		std::setfill(' ') << std::setw(10) << utility::toPrettyDiskString(this->writer->stream->tellp()) << '\t' <<
+		std::setfill(' ') << std::setw(8)  << batch.progress*100 << "%" << ' ' <<
+		timer.ElapsedString() << ' ' <<
+		this->header->getContig(batch.front().body->CHROM).name << ":" << batch.front().body->POS+1 << "->" << batch.back().body->POS+1 << std::endl;
+	}
+
+	this->writer->stream->flush();
+	this->profiler_[algorithm::YON_PROFILE_WRITE].add(write_timer, index_entry.byte_offset_end - index_entry.byte_offset, index_entry.byte_offset_end - index_entry.byte_offset, batch.size());
+	return(this->writer->stream->good());
+}
+
+bool VariantImporter::addGenotypes(bcf_reader_type& bcf_reader, meta_type* meta_entries, block_type& block){
 	/*
 	for(U32 i = 0; i < bcf_reader.size(); ++i){
 		if(bcf_reader[i].hasGenotypes){
 			meta_entries[i].controller.gt_available = true;
 
-			if(!this->encoder.Encode(bcf_reader[i], meta_entries[i], this->block, this->permutator.manager->get())){
+			if(!this->encoder.Encode(bcf_reader[i], meta_entries[i], block, this->permutator.manager->get())){
 				std::cerr << utility::timestamp("ERROR","ENCODER") << "Failed to encode GT..." << std::endl;
 				return false;
 			}
@@ -436,12 +1207,12 @@ bool VariantImporter::addGenotypes(bcf_reader_type& bcf_reader, meta_type* meta_
 		}
 	}
 	*/
-	this->encoder.EncodeParallel(bcf_reader, meta_entries, this->block, this->permutator.manager->get(), this->n_threads_);
+	this->encoder.EncodeParallel(bcf_reader, meta_entries, block, this->permutator.manager->get(), this->n_threads_);
 
 	return true;
 }
 
-bool VariantImporter::add(meta_type& meta, bcf_entry_type& entry){
+bool VariantImporter::add(meta_type& meta, bcf_entry_type& entry, batch_type& batch){
 	// Assert position is in range
 	if(entry.body->POS + 1 > this->header->getContig(entry.body->CHROM).bp_length){
 		std::cerr << utility::timestamp("ERROR", "IMPORT") << this->header->getContig(entry.body->CHROM).name << ':' << entry.body->POS+1 << " > reported max size of contig (" << this->header->getContig(entry.body->CHROM).bp_length << ")..." << std::endl;
@@ -449,7 +1220,7 @@ bool VariantImporter::add(meta_type& meta, bcf_entry_type& entry){
 	}
 
 	//meta_type meta(entry, this->block.header.minPosition);
-	if(!this->parseBCFBody(meta, entry)){
+	if(!this->parseBCFBody(meta, entry, batch.block)){
 		std::cerr << utility::timestamp("ERROR","ENCODER") << "Failed to encode BCF body..." << std::endl;
 		return false;
 	}
@@ -470,7 +1241,7 @@ bool VariantImporter::add(meta_type& meta, bcf_entry_type& entry){
 				const U32 end = entry.getInteger(entry.infoID[i].primitive_type, entry.infoID[i].l_offset);
 				//std::cerr << "Found END at " << i << ".  END=" << end << " POS=" << entry.body->POS+1 << " BIN=" << reg2bin(entry.body->POS, end)  << std::endl;
 				//reg2bin2(entry.body->POS, end, used_contig_length, 7);
-				index_bin = this->writer->index.index_[meta.contigID].Add(entry.body->POS, end, (U32)this->writer->index.current_block_number());
+				index_bin = this->writer->index.index_[meta.contigID].Add(entry.body->POS, end, (U32)batch.block_number);
 
 				// index_bin= reg2bin(entry.body->POS, end);
 				break;
@@ -496,9 +1267,9 @@ bool VariantImporter::add(meta_type& meta, bcf_entry_type& entry){
 		if(longest){
 			//if(longest > 3) std::cerr << "longest: " << longest << std::endl;
 			//index_bin = reg2bin(entry.body->POS, entry.body->POS + longest);
-			index_bin = this->writer->index.index_[meta.contigID].Add(entry.body->POS, entry.body->POS + longest, (U32)this->writer->index.current_block_number());
+			index_bin = this->writer->index.index_[meta.contigID].Add(entry.body->POS, entry.body->POS + longest, (U32)batch.block_number);
 		} else { // fallback if all others fail
-			index_bin = this->writer->index.index_[meta.contigID].Add(entry.body->POS, entry.body->POS, (U32)this->writer->index.current_block_number());
+			index_bin = this->writer->index.index_[meta.contigID].Add(entry.body->POS, entry.body->POS, (U32)batch.block_number);
 			//index_bin = reg2bin(entry.body->POS, entry.body->POS);
 			//index_bin = 0;
 		}
@@ -507,26 +1278,26 @@ bool VariantImporter::add(meta_type& meta, bcf_entry_type& entry){
 	//if(index_bin <= 5) std::cerr << "POS=" << entry.body->POS << " to bin=" << index_bin << std::endl;
 
 	//index_bin = reg2bin(entry.body->POS, entry.body->POS);
-	if(index_bin > this->index_entry.maxBin) this->index_entry.maxBin = index_bin;
-	if(index_bin < this->index_entry.minBin) this->index_entry.minBin = index_bin;
+	if(index_bin > batch.index_entry.maxBin) batch.index_entry.maxBin = index_bin;
+	if(index_bin < batch.index_entry.minBin) batch.index_entry.minBin = index_bin;
 
 	// Update number of entries in block
-	++this->index_entry.n_variants;
+	++batch.index_entry.n_variants;
 
 	return true;
 }
 
-bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry){
+bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry, block_type& block){
 	for(U32 i = 0; i < entry.filterPointer; ++i){
 		assert(entry.filterID[i].mapID != -1);
-		this->block.AddFieldFILTER(this->header->filter_remap[entry.filterID[i].mapID]);
+		block.AddFieldFILTER(this->header->filter_remap[entry.filterID[i].mapID]);
 	}
 
 	for(U32 i = 0; i < entry.infoPointer; ++i){
 		assert(entry.infoID[i].mapID != -1);
-		const U32 mapID = this->block.AddFieldINFO(this->header->info_remap[entry.infoID[i].mapID]);
+		const U32 mapID = block.AddFieldINFO(this->header->info_remap[entry.infoID[i].mapID]);
 
-		stream_container& target_container = this->block.info_containers[mapID];
+		stream_container& target_container = block.info_containers[mapID];
 
 		// Flags and integers
 		// These are BCF value types
@@ -560,8 +1331,8 @@ bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry){
 	for(U32 i = 0; i < entry.formatPointer; ++i){
 		assert(entry.formatID[i].mapID != -1);
 
-		//const U32 mapID = this->block.format_fields.setGet(this->header->format_remap[entry.formatID[i].mapID]);
-		const U32 mapID = this->block.AddFieldFORMAT(this->header->format_remap[entry.formatID[i].mapID]);
+		//const U32 mapID = block.format_fields.setGet(this->header->format_remap[entry.formatID[i].mapID]);
+		const U32 mapID = block.AddFieldFORMAT(this->header->format_remap[entry.formatID[i].mapID]);
 		U32 internal_pos = entry.formatID[i].l_offset;
 
 		// First value is always genotypes if there are any
@@ -569,7 +1340,7 @@ bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry){
 			continue;
 
 		// Hash INFO values
-		stream_container& target_container = this->block.format_containers[mapID];
+		stream_container& target_container = block.format_containers[mapID];
 
 		// Flags and integers
 		// These are BCF value types
@@ -609,15 +1380,15 @@ bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry){
 		// Hash FILTER pattern
 		const U64 hash_filter_vector = entry.hashFilter();
 
-		S32 mapID = this->block.getPatternsFILTER(hash_filter_vector);
+		S32 mapID = block.getPatternsFILTER(hash_filter_vector);
 		if(mapID == -1){
 			std::vector<U32> ret_pattern;
 			for(U32 i = 0; i < entry.filterPointer; ++i)
 				ret_pattern.push_back(this->header->filter_remap[entry.filterID[i].mapID]);
 
-			mapID = this->block.filter_patterns.size();
+			mapID = block.filter_patterns.size();
 			assert(mapID < 65536);
-			this->block.addPatternFILTER(ret_pattern, hash_filter_vector);
+			block.addPatternFILTER(ret_pattern, hash_filter_vector);
 		}
 		meta.filter_pattern_id = mapID;
 	}
@@ -626,15 +1397,15 @@ bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry){
 		// Hash INFO pattern
 		const U64 hash_info_vector = entry.hashInfo();
 
-		S32 mapID = this->block.getPatternsINFO(hash_info_vector);
+		S32 mapID = block.getPatternsINFO(hash_info_vector);
 		if(mapID == -1){
 			std::vector<U32> ret_pattern;
 			for(U32 i = 0; i < entry.infoPointer; ++i)
 				ret_pattern.push_back(this->header->info_remap[entry.infoID[i].mapID]);
 
-			mapID = this->block.info_patterns.size();
+			mapID = block.info_patterns.size();
 			assert(mapID < 65536);
-			this->block.addPatternINFO(ret_pattern, hash_info_vector);
+			block.addPatternINFO(ret_pattern, hash_info_vector);
 		}
 		meta.info_pattern_id = mapID;
 	}
@@ -643,15 +1414,15 @@ bool VariantImporter::parseBCFBody(meta_type& meta, bcf_entry_type& entry){
 		// Hash FORMAT pattern
 		const U64 hash_format_vector = entry.hashFormat();
 
-		S32 mapID = this->block.getPatternsFORMAT(hash_format_vector);
+		S32 mapID = block.getPatternsFORMAT(hash_format_vector);
 		if(mapID == -1){
 			std::vector<U32> ret_pattern;
 			for(U32 i = 0; i < entry.formatPointer; ++i)
 				ret_pattern.push_back(this->header->format_remap[entry.formatID[i].mapID]);
 
-			mapID = this->block.format_patterns.size();
+			mapID = block.format_patterns.size();
 			assert(mapID < 65536);
-			this->block.addPatternFORMAT(ret_pattern, hash_format_vector);
+			block.addPatternFORMAT(ret_pattern, hash_format_vector);
 		}
 		meta.format_pattern_id = mapID;
 	}
@@ -1,18 +1,29 @@
 #ifndef CORE_VARIANT_IMPORTER_H_
 #define CORE_VARIANT_IMPORTER_H_
 
+#include <atomic>
+
+#include "../algorithm/bounded_queue.h"
+#include "../algorithm/memory_budget.h"
+#include "../algorithm/stage_profiler.h"
+#include "../algorithm/digital_digest.h"
+#include "../algorithm/block_checksum.h"
+#include "../algorithm/encryption/EncryptionDecorator.h"
 #include "../algorithm/compression/compression_manager.h"
 #include "../algorithm/compression/genotype_encoder.h"
 #include "../algorithm/permutation/radix_sort_gt.h"
 #include "../support/type_definitions.h"
 #include "../support/helpers.h"
 #include "../io/bcf/BCFReader.h"
+#include "../io/vcf/VCFReader.h"
 #include "../containers/variantblock.h"
 #include "../index/index_entry.h"
 #include "../index/index_index_entry.h"
 #include "variant_importer_container_stats.h"
 #include "../algorithm/timer.h"
 #include "variant_import_writer.h"
+#include "variant_importer_batch.h"
+#include "variant_importer_block_sizer.h"
 
 namespace tachyon {
 
@@ -37,6 +48,27 @@ private:
 	typedef containers::VariantBlock        block_type;
 	typedef support::VariantImporterContainerStats import_stats_type;
 	typedef core::MetaEntry                 meta_type;
+	typedef VariantImporterBatch            batch_type;
+	typedef algorithm::BoundedQueue<batch_type*> batch_queue_type;
+	typedef algorithm::MemoryBudget         memory_budget_type;
+	typedef VariantImporterBlockSizer       block_sizer_type;
+	typedef algorithm::VariantDigitalDigestManager checksum_type;
+	typedef algorithm::BlockChecksumManager block_checksum_type;
+	typedef encryption::EncryptionDecorator encryption_type;
+	typedef encryption::Keychain            keychain_type;
+
+	/**<
+	 * Region of a BCF file imported by a shard: a run of records
+	 * starting at a BGZF virtual offset
+	 */
+	struct ImportRegion{
+		ImportRegion() : block_offset(0), in_block_offset(0), n_records(0){}
+		ImportRegion(const U64 block_offset, const U32 in_block_offset) : block_offset(block_offset), in_block_offset(in_block_offset), n_records(0){}
+
+		U64 block_offset;    // offset of the BGZF block holding the first record
+		U32 in_block_offset; // offset of the first record in the inflated block
+		U64 n_records;       // number of records in the region
+	};
 
 public:
 	VariantImporter(std::string inputFile, std::string outputPrefix, const U32 checkpoint_size, const double checkpoint_bases);
@@ -45,26 +77,155 @@ public:
 
 	inline void setPermute(const bool yes){ this->permute = yes; }
 	inline void setEncrypt(const bool yes){ this->encrypt = yes; }
+	inline void setCompressionObjective(const algorithm::TACHYON_COMPRESSION_OBJECTIVE objective){ this->compression_manager.policy.setObjective(objective); }
+	inline void setDecodeBudget(const double mb_per_second){ this->compression_manager.policy.setDecodeBudget(mb_per_second); }
+	inline void setDictionaries(const bool yes){ this->train_dictionaries_ = yes; }
+	inline void setAppend(const bool yes){ this->append_ = yes; }
+	inline void setChecksumType(const algorithm::TACHYON_CHECKSUM_TYPE type){ this->checksum_algorithm_ = type; }
+	inline void setPBWT(const bool yes){ this->encoder.setPBWT(yes); }
+	inline void setBitplane(const bool yes){ this->encoder.setBitplane(yes); }
+	inline void setThreads(const U32 n_threads){ this->n_threads_ = (n_threads == 0 ? 1 : n_threads); }
+	inline void setSilent(const bool yes){ this->silent_ = yes; }
+
+	/**<
+	 * Import a BCF file as `n_shards` regions in parallel. Each
+	 * region is imported by an independent importer into a
+	 * temporary file and the files are concatenated into the
+	 * output. Only supported for BCF files.
+	 * @param n_shards Number of regions imported in parallel
+	 */
+	inline void setShards(const U32 n_shards){ this->n_shards_ = (n_shards == 0 ? 1 : n_shards); }
+	inline void setMemoryBudget(const U64 bytes){ this->block_sizer_.setMemoryBudget(bytes); }
+	inline void setTargetBlockSize(const U64 b_uncompressed, const U64 b_compressed){
+		this->block_sizer_.setTargetUncompressed(b_uncompressed);
+		this->block_sizer_.setTargetCompressed(b_compressed);
+	}
 	void setWriterTypeFile(void){ this->writer = new writer_file_type; }
 	void setWriterTypeStream(void){ this->writer = new writer_stream_type; }
 
 private:
 	bool BuildBCF();  // import a BCF file
-	bool add(meta_type& meta, bcf_entry_type& line); // Import a BCF line
-	bool addGenotypes(bcf_reader_type& bcf_reader, meta_type* meta_entries);
-	bool parseBCFBody(meta_type& meta, bcf_entry_type& line);
+	bool BuildVCF();  // import a VCF file
+
+	/**<
+	 * Import a BCF file in parallel regions. A first pass over the
+	 * file finds the virtual offsets of the region boundaries.
+	 * @return Returns TRUE upon success or FALSE otherwise
+	 */
+	bool BuildSharded(void);
+
+	/**<
+	 * Split a BCF file into at most `n_shards_` regions of
+	 * approximately equal compressed size. Regions start at a
+	 * contig switch if one is close to the boundary.
+	 * @param reader  Opened BCF reader positioned at the first record
+	 * @param regions Destination regions in file order
+	 * @return        Returns TRUE upon success or FALSE otherwise
+	 */
+	bool findRegions(bcf_reader_type& reader, std::vector<ImportRegion>& regions) const;
+
+	/**<
+	 * Import a region of the input file into a separate file
+	 * @param region  Target region
+	 * @param output  Output file prefix
+	 * @param success Set to TRUE upon success or FALSE otherwise
+	 */
+	void buildRegion(const ImportRegion& region, const std::string output, BYTE& success) const;
+
+	// Header literals describing the import
+	std::string getImportLiterals(void) const;
+
+	/**<
+	 * Import all variants from an opened reader. The reader runs
+	 * in this thread and feeds the encode, compress, and write
+	 * stages of the pipeline.
+	 * @param reader     Opened BCF or VCF reader
+	 * @param input_type Input format name used in the statistics
+	 * @return           Returns TRUE upon success or FALSE otherwise
+	 */
+	template <class reader_type> bool BuildImport(reader_type& reader, const std::string& input_type);
+	bool add(meta_type& meta, bcf_entry_type& line, batch_type& batch); // Import a BCF line
+	bool addGenotypes(bcf_reader_type& bcf_reader, meta_type* meta_entries, block_type& block);
+	bool parseBCFBody(meta_type& meta, bcf_entry_type& line, block_type& block);
+
+	// Pipeline stages: each stage runs in its own thread and
+	// passes batches downstream through bounded queues. Batches
+	// are returned to the pool after they have been written.
+	void encodeStage(batch_queue_type& in, batch_queue_type& out, batch_queue_type& pool);
+	void compressStage(batch_queue_type& in, batch_queue_type& out, batch_queue_type& pool, checksum_type& checksums, encryption_type& encryption_manager, keychain_type& keychain);
+	void writeStage(batch_queue_type& in, batch_queue_type& pool, const core::VariantHeader& header, algorithm::Timer& timer);
+
+	/**<
+	 * Prepare appending to the existing output file. The header
+	 * of the file has to match the input header. Existing blocks
+	 * are read once to extend the digests, which cannot be resumed
+	 * from their finalized values, and the digests are verified
+	 * against the stored ones. Per-block checksums are extended
+	 * without reading the blocks. The existing index is merged into
+	 * the index of the writer and the writer is positioned at the
+	 * end of the data. Nothing is written to the file.
+	 * @param header    Tachyon header converted from the input header
+	 * @param checksums Digests to extend
+	 * @param keychain  Keychain to extend if the file is encrypted
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	bool openAppend(const core::VariantHeader& header, checksum_type& checksums, keychain_type& keychain);
+
+	/**<
+	 * Restore the index, digests, and footer of the file that is
+	 * appended to after a failed import such that the file remains
+	 * valid
+	 */
+	void abortAppend(void);
+
+	/**<
+	 * Return a batch to the pool after it has been written or
+	 * dropped and release its memory from the budget
+	 * @param batch Target batch
+	 * @param pool  Pool of free batches
+	 */
+	void recycleBatch(batch_type* batch, batch_queue_type& pool);
+
+	bool encodeBatch(batch_type& batch);
+	bool compressBatch(batch_type& batch, checksum_type& checksums, encryption_type& encryption_manager, keychain_type& keychain);
+	bool writeBatch(batch_type& batch, algorithm::ZSTDCodec& footer_codec, algorithm::Timer& timer);
+	bool writeHeader(const core::VariantHeader& header);
+
+	/**<
+	 * Train per-field ZSTD dictionaries from the uncompressed
+	 * INFO and FORMAT data in a set of encoded batches
+	 * @param batches Encoded batches
+	 */
+	void trainDictionaries(const std::vector<batch_type*>& batches);
 
 private:
 	bool GT_available_;
 	bool permute;            // permute GT flag
 	bool encrypt;            // encryption flag
+	bool train_dictionaries_; // train per-field ZSTD dictionaries
+	bool append_;            // append to an existing file
+	algorithm::TACHYON_CHECKSUM_TYPE checksum_algorithm_; // SHA-512 digests or per-block checksums
 	U32 checkpoint_n_snps;   // number of variants until checkpointing
 	double checkpoint_bases; // number of bases until checkpointing
 	U32 n_threads_;
+	U32 n_shards_;           // number of regions imported in parallel
+	ImportRegion region_;    // region of the input to import if set
+	U32 n_pipeline_batches_; // number of recycled batches in flight
+	bool silent_;            // suppress program messages
+	std::atomic<bool> pipeline_failed_;
 
 	S32 info_end_key_;
 	S32 info_svlen_key_;
 
+	// State of the file appended to
+	S32         append_contig_;   // contig of the last variant in the file
+	U64         append_position_; // position of the last variant in the file
+	U64         append_offset_;   // end of data in the file
+	buffer_type append_tail_;     // index, digests, and footer of the file
+
+	// Per-block checksums computed as blocks are written
+	block_checksum_type block_checksums_;
+
 	// Stats
 	import_stats_type stats_basic;
 	import_stats_type stats_info;
@@ -75,15 +236,21 @@ private:
 	std::string outputPrefix;// output file prefix
 	writer_interface_type* writer;      // writer
 
-	index_entry_type  index_entry; // streaming index entry
 	radix_sorter_type permutator;  // GT permuter
 	header_type*      header;      // header
 	gt_encoder_type   encoder;     // RLE packer
 
 	compression_manager_type compression_manager;
 
-	// Data container
-	block_type block;
+	// Recycled pipeline batches
+	batch_type* batches_;
+
+	// Automatic block sizing and memory back-pressure
+	block_sizer_type   block_sizer_;
+	memory_budget_type memory_budget_;
+
+	// Per-stage and per-field timings
+	algorithm::StageProfiler profiler_;
 
 	// temp
 	//algorithm::GenotypeNearestNeighbour* nn;
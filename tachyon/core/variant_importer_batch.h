@@ -0,0 +1,56 @@
+#ifndef CORE_VARIANT_IMPORTER_BATCH_H_
+#define CORE_VARIANT_IMPORTER_BATCH_H_
+
+#include "../io/bcf/BCFReader.h"
+#include "../containers/variantblock.h"
+#include "../index/index_entry.h"
+
+namespace tachyon {
+
+/**<
+ * Unit of work passed between the stages of the pipelined
+ * importer. Each batch owns the BCF entries it was constructed
+ * from together with the Tachyon block they are encoded into.
+ * Batches are allocated once and recycled through a pool to
+ * avoid re-allocating the (large) block containers.
+ */
+struct VariantImporterBatch{
+	typedef VariantImporterBatch    self_type;
+	typedef bcf::BCFReader          bcf_reader_type;
+	typedef containers::VariantBlock block_type;
+	typedef index::IndexEntry       index_entry_type;
+
+	VariantImporterBatch() : block_number(0), progress(0), b_records(0), b_uncompressed(0), b_memory(0){}
+	~VariantImporterBatch(){}
+
+	/**<
+	 * Recycle this batch without releasing memory
+	 */
+	inline void reset(void){
+		this->block.clear();
+		this->index_entry.reset();
+		this->block_number   = 0;
+		this->progress       = 0;
+		this->b_records      = 0;
+		this->b_uncompressed = 0;
+		this->b_memory       = 0;
+	}
+
+	inline const bcf::BCFEntry& front(void) const{ return(this->entries.front()); }
+	inline const bcf::BCFEntry& back(void) const{ return(this->entries.back()); }
+	inline const size_t& size(void) const{ return(this->entries.size()); }
+
+public:
+	bcf_reader_type  entries;      // loaded BCF entries (container only)
+	block_type       block;        // target Tachyon block
+	index_entry_type index_entry;  // index entry for this block
+	U64              block_number; // sequential block number
+	double           progress;     // fraction of input consumed at load time
+	U64              b_records;      // bytes of input record data
+	U64              b_uncompressed; // bytes of encoded data before compression
+	U64              b_memory;       // bytes charged against the memory budget
+};
+
+}
+
+#endif /* CORE_VARIANT_IMPORTER_BATCH_H_ */
@@ -0,0 +1,181 @@
+#ifndef CORE_VARIANT_IMPORTER_BLOCK_SIZER_H_
+#define CORE_VARIANT_IMPORTER_BLOCK_SIZER_H_
+
+#include <mutex>
+#include <algorithm>
+
+#include "../support/type_definitions.h"
+#include "../io/bcf/BCFEntry.h"
+
+namespace tachyon{
+
+/**< Upper bound on the number of variants in an automatically sized block */
+#define YON_IMPORT_MAX_BLOCK_VARIANTS 100000
+/**< Assumed bytes per sample in a record before any block has been observed */
+#define YON_IMPORT_SAMPLE_BYTES       2
+/**< Assumed bytes per record excluding samples before any block has been observed */
+#define YON_IMPORT_RECORD_BYTES       256
+
+/**<
+ * Chooses the number of variants in the next block from the number
+ * of bytes per variant observed in the blocks written so far. Blocks
+ * are limited by a target uncompressed and/or compressed size and by
+ * a memory budget shared by all batches in flight in the import
+ * pipeline. The estimates are exponentially weighted averages such
+ * that the block size follows changes in record density along the
+ * genome.
+ *
+ * Sizes are updated by the write stage and read by the reader
+ * thread: all accessors are thread-safe.
+ */
+class VariantImporterBlockSizer{
+private:
+	typedef VariantImporterBlockSizer self_type;
+
+public:
+	VariantImporterBlockSizer() :
+		n_max_variants_(0),
+		n_batches_(1),
+		n_samples_(0),
+		b_memory_budget_(0),
+		b_target_uncompressed_(0),
+		b_target_compressed_(0),
+		n_observed_(0),
+		b_record_(0),
+		b_uncompressed_(0),
+		b_compressed_(0)
+	{}
+	~VariantImporterBlockSizer(){}
+
+	inline void setMemoryBudget(const U64 bytes){ this->b_memory_budget_ = bytes; }
+	inline void setTargetUncompressed(const U64 bytes){ this->b_target_uncompressed_ = bytes; }
+	inline void setTargetCompressed(const U64 bytes){ this->b_target_compressed_ = bytes; }
+	inline const U64& getMemoryBudget(void) const{ return(this->b_memory_budget_); }
+	inline const U64& getTargetUncompressed(void) const{ return(this->b_target_uncompressed_); }
+	inline const U64& getTargetCompressed(void) const{ return(this->b_target_compressed_); }
+	inline bool isActive(void) const{ return(this->b_memory_budget_ || this->b_target_uncompressed_ || this->b_target_compressed_); }
+
+	/**<
+	 * Prepare the estimates for a new import. Until the first block
+	 * has been written records are assumed to be dominated by
+	 * genotypes.
+	 * @param n_max_variants Largest number of variants in a block
+	 * @param n_samples      Number of samples in the file
+	 * @param n_batches      Number of batches in flight in the pipeline
+	 */
+	void init(const U32 n_max_variants, const U64 n_samples, const U32 n_batches){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->n_max_variants_ = n_max_variants;
+		this->n_samples_      = n_samples;
+		this->n_batches_      = (n_batches == 0 ? 1 : n_batches);
+		this->n_observed_     = 0;
+		this->b_record_       = n_samples * YON_IMPORT_SAMPLE_BYTES + YON_IMPORT_RECORD_BYTES;
+		this->b_uncompressed_ = this->b_record_;
+		this->b_compressed_   = this->b_record_;
+	}
+
+	/**<
+	 * Number of variants to load into the next block. Always
+	 * returns at least one variant.
+	 * @return Returns the number of variants
+	 */
+	U32 nextBlockSize(void){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		if(this->isActive() == false)
+			return(this->n_max_variants_);
+
+		double n_variants = this->n_max_variants_;
+		if(this->b_target_uncompressed_)
+			n_variants = std::min(n_variants, this->b_target_uncompressed_ / this->b_uncompressed_);
+		if(this->b_target_compressed_)
+			n_variants = std::min(n_variants, this->b_target_compressed_ / this->b_compressed_);
+		if(this->b_memory_budget_){
+			// The reader holds one more batch than the pipeline
+			const double b_batch = (double)this->b_memory_budget_ / (this->n_batches_ + 1);
+			const double b_fixed = this->fixedFootprint();
+			n_variants = std::min(n_variants, (b_batch > b_fixed ? (b_batch - b_fixed) / this->variantFootprint() : 0));
+		}
+
+		if(n_variants < 1) n_variants = 1;
+		return((U32)n_variants);
+	}
+
+	/**<
+	 * Expected number of bytes held in memory by a batch of
+	 * `n_variants` variants.
+	 * @param n_variants Number of variants
+	 * @return           Returns the number of bytes
+	 */
+	U64 expectedFootprint(const U32 n_variants){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		return(this->fixedFootprint() + n_variants * this->variantFootprint());
+	}
+
+	/**<
+	 * Number of bytes held in memory by a loaded batch given the
+	 * actual size of its records.
+	 * @param n_variants Number of variants
+	 * @param b_records  Number of bytes of record data
+	 * @return           Returns the number of bytes
+	 */
+	U64 loadedFootprint(const U32 n_variants, const U64 b_records){
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		return(this->fixedFootprint() + b_records + n_variants * (sizeof(bcf::BCFEntry) + this->b_uncompressed_ + this->b_compressed_));
+	}
+
+	/**<
+	 * Add the observed sizes of a written block to the estimates.
+	 * @param n_variants     Number of variants in the block
+	 * @param b_records      Number of bytes of input record data
+	 * @param b_uncompressed Number of bytes of encoded data before compression
+	 * @param b_compressed   Number of bytes written to the output
+	 */
+	void update(const U32 n_variants, const U64 b_records, const U64 b_uncompressed, const U64 b_compressed){
+		if(n_variants == 0) return;
+
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		const double record       = (double)b_records / n_variants;
+		const double uncompressed = (double)b_uncompressed / n_variants;
+		const double compressed   = (double)b_compressed / n_variants;
+
+		// The first observation replaces the initial guess
+		if(this->n_observed_ == 0){
+			this->b_record_       = record;
+			this->b_uncompressed_ = uncompressed;
+			this->b_compressed_   = compressed;
+		} else {
+			this->b_record_       = (this->b_record_ + record) / 2;
+			this->b_uncompressed_ = (this->b_uncompressed_ + uncompressed) / 2;
+			this->b_compressed_   = (this->b_compressed_ + compressed) / 2;
+		}
+		if(this->b_uncompressed_ < 1) this->b_uncompressed_ = 1;
+		if(this->b_compressed_ < 1)   this->b_compressed_   = 1;
+		++this->n_observed_;
+	}
+
+private:
+	// Permutation arrays are allocated for every batch regardless
+	// of the number of variants: both the array and its encoded copy
+	inline double fixedFootprint(void) const{ return(this->n_samples_ * 2 * sizeof(U32) * 2); }
+
+	// Record data and its entry slot, the encoded data, and the
+	// compressed data
+	inline double variantFootprint(void) const{ return(this->b_record_ + sizeof(bcf::BCFEntry) + this->b_uncompressed_ + this->b_compressed_); }
+
+private:
+	U32    n_max_variants_;
+	U32    n_batches_;
+	U64    n_samples_;
+	U64    b_memory_budget_;       // bytes for all batches in flight
+	U64    b_target_uncompressed_; // target encoded block size
+	U64    b_target_compressed_;   // target compressed block size
+	U64    n_observed_;            // number of blocks observed
+	double b_record_;              // input record bytes per variant
+	double b_uncompressed_;        // encoded bytes per variant
+	double b_compressed_;          // compressed bytes per variant
+	std::mutex mutex_;
+};
+
+}
+
+#endif /* CORE_VARIANT_IMPORTER_BLOCK_SIZER_H_ */
@@ -30,15 +30,28 @@ DEALINGS IN THE SOFTWARE.
 void import_usage(void){
 	programMessage();
 	std::cerr <<
-	"Brief:  Convert BCF -> YON/\n"
+	"Brief:  Convert BCF/VCF -> YON/\n"
 	"Usage:  " << tachyon::constants::PROGRAM_NAME << " import [options] -i <input file> -o <output.yon>\n\n"
 	"Options:\n"
-	"  -i FILE  input BCF file (required)\n"
+	"  -i FILE  input BCF or VCF (plain or gzip/bgzip compressed) file or - for BCF from stdin (required)\n"
 	"  -o FILE  output file prefix (required)\n"
+	"  -a       Append to the existing output file: the header of the input has to match\n"
 	"  -c INT   Import checkpoint size in number of variants (default: 1000)\n"
 	"  -C FLOAT Import checkpoint size in bases (defaukt: 5 Mb)\n"
 	"  -p/-P    Permute/Do not permute diploid genotypes\n"
+	"  -G STR   Genotype encoding: rle, pbwt to encode diploid biallelic sites in positional BWT order,\n"
+	"           or bitplane to store diploid biallelic sites as bit-planes when smaller than rle (default: rle)\n"
 	"  -e       Encrypt data (default AES-256)\n"
+	"  -O STR   Codec selection objective: fixed, size, decode, or budget (default: fixed)\n"
+	"  --decode-budget FLOAT\n"
+	"           Minimum decode speed in MB/s for the budget objective (default: 500)\n"
+	"  -D       Train ZSTD dictionaries for INFO/FORMAT fields from the first blocks\n"
+	"  -m FLOAT Memory budget in MB for blocks in flight: block sizes adapt to the data\n"
+	"  -b FLOAT Target uncompressed block size in MB: block sizes adapt to the data\n"
+	"  -z FLOAT Target compressed block size in MB: block sizes adapt to the data\n"
+	"           With -m/-b/-z the checkpoint size (-c) is an upper bound (default: 100000)\n"
+	"  -n INT   Import a BCF file as INT regions in parallel (default: 1)\n"
+	"  -X STR   Checksums: sha512 digests of the file, or crc32c or xxhash64 of each block (default: sha512)\n"
 	"  -s       Hide all program messages [null]\n";
 }
 
@@ -54,6 +67,9 @@ int import(int argc, char** argv){
 		return(1);
 	}
 
+	// Long-only options are given values outside of the short options
+	const int OPTION_DECODE_BUDGET = 256;
+
 	int option_index = 0;
 	static struct option long_options[] = {
 		{"input",               required_argument, 0, 'i' },
@@ -65,6 +81,16 @@ int import(int argc, char** argv){
 		{"encrypt",             no_argument,       0, 'e' },
 		{"no-permute",          no_argument,       0, 'P' },
 		{"silent",              no_argument,       0, 's' },
+		{"objective",           required_argument, 0, 'O' },
+		{"decode-budget",       required_argument, 0, OPTION_DECODE_BUDGET },
+		{"dictionaries",        no_argument,       0, 'D' },
+		{"memory",              required_argument, 0, 'm' },
+		{"block-size",          required_argument, 0, 'b' },
+		{"block-size-compressed", required_argument, 0, 'z' },
+		{"append",              no_argument,       0, 'a' },
+		{"shards",              required_argument, 0, 'n' },
+		{"checksum",            required_argument, 0, 'X' },
+		{"gt-encoding",         required_argument, 0, 'G' },
 		{0,0,0,0}
 	};
 
@@ -74,10 +100,22 @@ int import(int argc, char** argv){
 	S32 checkpoint_n_variants = 1000;
 	double checkpoint_bp_window = 5e6;
 	bool permute = true;
+	bool pbwt = false;
+	bool bitplane = false;
 	bool encrypt = false;
 	bool isFASTQ = false;
+	tachyon::algorithm::TACHYON_COMPRESSION_OBJECTIVE objective = tachyon::algorithm::YON_OBJECTIVE_FIXED;
+	double decode_budget = 500;
+	bool dictionaries = false;
+	bool checkpoint_set = false;
+	double memory_budget = 0;
+	double target_uncompressed = 0;
+	double target_compressed = 0;
+	bool append = false;
+	S32 n_shards = 1;
+	tachyon::algorithm::TACHYON_CHECKSUM_TYPE checksum_type = tachyon::algorithm::YON_CHECKSUM_SHA512;
 
-	while ((c = getopt_long(argc, argv, "i:o:c:C:sepPf?", long_options, &option_index)) != -1){
+	while ((c = getopt_long(argc, argv, "i:o:c:C:O:m:b:z:n:X:G:asepPDf?", long_options, &option_index)) != -1){
 		switch (c){
 		case 0:
 			std::cerr << "Case 0: " << option_index << '\t' << long_options[option_index].name << std::endl;
@@ -100,6 +138,7 @@ int import(int argc, char** argv){
 				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set checkpoint to <= 0..." << std::endl;
 				return(1);
 			}
+			checkpoint_set = true;
 			break;
 		case 'C':
 			checkpoint_bp_window = atof(optarg);
@@ -108,6 +147,64 @@ int import(int argc, char** argv){
 				return(1);
 			}
 			break;
+		case 'O':
+			if(!tachyon::algorithm::CompressionPolicy::parseObjective(std::string(optarg), objective)){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Unknown compression objective: " << optarg << "..." << std::endl;
+				return(1);
+			}
+			break;
+		case OPTION_DECODE_BUDGET:
+			decode_budget = atof(optarg);
+			if(decode_budget <= 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set decode budget to <= 0..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'm':
+			memory_budget = atof(optarg);
+			if(memory_budget <= 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set memory budget to <= 0..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'b':
+			target_uncompressed = atof(optarg);
+			if(target_uncompressed <= 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set block size to <= 0..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'z':
+			target_compressed = atof(optarg);
+			if(target_compressed <= 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set block size to <= 0..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'n':
+			n_shards = atoi(optarg);
+			if(n_shards <= 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set number of regions to <= 0..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'X':
+			if(!tachyon::algorithm::BlockChecksum::parseType(std::string(optarg), checksum_type)){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Unknown checksum: " << optarg << "..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'G':
+			pbwt = bitplane = false;
+			if(std::string(optarg) == "pbwt") pbwt = true;
+			else if(std::string(optarg) == "bitplane") bitplane = true;
+			else if(std::string(optarg) != "rle"){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Unknown genotype encoding: " << optarg << "..." << std::endl;
+				return(1);
+			}
+			break;
+		case 'D': dictionaries = true; break;
+		case 'a': append = true; break;
 		case 'p': permute = true;  break;
 		case 'P': permute = false; break;
 		case 's':
@@ -140,9 +237,25 @@ int import(int argc, char** argv){
 			return(1);
 		}
 	} else {
+		// Automatically sized blocks are not limited by the default
+		// checkpoint size
+		const bool adaptive = (memory_budget > 0 || target_uncompressed > 0 || target_compressed > 0);
+		if(adaptive && checkpoint_set == false)
+			checkpoint_n_variants = YON_IMPORT_MAX_BLOCK_VARIANTS;
+
 		tachyon::VariantImporter importer(input, output, checkpoint_n_variants, checkpoint_bp_window);
 		importer.setPermute(permute);
+		importer.setPBWT(pbwt);
+		importer.setBitplane(bitplane);
 		importer.setEncrypt(encrypt);
+		importer.setCompressionObjective(objective);
+		importer.setDecodeBudget(decode_budget);
+		importer.setDictionaries(dictionaries);
+		importer.setAppend(append);
+		importer.setShards(n_shards);
+		importer.setChecksumType(checksum_type);
+		importer.setMemoryBudget(memory_budget * 1e6);
+		importer.setTargetBlockSize(target_uncompressed * 1e6, target_compressed * 1e6);
 
 		if(!importer.Build())
 			return 1;
@@ -42,6 +42,7 @@ public:
     	delete [] this->blocks_;
 		this->blocks_     = new value_type[other.capacity()];
     	this->binID_      = other.binID_;
+    	this->n_variants_ = other.n_variants_;
     	this->n_blocks_   = other.n_blocks_;
     	this->n_capacity_ = other.n_capacity_;
     	for(U32 i = 0; i < this->size(); ++i) this->blocks_[i] = other.blocks_[i];
@@ -138,6 +139,24 @@ public:
     	}
     }
 
+	/**<
+	 * Add the blocks and variants of another bin. Block numbers of
+	 * the other bin are shifted by `block_offset` and have to
+	 * follow the blocks in this bin.
+	 * @param other        Other bin
+	 * @param block_offset Number of blocks preceding the blocks of the other bin
+	 */
+	void merge(const self_type& other, const U32 block_offset){
+		for(U32 i = 0; i < other.size(); ++i){
+			if(this->size() + 1 >= this->capacity())
+				this->resize();
+
+			if(this->size() == 0 || this->back() != other[i] + block_offset)
+				this->blocks_[this->n_blocks_++] = other[i] + block_offset;
+		}
+		this->n_variants_ += other.n_variants_;
+	}
+
 private:
     friend std::ostream& operator<<(std::ostream& stream, const self_type& bin){
 		stream.write(reinterpret_cast<const char*>(&bin.binID_),     sizeof(U32));
@@ -250,6 +269,7 @@ public:
     	this->n_bins_ = other.n_bins_;
     	this->n_capacity_ = other.n_capacity_;
     	this->n_levels_ = other.n_levels_;
+    	this->n_sites_ = other.n_sites_;
     	this->bins_cumsum_ = nullptr;
     	this->calculateCumulativeSums_();
 
@@ -357,6 +377,29 @@ public:
 		return(0);
 	}
 
+	/**<
+	 * Add the bins of another index of the same contig. Block numbers
+	 * of the other index are shifted by `block_offset`. An empty index
+	 * adopts the layout of the other index.
+	 * @param other        Other index of the same contig
+	 * @param block_offset Number of blocks preceding the blocks of the other index
+	 * @return             Returns TRUE upon success or FALSE if the layouts differ
+	 */
+	bool merge(const self_type& other, const U32 block_offset){
+		if(other.size_sites() == 0) return true;
+		if(this->size_sites() == 0)
+			*this = self_type(other.contigID_, other.l_contig_, other.n_levels_);
+
+		if(this->l_contig_ != other.l_contig_ || this->n_levels_ != other.n_levels_ || this->size() != other.size())
+			return false;
+
+		for(U32 i = 0; i < this->size(); ++i)
+			this->bins_[i].merge(other.bins_[i], block_offset);
+
+		this->n_sites_ += other.n_sites_;
+		return true;
+	}
+
 	/**<
 	 * Computes the possible bins an interval might overlap
 	 * @param from_position From position of interval
@@ -2,6 +2,7 @@
 #define BASICBUFFER_H_
 
 #include <cstddef>
+#include <utility>
 #include <iostream>
 #include "../support/type_definitions.h"
 #include "../support/helpers.h"
@@ -25,7 +26,7 @@ public:
 	BasicBuffer(const U64 size) : owns_data_(true), n_chars(0), width(size), iterator_position_(0), buffer(new char[size]){}
 	BasicBuffer(char* target, const size_t length) : owns_data_(false), n_chars(length), width(length), iterator_position_(0), buffer(target){}
 	BasicBuffer(const U64 size, char* target) : owns_data_(false), n_chars(0), width(size), iterator_position_(0), buffer(target){}
-	BasicBuffer(const self_type& other) : owns_data_(other.owns_data_), n_chars(0), width(other.width), iterator_position_(0), buffer(new char[other.width]){}
+	BasicBuffer(const self_type& other) : owns_data_(true), n_chars(0), width(other.width), iterator_position_(0), buffer(new char[other.width]){}
 	virtual ~BasicBuffer(){
 		if(this->owns_data_)
 			delete [] this->buffer;
@@ -99,7 +100,38 @@ public:
 		this->buffer = target;
 	}
 
-	inline void reset(){ this->n_chars = 0; this->iterator_position_ = 0; }
+	/**<
+	 * Point the buffer at read-only memory owned elsewhere, such as
+	 * the pages of a memory-mapped file, without copying it. Memory
+	 * owned by the buffer is released. The view is dropped by the
+	 * next `reset` or growing `resize` and must not be written to.
+	 * @param target Start of the memory
+	 * @param length Length of the memory in bytes
+	 */
+	inline void view(const char* target, const U64 length){
+		if(this->owns_data_)
+			delete [] this->buffer;
+
+		this->owns_data_ = false;
+		this->buffer = const_cast<char*>(target);
+		this->n_chars = length;
+		this->width = length;
+		this->iterator_position_ = 0;
+	}
+
+	inline const bool isView(void) const{ return(this->owns_data_ == false); }
+
+	inline void reset(){
+		// Views are never reused: the buffer is reallocated on the
+		// next write
+		if(this->owns_data_ == false){
+			this->owns_data_ = true;
+			this->buffer = nullptr;
+			this->width = 0;
+		}
+		this->n_chars = 0;
+		this->iterator_position_ = 0;
+	}
 	inline void resetIterator(){ this->iterator_position_ = 0; }
 	inline void move(const U64 to){ this->n_chars = to; }
 	inline const U64& size(void) const{ return this->n_chars; }
@@ -123,7 +155,8 @@ public:
 		char* target = this->buffer;
 		this->buffer = new char[new_size];
 		memcpy(&this->buffer[0], &target[0], copy_to);
-		delete [] target;
+		if(this->owns_data_) delete [] target;
+		this->owns_data_ = true;
 		this->width = new_size;
 	}
 
@@ -348,6 +381,19 @@ public:
 		this->iterator_position_ += n_length;
 	}
 
+	/**<
+	 * Exchange the contents of this buffer with another
+	 * buffer without copying any data
+	 * @param other Target buffer
+	 */
+	inline void swap(self_type& other){
+		std::swap(this->owns_data_, other.owns_data_);
+		std::swap(this->n_chars, other.n_chars);
+		std::swap(this->width, other.width);
+		std::swap(this->iterator_position_, other.iterator_position_);
+		std::swap(this->buffer, other.buffer);
+	}
+
 private:
 	friend self_type& operator>>(self_type& data, BYTE& target){
 		target = *reinterpret_cast<BYTE*>(&data.buffer[data.iterator_position_++]);
@@ -0,0 +1,100 @@
+#ifndef BCF_BCFARENA_H_
+#define BCF_BCFARENA_H_
+
+#include <vector>
+
+#include "../../support/type_definitions.h"
+
+namespace tachyon {
+namespace bcf {
+
+/**< Minimum size of a slab in bytes */
+#define BCF_ARENA_SLAB_SIZE 4194304
+
+/**<
+ * Memory arena holding the raw record data of a batch of
+ * BCF entries. Records are appended to a slab and entries
+ * are views into it. If a slab is full then a new slab is
+ * started such that previously returned pointers remain
+ * valid. Resetting the arena recycles the memory for the next
+ * batch: multiple slabs are merged into a single slab large
+ * enough for the previous batch such that the data of a
+ * batch is contiguous in the steady state.
+ */
+class BCFArena{
+private:
+	typedef BCFArena self_type;
+
+	struct Slab{
+		Slab(const U64 capacity) : size(0), capacity(capacity), data(new char[capacity]){}
+
+		U64   size;
+		U64   capacity;
+		char* data;
+	};
+
+public:
+	BCFArena() : n_used_(0){}
+	~BCFArena(){ this->clear(); }
+
+	/**<
+	 * Reserve `length` contiguous bytes in the arena
+	 * @param length Number of bytes
+	 * @return       Returns a pointer to the reserved memory
+	 */
+	char* allocate(const U64 length){
+		if(this->slabs_.size() == 0 || this->slabs_.back().size + length > this->slabs_.back().capacity){
+			U64 capacity = (this->slabs_.size() ? this->slabs_.back().capacity * 2 : BCF_ARENA_SLAB_SIZE);
+			if(capacity < length) capacity = length;
+			this->slabs_.push_back(Slab(capacity));
+		}
+
+		Slab& slab = this->slabs_.back();
+		char* data = &slab.data[slab.size];
+		slab.size     += length;
+		this->n_used_ += length;
+		return(data);
+	}
+
+	/**<
+	 * Release all records. Memory is kept for the next batch
+	 * and merged into a single slab if necessary.
+	 */
+	void reset(void){
+		if(this->slabs_.size() > 1){
+			U64 capacity = 0;
+			for(U32 i = 0; i < this->slabs_.size(); ++i) capacity += this->slabs_[i].capacity;
+			this->clear();
+			this->slabs_.push_back(Slab(capacity));
+		} else if(this->slabs_.size() == 1){
+			this->slabs_[0].size = 0;
+		}
+		this->n_used_ = 0;
+	}
+
+	inline void swap(self_type& other){
+		std::swap(this->slabs_, other.slabs_);
+		std::swap(this->n_used_, other.n_used_);
+	}
+
+	inline const U64& size(void) const{ return(this->n_used_); }
+
+private:
+	BCFArena(const self_type& other);
+	self_type& operator=(const self_type& other);
+
+	void clear(void){
+		for(U32 i = 0; i < this->slabs_.size(); ++i)
+			delete [] this->slabs_[i].data;
+		this->slabs_.clear();
+	}
+
+private:
+	U64 n_used_;              // number of bytes in use
+	std::vector<Slab> slabs_; // slabs in order of allocation
+};
+
+}
+}
+
+#endif /* BCF_BCFARENA_H_ */
@@ -6,14 +6,17 @@
 namespace tachyon {
 namespace bcf {
 
+// Data is allocated upon the first add() or set
+// as a view
 BCFEntry::BCFEntry(void):
 	l_data(0),
-	l_capacity(128144),
+	l_capacity(0),
 	l_ID(0),
 	ref_alt(0),
 	isGood(false),
-	data(new char[this->l_capacity]),
-	body(reinterpret_cast<body_type*>(this->data)),
+	owns_data(true),
+	data(nullptr),
+	body(nullptr),
 	alleles(new string_type[100]),
 	ID(nullptr),
 	hasGenotypes(false),
@@ -36,6 +39,7 @@ BCFEntry::BCFEntry(const U64 start_capacity):
 	l_ID(0),
 	ref_alt(0),
 	isGood(false),
+	owns_data(true),
 	data(new char[this->l_capacity]),
 	body(reinterpret_cast<body_type*>(this->data)),
 	alleles(new string_type[100]),
@@ -61,6 +65,7 @@ BCFEntry::BCFEntry(const self_type& other):
 	l_ID(other.l_ID),
 	ref_alt(other.ref_alt),
 	isGood(other.isGood),
+	owns_data(true),
 	data(new char[other.l_capacity]),
 	body(nullptr),
 	alleles(new string_type[100]),
@@ -86,12 +91,12 @@ BCFEntry::BCFEntry(const self_type& other):
 		this->infoID[i]   = other.infoID[i];
 	}
 
-	U32 internal_pos = sizeof(body_type);
-	this->__parseID(internal_pos);
-	//this->__parseRefAlt(internal_pos);
-	//this->SetRefAlt();
-	for(U32 i = 0; i < this->body->n_allele; ++i)
-		this->alleles[i] = other.alleles[i];
+	// Alleles are views into the copied data
+	if(this->l_data){
+		U32 internal_pos = sizeof(body_type);
+		this->__parseID(internal_pos);
+		this->__parseRefAlt(internal_pos);
+	}
 }
 
 BCFEntry::BCFEntry(self_type&& other) noexcept :
@@ -100,6 +105,7 @@ BCFEntry::BCFEntry(self_type&& other) noexcept :
 	l_ID(other.l_ID),
 	ref_alt(other.ref_alt),
 	isGood(other.isGood),
+	owns_data(other.owns_data),
 	data(other.data),
 	body(other.body),
 	alleles(other.alleles),
@@ -138,11 +144,12 @@ BCFEntry& BCFEntry::operator=(self_type&& other) noexcept{
 		return *this;
 	}
 
-	delete [] this->data;
+	if(this->owns_data) delete [] this->data;
 	delete [] this->alleles;
 	delete [] this->filterID;
 	delete [] this->infoID;
 	delete [] this->formatID;
+	this->owns_data     = other.owns_data;
 	this->l_data        = other.l_data;
 	this->l_capacity    = other.l_capacity;
 	this->l_ID          = other.l_ID;
@@ -174,7 +181,7 @@ BCFEntry& BCFEntry::operator=(self_type&& other) noexcept{
 }
 
 BCFEntry::~BCFEntry(void){
-	delete [] this->data;
+	if(this->owns_data) delete [] this->data;
 	delete [] this->alleles;
 	delete [] this->filterID;
 	delete [] this->infoID;
@@ -185,16 +192,27 @@ void BCFEntry::resize(const U32 size){
 	if(size == 0)
 		return;
 
+	// A view is copied into owned memory
 	char* temp = this->data;
 	this->data = new char[size];
-	memcpy(this->data, temp, this->l_data);
-	delete [] temp;
+	if(this->l_data) memcpy(this->data, temp, this->l_data);
+	if(this->owns_data) delete [] temp;
+	this->owns_data = true;
 	this->body = reinterpret_cast<body_type*>(this->data);
 
 	if(size > this->l_capacity)
 		this->l_capacity = size;
 }
 
+void BCFEntry::view(char* const data, const U32 length){
+	if(this->owns_data) delete [] this->data;
+	this->owns_data  = false;
+	this->data       = data;
+	this->l_data     = length;
+	this->l_capacity = length;
+	this->body       = reinterpret_cast<body_type*>(this->data);
+}
+
 void BCFEntry::add(const char* const data, const U32 length){
 	if(this->l_data + length > this-> capacity())
 		this->resize(this->l_data + length + 65536);
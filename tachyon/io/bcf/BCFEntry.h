@@ -67,29 +67,22 @@ struct __attribute__((packed, aligned(1))) BCFEntryBody{
 };
 #pragma pack(pop)
 
+/**<
+ * View of a typed string in the data of a BCFEntry: the
+ * string is not copied and is only valid as long as the
+ * record data is
+ */
 struct BCFTypeString{
 	typedef BCFTypeString self_type;
 
 	BCFTypeString() : length(0), data(nullptr){}
-	BCFTypeString(const self_type& other) : length(other.length), data(new char[other.length]){ memcpy(this->data, other.data, other.length); }
-	void operator=(const self_type& other){
-		this->length = other.length;
-		delete [] this->data;
-		this->data = new char[other.length];
-		memcpy(this->data, other.data, other.length);
-	}
 	void operator()(const char* const data, const U16 length){
 		this->length = length;
-		delete [] this->data;
-		this->data = new char[length];
-		memcpy(this->data, data, length);
-	}
-	~BCFTypeString(){
-		delete [] this->data;
+		this->data   = data;
 	}
 
 	U16 length;
-	char* data;
+	const char* data;
 };
 
 struct BCFKeyTuple{
@@ -173,7 +166,25 @@ public:
 	void resize(const U32 size);
 	void add(const char* const data, const U32 length);
 
+	/**<
+	 * Set the record data to a view of external memory, such as
+	 * a BCFArena, that has to outlive the entry or until another
+	 * record is set. Any owned data is released.
+	 * @param data   Pointer to a complete BCF record
+	 * @param length Length of the record in bytes
+	 */
+	void view(char* const data, const U32 length);
+
 	inline void reset(void){
+		// Views are detached: owned memory is
+		// allocated upon the next add()
+		if(this->owns_data == false){
+			this->data       = nullptr;
+			this->body       = nullptr;
+			this->l_capacity = 0;
+			this->owns_data  = true;
+		}
+
 		this->l_data        = 0;
 		this->isGood        = false;
 		this->infoPointer   = 0;
@@ -181,6 +192,8 @@ public:
 		this->filterPointer = 0;
 		this->n_filter      = 0;
 		this->filter_start  = 0;
+		this->hasGenotypes  = false;
+		this->gt_support    = gt_support_type();
 	}
 
 	inline const U32& size(void) const{ return(this->l_data); }
@@ -235,7 +248,7 @@ public:
 			for(U32 i = ploidy; i < n_samples*ploidy; i+=ploidy, ++current_sample){
 				// retrieve ploidy primitives
 				for(U32 p = 0; p < ploidy; ++p){
-					const SBYTE& ref  = *reinterpret_cast<const BYTE* const>(&internal_data[internal_data_offset]);
+					const BYTE& ref  = *reinterpret_cast<const BYTE* const>(&internal_data[internal_data_offset]);
 					if((ref >> 1) == 0){
 						//std::cerr << "is missing" << std::endl;
 						this->gt_support.hasMissing = true;
@@ -381,7 +394,8 @@ public:
 	U32 l_ID;
 	BYTE ref_alt;    // parsed
 	bool isGood;
-	char* data;      // hard copy data to buffer, interpret internally
+	bool owns_data;  // data is owned or a view
+	char* data;      // hard copy data to buffer or view, interpret internally
 	body_type* body; // BCF2 body
 	string_type* alleles; // pointer to pointer of ref alleles and their lengths
 	char* ID;
@@ -4,33 +4,55 @@ namespace tachyon{
 namespace bcf{
 
 BCFReader::BCFReader() :
+		stream(nullptr),
 		filesize(0),
 		current_pointer(0),
+		block_offset(0),
+		next_block_offset(0),
 		map_gt_id(-1),
+		n_inflate_threads(0),
+		bgzf_parallel_controller(nullptr),
 		state(bcf_reader_state::BCF_INIT),
 		n_entries(0),
 		n_capacity(0),
 		n_carry_over(0),
 		entries(nullptr),
-		b_data_read(0)
+		b_data_read(0),
+		n_limit(0),
+		n_read(0),
+		profiler(nullptr),
+		t_inflate_wall(0),
+		t_inflate_cpu(0)
 {}
 
 BCFReader::BCFReader(const std::string& file_name) :
 		file_name(file_name),
+		stream(nullptr),
 		filesize(0),
 		current_pointer(0),
+		block_offset(0),
+		next_block_offset(0),
 		map_gt_id(-1),
+		n_inflate_threads(0),
+		bgzf_parallel_controller(nullptr),
 		state(bcf_reader_state::BCF_INIT),
 		n_entries(0),
 		n_capacity(0),
 		n_carry_over(0),
 		entries(nullptr),
-		b_data_read(0)
+		b_data_read(0),
+		n_limit(0),
+		n_read(0),
+		profiler(nullptr),
+		t_inflate_wall(0),
+		t_inflate_cpu(0)
 {}
 
 BCFReader::~BCFReader(){
+	delete this->bgzf_parallel_controller;
+
 	if(this->entries != nullptr){
-		for(std::size_t i = 0; i < this->n_entries; ++i)
+		for(std::size_t i = 0; i < this->n_capacity; ++i)
 			((this->entries + i)->~BCFEntry());
 
 		::operator delete[](static_cast<void*>(this->entries));
@@ -39,25 +61,43 @@ BCFReader::~BCFReader(){
 
 
 bool BCFReader::nextBlock(void){
+	if(this->bgzf_parallel_controller != nullptr)
+		return(this->nextBlockParallel());
+
 	// Stream died
-	if(!this->stream.good()){
+	if(!this->stream->good()){
 		std::cerr << utility::timestamp("ERROR", "BCF") << "Stream died!" << std::endl;
 		this->state = bcf_reader_state::BCF_STREAM_ERROR;
 		return false;
 	}
 
-	// EOF
-	if(this->stream.tellg() == this->filesize){
+	// EOF: checked without seeking as the input may be a pipe
+	if(this->stream->peek() == std::istream::traits_type::eof()){
 		this->state = bcf_reader_state::BCF_EOF;
 		return false;
 	}
 
-	if(!this->bgzf_controller.InflateBlock(this->stream, this->buffer)){
+	algorithm::Timer timer;
+	if(this->profiler != nullptr) timer.Start();
+
+	if(!this->bgzf_controller.InflateBlock(*this->stream, this->buffer)){
 		if(this->bgzf_controller.buffer.size() == 0) this->state = bcf_reader_state::BCF_EOF;
 		else this->state = bcf_reader_state::BCF_ERROR;
 		return false;
 	}
 
+	if(this->profiler != nullptr){
+		const double wall = timer.Elapsed().count();
+		const double cpu  = timer.ElapsedCPU();
+		(*this->profiler)[algorithm::YON_PROFILE_INFLATE].add(wall, cpu, this->buffer.size(), this->bgzf_controller.buffer.size(), 1);
+		this->t_inflate_wall += wall;
+		this->t_inflate_cpu  += cpu;
+	}
+
+	// The compressed block is still held in the buffer
+	this->block_offset       = this->next_block_offset;
+	this->next_block_offset += this->buffer.size();
+
 	// Reset buffer
 	this->buffer.reset();
 	this->current_pointer = 0;
@@ -67,51 +107,185 @@ bool BCFReader::nextBlock(void){
 	return true;
 }
 
+bool BCFReader::nextBlockParallel(void){
+	// Workers account for the CPU time and bytes: this
+	// thread only waits for and reads the blocks
+	algorithm::Timer timer;
+	if(this->profiler != nullptr) timer.Start();
+
+	const bool loaded = this->bgzf_parallel_controller->next(*this->stream, this->bgzf_controller.buffer);
+
+	if(this->profiler != nullptr){
+		const double wall = timer.Elapsed().count();
+		const double cpu  = timer.ElapsedCPU();
+		(*this->profiler)[algorithm::YON_PROFILE_INFLATE].addWall(wall);
+		(*this->profiler)[algorithm::YON_PROFILE_INFLATE].addCPU(cpu);
+		this->t_inflate_wall += wall;
+		this->t_inflate_cpu  += cpu;
+	}
+
+	if(!loaded){
+		if(this->bgzf_parallel_controller->isError()) this->state = bcf_reader_state::BCF_ERROR;
+		else this->state = bcf_reader_state::BCF_EOF;
+		return false;
+	}
+
+	this->block_offset    = this->bgzf_parallel_controller->getBlockOffset();
+	this->current_pointer = 0;
+	this->state = bcf_reader_state::BCF_OK;
+	this->b_data_read += this->bgzf_controller.buffer.size();
+
+	return true;
+}
+
+bool BCFReader::readBytes(char* destination, U64 length){
+	while(length){
+		if(this->current_pointer == this->bgzf_controller.buffer.size()){
+			if(!this->nextBlock())
+				return false;
+		}
+
+		const U64 available = this->bgzf_controller.buffer.size() - this->current_pointer;
+		const U64 n_copy    = (length < available ? length : available);
+		if(destination != nullptr){
+			memcpy(destination, &this->bgzf_controller.buffer[this->current_pointer], n_copy);
+			destination += n_copy;
+		}
+		this->current_pointer += n_copy;
+		length -= n_copy;
+	}
+	return true;
+}
+
+bool BCFReader::nextRecordOffset(S32& contig, U64& block_offset, U32& in_block_offset){
+	if(this->current_pointer == this->bgzf_controller.buffer.size()){
+		if(!this->nextBlock())
+			return false;
+	}
+
+	block_offset    = this->block_offset;
+	in_block_offset = this->current_pointer;
+
+	// Record lengths followed by the contig identifier
+	U32 fields[3];
+	if(!this->readBytes(reinterpret_cast<char*>(fields), sizeof(U32)*3)){
+		std::cerr << utility::timestamp("ERROR","BCF") << "Truncated record..." << std::endl;
+		this->state = bcf_reader_state::BCF_ERROR;
+		return false;
+	}
+	contig = fields[2];
+
+	if(!this->readBytes(nullptr, (U64)fields[0] + fields[1] - sizeof(U32))){
+		std::cerr << utility::timestamp("ERROR","BCF") << "Truncated record..." << std::endl;
+		this->state = bcf_reader_state::BCF_ERROR;
+		return false;
+	}
+
+	++this->n_read;
+	return true;
+}
+
+bool BCFReader::seek(const U64 block_offset, const U32 in_block_offset){
+	if(this->filesize == 0){
+		std::cerr << utility::timestamp("ERROR","BCF") << "Cannot seek in a stream..." << std::endl;
+		return false;
+	}
+
+	this->file_stream.clear();
+	this->file_stream.seekg(block_offset);
+	if(!this->file_stream.good()){
+		std::cerr << utility::timestamp("ERROR","BCF") << "Failed to seek to offset " << block_offset << "..." << std::endl;
+		this->state = bcf_reader_state::BCF_STREAM_ERROR;
+		return false;
+	}
+
+	if(this->bgzf_parallel_controller != nullptr)
+		this->bgzf_parallel_controller->reset(block_offset);
+	this->next_block_offset = block_offset;
+
+	// Entries loaded before seeking are dropped
+	this->n_entries    = 0;
+	this->n_carry_over = 0;
+	this->arena.reset();
+	this->bgzf_controller.buffer.reset();
+	this->current_pointer = 0;
+
+	if(!this->nextBlock()){
+		std::cerr << utility::timestamp("ERROR","BCF") << "Failed to load block at offset " << block_offset << "..." << std::endl;
+		return false;
+	}
+
+	if(in_block_offset > this->bgzf_controller.buffer.size()){
+		std::cerr << utility::timestamp("ERROR","BCF") << "Offset " << in_block_offset << " is outside of the block at offset " << block_offset << "..." << std::endl;
+		this->state = bcf_reader_state::BCF_ERROR;
+		return false;
+	}
+	this->current_pointer = in_block_offset;
+
+	return true;
+}
+
 bool BCFReader::nextVariant(reference entry){
 	if(this->current_pointer == this->bgzf_controller.buffer.size()){
 		if(!this->nextBlock())
 			return false;
 	}
 
+	// Record lengths: these may span over two blocks
+	U32 lengths[2];
 	if(this->current_pointer + 8 > this->bgzf_controller.buffer.size()){
 		const S32 partial = (S32)this->bgzf_controller.buffer.size() - this->current_pointer;
-		entry.add(&this->bgzf_controller.buffer[this->current_pointer], this->bgzf_controller.buffer.size() - this->current_pointer);
+		memcpy(lengths, &this->bgzf_controller.buffer[this->current_pointer], partial);
 		if(!this->nextBlock()){
 			std::cerr << utility::timestamp("ERROR","BCF") << "Failed to get next block in partial" << std::endl;
 			return false;
 		}
 
-		entry.add(&this->bgzf_controller.buffer[0], 8 - partial);
+		memcpy(reinterpret_cast<char*>(lengths) + partial, &this->bgzf_controller.buffer[0], 8 - partial);
 		this->current_pointer = 8 - partial;
 	} else {
-		entry.add(&this->bgzf_controller.buffer[this->current_pointer], 8);
+		memcpy(lengths, &this->bgzf_controller.buffer[this->current_pointer], 8);
 		this->current_pointer += 8;
 	}
 
-	U64 remainder = entry.sizeBody();
+	// Copy the record once into the arena
+	const U64 l_record = 8 + (U64)lengths[0] + lengths[1];
+	char* const record = this->arena.allocate(l_record);
+	memcpy(record, lengths, 8);
+
+	U64 offset    = 8;
+	U64 remainder = l_record - 8;
 	while(remainder){
 		if(this->current_pointer + remainder > this->bgzf_controller.buffer.size()){
-			entry.add(&this->bgzf_controller.buffer[this->current_pointer], this->bgzf_controller.buffer.size() - this->current_pointer);
-			remainder -= this->bgzf_controller.buffer.size() - this->current_pointer;
+			const U64 partial = this->bgzf_controller.buffer.size() - this->current_pointer;
+			memcpy(&record[offset], &this->bgzf_controller.buffer[this->current_pointer], partial);
+			offset    += partial;
+			remainder -= partial;
 			if(!this->nextBlock())
 				return false;
 
 		} else {
-			entry.add(&this->bgzf_controller.buffer[this->current_pointer], remainder);
+			memcpy(&record[offset], &this->bgzf_controller.buffer[this->current_pointer], remainder);
 			this->current_pointer += remainder;
 			remainder = 0;
 			break;
 		}
 	}
 
+	entry.view(record, l_record);
+	++this->n_read;
+	return(this->parseEntry(entry));
+}
+
+bool BCFReader::parseEntry(reference entry){
 	if(!entry.parse(this->header.samples)){
 		std::cerr << "parse error" << std::endl;
 		exit(1);
 	}
 
-	if(this->entries[this->n_entries].body->n_fmt > 0 && this->map_gt_id != -1){
-		if(this->entries[this->n_entries].formatID[0].mapID == this->map_gt_id){
-			this->entries[this->n_entries].hasGenotypes = true;
+	if(entry.body->n_fmt > 0 && this->map_gt_id != -1){
+		if(entry.formatID[0].mapID == this->map_gt_id){
+			entry.hasGenotypes = true;
 			entry.assessGenotypes(this->header.samples);
 		}
 	}
@@ -119,27 +293,64 @@ bool BCFReader::nextVariant(reference entry){
 	return true;
 }
 
+void BCFReader::reserve(const size_type n_entries){
+	if(n_entries <= this->n_capacity)
+		return;
+
+	// Entries are recycled: every slot in the
+	// array holds a constructed entry
+	pointer temp = static_cast<pointer>(::operator new[](n_entries*sizeof(value_type)));
+	for(std::size_t i = 0; i < this->n_capacity; ++i){
+		new( &temp[i] ) value_type( std::move(this->entries[i]) );
+		((this->entries + i)->~BCFEntry());
+	}
+	for(std::size_t i = this->n_capacity; i < n_entries; ++i)
+		new( &temp[i] ) value_type( );
+
+	::operator delete[](static_cast<void*>(this->entries));
+	this->entries    = temp;
+	this->n_capacity = n_entries;
+}
+
 bool BCFReader::getVariants(const U32 n_variants, const double bp_window, bool across_contigs){
+	if(this->profiler == nullptr)
+		return(this->loadVariants(n_variants, bp_window, across_contigs));
+
+	// Parsing is interleaved with inflating blocks: the
+	// inflate time is accounted for separately
+	algorithm::Timer timer;
+	timer.Start();
+	this->t_inflate_wall = 0;
+	this->t_inflate_cpu  = 0;
+
+	const bool loaded = this->loadVariants(n_variants, bp_window, across_contigs);
+	(*this->profiler)[algorithm::YON_PROFILE_PARSE].add(timer.Elapsed().count() - this->t_inflate_wall, timer.ElapsedCPU() - this->t_inflate_cpu, this->arena.size(), 0, this->size());
+	return(loaded);
+}
+
+bool BCFReader::loadVariants(const U32 n_variants, const double bp_window, bool across_contigs){
 	S64 firstPos    = 0;
 	S32 firstContig = -1;
+	this->reserve(n_variants + 1);
+
 	// If there is any carry over
 	if(this->n_carry_over == 1){
-		value_type last(this->entries[this->n_entries]);
-		if(last.body->n_fmt > 0 && this->map_gt_id != -1){
-			if(last.formatID[0].mapID == this->map_gt_id)
-				last.hasGenotypes = true;
-		}
-
-		for(std::size_t i = 0; i <= this->n_entries; ++i)
-			((this->entries + i)->~BCFEntry());
-
-		if(n_variants + 1 > this->capacity()){
-			::operator delete[](static_cast<void*>(this->entries));
-			this->entries    = static_cast<pointer>(::operator new[]((n_variants + 1)*sizeof(value_type)));
-			this->n_capacity = n_variants + 1;
+		// The carry over entry is stored past the last valid entry
+		// unless it has been moved to the front by transferEntries()
+		if(this->n_entries){
+			const value_type& last = this->entries[this->n_entries];
+			this->carry_buffer.resize(last.size());
+			this->carry_buffer.reset();
+			this->carry_buffer.Add(last.data, last.size());
+			this->arena.reset();
+
+			char* const record = this->arena.allocate(this->carry_buffer.size());
+			memcpy(record, this->carry_buffer.data(), this->carry_buffer.size());
+			this->entries[0].reset();
+			this->entries[0].view(record, this->carry_buffer.size());
+			this->parseEntry(this->entries[0]);
 		}
 
-		new( &this->entries[0] ) value_type( last );
 		this->n_entries  = 1;
 		firstPos         = this->entries[0].body->POS;
 		firstContig      = this->entries[0].body->CHROM;
@@ -148,16 +359,7 @@ bool BCFReader::getVariants(const U32 n_variants, const double bp_window, bool a
 	else {
 		// Only set this to 0 if there is no carry
 		// over data from the previous cycle
-		for(std::size_t i = 0; i < this->n_entries; ++i)
-			((this->entries + i)->~BCFEntry());
-
-		if(n_variants + 1 > this->capacity()){
-			::operator delete[](static_cast<void*>(this->entries));
-			this->entries    = static_cast<pointer>(::operator new[]((n_variants + 1)*sizeof(value_type)));
-			this->n_capacity = n_variants + 1;
-		}
-
-		//delete this->entries;
+		this->arena.reset();
 		this->n_entries  = 0;
 	}
 
@@ -169,13 +371,17 @@ bool BCFReader::getVariants(const U32 n_variants, const double bp_window, bool a
 		return false;
 
 	for(U32 i = 0; i < n_variants; ++i){
+		// All records of the region have been read
+		if(this->n_limit != 0 && this->n_read >= this->n_limit)
+			return(this->size() > 0);
+
 		if(this->current_pointer == this->bgzf_controller.buffer.size()){
 			if(!this->nextBlock()){
 				return(this->size() > 0);
 			}
 		}
 
-		new( &this->entries[this->n_entries] ) value_type( this->header.samples * 2 );
+		this->entries[this->n_entries].reset();
 		if(!this->nextVariant(this->entries[this->n_entries])){
 			std::cerr << "failed to get next" << std::endl;
 			return false;
@@ -212,6 +418,36 @@ bool BCFReader::getVariants(const U32 n_variants, const double bp_window, bool a
 	return(this->size() > 0);
 }
 
+void BCFReader::transferEntries(self_type& other){
+	// The entries held by the destination have already
+	// been consumed: these are recycled together with
+	// the arena holding their data
+	other.n_entries    = 0;
+	other.n_carry_over = 0;
+
+	std::swap(this->entries,    other.entries);
+	std::swap(this->n_capacity, other.n_capacity);
+	this->arena.swap(other.arena);
+	other.n_entries = this->n_entries;
+	this->n_entries = 0;
+	this->arena.reset();
+
+	// Make sure there is room for a carry over entry
+	this->reserve(1);
+
+	// The carry over entry is stored past the last valid
+	// entry. Copy it to the front of our new array as
+	// getVariants() expects it at position `n_entries`
+	if(this->n_carry_over){
+		const value_type& last = other.entries[other.n_entries];
+		char* const record = this->arena.allocate(last.size());
+		memcpy(record, last.data, last.size());
+		this->entries[0].reset();
+		this->entries[0].view(record, last.size());
+		this->parseEntry(this->entries[0]);
+	}
+}
+
 bool BCFReader::parseHeader(void){
 	if(this->bgzf_controller.buffer.size() == 0){
 		std::cerr << utility::timestamp("ERROR","BCF") << "No buffer!" << std::endl;
@@ -262,16 +498,30 @@ bool BCFReader::open(){
 	if(this->file_name.size() == 0)
 		return false;
 
-	this->stream.open(this->file_name, std::ios::binary | std::ios::in | std::ios::ate);
-	if(!this->stream.good()){
-		std::cerr << utility::timestamp("ERROR", "BCF") << "Failed to open file: " << this->file_name << std::endl;
-		return false;
+	// Standard input is read as a stream: its size is unknown
+	// and no seeks are performed
+	if(this->file_name == "-"){
+		this->stream   = &std::cin;
+		this->filesize = 0;
+	} else {
+		this->file_stream.open(this->file_name, std::ios::binary | std::ios::in | std::ios::ate);
+		if(!this->file_stream.good()){
+			std::cerr << utility::timestamp("ERROR", "BCF") << "Failed to open file: " << this->file_name << std::endl;
+			return false;
+		}
+
+		this->stream   = &this->file_stream;
+		this->filesize = this->file_stream.tellg();
+		this->file_stream.seekg(0);
 	}
 
-	this->filesize = this->stream.tellg();
-	this->stream.seekg(0);
+	if(this->n_inflate_threads){
+		delete this->bgzf_parallel_controller;
+		this->bgzf_parallel_controller = new bgzf_parallel_controller_type(this->n_inflate_threads, this->n_inflate_threads*4);
+		this->bgzf_parallel_controller->setProfiler(this->profiler);
+	}
 
-	if(!this->stream.good()){
+	if(!this->stream->good()){
 		std::cerr << utility::timestamp("ERROR", "BCF") << "Bad stream!" << std::endl;
 		return false;
 	}
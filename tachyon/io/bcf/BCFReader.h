@@ -4,7 +4,10 @@
 #include <cassert>
 
 #include "BCFEntry.h"
+#include "BCFArena.h"
 #include "../compression/BGZFController.h"
+#include "../compression/BGZFControllerParallel.h"
+#include "../../algorithm/stage_profiler.h"
 
 
 namespace tachyon {
@@ -21,7 +24,9 @@ class BCFReader{
     typedef std::size_t        size_type;
     typedef io::BasicBuffer    buffer_type;
     typedef io::BGZFController bgzf_controller_type;
+    typedef io::BGZFControllerParallel bgzf_parallel_controller_type;
     typedef vcf::VCFHeader     header_type;
+    typedef BCFArena           arena_type;
 	typedef core::HeaderContig contig_type;
 
 public:
@@ -95,7 +100,7 @@ public:
 	 * Attempts to open a target input file. Internally
 	 * checks if the input file is an actual BCF file and
 	 * the first TGZF can be opened and the BCF header is
-	 * valid.
+	 * valid. The input file "-" reads from standard input.
 	 * @param input Input target BCF file
 	 * @return      Returns TRUE upon success or FALSE otherwise
 	 */
@@ -130,6 +135,82 @@ public:
 
 	inline const bool hasCarryOver(void) const{ return(this->n_carry_over); }
 
+	/**<
+	 * Reads the next record without parsing it. Used to find
+	 * the boundaries of regions in a first pass over the file.
+	 * @param contig          Contig identifier of the record
+	 * @param block_offset    Offset of the BGZF block holding the first byte of the record
+	 * @param in_block_offset Offset of the record in the inflated block
+	 * @return                Returns TRUE upon success or FALSE at EOF or if there was a problem
+	 */
+	bool nextRecordOffset(S32& contig, U64& block_offset, U32& in_block_offset);
+
+	/**<
+	 * Seek to a record given its virtual offset as returned by
+	 * nextRecordOffset(). Loaded and carried over entries are
+	 * dropped. Cannot be used when reading from standard input.
+	 * @param block_offset    Offset of the BGZF block holding the record
+	 * @param in_block_offset Offset of the record in the inflated block
+	 * @return                Returns TRUE upon success or FALSE otherwise
+	 */
+	bool seek(const U64 block_offset, const U32 in_block_offset);
+
+	/**<
+	 * Stop reading after `n_records` records have been read: the
+	 * reader then behaves as if the end of the file was reached.
+	 * Used together with seek() to read a region of the file.
+	 * @param n_records Number of records or 0 to read until the end of the file
+	 */
+	inline void setLimit(const U64 n_records){ this->n_limit = n_records; this->n_read = 0; }
+
+	/**<
+	 * Set the number of threads used to inflate BGZF blocks. If
+	 * this is set to a non-zero value then BGZF blocks are read
+	 * ahead and inflated in parallel. Has to be set before
+	 * opening the file.
+	 * @param n_threads Number of inflate worker threads
+	 */
+	inline void setInflateThreads(const U32 n_threads){ this->n_inflate_threads = n_threads; }
+
+	/**<
+	 * Set a profiler receiving the inflate and parse times. Has
+	 * to be set before opening the file.
+	 * @param profiler Target profiler or nullptr to disable profiling
+	 */
+	inline void setProfiler(algorithm::StageProfiler* profiler){ this->profiler = profiler; }
+
+	/**<
+	 * Moves the currently loaded variants into the `other` reader
+	 * object by swapping the underlying entry arrays and the arenas
+	 * holding their data. No BCF entry data is copied. The entries
+	 * and arena previously held by `other` are recycled by this
+	 * reader. A pending carry over entry is retained in this
+	 * reader such that the next call to getVariants() proceeds as
+	 * normal. Used to hand off batches of variants to other threads.
+	 * @param other Destination reader object acting as a container
+	 */
+	void transferEntries(self_type& other);
+
+	/**<
+	 * Make sure there are at least `n_entries` entries available.
+	 * Entries are constructed once and recycled between batches:
+	 * all `n_capacity` entries are constructed.
+	 * @param n_entries Number of entries
+	 */
+	void reserve(const size_type n_entries);
+
+	inline const bool good(void) const{ return(this->state != BCF_ERROR && this->state != BCF_STREAM_ERROR); }
+
+	// Fraction of the input file that has been read: unknown
+	// when streaming
+	inline const double getProgress(void){
+		if(this->filesize == 0) return(0);
+		// The stream position is not available once EOF has been reached
+		const std::streamoff position = this->file_stream.tellg();
+		if(position < 0) return(1);
+		return((double)position / this->filesize);
+	}
+
 private:
 	/**<
 	 * Parse the TGZF header of a block given
@@ -139,22 +220,69 @@ private:
 	 */
 	bool parseHeader(void);
 
+	/**<
+	 * Retrieves the next inflated block from the parallel
+	 * BGZF decoder.
+	 * Internal use only
+	 * @return Returns TRUE on success or FALSE otherwise
+	 */
+	bool nextBlockParallel(void);
+
+	/**<
+	 * Parse the record data of an entry and assess its
+	 * genotypes if available.
+	 * Internal use only
+	 * @param entry Target entry with record data set
+	 * @return      Returns TRUE on success or FALSE otherwise
+	 */
+	bool parseEntry(reference entry);
+
+	/**<
+	 * Implementation of getVariants() without profiling.
+	 * Internal use only
+	 */
+	bool loadVariants(const U32 n_variants, const double bp_window, bool across_contigs);
+
+	/**<
+	 * Copy or skip bytes of record data spanning over any
+	 * number of blocks.
+	 * Internal use only
+	 * @param destination Destination or nullptr to skip the bytes
+	 * @param length      Number of bytes
+	 * @return            Returns TRUE on success or FALSE otherwise
+	 */
+	bool readBytes(char* destination, U64 length);
+
 public:
 	std::string          file_name;
-	std::ifstream        stream;
+	std::istream*        stream;      // input stream: file or standard input
+	std::ifstream        file_stream;
 	U64                  filesize;
 	U32                  current_pointer;
+	U64                  block_offset;      // offset of the loaded BGZF block in the file
+	U64                  next_block_offset; // offset of the next BGZF block in the file
 	S32                  map_gt_id;
 	buffer_type          buffer;
 	buffer_type          header_buffer;
 	bgzf_controller_type bgzf_controller;
+	U32                  n_inflate_threads;
+	bgzf_parallel_controller_type* bgzf_parallel_controller;
 	header_type          header;
 	bcf_reader_state     state;
 	size_type            n_entries;
 	size_type            n_capacity;
 	size_type            n_carry_over;
 	pointer              entries;
+	arena_type           arena;        // record data of the entries
+	buffer_type          carry_buffer; // temporary copy of a carry over record
 	U64                  b_data_read;
+	U64                  n_limit;      // maximum number of records to read or 0
+	U64                  n_read;       // number of records read
+	algorithm::StageProfiler* profiler;
+
+private:
+	double t_inflate_wall; // inflate time spent in the current getVariants() call
+	double t_inflate_cpu;
 };
 
 }
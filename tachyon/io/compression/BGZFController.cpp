@@ -99,7 +99,7 @@ bool BGZFController::__Inflate(buffer_type& input, buffer_type& output, const he
 	return(true);
 }
 
-bool BGZFController::InflateBlock(std::ifstream& stream, buffer_type& input){
+bool BGZFController::ReadBlock(std::istream& stream, buffer_type& input) const{
 	input.resize(sizeof(header_type));
 	stream.read(&input.buffer[0], io::constants::BGZF_BLOCK_HEADER_LENGTH);
 	if(!stream.good()){
@@ -128,6 +128,13 @@ bool BGZFController::InflateBlock(std::ifstream& stream, buffer_type& input){
 	}
 
 	input.n_chars = h->BSIZE + 1;
+	return true;
+}
+
+bool BGZFController::InflateBlock(std::istream& stream, buffer_type& input){
+	if(!this->ReadBlock(stream, input))
+		return false;
+
 	const U32 uncompressed_size = *reinterpret_cast<const U32*>(&input[input.size() -  sizeof(U32)]);
 	this->buffer.resize(uncompressed_size + 1);
 	this->buffer.reset();
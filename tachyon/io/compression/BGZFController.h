@@ -24,7 +24,16 @@ class BGZFController {
 		bool Inflate(buffer_type& input, buffer_type& output, const header_type& header) const;
 		bool Inflate(buffer_type& input, buffer_type& output) const;
 		U32 InflateSize(buffer_type& input) const;
-		bool InflateBlock(std::ifstream& stream, buffer_type& input);
+		bool InflateBlock(std::istream& stream, buffer_type& input);
+
+		/**<
+		 * Reads a complete BGZF block from the stream into the
+		 * input buffer without inflating it
+		 * @param stream Input stream
+		 * @param input  Destination buffer for the compressed block
+		 * @return       Returns TRUE upon success or FALSE otherwise
+		 */
+		bool ReadBlock(std::istream& stream, buffer_type& input) const;
 
 		friend std::ostream& operator<<(std::ostream& stream, const self_type& entry){
 			stream.write(entry.buffer.buffer, entry.buffer.size());
@@ -0,0 +1,129 @@
+#include <fstream>
+
+#include "BGZFControllerParallel.h"
+
+namespace tachyon {
+namespace io {
+
+BGZFControllerParallel::BGZFControllerParallel(const U32 n_threads, const U32 n_read_ahead) :
+	eof_(false),
+	error_(false),
+	n_threads_(n_threads == 0 ? 1 : n_threads),
+	n_slots_(n_read_ahead < this->n_threads_ ? this->n_threads_ : n_read_ahead),
+	head_(0),
+	n_loaded_(0),
+	offset_(0),
+	block_offset_(0),
+	slots_(new Slot[this->n_slots_]),
+	slaves_(new InflateSlave[this->n_threads_]),
+	tasks_(this->n_slots_),
+	profiler_(nullptr)
+{
+	for(U32 i = 0; i < this->n_threads_; ++i)
+		this->slaves_[i].Start(*this);
+}
+
+BGZFControllerParallel::~BGZFControllerParallel(){
+	this->tasks_.close();
+	for(U32 i = 0; i < this->n_threads_; ++i)
+		this->slaves_[i].thread.join();
+
+	delete [] this->slaves_;
+	delete [] this->slots_;
+}
+
+bool BGZFControllerParallel::readAhead(std::istream& stream){
+	while(this->n_loaded_ < this->n_slots_ && this->eof_ == false){
+		if(!stream.good()){
+			std::cerr << utility::timestamp("ERROR", "BGZF") << "Stream died!" << std::endl;
+			this->error_ = true;
+			return false;
+		}
+
+		if(stream.peek() == std::istream::traits_type::eof()){
+			this->eof_ = true;
+			break;
+		}
+
+		const U32 slot_id = (this->head_ + this->n_loaded_) % this->n_slots_;
+		Slot& slot = this->slots_[slot_id];
+		if(!this->controller_.ReadBlock(stream, slot.compressed)){
+			this->error_ = true;
+			return false;
+		}
+
+		slot.ready  = false;
+		slot.offset = this->offset_;
+		this->offset_ += slot.compressed.size();
+		++this->n_loaded_;
+		this->tasks_.push(slot_id);
+	}
+	return true;
+}
+
+void BGZFControllerParallel::inflate(const U32 slot_id){
+	Slot& slot = this->slots_[slot_id];
+	const U32 uncompressed_size = *reinterpret_cast<const U32*>(&slot.compressed[slot.compressed.size() - sizeof(U32)]);
+	slot.data.resize(uncompressed_size + 1);
+	slot.data.reset();
+
+	// Inflate is stateless: a new z_stream is used for each call
+	algorithm::Timer timer;
+	if(this->profiler_ != nullptr) timer.Start();
+	this->controller_.Inflate(slot.compressed, slot.data);
+	if(this->profiler_ != nullptr)
+		(*this->profiler_)[algorithm::YON_PROFILE_INFLATE].add(0, timer.ElapsedCPU(), slot.compressed.size(), slot.data.size(), 1);
+
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	slot.ready = true;
+	lock.unlock();
+	this->cv_ready_.notify_all();
+}
+
+bool BGZFControllerParallel::next(std::istream& stream, buffer_type& output){
+	if(!this->readAhead(stream))
+		return false;
+
+	if(this->n_loaded_ == 0)
+		return false;
+
+	Slot& slot = this->slots_[this->head_];
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	this->cv_ready_.wait(lock, [&slot]{ return(slot.ready); });
+	lock.unlock();
+
+	output.swap(slot.data);
+	slot.ready = false;
+	this->block_offset_ = slot.offset;
+	this->head_ = (this->head_ + 1) % this->n_slots_;
+	--this->n_loaded_;
+
+	// BGZF EOF marker
+	if(output.size() == 0){
+		this->eof_ = true;
+		return false;
+	}
+
+	// Keep the workers busy while the caller consumes this block
+	return(this->readAhead(stream));
+}
+
+void BGZFControllerParallel::reset(const U64 offset){
+	std::unique_lock<std::mutex> lock(this->mutex_);
+	for(U32 i = 0; i < this->n_loaded_; ++i){
+		Slot& slot = this->slots_[(this->head_ + i) % this->n_slots_];
+		this->cv_ready_.wait(lock, [&slot]{ return(slot.ready); });
+		slot.ready = false;
+	}
+	lock.unlock();
+
+	this->head_     = 0;
+	this->n_loaded_ = 0;
+	this->eof_      = false;
+	this->error_    = false;
+	this->offset_   = offset;
+	this->block_offset_ = offset;
+}
+
+} /* namespace IO */
+} /* namespace Tachyon */
@@ -0,0 +1,127 @@
+#ifndef IO_BGZFCONTROLLERPARALLEL_H_
+#define IO_BGZFCONTROLLERPARALLEL_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "BGZFController.h"
+#include "../../algorithm/bounded_queue.h"
+#include "../../algorithm/stage_profiler.h"
+
+namespace tachyon {
+namespace io {
+
+/**<
+ * Parallel BGZF decoder: compressed BGZF blocks are read ahead
+ * from the input stream on the calling thread and inflated
+ * independently on a pool of worker threads. Inflated blocks
+ * are handed back in stream order.
+ */
+class BGZFControllerParallel {
+private:
+	typedef BGZFControllerParallel self_type;
+	typedef io::BasicBuffer        buffer_type;
+	typedef BGZFController         controller_type;
+	typedef algorithm::BoundedQueue<U32> queue_type;
+
+	/**<
+	 * Read-ahead slot: holds one compressed block and
+	 * its inflated counterpart
+	 */
+	struct Slot{
+		Slot() : ready(false), offset(0){}
+
+		bool        ready;      // inflated data is available
+		U64         offset;     // offset of the compressed block in the stream
+		buffer_type compressed; // compressed BGZF block
+		buffer_type data;       // inflated data
+	};
+
+	/**<
+	 * Parallel support structure: this object encapsulates
+	 * a worker thread that inflates slots as they are submitted
+	 */
+	struct InflateSlave{
+		InflateSlave() : controller(nullptr){}
+		~InflateSlave(){}
+
+		std::thread* Start(self_type& controller){
+			this->controller = &controller;
+			this->thread = std::thread(&InflateSlave::Run_, this);
+			return(&this->thread);
+		}
+
+	private:
+		void Run_(void){
+			U32 slot_id = 0;
+			while(this->controller->tasks_.pop(slot_id))
+				this->controller->inflate(slot_id);
+		}
+
+	public:
+		self_type*  controller;
+		std::thread thread;
+	};
+
+public:
+	/**<
+	 * @param n_threads    Number of inflate worker threads
+	 * @param n_read_ahead Maximum number of blocks in flight
+	 */
+	BGZFControllerParallel(const U32 n_threads, const U32 n_read_ahead);
+	~BGZFControllerParallel();
+
+	/**<
+	 * Retrieve the next inflated BGZF block in stream order. Reads
+	 * ahead and submits up to `n_read_ahead` blocks for inflation.
+	 * The output buffer is swapped with the internal buffer so no
+	 * data is copied. The stream is read sequentially without seeking
+	 * such that pipes are supported.
+	 * @param stream   Input stream
+	 * @param output   Destination buffer
+	 * @return         Returns TRUE upon success or FALSE at EOF or if there was a problem
+	 */
+	bool next(std::istream& stream, buffer_type& output);
+
+	/**<
+	 * Discard all blocks read ahead such that the caller can seek
+	 * the stream. Waits for blocks that are being inflated.
+	 * @param offset Offset in the stream the next block is read from
+	 */
+	void reset(const U64 offset);
+
+	// Offset in the stream of the compressed block last returned
+	inline const U64& getBlockOffset(void) const{ return(this->block_offset_); }
+	inline const bool isEOF(void) const{ return(this->eof_); }
+	inline const bool isError(void) const{ return(this->error_); }
+
+	// Inflate workers add their CPU time and bytes to this profiler if set
+	inline void setProfiler(algorithm::StageProfiler* profiler){ this->profiler_ = profiler; }
+
+private:
+	bool readAhead(std::istream& stream);
+	void inflate(const U32 slot_id);
+
+private:
+	bool          eof_;       // no more compressed blocks in stream
+	bool          error_;
+	U32           n_threads_;
+	U32           n_slots_;
+	U32           head_;      // next slot to return
+	U32           n_loaded_;  // number of slots submitted but not returned
+	U64           offset_;    // offset in the stream of the next block to read
+	U64           block_offset_; // offset in the stream of the block last returned
+	Slot*         slots_;
+	InflateSlave* slaves_;
+	controller_type controller_;
+	queue_type    tasks_;
+	std::mutex    mutex_;
+	std::condition_variable cv_ready_;
+	algorithm::StageProfiler* profiler_;
+};
+
+} /* namespace IO */
+} /* namespace Tachyon */
+
+#endif /* IO_BGZFCONTROLLERPARALLEL_H_ */
@@ -0,0 +1,99 @@
+#ifndef IO_MAPPED_FILE_H_
+#define IO_MAPPED_FILE_H_
+
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../support/type_definitions.h"
+
+namespace tachyon{
+namespace io{
+
+/**<
+ * Read-only memory mapping of an entire file. Containers of a
+ * block are loaded by pointing their buffers at the mapped pages
+ * rather than copying them through a file stream.
+ */
+class MappedFile{
+private:
+	typedef MappedFile self_type;
+
+public:
+	MappedFile() : fd_(-1), size_(0), data_(nullptr){}
+	~MappedFile(){ this->close(); }
+
+	/**<
+	 * Map the entire file into memory. Any existing mapping is
+	 * released first.
+	 * @param filename Target file
+	 * @return         Returns TRUE upon success or FALSE otherwise
+	 */
+	bool open(const std::string& filename){
+		this->close();
+
+		this->fd_ = ::open(filename.c_str(), O_RDONLY);
+		if(this->fd_ < 0)
+			return false;
+
+		struct stat file_stats;
+		if(fstat(this->fd_, &file_stats) != 0 || file_stats.st_size == 0){
+			this->close();
+			return false;
+		}
+
+		void* mapping = mmap(nullptr, file_stats.st_size, PROT_READ, MAP_PRIVATE, this->fd_, 0);
+		if(mapping == MAP_FAILED){
+			this->close();
+			return false;
+		}
+
+		this->data_ = reinterpret_cast<const char*>(mapping);
+		this->size_ = file_stats.st_size;
+		return true;
+	}
+
+	void close(void){
+		if(this->data_ != nullptr)
+			munmap(const_cast<char*>(this->data_), this->size_);
+
+		if(this->fd_ >= 0)
+			::close(this->fd_);
+
+		this->fd_   = -1;
+		this->size_ = 0;
+		this->data_ = nullptr;
+	}
+
+	inline const bool good(void) const{ return(this->data_ != nullptr); }
+	inline const U64& size(void) const{ return(this->size_); }
+	inline const char* data(void) const{ return(this->data_); }
+
+	/**<
+	 * Check that the range [offset, offset + length) lies within
+	 * the mapped file
+	 * @param offset Start of the range
+	 * @param length Length of the range in bytes
+	 * @return       Returns TRUE if the range is mapped or FALSE otherwise
+	 */
+	inline const bool contains(const U64 offset, const U64 length) const{
+		return(offset <= this->size_ && length <= this->size_ - offset);
+	}
+
+private:
+	// A mapping is owned by a single object
+	MappedFile(const self_type& other);
+	self_type& operator=(const self_type& other);
+
+private:
+	int         fd_;
+	U64         size_;
+	const char* data_;
+};
+
+}
+}
+
+#endif /* IO_MAPPED_FILE_H_ */
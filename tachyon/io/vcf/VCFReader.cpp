@@ -0,0 +1,438 @@
+#include <map>
+
+#include "VCFReader.h"
+
+namespace tachyon {
+namespace vcf{
+
+VCFReader::VCFReader() :
+	filesize(0),
+	map_gt_id(-1),
+	n_parse_threads(1),
+	state(vcf_reader_state::VCF_INIT),
+	n_entries(0),
+	n_capacity(0),
+	entries(nullptr),
+	b_data_read(0),
+	profiler(nullptr),
+	file(nullptr),
+	buffer(YON_VCF_READ_CHUNK_SIZE + 1),
+	buffer_pointer(0),
+	converters(nullptr),
+	t_inflate_wall(0),
+	t_inflate_cpu(0)
+{}
+
+VCFReader::VCFReader(const std::string& file_name) :
+	file_name(file_name),
+	filesize(0),
+	map_gt_id(-1),
+	n_parse_threads(1),
+	state(vcf_reader_state::VCF_INIT),
+	n_entries(0),
+	n_capacity(0),
+	entries(nullptr),
+	b_data_read(0),
+	profiler(nullptr),
+	file(nullptr),
+	buffer(YON_VCF_READ_CHUNK_SIZE + 1),
+	buffer_pointer(0),
+	converters(nullptr),
+	t_inflate_wall(0),
+	t_inflate_cpu(0)
+{}
+
+VCFReader::~VCFReader(){
+	if(this->entries != nullptr){
+		for(std::size_t i = 0; i < this->n_capacity; ++i)
+			((this->entries + i)->~BCFEntry());
+
+		::operator delete[](static_cast<void*>(this->entries));
+	}
+
+	if(this->file != nullptr)
+		gzclose(this->file);
+
+	delete [] this->converters;
+}
+
+bool VCFReader::open(const std::string input){
+	this->file_name = input;
+	return(this->open());
+}
+
+bool VCFReader::open(void){
+	if(this->file_name.size() == 0)
+		return false;
+
+	std::ifstream temp(this->file_name, std::ios::binary | std::ios::in | std::ios::ate);
+	if(!temp.good()){
+		std::cerr << utility::timestamp("ERROR", "VCF") << "Failed to open file: " << this->file_name << std::endl;
+		return false;
+	}
+	this->filesize = temp.tellg();
+	temp.close();
+
+	// zlib reads uncompressed files transparently
+	this->file = gzopen(this->file_name.c_str(), "rb");
+	if(this->file == nullptr){
+		std::cerr << utility::timestamp("ERROR", "VCF") << "Failed to open file: " << this->file_name << std::endl;
+		return false;
+	}
+	gzbuffer(this->file, 131072);
+
+	if(!this->parseHeader()){
+		std::cerr << utility::timestamp("ERROR","VCF") << "Failed to parse header!" << std::endl;
+		this->state = vcf_reader_state::VCF_ERROR;
+		return false;
+	}
+
+	delete [] this->converters;
+	this->converters = new converter_type[this->n_parse_threads];
+	for(U32 i = 0; i < this->n_parse_threads; ++i)
+		this->converters[i].setHeader(this->header);
+
+	this->state = vcf_reader_state::VCF_OK;
+	return true;
+}
+
+bool VCFReader::nextChunk(void){
+	if(this->buffer.size() + YON_VCF_READ_CHUNK_SIZE + 1 > this->buffer.capacity())
+		this->buffer.resize(this->buffer.size() + YON_VCF_READ_CHUNK_SIZE + 1);
+
+	algorithm::Timer timer;
+	z_off_t offset = 0;
+	if(this->profiler != nullptr){
+		timer.Start();
+		offset = gzoffset(this->file);
+	}
+
+	const int n_read = gzread(this->file, &this->buffer[this->buffer.size()], YON_VCF_READ_CHUNK_SIZE);
+
+	if(this->profiler != nullptr && n_read > 0){
+		const double wall = timer.Elapsed().count();
+		const double cpu  = timer.ElapsedCPU();
+		(*this->profiler)[algorithm::YON_PROFILE_INFLATE].add(wall, cpu, gzoffset(this->file) - offset, n_read, 1);
+		this->t_inflate_wall += wall;
+		this->t_inflate_cpu  += cpu;
+	}
+
+	if(n_read < 0){
+		int error_number = 0;
+		std::cerr << utility::timestamp("ERROR", "VCF") << "Stream died: " << gzerror(this->file, &error_number) << std::endl;
+		this->state = vcf_reader_state::VCF_STREAM_ERROR;
+		return false;
+	}
+
+	this->buffer.n_chars += n_read;
+	return(n_read > 0);
+}
+
+bool VCFReader::nextLine(U32& position, U32& length){
+	U32 scanned = position;
+	while(true){
+		const char* newline = (const char*)memchr(&this->buffer[scanned], '\n', this->buffer.size() - scanned);
+		if(newline != nullptr){
+			length = newline - &this->buffer[position];
+			return true;
+		}
+
+		scanned = this->buffer.size();
+		if(!this->nextChunk()){
+			if(this->state == vcf_reader_state::VCF_STREAM_ERROR)
+				return false;
+
+			// The last line is not terminated by a newline
+			if(position < this->buffer.size()){
+				this->buffer += '\n';
+				continue;
+			}
+			return false;
+		}
+	}
+}
+
+bool VCFReader::parseHeader(void){
+	std::vector<std::string> header_lines;
+	std::string column_line;
+	U32 length = 0;
+	while(true){
+		if(!this->nextLine(this->buffer_pointer, length)){
+			std::cerr << utility::timestamp("ERROR", "VCF") << "Truncated header: no #CHROM line found..." << std::endl;
+			return false;
+		}
+
+		std::string line(&this->buffer[this->buffer_pointer], length);
+		this->buffer_pointer += length + 1;
+		if(line.size() && line.back() == '\r') line.pop_back();
+
+		if(line.size() >= 2 && line[0] == '#' && line[1] == '#'){
+			header_lines.push_back(line);
+			continue;
+		}
+
+		if(line.size() && line[0] == '#'){
+			column_line = line;
+			break;
+		}
+
+		std::cerr << utility::timestamp("ERROR", "VCF") << "Header is not terminated by a #CHROM line..." << std::endl;
+		return false;
+	}
+
+	if(header_lines.size() == 0){
+		std::cerr << utility::timestamp("ERROR", "VCF") << "Missing ##fileformat line..." << std::endl;
+		return false;
+	}
+
+	// FILTER, INFO, and FORMAT fields share a dictionary where
+	// PASS is the first entry. Lines without an IDX are assigned
+	// the next free index in order of appearance
+	const std::string structured[3] = {"##FILTER=<", "##INFO=<", "##FORMAT=<"};
+	std::vector<std::string> line_ids(header_lines.size());
+	std::vector<bool> has_idx(header_lines.size(), false);
+	std::map<std::string, S32> ids;
+	std::vector<bool> used;
+	bool has_pass = false;
+
+	for(U32 i = 0; i < header_lines.size(); ++i){
+		const std::string& line = header_lines[i];
+		U32 type = 0;
+		for(; type < 3; ++type)
+			if(line.compare(0, structured[type].size(), structured[type]) == 0) break;
+		if(type == 3) continue;
+
+		const size_t id_start = line.find("ID=");
+		if(id_start == std::string::npos){
+			std::cerr << utility::timestamp("ERROR", "VCF") << "Header line without ID: " << line << std::endl;
+			return false;
+		}
+		const size_t id_end = line.find_first_of(",>", id_start + 3);
+		line_ids[i] = line.substr(id_start + 3, id_end - (id_start + 3));
+		if(type == 0 && line_ids[i] == "PASS") has_pass = true;
+
+		const size_t idx_start = line.find(",IDX=");
+		if(idx_start != std::string::npos){
+			const S32 idx = atoi(&line[idx_start + 5]);
+			ids[line_ids[i]] = idx;
+			has_idx[i] = true;
+			if(idx >= (S32)used.size()) used.resize(idx + 1, false);
+			used[idx] = true;
+		}
+	}
+
+	if(ids.find("PASS") == ids.end()){
+		S32 idx = 0;
+		while(idx < (S32)used.size() && used[idx]) ++idx;
+		ids["PASS"] = idx;
+		if(idx >= (S32)used.size()) used.resize(idx + 1, false);
+		used[idx] = true;
+	}
+
+	S32 next_idx = used.size();
+	for(U32 i = 0; i < header_lines.size(); ++i){
+		if(line_ids[i].size() == 0 || has_idx[i]) continue;
+		if(ids.find(line_ids[i]) == ids.end())
+			ids[line_ids[i]] = next_idx++;
+
+		const size_t end = header_lines[i].rfind('>');
+		if(end == std::string::npos){
+			std::cerr << utility::timestamp("ERROR", "VCF") << "Malformed header line: " << header_lines[i] << std::endl;
+			return false;
+		}
+		header_lines[i].insert(end, ",IDX=" + std::to_string(ids[line_ids[i]]));
+	}
+
+	if(has_pass == false)
+		header_lines.insert(header_lines.begin() + 1, "##FILTER=<ID=PASS,Description=\"All filters passed\",IDX=" + std::to_string(ids["PASS"]) + ">");
+
+	// Header text in BCF layout: length prefix followed
+	// by the NUL-terminated text
+	buffer_type header_buffer(this->buffer_pointer + 65536);
+	header_buffer += (U32)0;
+	for(U32 i = 0; i < header_lines.size(); ++i){
+		header_buffer += header_lines[i];
+		header_buffer += '\n';
+	}
+	header_buffer += column_line;
+	header_buffer += '\n';
+	header_buffer += '\0';
+	*reinterpret_cast<U32*>(&header_buffer[0]) = header_buffer.size() - sizeof(U32);
+
+	if(!this->header.parse(&header_buffer[0], header_buffer.size()))
+		return false;
+
+	return true;
+}
+
+void VCFReader::reserve(const size_type n_entries){
+	if(n_entries <= this->n_capacity)
+		return;
+
+	// Entries are recycled: every slot in the array holds a
+	// constructed entry whose buffer is reused by the converter
+	pointer temp = static_cast<pointer>(::operator new[](n_entries*sizeof(value_type)));
+	for(std::size_t i = 0; i < this->n_capacity; ++i){
+		new( &temp[i] ) value_type( std::move(this->entries[i]) );
+		((this->entries + i)->~BCFEntry());
+	}
+	for(std::size_t i = this->n_capacity; i < n_entries; ++i)
+		new( &temp[i] ) value_type( );
+
+	::operator delete[](static_cast<void*>(this->entries));
+	this->entries    = temp;
+	this->n_capacity = n_entries;
+}
+
+bool VCFReader::getVariants(const U32 n_variants, const double bp_window, bool across_contigs){
+	if(this->profiler == nullptr)
+		return(this->loadVariants(n_variants, bp_window, across_contigs));
+
+	// Reading the text is interleaved with splitting lines: the
+	// inflate time is accounted for separately
+	algorithm::Timer timer;
+	timer.Start();
+	this->t_inflate_wall = 0;
+	this->t_inflate_cpu  = 0;
+
+	const bool loaded = this->loadVariants(n_variants, bp_window, across_contigs);
+
+	U64 b_lines = 0;
+	for(U32 i = 0; i < this->lines.size(); ++i) b_lines += this->lines[i].length + 1;
+	(*this->profiler)[algorithm::YON_PROFILE_PARSE].add(timer.Elapsed().count() - this->t_inflate_wall, timer.ElapsedCPU() - this->t_inflate_cpu, b_lines, 0, this->size());
+	return(loaded);
+}
+
+bool VCFReader::loadVariants(const U32 n_variants, const double bp_window, bool across_contigs){
+	this->n_entries = 0;
+	this->reserve(n_variants + 1);
+
+	if(this->state != vcf_reader_state::VCF_OK)
+		return false;
+
+	// Discard consumed data
+	if(this->buffer_pointer){
+		memmove(&this->buffer[0], &this->buffer[this->buffer_pointer], this->buffer.size() - this->buffer_pointer);
+		this->buffer.n_chars -= this->buffer_pointer;
+		this->buffer_pointer = 0;
+	}
+
+	// Split lines and assign contigs. A line on another
+	// contig is left in the buffer for the next batch
+	this->lines.clear();
+	S64 firstPos    = 0;
+	S32 firstContig = -1;
+	U32 position    = 0;
+	U32 length      = 0;
+	std::string contig_name;
+	while(this->lines.size() < n_variants){
+		if(!this->nextLine(position, length)){
+			if(this->state == vcf_reader_state::VCF_STREAM_ERROR)
+				return false;
+
+			this->state = vcf_reader_state::VCF_EOF;
+			break;
+		}
+
+		const char* const line = &this->buffer[position];
+		const U32 line_length  = (length && line[length - 1] == '\r') ? length - 1 : length;
+		if(line_length == 0){
+			position += length + 1;
+			continue;
+		}
+
+		const char* const tab = (const char*)memchr(line, '\t', line_length);
+		if(tab == nullptr){
+			std::cerr << utility::timestamp("ERROR","VCF") << "Malformed VCF line: " << std::string(line, line_length < 100 ? line_length : 100) << std::endl;
+			this->state = vcf_reader_state::VCF_ERROR;
+			return false;
+		}
+
+		contig_name.assign(line, tab - line);
+		S32* contig_id = nullptr;
+		if(!this->header.getContig(contig_name, contig_id)){
+			std::cerr << utility::timestamp("ERROR","VCF") << "Contig \"" << contig_name << "\" is not declared in the header..." << std::endl;
+			this->state = vcf_reader_state::VCF_ERROR;
+			return false;
+		}
+		const S64 variant_position = strtoll(tab + 1, nullptr, 10) - 1;
+
+		if(this->lines.size() == 0){
+			firstPos    = variant_position;
+			firstContig = *contig_id;
+		}
+
+		// Make sure that data does not span over
+		// multiple CHROM fields
+		if(!across_contigs && *contig_id != firstContig)
+			break;
+
+		this->lines.push_back(Line(position, line_length, *contig_id));
+		position += length + 1;
+
+		// Check break condition for window
+		if(variant_position - firstPos > bp_window)
+			break;
+	}
+	this->b_data_read   += position;
+	this->buffer_pointer = position;
+
+	if(this->lines.size() == 0)
+		return false;
+
+	// Convert lines in parallel
+	U32 n_threads = this->lines.size() / YON_VCF_THREAD_LINES;
+	if(n_threads > this->n_parse_threads) n_threads = this->n_parse_threads;
+	if(n_threads == 0) n_threads = 1;
+
+	this->thread_status.assign(n_threads, true);
+	const U32 lines_thread = this->lines.size() / n_threads;
+	std::vector<std::thread> threads;
+	for(U32 i = 1; i < n_threads; ++i)
+		threads.push_back(std::thread(&self_type::convertLines, this, i, i*lines_thread, (i + 1 == n_threads ? this->lines.size() : (i + 1)*lines_thread)));
+	this->convertLines(0, 0, (n_threads == 1 ? this->lines.size() : lines_thread));
+	for(U32 i = 0; i < threads.size(); ++i) threads[i].join();
+
+	this->n_entries = this->lines.size();
+	for(U32 i = 0; i < n_threads; ++i){
+		if(this->thread_status[i] == false){
+			this->state = vcf_reader_state::VCF_ERROR;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VCFReader::convertLines(const U32 thread, const U32 from, const U32 to){
+	// Thread 0 is the calling thread and is timed by getVariants()
+	algorithm::Timer timer;
+	if(this->profiler != nullptr && thread != 0) timer.Start();
+
+	converter_type& converter = this->converters[thread];
+	for(U32 i = from; i < to; ++i){
+		if(this->thread_status[thread] == false)
+			continue;
+
+		const Line& line = this->lines[i];
+		if(!converter.convert(&this->buffer[line.offset], line.length, line.contig_id, this->map_gt_id, this->entries[i]))
+			this->thread_status[thread] = false;
+	}
+
+	if(this->profiler != nullptr && thread != 0)
+		(*this->profiler)[algorithm::YON_PROFILE_PARSE].addCPU(timer.ElapsedCPU());
+}
+
+void VCFReader::transferEntries(bcf_reader_type& other){
+	// The entries held by the destination have already been
+	// consumed and are recycled by this reader
+	other.n_carry_over = 0;
+
+	std::swap(this->entries,    other.entries);
+	std::swap(this->n_capacity, other.n_capacity);
+	other.n_entries = this->n_entries;
+	this->n_entries = 0;
+}
+
+}
+}
@@ -0,0 +1,193 @@
+#ifndef VCF_VCFREADER_H_
+#define VCF_VCFREADER_H_
+
+#include <thread>
+
+#include "../../third_party/zlib/zconf.h"
+#include "../../third_party/zlib/zlib.h"
+#include "VCFRecordConverter.h"
+#include "../bcf/BCFReader.h"
+#include "../../algorithm/stage_profiler.h"
+
+namespace tachyon {
+namespace vcf{
+
+/**< Number of bytes requested from zlib for each read */
+#define YON_VCF_READ_CHUNK_SIZE 4194304
+/**< Minimum number of lines converted by each thread */
+#define YON_VCF_THREAD_LINES    16
+
+/**<
+ * Reader for VCF text files that are either uncompressed or
+ * gzip/bgzip compressed. Lines are split and assigned to contigs
+ * in the calling thread and are then converted into BCF entries
+ * in parallel. The resulting entries are identical to the ones
+ * produced by BCFReader and can be handed off to the import
+ * pipeline through transferEntries().
+ *
+ * All contigs, FILTER, INFO, and FORMAT fields have to be declared
+ * in the header. FILTER, INFO, and FORMAT header lines without an
+ * IDX field are assigned one in the order they appear as BCF does.
+ */
+class VCFReader{
+private:
+	typedef VCFReader          self_type;
+	typedef bcf::BCFEntry      value_type;
+	typedef value_type&        reference;
+	typedef const value_type&  const_reference;
+	typedef value_type*        pointer;
+	typedef const value_type*  const_pointer;
+	typedef std::size_t        size_type;
+	typedef io::BasicBuffer    buffer_type;
+	typedef VCFHeader          header_type;
+	typedef VCFRecordConverter converter_type;
+	typedef bcf::BCFReader     bcf_reader_type;
+
+	/**<
+	 * Location of an unparsed line in the text buffer
+	 */
+	struct Line{
+		Line(const U32 offset, const U32 length, const S32 contig_id) : offset(offset), length(length), contig_id(contig_id){}
+
+		U32 offset;
+		U32 length;
+		S32 contig_id;
+	};
+
+public:
+	enum vcf_reader_state{VCF_INIT, VCF_OK, VCF_ERROR, VCF_EOF, VCF_STREAM_ERROR};
+
+public:
+	VCFReader();
+	VCFReader(const std::string& file_name);
+	~VCFReader();
+
+	// Element access
+	inline reference operator[](const size_type& position){ return(this->entries[position]); }
+	inline const_reference operator[](const size_type& position) const{ return(this->entries[position]); }
+	inline reference front(void){ return(this->entries[0]); }
+	inline const_reference front(void) const{ return(this->entries[0]); }
+	inline reference back(void){ return(this->entries[this->n_entries - 1]); }
+	inline const_reference back(void) const{ return(this->entries[this->n_entries - 1]); }
+
+	// Capacity
+	inline const bool empty(void) const{ return(this->n_entries == 0); }
+	inline const size_type& size(void) const{ return(this->n_entries); }
+	inline const size_type& capacity(void) const{ return(this->n_capacity); }
+
+	/**<
+	 * Attempts to open a target input file and parse the VCF
+	 * header
+	 * @param input Input target VCF file
+	 * @return      Returns TRUE upon success or FALSE otherwise
+	 */
+	bool open(const std::string input);
+	bool open(void);
+
+	/**<
+	 * Attempts to load either `n_variants` number of variants or
+	 * variants covering >= `bp_window` base pairs. Semantics are
+	 * identical to BCFReader::getVariants().
+	 * @param n_variants     Number of variants
+	 * @param bp_window      Non-overlapping window size in base-pairs
+	 * @param across_contigs Allow the algorithm to span over two or more different chromosomes
+	 * @return               Returns TRUE upon success or FALSE otherwise
+	 */
+	bool getVariants(const U32 n_variants, const double bp_window, bool across_contigs = false);
+
+	/**<
+	 * Moves the currently loaded variants into the `other` BCF
+	 * reader object acting as a container by swapping the
+	 * underlying entry arrays. The entries previously held by
+	 * `other` are recycled by this reader.
+	 * @param other Destination reader object
+	 */
+	void transferEntries(bcf_reader_type& other);
+
+	/**<
+	 * Make sure there are at least `n_entries` entries available.
+	 * Entries are constructed once and recycled between batches.
+	 * @param n_entries Number of entries
+	 */
+	void reserve(const size_type n_entries);
+
+	/**<
+	 * Set the number of threads used to convert VCF lines
+	 * into BCF entries. Has to be set before opening the file.
+	 * @param n_threads Number of threads
+	 */
+	inline void setParseThreads(const U32 n_threads){ this->n_parse_threads = (n_threads == 0 ? 1 : n_threads); }
+
+	/**<
+	 * Set a profiler receiving the inflate and parse times.
+	 * @param profiler Target profiler or nullptr to disable profiling
+	 */
+	inline void setProfiler(algorithm::StageProfiler* profiler){ this->profiler = profiler; }
+
+	inline const bool good(void) const{ return(this->state != VCF_ERROR && this->state != VCF_STREAM_ERROR); }
+
+	// Fraction of the input file that has been consumed
+	inline const double getProgress(void) const{
+		if(this->filesize == 0 || this->file == nullptr) return(0);
+		return((double)gzoffset(this->file) / this->filesize);
+	}
+
+private:
+	/**<
+	 * Appends another chunk of data from the file to the
+	 * text buffer.
+	 * @return Returns TRUE if any data was added or FALSE otherwise
+	 */
+	bool nextChunk(void);
+
+	/**<
+	 * Finds the next complete line in the text buffer starting
+	 * at `position`. A missing final newline is added at the end
+	 * of the file.
+	 * @param position Offset of the line in the buffer
+	 * @param length   Length of the line excluding the newline
+	 * @return         Returns TRUE if a line is available or FALSE otherwise
+	 */
+	bool nextLine(U32& position, U32& length);
+
+	/**<
+	 * Reads the header lines and parses them. FILTER, INFO, and
+	 * FORMAT lines are assigned an IDX if they do not have one.
+	 * @return Returns TRUE upon success or FALSE otherwise
+	 */
+	bool parseHeader(void);
+
+	// Convert the lines assigned to a thread
+	void convertLines(const U32 thread, const U32 from, const U32 to);
+
+	// Implementation of getVariants() without profiling
+	bool loadVariants(const U32 n_variants, const double bp_window, bool across_contigs);
+
+public:
+	std::string      file_name;
+	U64              filesize;
+	S32              map_gt_id;
+	U32              n_parse_threads;
+	header_type      header;
+	vcf_reader_state state;
+	size_type        n_entries;
+	size_type        n_capacity;
+	pointer          entries;
+	U64              b_data_read;
+	algorithm::StageProfiler* profiler;
+
+private:
+	gzFile             file;
+	buffer_type        buffer;          // text data read from the file
+	U32                buffer_pointer;  // start of unconsumed data in the buffer
+	std::vector<Line>  lines;           // lines loaded by getVariants()
+	std::vector<BYTE>  thread_status;   // conversion success of each thread
+	converter_type*    converters;      // one converter per thread
+	double             t_inflate_wall;  // inflate time spent in the current getVariants() call
+	double             t_inflate_cpu;
+};
+
+}
+}
+
+#endif /* VCF_VCFREADER_H_ */
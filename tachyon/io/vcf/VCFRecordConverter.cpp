@@ -0,0 +1,522 @@
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+
+#include "VCFRecordConverter.h"
+
+namespace tachyon {
+namespace vcf{
+
+// Integer sentinels as returned by BCFEntry::getInteger
+const S32 VCF_INTEGER_MISSING = 0x80000000;
+const S32 VCF_INTEGER_EOV     = 0x80000001;
+// Float sentinels as defined in the BCF specification
+const U32 VCF_FLOAT_MISSING   = 0x7F800001;
+const U32 VCF_FLOAT_EOV       = 0x7F800002;
+
+/**<
+ * Parse a signed integer in [data, end). Values that do not fit
+ * in a S32 are clamped to the largest representable values that
+ * are not reserved by BCF
+ */
+static S32 parseInteger(const char* data, const char* const end){
+	bool negative = false;
+	if(data != end && (*data == '-' || *data == '+')){
+		negative = (*data == '-');
+		++data;
+	}
+
+	S64 value = 0;
+	for(; data != end && *data >= '0' && *data <= '9'; ++data){
+		value = value * 10 + (*data - '0');
+		if(value > std::numeric_limits<S32>::max()) value = std::numeric_limits<S32>::max();
+	}
+	if(negative){
+		value = -value;
+		if(value < std::numeric_limits<S32>::min() + 8) value = std::numeric_limits<S32>::min() + 8;
+	}
+	return(value);
+}
+
+static inline float floatFromBits(const U32 bits){
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return(value);
+}
+
+VCFRecordConverter::VCFRecordConverter() :
+	n_samples_(0),
+	info_table_(nullptr),
+	format_table_(nullptr),
+	filter_table_(nullptr),
+	shared_(65536),
+	indiv_(65536),
+	n_filter_(0),
+	n_info_(0),
+	n_fmt_(0)
+{
+}
+
+VCFRecordConverter::~VCFRecordConverter(){
+	delete this->info_table_;
+	delete this->format_table_;
+	delete this->filter_table_;
+}
+
+void VCFRecordConverter::setHeader(const header_type& header){
+	this->n_samples_     = header.samples;
+	this->info_fields_   = header.info_map;
+	this->format_fields_ = header.format_map;
+	this->filter_fields_ = header.filter_map;
+
+	hash_table_type** tables[3] = {&this->info_table_, &this->format_table_, &this->filter_table_};
+	const std::vector<map_entry_type>* fields[3] = {&this->info_fields_, &this->format_fields_, &this->filter_fields_};
+	for(U32 i = 0; i < 3; ++i){
+		delete *tables[i];
+		*tables[i] = new hash_table_type(fields[i]->size() * 2 < 1024 ? 1024 : fields[i]->size() * 2);
+		for(U32 j = 0; j < fields[i]->size(); ++j){
+			const std::string& id = (*fields[i])[j].ID;
+			(*tables[i])->SetItem(&id[0], &id, j, id.size());
+		}
+	}
+}
+
+const VCFRecordConverter::map_entry_type* VCFRecordConverter::getField(const hash_table_type* table, const std::vector<map_entry_type>& fields, const Token& key){
+	this->key_.assign(key.data, key.length);
+	S32* position = nullptr;
+	if(this->key_.size() == 0 || !table->GetItem(&this->key_[0], &this->key_, position, this->key_.size()))
+		return(nullptr);
+
+	return(&fields[*position]);
+}
+
+void VCFRecordConverter::addTypedSize(buffer_type& buffer, const U32 n_values, const BYTE type){
+	if(n_values < 15){
+		buffer += (BYTE)((n_values << 4) | type);
+	} else {
+		buffer += (BYTE)((15 << 4) | type);
+		this->addTypedInteger(buffer, n_values);
+	}
+}
+
+void VCFRecordConverter::addTypedInteger(buffer_type& buffer, const S32 value){
+	if(value >= -120 && value <= 127){
+		buffer += (BYTE)((1 << 4) | bcf::BCF_BYTE);
+		buffer += (BYTE)value;
+	} else if(value >= -32760 && value <= 32767){
+		buffer += (BYTE)((1 << 4) | bcf::BCF_U16);
+		buffer += (U16)value;
+	} else {
+		buffer += (BYTE)((1 << 4) | bcf::BCF_U32);
+		buffer += (U32)value;
+	}
+}
+
+void VCFRecordConverter::addTypedString(buffer_type& buffer, const char* const data, const U32 length){
+	this->addTypedSize(buffer, length, bcf::BCF_CHAR);
+	if(length) buffer.Add(data, length);
+}
+
+void VCFRecordConverter::addIntegers(buffer_type& buffer, const S32* values, const U32 n_values, const U32 stride){
+	// Smallest primitive that fits all values: the lowest
+	// values of each primitive are reserved by BCF
+	S32 min = std::numeric_limits<S32>::max();
+	S32 max = std::numeric_limits<S32>::min();
+	for(U32 i = 0; i < n_values; ++i){
+		if(values[i] == VCF_INTEGER_MISSING || values[i] == VCF_INTEGER_EOV) continue;
+		if(values[i] < min) min = values[i];
+		if(values[i] > max) max = values[i];
+	}
+
+	BYTE type = bcf::BCF_BYTE;
+	if(min <= max){
+		if(min >= -120 && max <= 127)          type = bcf::BCF_BYTE;
+		else if(min >= -32760 && max <= 32767) type = bcf::BCF_U16;
+		else                                   type = bcf::BCF_U32;
+	}
+
+	this->addTypedSize(buffer, stride, type);
+	if(type == bcf::BCF_BYTE){
+		for(U32 i = 0; i < n_values; ++i){
+			if(values[i] == VCF_INTEGER_MISSING)  buffer += (BYTE)0x80;
+			else if(values[i] == VCF_INTEGER_EOV) buffer += (BYTE)0x81;
+			else buffer += (BYTE)values[i];
+		}
+	} else if(type == bcf::BCF_U16){
+		for(U32 i = 0; i < n_values; ++i){
+			if(values[i] == VCF_INTEGER_MISSING)  buffer += (U16)0x8000;
+			else if(values[i] == VCF_INTEGER_EOV) buffer += (U16)0x8001;
+			else buffer += (U16)values[i];
+		}
+	} else {
+		for(U32 i = 0; i < n_values; ++i)
+			buffer += (U32)values[i];
+	}
+}
+
+void VCFRecordConverter::addFloats(buffer_type& buffer, const float* values, const U32 n_values, const U32 stride){
+	this->addTypedSize(buffer, stride, bcf::BCF_FLOAT);
+	buffer.Add(reinterpret_cast<const char*>(values), n_values*sizeof(float));
+}
+
+void VCFRecordConverter::parseIntegers(const Token& token, std::vector<S32>& values){
+	values.clear();
+	const char* const end = token.data + token.length;
+	const char* data = token.data;
+	while(true){
+		const char* next = (const char*)memchr(data, ',', end - data);
+		if(next == nullptr) next = end;
+
+		if(next - data == 0 || (next - data == 1 && *data == '.')) values.push_back(VCF_INTEGER_MISSING);
+		else values.push_back(parseInteger(data, next));
+
+		if(next == end) break;
+		data = next + 1;
+	}
+}
+
+void VCFRecordConverter::parseFloats(const Token& token, std::vector<float>& values){
+	values.clear();
+	const char* const end = token.data + token.length;
+	const char* data = token.data;
+	while(true){
+		const char* next = (const char*)memchr(data, ',', end - data);
+		if(next == nullptr) next = end;
+
+		if(next - data == 0 || (next - data == 1 && *data == '.')) values.push_back(floatFromBits(VCF_FLOAT_MISSING));
+		else values.push_back(strtof(data, nullptr));
+
+		if(next == end) break;
+		data = next + 1;
+	}
+}
+
+bool VCFRecordConverter::addFilter(const Token& token){
+	if(token.isMissing()){
+		this->shared_ += (BYTE)0;
+		return true;
+	}
+
+	this->integers_.clear();
+	const char* const end = token.data + token.length;
+	const char* data = token.data;
+	while(true){
+		const char* next = (const char*)memchr(data, ';', end - data);
+		if(next == nullptr) next = end;
+
+		const map_entry_type* field = this->getField(this->filter_table_, this->filter_fields_, Token(data, next - data));
+		if(field == nullptr){
+			std::cerr << utility::timestamp("ERROR","VCF") << "FILTER field \"" << std::string(data, next - data) << "\" is not declared in the header..." << std::endl;
+			return false;
+		}
+		this->integers_.push_back(field->IDX);
+
+		if(next == end) break;
+		data = next + 1;
+	}
+
+	this->n_filter_ = this->integers_.size();
+	this->addIntegers(this->shared_, &this->integers_[0], this->integers_.size(), this->integers_.size());
+	return true;
+}
+
+bool VCFRecordConverter::addInfo(const Token& token, const S32 position, S32& rlen){
+	if(token.isMissing())
+		return true;
+
+	const char* const end = token.data + token.length;
+	const char* data = token.data;
+	while(true){
+		const char* next = (const char*)memchr(data, ';', end - data);
+		if(next == nullptr) next = end;
+
+		// Empty entries (e.g. trailing semicolons) are skipped
+		if(next != data){
+			const char* equals = (const char*)memchr(data, '=', next - data);
+			const Token key(data, (equals == nullptr ? next : equals) - data);
+			const Token value = (equals == nullptr ? Token() : Token(equals + 1, next - (equals + 1)));
+
+			const map_entry_type* field = this->getField(this->info_table_, this->info_fields_, key);
+			if(field == nullptr){
+				std::cerr << utility::timestamp("ERROR","VCF") << "INFO field \"" << this->key_ << "\" is not declared in the header..." << std::endl;
+				return false;
+			}
+
+			this->addTypedInteger(this->shared_, field->IDX);
+			switch(field->primitive_type){
+			case(0): // Integer
+				this->parseIntegers(value, this->integers_);
+				this->addIntegers(this->shared_, &this->integers_[0], this->integers_.size(), this->integers_.size());
+				// Reference length is given by END
+				if(this->key_ == "END" && this->integers_[0] != VCF_INTEGER_MISSING)
+					rlen = this->integers_[0] - position;
+				break;
+			case(1): // Float
+				this->parseFloats(value, this->floats_);
+				this->addFloats(this->shared_, &this->floats_[0], this->floats_.size(), this->floats_.size());
+				break;
+			case(2): // Flag
+				this->shared_ += (BYTE)0;
+				break;
+			default: // Character and String
+				this->addTypedString(this->shared_, value.data, value.length);
+				break;
+			}
+			++this->n_info_;
+		}
+
+		if(next == end) break;
+		data = next + 1;
+	}
+	return true;
+}
+
+bool VCFRecordConverter::addFormat(const Token& keys, const char* samples, const char* const end, const S32 map_gt_id){
+	// FORMAT keys
+	this->format_keys_.clear();
+	const char* data = keys.data;
+	const char* const keys_end = keys.data + keys.length;
+	while(true){
+		const char* next = (const char*)memchr(data, ':', keys_end - data);
+		if(next == nullptr) next = keys_end;
+		this->format_keys_.push_back(Token(data, next - data));
+		if(next == keys_end) break;
+		data = next + 1;
+	}
+	this->n_fmt_ = this->format_keys_.size();
+
+	// Split sample columns into one token for each key: absent
+	// trailing fields are left empty and treated as missing
+	this->sample_fields_.assign(this->n_fmt_ * this->n_samples_, Token());
+	for(U32 s = 0; s < this->n_samples_; ++s){
+		if(samples > end){
+			std::cerr << utility::timestamp("ERROR","VCF") << "Expected " << this->n_samples_ << " samples but found " << s << "..." << std::endl;
+			return false;
+		}
+
+		const char* column_end = (const char*)memchr(samples, '\t', end - samples);
+		if(column_end == nullptr) column_end = end;
+
+		U32 k = 0;
+		data = samples;
+		while(k < this->n_fmt_){
+			const char* next = (const char*)memchr(data, ':', column_end - data);
+			if(next == nullptr) next = column_end;
+			this->sample_fields_[k*this->n_samples_ + s] = Token(data, next - data);
+			++k;
+			if(next == column_end) break;
+			data = next + 1;
+		}
+		samples = column_end + 1;
+	}
+
+	if(samples <= end){
+		std::cerr << utility::timestamp("ERROR","VCF") << "Found more sample columns than the " << this->n_samples_ << " samples in the header..." << std::endl;
+		return false;
+	}
+
+	for(U32 k = 0; k < this->n_fmt_; ++k){
+		const map_entry_type* field = this->getField(this->format_table_, this->format_fields_, this->format_keys_[k]);
+		if(field == nullptr){
+			std::cerr << utility::timestamp("ERROR","VCF") << "FORMAT field \"" << this->key_ << "\" is not declared in the header..." << std::endl;
+			return false;
+		}
+		this->addTypedInteger(this->indiv_, field->IDX);
+
+		const Token* fields = &this->sample_fields_[k*this->n_samples_];
+
+		// Genotypes: alleles are encoded as (allele + 1) << 1 | phased
+		// where the phase bit refers to the separator preceding the allele
+		if(field->IDX == map_gt_id){
+			U32 ploidy = 1;
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				U32 n_alleles = 1;
+				for(U32 i = 0; i < fields[s].length; ++i)
+					n_alleles += (fields[s].data[i] == '/' || fields[s].data[i] == '|');
+				if(n_alleles > ploidy) ploidy = n_alleles;
+			}
+
+			this->matrix_.assign(this->n_samples_ * ploidy, VCF_INTEGER_EOV);
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				S32* alleles = &this->matrix_[s*ploidy];
+				const char* allele = fields[s].data;
+				const char* const field_end = fields[s].data + fields[s].length;
+				if(fields[s].length == 0){
+					alleles[0] = 0;
+					continue;
+				}
+
+				BYTE phase = 0;
+				for(U32 a = 0; a < ploidy; ++a){
+					const char* separator = allele;
+					while(separator != field_end && *separator != '/' && *separator != '|') ++separator;
+
+					if(*allele == '.') alleles[a] = phase;
+					else alleles[a] = ((parseInteger(allele, separator) + 1) << 1) | phase;
+
+					if(separator == field_end) break;
+					phase = (*separator == '|');
+					allele = separator + 1;
+				}
+			}
+			this->addIntegers(this->indiv_, &this->matrix_[0], this->matrix_.size(), ploidy);
+			continue;
+		}
+
+		switch(field->primitive_type){
+		case(0): // Integer
+			{
+			U32 stride = 1;
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				U32 n_values = 1;
+				for(U32 i = 0; i < fields[s].length; ++i) n_values += (fields[s].data[i] == ',');
+				if(n_values > stride) stride = n_values;
+			}
+
+			this->matrix_.assign(this->n_samples_ * stride, VCF_INTEGER_EOV);
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				this->parseIntegers(fields[s], this->integers_);
+				memcpy(&this->matrix_[s*stride], &this->integers_[0], this->integers_.size()*sizeof(S32));
+			}
+			this->addIntegers(this->indiv_, &this->matrix_[0], this->matrix_.size(), stride);
+			}
+			break;
+		case(1): // Float
+			{
+			U32 stride = 1;
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				U32 n_values = 1;
+				for(U32 i = 0; i < fields[s].length; ++i) n_values += (fields[s].data[i] == ',');
+				if(n_values > stride) stride = n_values;
+			}
+
+			this->fmatrix_.assign(this->n_samples_ * stride, floatFromBits(VCF_FLOAT_EOV));
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				this->parseFloats(fields[s], this->floats_);
+				memcpy(&this->fmatrix_[s*stride], &this->floats_[0], this->floats_.size()*sizeof(float));
+			}
+			this->addFloats(this->indiv_, &this->fmatrix_[0], this->fmatrix_.size(), stride);
+			}
+			break;
+		default: // Character and String: padded with NUL bytes
+			{
+			U32 stride = 1;
+			for(U32 s = 0; s < this->n_samples_; ++s)
+				if(fields[s].length > stride) stride = fields[s].length;
+
+			this->addTypedSize(this->indiv_, stride, bcf::BCF_CHAR);
+			for(U32 s = 0; s < this->n_samples_; ++s){
+				if(fields[s].length == 0){
+					this->indiv_ += '.';
+					for(U32 i = 1; i < stride; ++i) this->indiv_ += (char)0;
+					continue;
+				}
+				this->indiv_.Add(fields[s].data, fields[s].length);
+				for(U32 i = fields[s].length; i < stride; ++i) this->indiv_ += (char)0;
+			}
+			}
+			break;
+		}
+	}
+	return true;
+}
+
+bool VCFRecordConverter::convert(const char* const line, const U32 length, const S32 contig_id, const S32 map_gt_id, entry_type& entry){
+	const char* const end = line + length;
+
+	// Mandatory columns and FORMAT
+	Token columns[9];
+	U32 n_columns = 0;
+	const char* data = line;
+	while(n_columns < 9){
+		const char* next = (const char*)memchr(data, '\t', end - data);
+		if(next == nullptr) next = end;
+		columns[n_columns++] = Token(data, next - data);
+		data = next + 1;
+		if(next == end) break;
+	}
+
+	if(n_columns < 8){
+		std::cerr << utility::timestamp("ERROR","VCF") << "Malformed VCF line with " << n_columns << " columns: " << std::string(line, length < 100 ? length : 100) << std::endl;
+		return false;
+	}
+
+	const S32 position = parseInteger(columns[1].data, columns[1].data + columns[1].length) - 1;
+
+	this->shared_.reset();
+	this->indiv_.reset();
+	this->n_filter_ = 0;
+	this->n_info_   = 0;
+	this->n_fmt_    = 0;
+
+	// ID
+	if(columns[2].isMissing()) this->addTypedString(this->shared_, nullptr, 0);
+	else this->addTypedString(this->shared_, columns[2].data, columns[2].length);
+
+	// REF and ALT: a missing ALT has no allele
+	U32 n_allele = 1;
+	this->addTypedString(this->shared_, columns[3].data, columns[3].length);
+	if(!columns[4].isMissing()){
+		const char* const alt_end = columns[4].data + columns[4].length;
+		data = columns[4].data;
+		while(true){
+			const char* next = (const char*)memchr(data, ',', alt_end - data);
+			if(next == nullptr) next = alt_end;
+			this->addTypedString(this->shared_, data, next - data);
+			++n_allele;
+			if(next == alt_end) break;
+			data = next + 1;
+		}
+	}
+
+	// QUAL
+	const float quality = columns[5].isMissing() ? floatFromBits(VCF_FLOAT_MISSING) : strtof(columns[5].data, nullptr);
+
+	// FILTER and INFO
+	S32 rlen = columns[3].length;
+	if(!this->addFilter(columns[6]))
+		return false;
+
+	if(!this->addInfo(columns[7], position, rlen))
+		return false;
+
+	// FORMAT and samples
+	if(n_columns == 9 && this->n_samples_){
+		const char* const samples = columns[8].data + columns[8].length + 1;
+		if(!this->addFormat(columns[8], samples, end, map_gt_id))
+			return false;
+	}
+
+	// BCF record: lengths followed by the fixed fields
+	U32 body[8];
+	body[0] = 6*sizeof(U32) + this->shared_.size();
+	body[1] = this->indiv_.size();
+	body[2] = contig_id;
+	body[3] = position;
+	body[4] = rlen;
+	memcpy(&body[5], &quality, sizeof(float));
+	body[6] = (n_allele << 16) | (this->n_info_ & 0xFFFF);
+	body[7] = (this->n_fmt_ << 24) | (this->n_samples_ & 0xFFFFFF);
+
+	entry.reset();
+	entry.add(reinterpret_cast<const char*>(body), sizeof(U32)*8);
+	entry.add(this->shared_.data(), this->shared_.size());
+	entry.add(this->indiv_.data(), this->indiv_.size());
+
+	if(!entry.parse(this->n_samples_)){
+		std::cerr << utility::timestamp("ERROR","VCF") << "Failed to parse converted record..." << std::endl;
+		return false;
+	}
+
+	if(entry.body->n_fmt > 0 && map_gt_id != -1){
+		if(entry.formatID[0].mapID == map_gt_id){
+			entry.hasGenotypes = true;
+			entry.assessGenotypes(this->n_samples_);
+		}
+	}
+
+	return true;
+}
+
+}
+}
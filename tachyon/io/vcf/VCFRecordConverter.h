@@ -0,0 +1,114 @@
+#ifndef VCF_VCFRECORDCONVERTER_H_
+#define VCF_VCFRECORDCONVERTER_H_
+
+#include <vector>
+
+#include "VCFHeader.h"
+#include "../bcf/BCFEntry.h"
+
+namespace tachyon {
+namespace vcf{
+
+/**<
+ * Converts VCF text records into in-memory BCF records such
+ * that they can be consumed by the same import path as records
+ * read from BCF files. Values are encoded following the BCF2.2
+ * specification: integers use the smallest primitive type that
+ * fits all values and vectors are padded with end-of-vector
+ * values.
+ *
+ * A converter holds scratch memory and lookup tables for the
+ * fields declared in the header. It is not thread-safe: use one
+ * converter per thread.
+ */
+class VCFRecordConverter{
+private:
+	typedef VCFRecordConverter                self_type;
+	typedef VCFHeader                         header_type;
+	typedef bcf::BCFEntry                     entry_type;
+	typedef io::BasicBuffer                   buffer_type;
+	typedef core::HeaderMapEntry              map_entry_type;
+	typedef hash::HashTable<std::string, S32> hash_table_type;
+
+	/**<
+	 * Position and length of a token in a VCF line
+	 */
+	struct Token{
+		Token() : data(nullptr), length(0){}
+		Token(const char* data, const U32 length) : data(data), length(length){}
+
+		inline const bool isMissing(void) const{ return(this->length == 0 || (this->length == 1 && this->data[0] == '.')); }
+
+		const char* data;
+		U32 length;
+	};
+
+public:
+	VCFRecordConverter();
+	~VCFRecordConverter();
+
+	/**<
+	 * Build lookup tables for the FILTER, INFO, and FORMAT
+	 * fields declared in the header
+	 * @param header Parsed VCF header
+	 */
+	void setHeader(const header_type& header);
+
+	/**<
+	 * Convert a VCF line into a parsed BCF entry
+	 * @param line      Pointer to the start of the line
+	 * @param length    Length of the line excluding the newline
+	 * @param contig_id Contig identifier of the line in the header
+	 * @param map_gt_id Header IDX of the GT field or -1 if not available
+	 * @param entry     Destination BCF entry
+	 * @return          Returns TRUE upon success or FALSE otherwise
+	 */
+	bool convert(const char* const line, const U32 length, const S32 contig_id, const S32 map_gt_id, entry_type& entry);
+
+private:
+	const map_entry_type* getField(const hash_table_type* table, const std::vector<map_entry_type>& fields, const Token& key);
+
+	bool addFilter(const Token& token);
+	bool addInfo(const Token& token, const S32 position, S32& rlen);
+	bool addFormat(const Token& keys, const char* samples, const char* const end, const S32 map_gt_id);
+
+	// Typed value encoders
+	void addTypedSize(buffer_type& buffer, const U32 n_values, const BYTE type);
+	void addTypedInteger(buffer_type& buffer, const S32 value);
+	void addTypedString(buffer_type& buffer, const char* const data, const U32 length);
+	void addIntegers(buffer_type& buffer, const S32* values, const U32 n_values, const U32 stride);
+	void addFloats(buffer_type& buffer, const float* values, const U32 n_values, const U32 stride);
+
+	// Value parsers
+	void parseIntegers(const Token& token, std::vector<S32>& values);
+	void parseFloats(const Token& token, std::vector<float>& values);
+
+private:
+	U64 n_samples_;
+	std::string key_; // scratch key for hash table lookups
+
+	std::vector<map_entry_type> info_fields_;
+	std::vector<map_entry_type> format_fields_;
+	std::vector<map_entry_type> filter_fields_;
+	hash_table_type* info_table_;
+	hash_table_type* format_table_;
+	hash_table_type* filter_table_;
+
+	// Scratch memory
+	buffer_type shared_;           // shared part of the BCF record
+	buffer_type indiv_;            // per-sample part of the BCF record
+	std::vector<S32>   integers_;  // parsed integer values
+	std::vector<float> floats_;    // parsed float values
+	std::vector<S32>   matrix_;    // per-sample integer values
+	std::vector<float> fmatrix_;   // per-sample float values
+	std::vector<Token> sample_fields_; // FORMAT tokens for each field and sample
+	std::vector<Token> format_keys_;   // FORMAT keys for the current line
+	U32 n_filter_;
+	U32 n_info_;
+	U32 n_fmt_;
+};
+
+}
+}
+
+#endif /* VCF_VCFRECORDCONVERTER_H_ */
@@ -24,6 +24,7 @@ DEALINGS IN THE SOFTWARE.
 #include <getopt.h>
 
 #include "import.h"
+#include "concat.h"
 #include "view.h"
 #include "utility.h"
 #include "stats.h"
@@ -48,6 +49,8 @@ int main(int argc, char** argv){
 	if(strncmp(&argv[1][0], "import", 5) == 0){
 		return(import(argc, argv));
 
+	} else if(strncmp(&argv[1][0], "concat", 6) == 0){
+		return(concat(argc, argv));
 	} else if(strncmp(&argv[1][0], "view", 4) == 0){
 		return(view(argc, argv));
 	} else if(strncmp(&argv[1][0], "stats", 5) == 0){
@@ -29,6 +29,7 @@ DEALINGS IN THE SOFTWARE.
 
 #include "utility.h"
 #include "variant_reader.h"
+#include "variant_reader_prefetcher.h"
 
 void stats_usage(void){
 
@@ -141,8 +142,12 @@ int stats(int argc, char** argv){
 
 	U32 block_counter = 0;
 	std::vector<tachyon::core::TsTvObject> global_titv(reader.header.getSampleNumber());
-	while(reader.nextBlock()){
-		reader.getTiTVRatios(std::cout, global_titv);
+	// The next block is loaded in the background while the
+	// current one is processed
+	tachyon::VariantReaderPrefetcher prefetcher(reader);
+	tachyon::VariantReader* block_reader = nullptr;
+	while(prefetcher.next(block_reader)){
+		block_reader->getTiTVRatios(std::cout, global_titv);
 		//reader.getGenotypeSummary(std::cout);
 		std::cerr << block_counter++ << "/" << reader.index.size() << " in " << timer.ElapsedString() << " " << timer2.ElapsedString() << " " << timer2.Elapsed().count()/(block_counter+1)*reader.index.size() << std::endl;
 		timer.Start();
@@ -40,7 +40,11 @@ enum TACHYON_GT_ENCODING{
 	YON_GT_RLE_DIPLOID_BIALLELIC = 0,//!< YON_GT_RLE_DIPLOID_BIALLELIC
 	YON_GT_RLE_DIPLOID_NALLELIC  = 1,//!< YON_GT_RLE_DIPLOID_NALLELIC
 	YON_GT_BCF_DIPLOID           = 2,//!< YON_GT_BCF_DIPLOID
-	YON_GT_BCF_STYLE             = 3 //!< YON_GT_BCF_STYLE
+	YON_GT_BCF_STYLE             = 3,//!< YON_GT_BCF_STYLE
+	YON_GT_RLE_DIPLOID_BIALLELIC_PBWT = 4,//!< YON_GT_RLE_DIPLOID_BIALLELIC in positional BWT order
+	YON_GT_BITPLANE_DIPLOID_BIALLELIC = 5,//!< YON_GT_BITPLANE_DIPLOID_BIALLELIC
+	YON_GT_RLE_MPLOID_BIALLELIC  = 6,//!< YON_GT_RLE_MPLOID_BIALLELIC for haploid and polyploid variants
+	YON_GT_RLE_MPLOID_NALLELIC   = 7 //!< YON_GT_RLE_MPLOID_NALLELIC for haploid and polyploid variants
 };
 
 /**<
@@ -27,7 +27,7 @@ void programMessage(const bool separator = true){
 
 void programHelp(void){
 	std::cerr << "Usage: " << tachyon::constants::PROGRAM_NAME << " [--version] [--help] <commands> <argument>" << std::endl;
-	std::cerr << "Commands: import, view" << std::endl;
+	std::cerr << "Commands: import, concat, view" << std::endl;
 }
 
 void programHelpDetailed(void){
@@ -35,6 +35,7 @@ void programHelpDetailed(void){
 	std::cerr <<
     "\n"
 	"import       import VCF/BCF to YON\n"
+	"concat       concatenate YON files without decompression\n"
     "view         YON->VCF/BCF conversion, YON subset and filter\n"
 	"check        comprehensive file integrity checks\n" << std::endl;
 }
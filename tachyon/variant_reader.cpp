@@ -3,12 +3,24 @@
 namespace tachyon{
 
 VariantReader::VariantReader() :
-	filesize(0)
+	filesize(0),
+	memory_map(false),
+	n_threads(1),
+	lazy_decompression(false),
+	mapped_position(0),
+	block_cache(nullptr),
+	verify_checksums(false)
 {}
 
 VariantReader::VariantReader(const std::string& filename) :
 	input_file(filename),
-	filesize(0)
+	filesize(0),
+	memory_map(false),
+	n_threads(1),
+	lazy_decompression(false),
+	mapped_position(0),
+	block_cache(nullptr),
+	verify_checksums(false)
 {}
 
 VariantReader::~VariantReader(){}
@@ -16,14 +28,25 @@ VariantReader::~VariantReader(){}
 VariantReader::VariantReader(const self_type& other) :
 	input_file(other.input_file),
 	filesize(other.filesize),
+	memory_map(other.memory_map),
+	n_threads(other.n_threads),
+	lazy_decompression(other.lazy_decompression),
+	block_offsets(other.block_offsets),
+	mapped_position(other.mapped_position),
+	block_cache(other.block_cache),
+	cache_id(other.cache_id),
 	settings(other.settings),
 	header(other.header),
 	footer(other.footer),
 	index(other.index),
 	checksums(other.checksums),
+	block_checksums(other.block_checksums),
+	verify_checksums(other.verify_checksums),
 	keychain(other.keychain)
 {
 	this->stream.open(this->input_file, std::ios::in | std::ios::binary);
+	if(this->memory_map) this->mapped_file.open(this->input_file);
+	this->codec_manager.dictionaries = other.codec_manager.dictionaries;
 }
 
 bool VariantReader::open(void){
@@ -34,6 +57,7 @@ bool VariantReader::open(void){
 
 	this->stream.open(this->input_file, std::ios::binary | std::ios::in | std::ios::ate);
 	this->filesize = (U64)this->stream.tellg();
+	this->cache_id = block_cache_type::identify(this->input_file);
 
 	if(this->filesize <= YON_FOOTER_LENGTH){
 		std::cerr << utility::timestamp("ERROR") << "File is corrupted!" << std::endl;
@@ -86,6 +110,15 @@ bool VariantReader::open(void){
 	}
 	header_container.buffer_data_uncompressed >> this->header; // parse header from buffer
 
+	// Trained dictionaries, if any, are stored after the header literals
+	if(header_container.buffer_data_uncompressed.iterator_position_ < header_container.buffer_data_uncompressed.size()){
+		header_container.buffer_data_uncompressed >> this->codec_manager.dictionaries;
+		if(!this->codec_manager.dictionaries.prepareDecompression()){
+			std::cerr << utility::timestamp("ERROR") << "Failed to load dictionaries!" << std::endl;
+			return false;
+		}
+	}
+
 	if(!this->header.header_magic.validate()){
 		std::cerr << utility::timestamp("ERROR") << "Failed to validate header!" << std::endl;
 		return false;
@@ -100,12 +133,55 @@ bool VariantReader::open(void){
 	const U64 return_pos = this->stream.tellg();
 	this->stream.seekg(this->footer.offset_end_of_data);
 	this->stream >> this->index;
-	this->stream >> this->checksums;
+	this->block_checksums.type = (algorithm::TACHYON_CHECKSUM_TYPE)this->footer.getChecksumType();
+	if(this->block_checksums.type == algorithm::YON_CHECKSUM_SHA512) this->stream >> this->checksums;
+	else this->stream >> this->block_checksums;
 	this->stream.seekg(return_pos);
+
+	// Start of each block in file order
+	const index::VariantIndex& variant_index = this->index.getIndex();
+	this->block_offsets.clear();
+	for(U32 c = 0; c < variant_index.size(); ++c){
+		for(U32 j = 0; j < variant_index.linear_at(c).size(); ++j)
+			this->block_offsets.push_back(variant_index.linear_at(c)[j].byte_offset);
+	}
+	std::sort(this->block_offsets.begin(), this->block_offsets.end());
+
+	if(this->memory_map){
+		if(!this->mapped_file.open(this->input_file)){
+			std::cerr << utility::timestamp("ERROR") << "Failed to memory-map file: " << this->input_file << "..." << std::endl;
+			return false;
+		}
+		this->mapped_position = return_pos;
+	}
+
 	return(this->stream.good());
 }
 
 bool VariantReader::nextBlock(){
+	if(this->block_cache != nullptr)
+		return(this->nextBlockCached());
+
+	if(!this->nextBlockCompressed())
+		return false;
+
+	// Containers are decompressed when first accessed
+	if(this->lazy_decompression){
+		this->block.deferDecompression(this->codec_manager);
+		return true;
+	}
+
+	// Internally decompress available data
+	if(!this->codec_manager.decompress(this->block)){
+		std::cerr << utility::timestamp("ERROR", "COMPRESSION") << "Failed decompression!" << std::endl;
+		return false;
+	}
+
+	// All passed
+	return true;
+}
+
+bool VariantReader::nextBlockCompressed(){
 	// If the stream is faulty then return
 	if(!this->stream.good()){
 		std::cerr << utility::timestamp("ERROR", "IO") << "Corrupted! Input stream died prematurely!" << std::endl;
@@ -114,49 +190,176 @@ bool VariantReader::nextBlock(){
 
 	// If the current position is the EOF then
 	// exit the function
-	if((U64)this->stream.tellg() == this->footer.offset_end_of_data)
+	if(this->tell() == this->footer.offset_end_of_data)
+		return false;
+
+	if(this->verify_checksums && !this->verifyBlock())
 		return false;
 
 	// Reset and re-use
 	this->block.clear();
+	if(!this->readBlockHeaderFooter(this->block))
+		return false;
+
+	this->parseSettings();
+	return(this->readBlockContainers(this->block, this->settings));
+}
 
-	if(!this->block.readHeaderFooter(this->stream))
+bool VariantReader::nextBlockCached(){
+	// If the stream is faulty then return
+	if(!this->stream.good()){
+		std::cerr << utility::timestamp("ERROR", "IO") << "Corrupted! Input stream died prematurely!" << std::endl;
 		return false;
+	}
 
-	if(!this->codec_manager.zstd_codec.decompress(this->block.footer_support)){
-		std::cerr << utility::timestamp("ERROR", "COMPRESSION") << "Failed decompression of footer!" << std::endl;
+	// If the current position is the EOF then
+	// exit the function
+	const U64 position = this->tell();
+	if(position == this->footer.offset_end_of_data)
+		return false;
+
+	const U32 blockID = std::lower_bound(this->block_offsets.begin(), this->block_offsets.end(), position) - this->block_offsets.begin();
+	if(blockID == this->block_offsets.size() || this->block_offsets[blockID] != position){
+		std::cerr << utility::timestamp("ERROR", "CACHE") << "No block starts at offset " << position << "..." << std::endl;
+		return false;
 	}
-	this->block.footer_support.buffer_data_uncompressed >> this->block.footer;
+
+	this->cached_block = this->block_cache->find(this->cache_id, blockID);
+	if(this->cached_block == nullptr){
+		if(this->verify_checksums && !this->verifyBlock())
+			return false;
+
+		// The cached copy holds every container such that it can
+		// serve readers with any settings
+		block_entry_type* decoded = new block_entry_type;
+		settings_type decoded_settings;
+		decoded_settings.loadAll(true);
+		if(!this->readBlockHeaderFooter(*decoded) || !this->readBlockContainers(*decoded, decoded_settings)){
+			delete decoded;
+			return false;
+		}
+
+		if(!this->codec_manager.decompress(*decoded)){
+			std::cerr << utility::timestamp("ERROR", "COMPRESSION") << "Failed decompression!" << std::endl;
+			delete decoded;
+			return false;
+		}
+
+		decoded->detach();
+		this->cached_block = this->block_cache->insert(this->cache_id, blockID, decoded);
+		this->seek(position);
+	}
+
+	// Only the header and footer are read from the file: the
+	// containers point at the cached data
+	this->block.clear();
+	if(!this->readBlockHeaderFooter(this->block))
+		return false;
+
 	this->parseSettings();
+	if(!this->block.read(*this->cached_block, this->settings))
+		return false;
+
+	this->seek(this->block.getEndOfBlock());
+	return(this->stream.good());
+}
+
+bool VariantReader::readBlockHeaderFooter(block_entry_type& block){
+	if(this->memory_map){
+		if(!block.readHeaderFooter(this->mapped_file, this->mapped_position))
+			return false;
+	} else if(!block.readHeaderFooter(this->stream))
+		return false;
+
+	if(!this->codec_manager.zstd_codec.decompress(block.footer_support)){
+		std::cerr << utility::timestamp("ERROR", "COMPRESSION") << "Failed decompression of footer!" << std::endl;
+	}
+	block.footer_support.buffer_data_uncompressed >> block.footer;
+	return true;
+}
 
+bool VariantReader::readBlockContainers(block_entry_type& block, settings_type& settings){
 	// Attempts to read a YON block with the provided
-	if(!this->block.read(this->stream, this->settings))
+	if(this->memory_map){
+		if(!block.read(this->mapped_file, settings))
+			return false;
+		this->mapped_position = block.getEndOfBlock();
+	} else if(!block.read(this->stream, settings))
 		return false;
 
 	// encryption manager ascertainment
-	if(this->block.header.controller.anyEncrypted){
+	if(block.header.controller.anyEncrypted){
 		if(this->keychain.size() == 0){
 			std::cerr << utility::timestamp("ERROR", "DECRYPTION") << "Data is encrypted but no keychain was provided!" << std::endl;
 			return false;
 		}
 
-		encryption::EncryptionDecorator e;
-		if(!e.decryptAES256(this->block, this->keychain)){
+		// Only the containers loaded with the current settings
+		// are decrypted
+		if(!this->encryption_manager.decryptAES256(block, this->keychain, settings)){
 			std::cerr << utility::timestamp("ERROR", "DECRYPTION") << "Failed decryption!" << std::endl;
 			return false;
 		}
 	}
 
-	// Internally decompress available data
-	if(!this->codec_manager.decompress(this->block)){
-		std::cerr << utility::timestamp("ERROR", "COMPRESSION") << "Failed decompression!" << std::endl;
+	return true;
+}
+
+bool VariantReader::verifyBlock(void){
+	if(this->block_checksums.type == algorithm::YON_CHECKSUM_SHA512){
+		std::cerr << utility::timestamp("ERROR", "CHECKSUM") << "File has no per-block checksums: SHA-512 digests cover the entire file..." << std::endl;
+		return false;
+	}
+
+	const U64 position = this->tell();
+	U64 length = 0, checksum = 0;
+	if(!this->block_checksums.find(position, this->footer.offset_end_of_data, length, checksum)){
+		std::cerr << utility::timestamp("ERROR", "CHECKSUM") << "No checksum for block at offset " << position << "..." << std::endl;
+		return false;
+	}
+
+	this->checksum_buffer.reset();
+	if(this->memory_map){
+		// The checksum is computed directly over the mapped block
+		if(!this->mapped_file.contains(position, length)){
+			std::cerr << utility::timestamp("ERROR", "CHECKSUM") << "Failed to read block at offset " << position << "..." << std::endl;
+			return false;
+		}
+		this->checksum_buffer.view(this->mapped_file.data() + position, length);
+	} else {
+		this->checksum_buffer.resize(length);
+		this->stream.read(this->checksum_buffer.data(), length);
+		this->stream.seekg(position);
+		if(!this->stream.good()){
+			std::cerr << utility::timestamp("ERROR", "CHECKSUM") << "Failed to read block at offset " << position << "..." << std::endl;
+			return false;
+		}
+	}
+
+	if(algorithm::BlockChecksum::compute(this->block_checksums.type, this->checksum_buffer.data(), length) != checksum){
+		std::cerr << utility::timestamp("ERROR", "CHECKSUM") << "Block at offset " << position << " does not match its " << algorithm::BlockChecksum::typeString(this->block_checksums.type) << " checksum: the file is corrupted..." << std::endl;
 		return false;
 	}
 
-	// All passed
 	return true;
 }
 
+bool VariantReader::seek_to_block(const U32& blockID){
+	if(blockID >= this->block_offsets.size()){
+		std::cerr << utility::timestamp("ERROR") << "Illegal block identifier: " << blockID << " (" << this->block_offsets.size() << " blocks)..." << std::endl;
+		return false;
+	}
+
+	if(this->memory_map){
+		this->mapped_position = this->block_offsets[blockID];
+		return true;
+	}
+
+	this->stream.clear();
+	this->stream.seekg(this->block_offsets[blockID]);
+	return(this->stream.good());
+}
+
 VariantReader::block_entry_type VariantReader::getBlock(){
 	// If the stream is faulty then return
 	if(!this->stream.good()){
@@ -219,7 +422,7 @@ const int VariantReader::has_filter_field(const std::string& field_name) const{
 VariantReaderObjects& VariantReader::loadObjects(objects_type& objects) const{
 	objects.meta = new meta_container_type(this->block);
 	if(this->block.header.controller.hasGT && settings.load_genotypes_all){
-		objects.genotypes = new gt_container_type(this->block, *objects.meta);
+		objects.genotypes = new gt_container_type(this->block, *objects.meta, this->header.getSampleNumber());
 		objects.genotype_summary = new objects_type::genotype_summary_type(10);
 	}
 
@@ -231,7 +434,11 @@ VariantReaderObjects& VariantReader::loadObjects(objects_type& objects) const{
 			const U32 global_key = settings.load_format_ID_loaded[i].offset->data_header.global_key;
 			std::vector<bool> matches = this->get_format_field_pattern_matches(this->header.format_fields[global_key].ID);
 
-			if(this->header.format_fields[global_key].getType() == YON_VCF_HEADER_INTEGER){
+			// Fields that fail to decompress are left empty
+			if(!this->block.prepareFormat(i)){
+				objects.format_fields[i] = new containers::FormatContainer<U32>;
+				objects.format_field_names.push_back(this->header.format_fields[global_key].ID);
+			} else if(this->header.format_fields[global_key].getType() == YON_VCF_HEADER_INTEGER){
 				objects.format_fields[i] = new containers::FormatContainer<S32>(this->block.format_containers[i], *objects.meta, matches, this->header.getSampleNumber());
 				objects.format_field_names.push_back(this->header.format_fields[global_key].ID);
 			} else if(this->header.format_fields[global_key].getType() == YON_VCF_HEADER_STRING ||
@@ -258,7 +465,11 @@ VariantReaderObjects& VariantReader::loadObjects(objects_type& objects) const{
 			const U32 global_key = settings.load_info_ID_loaded[i].offset->data_header.global_key;
 			std::vector<bool> matches = this->get_info_field_pattern_matches(this->header.info_fields[global_key].ID);
 
-			if(this->header.info_fields[global_key].getType() == YON_VCF_HEADER_INTEGER){
+			// Fields that fail to decompress are left empty
+			if(!this->block.prepareInfo(i)){
+				objects.info_fields[i] = new containers::InfoContainer<U32>();
+				objects.info_field_names.push_back(this->header.info_fields[global_key].ID);
+			} else if(this->header.info_fields[global_key].getType() == YON_VCF_HEADER_INTEGER){
 				objects.info_fields[i] = new containers::InfoContainer<S32>(this->block.info_containers[i], *objects.meta, matches);
 				objects.info_field_names.push_back(this->header.info_fields[global_key].ID);
 			} else if(this->header.info_fields[global_key].getType() == YON_VCF_HEADER_STRING ||
@@ -1,13 +1,18 @@
 #ifndef CORE_TACHYON_READER_H_
 #define CORE_TACHYON_READER_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
+#include <thread>
 
 #include "zstd.h"
 #include "zstd_errors.h"
 
 #include "algorithm/compression/compression_manager.h"
 #include "algorithm/encryption/EncryptionDecorator.h"
+#include "algorithm/ordered_writer.h"
 #include "algorithm/timer.h"
 #include "containers/format_container.h"
 #include "containers/format_container_string.h"
@@ -17,7 +22,9 @@
 #include "containers/primitive_group_container.h"
 #include "containers/meta_container.h"
 #include "algorithm/digital_digest.h"
+#include "algorithm/block_checksum.h"
 #include "containers/variantblock.h"
+#include "containers/variantblock_cache.h"
 #include "core/genotype_object.h"
 #include "core/footer/footer.h"
 #include "core/header/variant_header.h"
@@ -94,10 +101,13 @@ class VariantReader{
 	typedef core::DataBlockSettings                settings_type;
 	typedef index::Index                           index_type;
 	typedef algorithm::VariantDigitalDigestManager checksum_type;
+	typedef algorithm::BlockChecksumManager        block_checksum_type;
 	typedef encryption::Keychain                   keychain_type;
+	typedef encryption::EncryptionDecorator        encryption_manager_type;
 	typedef core::MetaEntry                        meta_entry_type;
 	typedef VariantReaderObjects                   objects_type;
 	typedef containers::VariantBlock               block_entry_type;
+	typedef containers::VariantBlockCache          block_cache_type;
 	typedef containers::MetaContainer              meta_container_type;
 	typedef containers::GenotypeContainer          gt_container_type;
 	typedef containers::InfoContainerInterface     info_interface_type;
@@ -182,7 +192,7 @@ public:
 	template <class T>
 	containers::FormatContainer<T>* get_format_container(const std::string& field_name) const{
 		int format_field = this->has_format_field(field_name);
-		if(format_field >= 0) return(new containers::FormatContainer<T>(this->block.format_containers[format_field], this->header.getSampleNumber()));
+		if(format_field >= 0 && this->block.prepareFormat(format_field)) return(new containers::FormatContainer<T>(this->block.format_containers[format_field], this->header.getSampleNumber()));
 		else return nullptr;
 	}
 
@@ -203,7 +213,7 @@ public:
 			for(U32 i = 0; i < pattern_matches.size(); ++i)
 				matches += pattern_matches[i];
 
-			if(matches == 0)
+			if(matches == 0 || !this->block.prepareFormat(format_field))
 				return nullptr;
 
 			return(new containers::FormatContainer<T>(this->block.format_containers[format_field], meta_container, pattern_matches, this->header.getSampleNumber()));
@@ -219,7 +229,7 @@ public:
 	template <class T>
 	containers::InfoContainer<T>* get_info_container(const std::string& field_name) const{
 		int info_field = this->has_info_field(field_name);
-		if(info_field >= 0) return(new containers::InfoContainer<T>(this->block.info_containers[info_field]));
+		if(info_field >= 0 && this->block.prepareInfo(info_field)) return(new containers::InfoContainer<T>(this->block.info_containers[info_field]));
 		else return nullptr;
 	}
 
@@ -241,7 +251,7 @@ public:
 			for(U32 i = 0; i < pattern_matches.size(); ++i)
 				matches += pattern_matches[i];
 
-			if(matches == 0)
+			if(matches == 0 || !this->block.prepareInfo(info_field))
 				return nullptr;
 
 			return(new containers::InfoContainer<T>(this->block.info_containers[info_field], meta_container, pattern_matches));
@@ -305,23 +315,190 @@ public:
 	 */
 	bool nextBlock(void);
 
+	/**<
+	 * Get the next YON block in-order without decompressing it.
+	 * Encrypted containers are decrypted such that the loaded
+	 * containers hold the compressed data
+	 * @return Returns TRUE if successful or FALSE otherwise
+	 */
+	bool nextBlockCompressed(void);
+
+	/**<
+	 * Get the next YON block in-order from the block cache. Blocks
+	 * that are not cached are read with every container, decrypted,
+	 * decompressed, and added to the cache; checksums are verified
+	 * at that point only. The containers of `block` point at the
+	 * cached data, which remains valid until the next block is read.
+	 * @return Returns TRUE if successful or FALSE otherwise
+	 */
+	bool nextBlockCached(void);
+
+	/**<
+	 * Verify the checksum of the block at the current position of
+	 * the stream. The stream is returned to the start of the block.
+	 * Only files with per-block checksums can be verified.
+	 * @return Returns TRUE if the checksum matches or FALSE otherwise
+	 */
+	bool verifyBlock(void);
+
+	/**<
+	 * Verify the checksum of every block as it is loaded. Only
+	 * the blocks that are read are verified.
+	 * @param yes Verify checksums or not
+	 */
+	inline void setVerifyChecksums(const bool yes){ this->verify_checksums = yes; }
+
+	/**<
+	 * Read blocks from a memory mapping of the file rather than the
+	 * file stream. Compressed containers point directly at the mapped
+	 * pages and uncompressed containers are used without any copy.
+	 * Has to be set before the file is opened.
+	 * @param yes Memory-map the file or not
+	 */
+	inline void setMemoryMap(const bool yes){ this->memory_map = yes; }
+	inline const bool useMemoryMap(void) const{ return(this->memory_map); }
+
+	/**<
+	 * Set the number of threads used by `outputVCF` and `outputCustom`.
+	 * With more than one thread blocks are decoded and formatted in
+	 * parallel by copies of this reader and written in block order.
+	 * @param n_threads Number of threads
+	 */
+	inline void setThreads(const U32 n_threads){ this->n_threads = (n_threads == 0 ? 1 : n_threads); }
+	inline const U32& getThreads(void) const{ return(this->n_threads); }
+
+	/**<
+	 * Defer decompression of the containers of each block until they
+	 * are first accessed through `MetaContainer`, `GenotypeContainer`,
+	 * or the INFO and FORMAT container accessors. Blocks that are
+	 * rejected on their positions or a single INFO field then never
+	 * inflate their genotypes or FORMAT data. Decompression errors
+	 * are reported when the data is accessed rather than by nextBlock():
+	 * callers that need every container should check
+	 * `block.prepareAll()`.
+	 * @param yes Enable or disable deferred decompression
+	 */
+	inline void setLazyDecompression(const bool yes){ this->lazy_decompression = yes; }
+
+	/**<
+	 * Serve blocks read by nextBlock() from a cache of decoded blocks
+	 * shared with other readers, such as the copies made by
+	 * `parallel_for_blocks`. Copies of this reader use the same
+	 * cache. Cached blocks are always decompressed in full, so lazy
+	 * decompression has no effect. The cache is not owned by the
+	 * reader and must outlive it.
+	 * @param cache Shared cache or nullptr to read blocks directly
+	 */
+	inline void setBlockCache(block_cache_type* cache){ this->block_cache = cache; }
+	inline block_cache_type* getBlockCache(void) const{ return(this->block_cache); }
+
+	// Current offset in the file of either the stream or the mapping
+	inline void seek(const U64 position){
+		if(this->memory_map) this->mapped_position = position;
+		else this->stream.seekg(position);
+	}
+	inline const U64 tell(void){ return(this->memory_map ? this->mapped_position : (U64)this->stream.tellg()); }
+
+	/**<
+	 * Set the number of threads used to decrypt the containers of
+	 * encrypted blocks
+	 * @param n_threads Number of threads
+	 */
+	inline void setDecryptionThreads(const U32 n_threads){ this->encryption_manager.setThreads(n_threads); }
+
 	/**<
 	 * Get the current YON block in-order as a copy
 	 * @return Returns a YON block. The container has a size of 0 upon fail/empty
 	 */
 	block_entry_type getBlock(void);
 
+private:
+	/**<
+	 * Read the header and footer of the block at the current position
+	 * of the stream or the mapping into `block`
+	 * @param block Target block that has been cleared
+	 * @return      Returns TRUE if successful or FALSE otherwise
+	 */
+	bool readBlockHeaderFooter(block_entry_type& block);
+
+	/**<
+	 * Read the containers selected by `settings` of the block whose
+	 * header and footer were read last and decrypt them. Moves past
+	 * the end of the block.
+	 * @param block    Target block
+	 * @param settings Settings record describing reading parameters
+	 * @return         Returns TRUE if successful or FALSE otherwise
+	 */
+	bool readBlockContainers(block_entry_type& block, settings_type& settings);
+
+public:
+
 
 	/**<
 	 * Seeks to a specific YON block without loading anything.
 	 * This allows the user to seek to a specific block and
 	 * change the settings (i.e. what fields to load) and
 	 * then invoke nextBlock() for example.
-	 * @param blockID
-	 * @return
+	 * @param blockID Block number in file order in range [0..n_blocks)
+	 * @return        Returns TRUE upon success or FALSE otherwise
 	 */
 	bool seek_to_block(const U32& blockID);
 
+	/**<
+	 * Invoke `function(reader, block)` for every block of the file
+	 * on `n_threads` threads. Each thread owns a copy of this reader
+	 * and repeatedly claims the next unread block, loads it with the
+	 * current settings, and passes its copy to `function`. Blocks
+	 * complete in no particular order: use the block number to order
+	 * results. `function` returns FALSE to stop all threads.
+	 * @param function  Callable as bool(VariantReader& reader, const U32 block)
+	 * @param n_threads Number of threads
+	 * @return          Returns TRUE if every block was visited or FALSE otherwise
+	 */
+	template <class F>
+	bool parallel_for_blocks(F function, const U32 n_threads) const{
+		return(this->parallel_for_blocks(function, n_threads, [](const U32){}));
+	}
+
+	/**<
+	 * As above. `abort(block)` is invoked by a thread that fails on
+	 * `block` such that shared state that other threads block on can
+	 * be released. Blocks claimed before the failure are still visited.
+	 * @param function  Callable as bool(VariantReader& reader, const U32 block)
+	 * @param n_threads Number of threads
+	 * @param abort     Callable as void(const U32 block)
+	 * @return          Returns TRUE if every block was visited or FALSE otherwise
+	 */
+	template <class F, class A>
+	bool parallel_for_blocks(F function, const U32 n_threads, A abort) const{
+		std::atomic<U32>  next_block(0);
+		std::atomic<bool> failed(false);
+		const U32 n_blocks = this->block_offsets.size();
+
+		// Every thread holds a copy of the reader: never start more
+		// threads than there are blocks to claim
+		const U32 n_workers = std::max(1U, std::min(n_threads, n_blocks));
+
+		std::vector<std::thread> threads;
+		for(U32 i = 0; i < n_workers; ++i){
+			threads.push_back(std::thread([&](){
+				self_type reader(*this);
+				for(U32 block = next_block++; block < n_blocks && failed == false; block = next_block++){
+					if(!reader.seek_to_block(block) || !reader.nextBlock() || !function(reader, block)){
+						failed = true;
+						abort(block);
+						break;
+					}
+				}
+			}));
+		}
+
+		for(U32 i = 0; i < threads.size(); ++i)
+			threads[i].join();
+
+		return(failed == false);
+	}
+
 	/**<
 	 *
 	 * @return
@@ -431,8 +608,11 @@ public:
 			this->header.writeVCFHeaderString(std::cout, this->settings.load_format || this->settings.format_list.size());
 		}
 
+		if(this->n_threads > 1)
+			return(this->outputParallel(false));
+
 		// While there are YON blocks
-		while(this->nextBlock()) n_variants += this->outputBlockVCF();
+		while(this->nextBlock() && this->block.prepareAll()) n_variants += this->outputBlockVCF();
 		return(n_variants);
 	}
 
@@ -443,8 +623,11 @@ public:
 	const U64 outputCustom(void){
 		U64 n_variants = 0;
 
+		if(this->n_threads > 1)
+			return(this->outputParallel(true));
+
 		// While there are YON blocks
-		while(this->nextBlock()) n_variants += this->outputBlockCustom();
+		while(this->nextBlock() && this->block.prepareAll()) n_variants += this->outputBlockCustom();
 		return(n_variants);
 	}
 
@@ -453,13 +636,25 @@ public:
 	 * @return
 	 */
 	const U32 outputBlockVCF(void) const{
-		objects_type objects;
-		this->loadObjects(objects);
-
 		// Reserve memory for output buffer
 		// This is much faster than writing directly to ostream because of syncing
 		io::BasicBuffer output_buffer(256000);
 		if(this->settings.load_format) output_buffer.resize(256000 + this->header.getSampleNumber()*2);
+		return(this->outputBlockVCF(output_buffer, &std::cout));
+	}
+
+	/**<
+	 * Format the current block as VCF into `output_buffer`. If
+	 * `stream` is set the buffer is flushed to it whenever it grows
+	 * large and once the block is done. Otherwise the formatted
+	 * block is left in the buffer.
+	 * @param output_buffer Destination buffer
+	 * @param stream        Destination stream or nullptr
+	 * @return              Returns the number of variants formatted
+	 */
+	const U32 outputBlockVCF(buffer_type& output_buffer, std::ostream* stream) const{
+		objects_type objects;
+		this->loadObjects(objects);
 
 		std::vector<core::GTObject> genotypes_unpermuted(this->header.getSampleNumber());
 
@@ -495,16 +690,18 @@ public:
 			(this->*print_format)(output_buffer, '\t', p, objects, genotypes_unpermuted);
 			output_buffer += '\n';
 
-			if(output_buffer.size() > 65536){
-				std::cout.write(output_buffer.data(), output_buffer.size());
+			if(stream != nullptr && output_buffer.size() > 65536){
+				stream->write(output_buffer.data(), output_buffer.size());
 				output_buffer.reset();
-				std::cout.flush();
+				stream->flush();
 			}
 		}
 
-		std::cout.write(output_buffer.data(), output_buffer.size());
-		output_buffer.reset();
-		std::cout.flush();
+		if(stream != nullptr){
+			stream->write(output_buffer.data(), output_buffer.size());
+			output_buffer.reset();
+			stream->flush();
+		}
 
 		return(objects.meta->size());
 	}
@@ -514,12 +711,23 @@ public:
 	 * @return
 	 */
 	const U32 outputBlockCustom(void) const{
-		objects_type objects;
-		this->loadObjects(objects);
-
 		// Reserve memory for output buffer
 		// This is much faster than writing directly to ostream because of syncing
 		io::BasicBuffer output_buffer(256000 + this->header.getSampleNumber()*2);
+		return(this->outputBlockCustom(output_buffer, &std::cout));
+	}
+
+	/**<
+	 * Format the current block in the custom output format into
+	 * `output_buffer`. Flushing follows `outputBlockVCF`.
+	 * @param output_buffer Destination buffer
+	 * @param stream        Destination stream or nullptr
+	 * @return              Returns the number of records formatted
+	 */
+	const U32 outputBlockCustom(buffer_type& output_buffer, std::ostream* stream) const{
+		objects_type objects;
+		this->loadObjects(objects);
+
 		std::vector<core::GTObject> genotypes_unpermuted(this->header.getSampleNumber());
 
 		// Todo: move to function
@@ -578,22 +786,54 @@ public:
 			//output_buffer += "}";
 
 			// Flush if buffer is large
-			if(output_buffer.size() > 65536){
-				std::cout.write(output_buffer.data(), output_buffer.size());
+			if(stream != nullptr && output_buffer.size() > 65536){
+				stream->write(output_buffer.data(), output_buffer.size());
 				output_buffer.reset();
-				std::cout.flush();
+				stream->flush();
 			}
 		}
 		if(settings.output_json) output_buffer += "}";
 
 		// Flush buffer
-		std::cout.write(output_buffer.data(), output_buffer.size());
-		output_buffer.reset();
-		std::cout.flush();
+		if(stream != nullptr){
+			stream->write(output_buffer.data(), output_buffer.size());
+			output_buffer.reset();
+			stream->flush();
+		}
 
 		return(n_records_returned);
 	}
 
+	/**<
+	 * Decode and format all blocks on `n_threads` threads and write
+	 * them to standard output in block order. At most two blocks per
+	 * thread are held in memory.
+	 * @param custom Use the custom output format or VCF
+	 * @return       Returns the number of variants written
+	 */
+	const U64 outputParallel(const bool custom){
+		algorithm::OrderedWriter writer(std::cout, 2*std::min(this->n_threads, (U32)this->block_offsets.size()));
+		std::atomic<U64> n_variants(0);
+		const U64 reserve = 256000 + this->header.getSampleNumber()*2;
+
+		const bool success = this->parallel_for_blocks([&](self_type& reader, const U32 block){
+			buffer_type* output_buffer = nullptr;
+			if(!reader.block.prepareAll() || !writer.acquire(block, output_buffer))
+				return false;
+
+			if(output_buffer->capacity() < reserve) output_buffer->resize(reserve);
+			if(custom) n_variants += reader.outputBlockCustom(*output_buffer, nullptr);
+			else n_variants += reader.outputBlockVCF(*output_buffer, nullptr);
+			writer.release(block);
+			return true;
+		}, this->n_threads, [&](const U32 block){ writer.close(block); });
+
+		if(!success)
+			std::cerr << utility::timestamp("ERROR") << "Failed to read block " << writer.written() << "..." << std::endl;
+
+		return(n_variants);
+	}
+
 	// Dummy functions as interfaces for function pointers
 	inline void printFILTERDummy(buffer_type& outputBuffer, const U32& position, const objects_type& objects) const{}
 	inline void printFORMATDummy(buffer_type& buffer, const char& delimiter, const U32& position, const objects_type& objects, std::vector<core::GTObject>& genotypes_unpermuted) const{}
@@ -680,7 +920,7 @@ public:
 
 	U64 iterate_genotypes(std::ostream& stream = std::cout){
 		containers::MetaContainer meta(this->block);
-		containers::GenotypeContainer gt(this->block, meta);
+		containers::GenotypeContainer gt(this->block, meta, this->header.getSampleNumber());
 
 		for(U32 i = 0; i < gt.size(); ++i){
 			// All of these functions are in relative terms very expensive!
@@ -706,7 +946,7 @@ public:
 		timer.Start();
 
 		containers::MetaContainer meta(this->block);
-		containers::GenotypeContainer gt(this->block, meta);
+		containers::GenotypeContainer gt(this->block, meta, this->header.getSampleNumber());
 		for(U32 i = 0; i < gt.size(); ++i)
 			gt[i].comparePairwise(square_temporary);
 
@@ -722,7 +962,7 @@ public:
 
 	U64 getTiTVRatios(std::ostream& stream, std::vector<core::TsTvObject>& global){
 		containers::MetaContainer meta(this->block);
-		containers::GenotypeContainer gt(this->block, meta);
+		containers::GenotypeContainer gt(this->block, meta, this->header.getSampleNumber());
 
 		std::vector<core::TsTvObject> objects(this->header.getSampleNumber());
 		for(U32 i = 0; i < gt.size(); ++i)
@@ -897,7 +1137,7 @@ public:
 
 	U64 iterateMeta(std::ostream& stream = std::cout){
 		containers::MetaContainer meta(this->block);
-		containers::GenotypeContainer gt(this->block, meta);
+		containers::GenotypeContainer gt(this->block, meta, this->header.getSampleNumber());
 		containers::GenotypeSummary gt_summary;
 		for(U32 i = 0; i < gt.size(); ++i){
 			// If there's > 5 alleles continue
@@ -938,18 +1178,31 @@ public:
 	std::string        input_file;
 	std::ifstream      stream;
 	U64                filesize;
+	bool               memory_map;      // read blocks from the mapped file
+	U32                n_threads;       // threads used to output blocks
+	bool               lazy_decompression; // decompress containers on first access
+	std::vector<U64>   block_offsets;   // start of each block in file order
+	U64                mapped_position; // current offset in the mapped file
+	io::MappedFile     mapped_file;
 
 	// Actual data
 	block_entry_type   block;
+	block_cache_type*  block_cache;     // shared decoded blocks or nullptr
+	std::string        cache_id;        // identity of the input file in the cache
+	std::shared_ptr<const block_entry_type> cached_block; // cached data viewed by block
 
 	// Supportive objects
 	settings_type      settings;
 	header_type        header;
 	footer_type        footer;
 	index_type         index;
-	checksum_type      checksums;
+	checksum_type      checksums;       // SHA-512 digests of the file
+	block_checksum_type block_checksums; // or checksums of each block
+	bool               verify_checksums;
+	buffer_type        checksum_buffer; // raw data of a verified block
 	codec_manager_type codec_manager;
 	keychain_type      keychain;
+	encryption_manager_type encryption_manager;
 };
 
 }
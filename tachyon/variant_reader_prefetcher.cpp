@@ -0,0 +1,72 @@
+#include "variant_reader_prefetcher.h"
+
+namespace tachyon{
+
+VariantReaderPrefetcher::VariantReaderPrefetcher(reader_type& reader, const U32 depth) :
+	error_(false),
+	n_slots_(depth + 1),
+	n_blocks_(reader.block_offsets.size()),
+	first_block_(std::lower_bound(reader.block_offsets.begin(), reader.block_offsets.end(), reader.tell()) - reader.block_offsets.begin()),
+	current_(-1),
+	readers_(new reader_type*[this->n_slots_]),
+	free_(this->n_slots_),
+	ready_(this->n_slots_ + 1)
+{
+	for(U32 i = 0; i < this->n_slots_; ++i){
+		this->readers_[i] = new reader_type(reader);
+		this->readers_[i]->setLazyDecompression(false); // decompress in the background
+		this->free_.push(i);
+	}
+
+	this->thread_ = std::thread(&self_type::Run_, this);
+}
+
+VariantReaderPrefetcher::~VariantReaderPrefetcher(){
+	this->stop();
+	for(U32 i = 0; i < this->n_slots_; ++i)
+		delete this->readers_[i];
+	delete [] this->readers_;
+}
+
+bool VariantReaderPrefetcher::next(reader_type*& reader){
+	if(this->current_ >= 0){
+		this->free_.push(this->current_);
+		this->current_ = -1;
+	}
+
+	S32 slot = -1;
+	if(!this->ready_.pop(slot) || slot < 0)
+		return false;
+
+	this->current_ = slot;
+	reader = this->readers_[slot];
+	return true;
+}
+
+void VariantReaderPrefetcher::stop(void){
+	this->free_.close();
+	this->ready_.close();
+	if(this->thread_.joinable())
+		this->thread_.join();
+}
+
+void VariantReaderPrefetcher::Run_(void){
+	S32 slot = -1;
+	for(U32 block = this->first_block_; block < this->n_blocks_; ++block){
+		if(!this->free_.pop(slot))
+			break;
+
+		if(!this->readers_[slot]->seek_to_block(block) || !this->readers_[slot]->nextBlock()){
+			this->error_ = true;
+			this->ready_.push(-1);
+			break;
+		}
+
+		if(!this->ready_.push(slot))
+			break;
+	}
+
+	this->ready_.close();
+}
+
+}
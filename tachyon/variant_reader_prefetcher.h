@@ -0,0 +1,70 @@
+#ifndef CORE_TACHYON_READER_PREFETCHER_H_
+#define CORE_TACHYON_READER_PREFETCHER_H_
+
+#include <thread>
+
+#include "variant_reader.h"
+#include "algorithm/bounded_queue.h"
+
+namespace tachyon{
+
+/**<
+ * Sequential block iterator that reads, decrypts, and decompresses
+ * the next blocks on a background thread while the caller works on
+ * the current one. Each slot is a copy of the source reader that owns
+ * its own VariantBlock, stream, and codecs: with a depth of one the
+ * blocks are double-buffered. Slots are returned to the background
+ * thread when the caller asks for the next block, so a slot must not
+ * be used after the following call to next().
+ */
+class VariantReaderPrefetcher{
+private:
+	typedef VariantReaderPrefetcher self_type;
+	typedef VariantReader           reader_type;
+	typedef algorithm::BoundedQueue<S32> queue_type;
+
+public:
+	/**<
+	 * Iterate over the blocks of `reader` starting at the block it
+	 * would read next. The settings of `reader` at the time of
+	 * construction determine what is loaded.
+	 * @param reader Source reader that must be open
+	 * @param depth  Number of blocks loaded ahead of the current block
+	 */
+	VariantReaderPrefetcher(reader_type& reader, const U32 depth = 1);
+	~VariantReaderPrefetcher();
+
+	/**<
+	 * Retrieve the next block. Blocks while it is loaded and returns
+	 * the slot of the previous block to the background thread.
+	 * @param reader Reader holding the loaded block
+	 * @return       Returns TRUE upon success or FALSE at the end of the file or if there was a problem
+	 */
+	bool next(reader_type*& reader);
+
+	/**<
+	 * Stop reading ahead and wait for the background thread. Called
+	 * by the destructor: blocks that were loaded ahead are discarded.
+	 */
+	void stop(void);
+
+	inline const bool isError(void) const{ return(this->error_); }
+
+private:
+	void Run_(void);
+
+private:
+	bool          error_;
+	U32           n_slots_;
+	U32           n_blocks_;
+	U32           first_block_;
+	S32           current_;   // slot held by the caller or -1
+	reader_type** readers_;
+	queue_type    free_;      // slots available to the background thread
+	queue_type    ready_;     // loaded slots in block order, -1 on failure
+	std::thread   thread_;
+};
+
+}
+
+#endif /* CORE_TACHYON_READER_PREFETCHER_H_ */
@@ -46,6 +46,10 @@ void view_usage(void){
 	"  -d CHAR   output delimiter (-c must be triggered)\n"
 	"  -c        custom output format (ignores VCF/BCF specification rules)\n"
 	"  -G        drop all FORMAT fields from output\n"
+	"  -C        verify the checksum of each block as it is read\n"
+	"  -x        memory-map the input file instead of reading it through a stream\n"
+	"  -t INT    number of threads decoding and formatting blocks (default: 1)\n"
+	"  -b INT    cache up to INT MB of decoded blocks shared by the threads (default: 0)\n"
 	"  -h/H      header only / no header\n"
 	"  -s        Hide all program messages\n";
 }
@@ -80,6 +84,10 @@ int view(int argc, char** argv){
 		{"dropFormat",  no_argument, 0,  'G' },
 		{"customFormat",no_argument, 0,  'c' },
 		{"silent",      no_argument, 0,  's' },
+		{"verify",      no_argument, 0,  'C' },
+		{"mmap",        no_argument, 0,  'x' },
+		{"threads",     required_argument, 0,  't' },
+		{"cache",       required_argument, 0,  'b' },
 		{0,0,0,0}
 	};
 
@@ -97,13 +105,17 @@ int view(int argc, char** argv){
 	bool filterAny = false;
 	bool filterAll = false;
 	bool annotateGenotypes = false;
+	bool verifyChecksums = false;
+	bool memoryMap = false;
+	int n_threads = 1;
+	S64 cache_mb = 0;
 
 	std::string output_type;
 	bool output_FORMAT_as_vector = false;
 
 	std::string temp;
 
-	while ((c = getopt_long(argc, argv, "i:o:k:f:d:O:cGshHmMVX?", long_options, &option_index)) != -1){
+	while ((c = getopt_long(argc, argv, "i:o:k:f:d:O:t:b:cCGshHmMVXx?", long_options, &option_index)) != -1){
 		switch (c){
 		case 0:
 			std::cerr << "Case 0: " << option_index << '\t' << long_options[option_index].name << std::endl;
@@ -164,6 +176,30 @@ int view(int argc, char** argv){
 			annotateGenotypes = true;
 			break;
 
+		case 'C':
+			verifyChecksums = true;
+			break;
+
+		case 'x':
+			memoryMap = true;
+			break;
+
+		case 't':
+			n_threads = atoi(optarg);
+			if(n_threads <= 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set number of threads to <= 0..." << std::endl;
+				return(1);
+			}
+			break;
+
+		case 'b':
+			cache_mb = atoll(optarg);
+			if(cache_mb < 0){
+				std::cerr << tachyon::utility::timestamp("ERROR") << "Cannot set the block cache to < 0 MB..." << std::endl;
+				return(1);
+			}
+			break;
+
 		default:
 			std::cerr << tachyon::utility::timestamp("ERROR") << "Unrecognized option: " << (char)c << std::endl;
 			return(1);
@@ -196,13 +232,29 @@ int view(int argc, char** argv){
 			std::cerr << tachyon::utility::timestamp("ERROR") << "Failed to parse keychain..." << std::endl;
 			return 1;
 		}
+		reader.setDecryptionThreads(std::thread::hardware_concurrency());
 	}
 
+	reader.setMemoryMap(memoryMap);
+	reader.setThreads(n_threads);
+
+	// Decoded blocks are shared by the reader and its copies
+	tachyon::containers::VariantBlockCache block_cache(cache_mb * 1000000);
+	if(cache_mb) reader.setBlockCache(&block_cache);
+
 	if(!reader.open(input)){
 		std::cerr << tachyon::utility::timestamp("ERROR") << "Failed to open file: " << input << "..." << std::endl;
 		return 1;
 	}
 
+	if(verifyChecksums){
+		if(reader.block_checksums.type == tachyon::algorithm::YON_CHECKSUM_SHA512){
+			std::cerr << tachyon::utility::timestamp("ERROR") << "File has no per-block checksums: import with -X crc32c or -X xxhash64..." << std::endl;
+			return 1;
+		}
+		reader.setVerifyChecksums(true);
+	}
+
 	if(headerOnly){
 		reader.header.literals += "\n##tachyon_viewVersion=" + tachyon::constants::PROGRAM_NAME + "-" + VERSION + ";";
 		reader.header.literals += "libraries=" +  tachyon::constants::PROGRAM_NAME + '-' + tachyon::constants::TACHYON_LIB_VERSION + ","
@@ -291,14 +343,6 @@ int view(int argc, char** argv){
 	if(showHeader) reader.getSettings().show_vcf_header = true;
 	else reader.getSettings().show_vcf_header = false;
 
-	tachyon::core::HeaderContig* contig = nullptr;
-	if(!reader.header.getContig("20",contig)){
-		std::cerr << "cant find: " << "20" << std::endl;
-		return(1);
-	}
-	reader.index.findOverlap(contig->contigID, 1000000, 2100000);
-	return(1);
-
 	// Temp
 	//while(reader.nextBlock()) reader.getGenotypeSummary(std::cout);
 	//return(0);
@@ -310,5 +354,10 @@ int view(int argc, char** argv){
 	//std::cerr << "Blocks: " << n_blocks << std::endl;
 	std::cerr << "Variants: " << tachyon::utility::ToPrettyString(n_variants) << " genotypes: " << tachyon::utility::ToPrettyString(n_variants*reader.header.getSampleNumber()) << '\t' << timer.ElapsedString() << '\t' << tachyon::utility::ToPrettyString((U64)((double)n_variants*reader.header.getSampleNumber()/timer.Elapsed().count())) << std::endl;
 
+	if(cache_mb && !SILENT){
+		std::cerr << tachyon::utility::timestamp("LOG","CACHE") << "Block cache: " << tachyon::utility::ToPrettyString(block_cache.hits()) << " hits, " << tachyon::utility::ToPrettyString(block_cache.misses()) << " misses, "
+		          << tachyon::utility::ToPrettyString(block_cache.evictions()) << " evictions; " << tachyon::utility::toPrettyDiskString(block_cache.size()) << " in " << block_cache.entries() << " blocks..." << std::endl;
+	}
+
 	return 0;
 }
@@ -0,0 +1,44 @@
+#!/bin/sh
+# Genotype round trips through the importer and the viewer
+#
+# usage: genotypes.sh <tachyon binary>
+#
+# genotypes.vcf has haploid variants, diploid variants with haploid
+# samples (EOV), and polyploid variants with mixed phasing that are
+# stored BCF-style. Every genotype has to be viewed as it was imported.
+#
+# genotypes_legacy.yon was written from genotypes_legacy.vcf before EOV
+# was packed apart from missing in diploid genotypes. It has to be viewed
+# as the genotypes it was written from.
+
+TACHYON=${1:-../bin/tachyon}
+DATA=$(dirname "$0")/data
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+FAILED=0
+
+# Compare the genotypes of a VCF file with the view of a YON file
+compare(){
+	grep -v '^#' "$1" | cut -f1,2,4,5,10- > "$TMP/expected"
+	"$TACHYON" view -H -s -i "$2" 2> "$TMP/view.log" | cut -f1,2,4,5,10- > "$TMP/observed"
+	if diff "$TMP/expected" "$TMP/observed"; then
+		echo "PASS: $3"
+	else
+		cat "$TMP/view.log"
+		echo "FAIL: $3"
+		FAILED=1
+	fi
+}
+
+if "$TACHYON" import -i "$DATA/genotypes.vcf" -o "$TMP/genotypes.yon" > "$TMP/import.log" 2>&1; then
+	compare "$DATA/genotypes.vcf" "$TMP/genotypes.yon" "round trip of haploid, mixed-ploidy and BCF-style genotypes"
+else
+	cat "$TMP/import.log"
+	echo "FAIL: import of genotypes.vcf"
+	FAILED=1
+fi
+
+compare "$DATA/genotypes_legacy.vcf" "$DATA/genotypes_legacy.yon" "view of a file written before EOV was packed apart from missing"
+
+exit $FAILED